@@ -0,0 +1,144 @@
+/***************************************************************************
+* Copyright ESIEE Paris (2021)                                             *
+*                                                                          *
+* Contributor(s) : Benjamin Perret                                         *
+*                                                                          *
+* Distributed under the terms of the CECILL-B License.                     *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <benchmark/benchmark.h>
+
+#include "higra/image/graph_image.hpp"
+#include "higra/algo/watershed.hpp"
+#include "higra/algo/rag.hpp"
+#include "higra/hierarchy/binary_partition_tree.hpp"
+#include "xtensor/xrandom.hpp"
+#include "utils.h"
+#include <cmath>
+#include <map>
+
+using namespace xt;
+using namespace hg;
+
+/*
+ * Region adjacency graph of the watershed of a random 4 adjacency grid graph with approximately the given number
+ * of edges (the watershed of white noise produces about 0.77 rag edge per pixel).
+ * Rags are cached as they are costly to build.
+ */
+static const region_adjacency_graph &get_rag(index_t num_edges) {
+    static std::map<index_t, region_adjacency_graph> cache;
+    auto it = cache.find(num_edges);
+    if (it == cache.end()) {
+        index_t size = (index_t) std::sqrt(num_edges / 0.77);
+        auto g = get_4_adjacency_graph({size, size});
+        xt::random::seed(42);
+        array_1d<double> weights = xt::random::rand<double>({hg::num_edges(g)});
+        auto labels = labelisation_watershed(g, weights);
+        it = cache.emplace(num_edges, make_region_adjacency_graph_from_labelisation(g, labels)).first;
+    }
+    return it->second;
+}
+
+static void rag_sizes(benchmark::internal::Benchmark *b) {
+    for (index_t num_edges = 10000; num_edges <= 10000000; num_edges *= 10)
+        b->Arg(num_edges);
+    b->Unit(benchmark::kMillisecond);
+}
+
+/*
+ * Arguments: approximate number of edges of the rag
+ */
+template<typename heap_policy>
+static void BM_binary_partition_tree_complete_linkage(benchmark::State &state) {
+    auto &rag = get_rag(state.range(0)).rag;
+    xt::random::seed(1);
+    array_1d<double> weights = xt::random::rand<double>({num_edges(rag)});
+
+    for (auto _ : state) {
+        auto res = binary_partition_tree_complete_linkage<heap_policy>(rag, weights);
+        benchmark::DoNotOptimize(res.altitudes.data());
+    }
+    state.counters["edges"] = (double) num_edges(rag);
+}
+
+template<typename heap_policy>
+static void BM_binary_partition_tree_average_linkage(benchmark::State &state) {
+    auto &rag = get_rag(state.range(0)).rag;
+    xt::random::seed(1);
+    array_1d<double> weights = xt::random::rand<double>({num_edges(rag)});
+    array_1d<double> weight_weights = xt::random::rand<double>({num_edges(rag)});
+
+    for (auto _ : state) {
+        auto res = binary_partition_tree_average_linkage<heap_policy>(rag, weights, weight_weights);
+        benchmark::DoNotOptimize(res.altitudes.data());
+    }
+    state.counters["edges"] = (double) num_edges(rag);
+}
+
+template<typename heap_policy>
+static void BM_binary_partition_tree_exponential_linkage(benchmark::State &state) {
+    auto &rag = get_rag(state.range(0)).rag;
+    xt::random::seed(1);
+    array_1d<double> weights = xt::random::rand<double>({num_edges(rag)});
+    array_1d<double> weight_weights = xt::random::rand<double>({num_edges(rag)});
+
+    for (auto _ : state) {
+        auto res = binary_partition_tree_exponential_linkage<heap_policy>(rag, weights, 2.0, weight_weights);
+        benchmark::DoNotOptimize(res.altitudes.data());
+    }
+    state.counters["edges"] = (double) num_edges(rag);
+}
+
+template<typename heap_policy>
+static void BM_binary_partition_tree_ward_linkage(benchmark::State &state) {
+    auto &rag = get_rag(state.range(0)).rag;
+    xt::random::seed(1);
+    array_2d<double> centroids = xt::random::rand<double>({num_vertices(rag), (size_t) 3});
+    array_1d<double> sizes = xt::random::randint<int>({num_vertices(rag)}, 1, 10);
+
+    for (auto _ : state) {
+        auto res = binary_partition_tree_ward_linkage<heap_policy>(rag, centroids, sizes);
+        benchmark::DoNotOptimize(res.altitudes.data());
+    }
+    state.counters["edges"] = (double) num_edges(rag);
+}
+
+/*
+ * Complete linkage with the given working graph type for the merging process.
+ * Arguments: approximate number of edges of the rag
+ */
+template<typename region_graph_t>
+static void BM_binary_partition_tree_region_graph(benchmark::State &state) {
+    auto &rag = get_rag(state.range(0)).rag;
+    xt::random::seed(1);
+    array_1d<double> weights = xt::random::rand<double>({num_edges(rag)});
+    using weighter_t = binary_partition_tree_internal::binary_partition_tree_complete_linkage_weighting_functor<array_1d<double>>;
+
+    for (auto _ : state) {
+        auto res = binary_partition_tree<bpt_heap::automatic, region_graph_t>(rag, weights, weighter_t(weights));
+        benchmark::DoNotOptimize(res.altitudes.data());
+    }
+    state.counters["edges"] = (double) num_edges(rag);
+    state.counters["peak_memory_MB"] = (double) peak_memory_usage([&rag, &weights]() {
+        binary_partition_tree<bpt_heap::automatic, region_graph_t>(rag, weights, weighter_t(weights));
+    }) / (1024 * 1024);
+}
+
+BENCHMARK_TEMPLATE(BM_binary_partition_tree_region_graph, undirected_graph<hash_setS>)->Apply(rag_sizes);
+BENCHMARK_TEMPLATE(BM_binary_partition_tree_region_graph, region_merging_graph)->Apply(rag_sizes);
+
+#define HG_BENCHMARK_BPT_HEAPS(bm) \
+    BENCHMARK_TEMPLATE(bm, bpt_heap::fibonacci)->Apply(rag_sizes); \
+    BENCHMARK_TEMPLATE(bm, bpt_heap::pairing)->Apply(rag_sizes); \
+    BENCHMARK_TEMPLATE(bm, bpt_heap::dary)->Apply(rag_sizes); \
+    BENCHMARK_TEMPLATE(bm, bpt_heap::automatic)->Apply(rag_sizes); \
+    BENCHMARK_TEMPLATE(bm, bpt_heap::nn_chain)->Apply(rag_sizes);
+
+HG_BENCHMARK_BPT_HEAPS(BM_binary_partition_tree_complete_linkage)
+HG_BENCHMARK_BPT_HEAPS(BM_binary_partition_tree_average_linkage)
+HG_BENCHMARK_BPT_HEAPS(BM_binary_partition_tree_exponential_linkage)
+HG_BENCHMARK_BPT_HEAPS(BM_binary_partition_tree_ward_linkage)
+
+#undef HG_BENCHMARK_BPT_HEAPS
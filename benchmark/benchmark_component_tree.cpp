@@ -0,0 +1,51 @@
+/***************************************************************************
+* Copyright ESIEE Paris (2021)                                             *
+*                                                                          *
+* Contributor(s) : Benjamin Perret                                         *
+*                                                                          *
+* Distributed under the terms of the CECILL-B License.                     *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <benchmark/benchmark.h>
+
+#include "higra/image/graph_image.hpp"
+#include "higra/hierarchy/component_tree.hpp"
+#include "xtensor/xrandom.hpp"
+#include "tbb/global_control.h"
+
+using namespace xt;
+using namespace hg;
+
+static void image_sizes_and_threads(benchmark::internal::Benchmark *b) {
+    for (index_t size = 1024; size <= 16384; size *= 4)
+        for (index_t num_threads = 1; num_threads <= 16; num_threads *= 2)
+            b->Args({size, num_threads});
+    b->Unit(benchmark::kMillisecond);
+    b->UseRealTime();
+}
+
+/*
+ * Max tree of a random 8 bits image on a 4 adjacency grid
+ * Arguments: size of the grid side, maximal number of threads
+ */
+template<typename engine_t>
+static void BM_component_tree_max_tree(benchmark::State &state) {
+    index_t size = state.range(0);
+    tbb::global_control control(tbb::global_control::max_allowed_parallelism, state.range(1));
+    auto g = get_4_adjacency_implicit_graph({size, size});
+    xt::random::seed(42);
+    array_1d<unsigned char> vertex_weights = xt::random::randint<int>({size * size}, 0, 256);
+
+    for (auto _ : state) {
+        auto res = component_tree_max_tree<engine_t>(g, vertex_weights);
+        benchmark::DoNotOptimize(res.tree.parents().data());
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_component_tree_max_tree, component_tree_engine::sequential)
+        ->Args({1024, 1})->Args({4096, 1})->Args({16384, 1})->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_component_tree_max_tree, component_tree_engine::hierarchical_queue)
+        ->Args({1024, 1})->Args({4096, 1})->Args({16384, 1})->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_component_tree_max_tree, component_tree_engine::tiled)->Apply(image_sizes_and_threads);
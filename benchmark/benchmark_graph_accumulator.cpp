@@ -0,0 +1,135 @@
+/***************************************************************************
+* Copyright ESIEE Paris (2021)                                             *
+*                                                                          *
+* Contributor(s) : Benjamin Perret                                         *
+*                                                                          *
+* Distributed under the terms of the CECILL-B License.                     *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <benchmark/benchmark.h>
+#include "utils.h"
+
+#include "higra/accumulator/at_accumulator.hpp"
+#include "higra/accumulator/graph_accumulator.hpp"
+#include "higra/image/graph_image.hpp"
+#include "xtensor/xrandom.hpp"
+#include "tbb/global_control.h"
+
+using namespace xt;
+using namespace hg;
+
+/*
+ * Images of side 1024 to 4096
+ */
+static void image_sizes_and_threads(benchmark::internal::Benchmark *b) {
+    for (index_t size = 1024; size <= 4096; size *= 2)
+        for (index_t num_threads = 1; num_threads <= 16; num_threads *= 2)
+            b->Args({size, num_threads});
+    b->Unit(benchmark::kMillisecond);
+    b->UseRealTime();
+}
+
+/*
+ * Labels of the square regions of side 8 of an image of side size (rag vertex map of a regular partition)
+ */
+static array_1d<index_t> get_square_regions(index_t size) {
+    array_1d<index_t> labels = array_1d<index_t>::from_shape({(size_t) (size * size)});
+    index_t regions_per_line = size / 8;
+    for (index_t y = 0; y < size; y++) {
+        for (index_t x = 0; x < size; x++) {
+            labels(y * size + x) = (y / 8) * regions_per_line + x / 8;
+        }
+    }
+    return labels;
+}
+
+/*
+ * Arguments: size of the side of the image, maximal number of threads
+ */
+static void BM_accumulate_graph_vertices_mean(benchmark::State &state) {
+    tbb::global_control control(tbb::global_control::max_allowed_parallelism, state.range(1));
+    index_t size = state.range(0);
+    auto g = get_4_adjacency_graph({size, size});
+    xt::random::seed(42);
+    array_1d<double> vertex_weights = random::rand<double>({num_vertices(g)});
+
+    for (auto _ : state) {
+        auto res = accumulate_graph_vertices(g, vertex_weights, accumulator_mean());
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+
+static void BM_accumulate_graph_edges_sum(benchmark::State &state) {
+    tbb::global_control control(tbb::global_control::max_allowed_parallelism, state.range(1));
+    index_t size = state.range(0);
+    auto g = get_4_adjacency_graph({size, size});
+    xt::random::seed(42);
+    array_1d<double> edge_weights = random::rand<double>({num_edges(g)});
+
+    for (auto _ : state) {
+        auto res = accumulate_graph_edges(g, edge_weights, accumulator_sum());
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+
+/*
+ * Colour statistics of regions: mean and max of 3 channels
+ */
+template<typename accumulator_t>
+static void BM_accumulate_at_colour(benchmark::State &state) {
+    tbb::global_control control(tbb::global_control::max_allowed_parallelism, state.range(1));
+    index_t size = state.range(0);
+    auto labels = get_square_regions(size);
+    xt::random::seed(42);
+    array_2d<double> colours = random::rand<double>({(size_t) (size * size), (size_t) 3});
+
+    for (auto _ : state) {
+        auto res = accumulate_at(labels, colours, accumulator_t());
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+
+/*
+ * Single threaded comparison of the at_accumulate engines
+ * Argument: size of the side of the image
+ */
+template<typename accumulator_t>
+static void BM_accumulate_at_colour_one_accumulator_per_output(benchmark::State &state) {
+    index_t size = state.range(0);
+    auto labels = get_square_regions(size);
+    xt::random::seed(42);
+    array_2d<double> colours = random::rand<double>({(size_t) (size * size), (size_t) 3});
+
+    for (auto _ : state) {
+        auto res = at_accumulator_internal::at_accumulate<true>(labels, colours, accumulator_t());
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+
+template<typename accumulator_t>
+static void BM_accumulate_at_colour_sorted(benchmark::State &state) {
+    index_t size = state.range(0);
+    auto labels = get_square_regions(size);
+    xt::random::seed(42);
+    array_2d<double> colours = random::rand<double>({(size_t) (size * size), (size_t) 3});
+
+    for (auto _ : state) {
+        auto res = at_accumulator_internal::at_accumulate_sorted<true>(labels, colours, accumulator_t(), 1);
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+
+BENCHMARK(BM_accumulate_graph_vertices_mean)->Apply(image_sizes_and_threads);
+BENCHMARK(BM_accumulate_graph_edges_sum)->Apply(image_sizes_and_threads);
+BENCHMARK_TEMPLATE(BM_accumulate_at_colour, accumulator_mean)->Apply(image_sizes_and_threads);
+BENCHMARK_TEMPLATE(BM_accumulate_at_colour, accumulator_max)->Apply(image_sizes_and_threads);
+BENCHMARK_TEMPLATE(BM_accumulate_at_colour_one_accumulator_per_output, accumulator_mean)->RangeMultiplier(2)
+        ->Range(1024, 4096)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_accumulate_at_colour_one_accumulator_per_output, accumulator_max)->RangeMultiplier(2)
+        ->Range(1024, 4096)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_accumulate_at_colour_sorted, accumulator_mean)->RangeMultiplier(2)
+        ->Range(1024, 4096)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_accumulate_at_colour_sorted, accumulator_max)->RangeMultiplier(2)
+        ->Range(1024, 4096)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,87 @@
+/***************************************************************************
+* Copyright ESIEE Paris (2021)                                             *
+*                                                                          *
+* Contributor(s) : Benjamin Perret                                         *
+*                                                                          *
+* Distributed under the terms of the CECILL-B License.                     *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+
+#include <benchmark/benchmark.h>
+#include "utils.h"
+
+#include "higra/image/graph_image.hpp"
+#include "higra/algo/graph_weights.hpp"
+#include "xtensor/xrandom.hpp"
+
+using namespace xt;
+using namespace hg;
+
+/*
+ * Edge weighting of a random image on the explicit 4 adjacency graph (generic per edge function)
+ * Arguments: weight function, number of channels of the vertex weights
+ */
+static void BM_weight_graph_explicit(benchmark::State &state) {
+    const size_t size = 1024;
+    auto f = (weight_functions) state.range(0);
+    size_t channels = state.range(1);
+    xt::random::seed(42);
+    auto g = get_4_adjacency_graph({size, size});
+    array_2d<double> image = xt::random::rand<double>({size * size, channels});
+    array_1d<double> image1d = xt::flatten(image);
+
+    for (auto _ : state) {
+        auto res = (channels == 1) ? weight_graph(g, image1d, f) : weight_graph(g, image, f);
+        benchmark::DoNotOptimize(res.data());
+    }
+    state.SetItemsProcessed(state.iterations() * num_edges(g));
+}
+
+/*
+ * Same as BM_weight_graph_explicit on the implicit 4 adjacency graph (vectorized row kernels)
+ * Arguments: weight function, number of channels of the vertex weights
+ */
+static void BM_weight_graph_implicit(benchmark::State &state) {
+    const size_t size = 1024;
+    auto f = (weight_functions) state.range(0);
+    size_t channels = state.range(1);
+    xt::random::seed(42);
+    auto g = get_4_adjacency_implicit_graph({size, size});
+    array_2d<double> image = xt::random::rand<double>({size * size, channels});
+    array_1d<double> image1d = xt::flatten(image);
+    size_t num_e = 0;
+
+    for (auto _ : state) {
+        auto res = (channels == 1) ? weight_graph(g, image1d, f) : weight_graph(g, image, f);
+        num_e = res.size();
+        benchmark::DoNotOptimize(res.data());
+    }
+    state.SetItemsProcessed(state.iterations() * num_e);
+}
+
+static void weight_graph_arguments(benchmark::internal::Benchmark *b) {
+    for (auto f: {weight_functions::mean,
+                  weight_functions::min,
+                  weight_functions::max,
+                  weight_functions::L0,
+                  weight_functions::L1,
+                  weight_functions::L2,
+                  weight_functions::L_infinity,
+                  weight_functions::L2_squared,
+                  weight_functions::source,
+                  weight_functions::target}) {
+        b->Args({(long) f, 1});
+    }
+    for (auto f: {weight_functions::L0,
+                  weight_functions::L1,
+                  weight_functions::L2,
+                  weight_functions::L_infinity,
+                  weight_functions::L2_squared}) {
+        b->Args({(long) f, 3});
+    }
+}
+
+BENCHMARK(BM_weight_graph_explicit)->Apply(weight_graph_arguments)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_weight_graph_implicit)->Apply(weight_graph_arguments)->Unit(benchmark::kMillisecond);
@@ -79,4 +79,102 @@ static void BM_lca_sparse_table(benchmark::State &state) {
     }
 }
 
-BENCHMARK(BM_lca_sparse_table)->DenseRange(256, 2048, 256);
\ No newline at end of file
+BENCHMARK(BM_lca_sparse_table)->DenseRange(256, 2048, 256);
+
+/*
+ * Query throughput and peak memory used during the construction, per tree node, of the lca structures
+ * Argument: size of the grid side
+ */
+template<typename lca_t>
+static void BM_lca_queries_and_memory(benchmark::State &state) {
+    index_t size = state.range(0);
+    xt::random::seed(42);
+    auto g = get_4_adjacency_graph({size, size});
+    array_1d<double> weights = xt::random::rand<double>({num_edges(g)});
+    auto res = watershed_hierarchy_by_area(g, weights);
+    auto &tree = res.tree;
+    tree.compute_children();
+
+    size_t memory = peak_memory_usage([&tree]() {
+        lca_t l(tree);
+        benchmark::DoNotOptimize(l.lca(0, 1));
+    });
+    lca_t l(tree);
+
+    for (auto _ : state) {
+        auto ll = l.lca(sources(g), targets(g));
+        benchmark::DoNotOptimize(ll[0]);
+    }
+    state.SetItemsProcessed(state.iterations() * num_edges(g));
+    state.counters["peak_bytes_per_node"] = (double) memory / num_vertices(tree);
+}
+
+static void grid_sizes(benchmark::internal::Benchmark *b) {
+    for (index_t size = 256; size <= 4096; size *= 4)
+        b->Arg(size);
+    b->Unit(benchmark::kMillisecond);
+}
+
+BENCHMARK_TEMPLATE(BM_lca_queries_and_memory, lca_sparse_table)->Apply(grid_sizes);
+BENCHMARK_TEMPLATE(BM_lca_queries_and_memory, lca_sparse_table_block)->Apply(grid_sizes);
+BENCHMARK_TEMPLATE(BM_lca_queries_and_memory, lca_preorder_block)->Apply(grid_sizes);
+BENCHMARK_TEMPLATE(BM_lca_queries_and_memory, lca_preorder_block_32)->Apply(grid_sizes);
+
+
+/*
+ * Lowest common ancestors of a fraction of the graph edges: online (lca structure construction and queries)
+ * versus offline
+ * Arguments: size of the grid side, percentage of the edges queried
+ */
+static void BM_lca_online_edges(benchmark::State &state) {
+    index_t size = state.range(0);
+    xt::random::seed(42);
+    auto g = get_4_adjacency_graph({size, size});
+    array_1d<double> weights = xt::random::rand<double>({num_edges(g)});
+    auto res = watershed_hierarchy_by_area(g, weights);
+    auto &tree = res.tree;
+    index_t num_queries = num_edges(g) * state.range(1) / 100;
+    array_1d<index_t> v1 = xt::view(sources(g), xt::range(0, num_queries));
+    array_1d<index_t> v2 = xt::view(targets(g), xt::range(0, num_queries));
+
+    size_t memory = 0;
+    for (auto _ : state) {
+        memory = peak_memory_usage([&]() {
+            lca_preorder_block_32 l(tree);
+            auto ll = l.lca(v1, v2);
+            benchmark::DoNotOptimize(ll.data());
+        });
+    }
+    state.counters["peak_bytes_per_node"] = (double) memory / num_vertices(tree);
+}
+
+static void BM_lca_offline_edges(benchmark::State &state) {
+    index_t size = state.range(0);
+    xt::random::seed(42);
+    auto g = get_4_adjacency_graph({size, size});
+    array_1d<double> weights = xt::random::rand<double>({num_edges(g)});
+    auto res = watershed_hierarchy_by_area(g, weights);
+    auto &tree = res.tree;
+    index_t num_queries = num_edges(g) * state.range(1) / 100;
+    array_1d<index_t> v1 = xt::view(sources(g), xt::range(0, num_queries));
+    array_1d<index_t> v2 = xt::view(targets(g), xt::range(0, num_queries));
+
+    size_t memory = 0;
+    for (auto _ : state) {
+        memory = peak_memory_usage([&]() {
+            auto ll = lca_offline(tree, v1, v2);
+            benchmark::DoNotOptimize(ll.data());
+        });
+    }
+    state.counters["peak_bytes_per_node"] = (double) memory / num_vertices(tree);
+}
+
+static void grid_sizes_and_query_ratios(benchmark::internal::Benchmark *b) {
+    for (index_t size = 256; size <= 4096; size *= 4)
+        for (index_t ratio: {1, 10, 50, 100})
+            b->Args({size, ratio});
+    b->Unit(benchmark::kMillisecond);
+}
+
+BENCHMARK(BM_lca_online_edges)->Apply(grid_sizes_and_query_ratios);
+BENCHMARK(BM_lca_offline_edges)->Apply(grid_sizes_and_query_ratios);
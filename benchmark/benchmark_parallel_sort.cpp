@@ -11,6 +11,7 @@
 #include <benchmark/benchmark.h>
 
 #include "higra/graph.hpp"
+#include "higra/sorting.hpp"
 #include "xtensor/xview.hpp"
 #include "xtensor/xrandom.hpp"
 #include <algorithm>
@@ -84,4 +85,60 @@ static void BM_tbb_parallel_stable_sort(benchmark::State &state) {
     }
 }
 
-BENCHMARK(BM_tbb_parallel_stable_sort)->Range(1 << min_array_size, 1 << max_array_size);
\ No newline at end of file
+BENCHMARK(BM_tbb_parallel_stable_sort)->Range(1 << min_array_size, 1 << max_array_size);
+
+/*
+ * Stable arg sort of the values of an array: comparison based sorts (STL and TBB) against the radix sort
+ * used by hg::stable_arg_sort for arithmetic values.
+ */
+template<typename T>
+array_1d<T> get_random_sort_keys(std::size_t size) {
+    xt::random::seed(42);
+    array_1d<double> values = xt::random::rand<double>({size});
+    if (!std::is_floating_point<T>::value) {
+        values *= (double) (std::numeric_limits<T>::max)();
+    }
+    return values;
+}
+
+template<typename T>
+static void BM_stl_stable_arg_sort(benchmark::State &state) {
+    size_t size = state.range(0);
+    array_1d<T> a = get_random_sort_keys<T>(size);
+    for (auto _ : state) {
+        array_1d<index_t> indices = xt::arange<index_t>(size);
+        std::stable_sort(indices.begin(), indices.end(), [&a](index_t i, index_t j) { return a(i) < a(j); });
+        benchmark::DoNotOptimize(indices[0]);
+    }
+}
+
+template<typename T>
+static void BM_tbb_stable_arg_sort(benchmark::State &state) {
+    size_t size = state.range(0);
+    array_1d<T> a = get_random_sort_keys<T>(size);
+    for (auto _ : state) {
+        array_1d<index_t> indices = xt::arange<index_t>(size);
+        pss::parallel_stable_sort(indices.begin(), indices.end(), [&a](index_t i, index_t j) { return a(i) < a(j); });
+        benchmark::DoNotOptimize(indices[0]);
+    }
+}
+
+template<typename T>
+static void BM_radix_stable_arg_sort(benchmark::State &state) {
+    size_t size = state.range(0);
+    array_1d<T> a = get_random_sort_keys<T>(size);
+    for (auto _ : state) {
+        auto indices = hg::sorting_internal::radix_stable_arg_sort(a);
+        benchmark::DoNotOptimize(indices[0]);
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_stl_stable_arg_sort, uint8_t)->Range(1 << min_array_size, 1 << max_array_size);
+BENCHMARK_TEMPLATE(BM_tbb_stable_arg_sort, uint8_t)->Range(1 << min_array_size, 1 << max_array_size);
+BENCHMARK_TEMPLATE(BM_radix_stable_arg_sort, uint8_t)->Range(1 << min_array_size, 1 << max_array_size);
+BENCHMARK_TEMPLATE(BM_stl_stable_arg_sort, uint16_t)->Range(1 << min_array_size, 1 << max_array_size);
+BENCHMARK_TEMPLATE(BM_tbb_stable_arg_sort, uint16_t)->Range(1 << min_array_size, 1 << max_array_size);
+BENCHMARK_TEMPLATE(BM_radix_stable_arg_sort, uint16_t)->Range(1 << min_array_size, 1 << max_array_size);
+BENCHMARK_TEMPLATE(BM_stl_stable_arg_sort, float)->Range(1 << min_array_size, 1 << max_array_size);
+BENCHMARK_TEMPLATE(BM_tbb_stable_arg_sort, float)->Range(1 << min_array_size, 1 << max_array_size);
+BENCHMARK_TEMPLATE(BM_radix_stable_arg_sort, float)->Range(1 << min_array_size, 1 << max_array_size);
@@ -14,6 +14,8 @@
 #include "higra/graph.hpp"
 #include "xtensor/xrandom.hpp"
 #include "higra/image/graph_image.hpp"
+#include "higra/algo/graph_weights.hpp"
+#include "higra/hierarchy/watershed_hierarchy.hpp"
 
 using namespace xt;
 using namespace hg;
@@ -45,4 +47,75 @@ static void BM_graph_implicit_adjacency_iterator(benchmark::State &state) {
 
 BENCHMARK(BM_graph_implicit_adjacency_iterator)->Range(1 << min_size, 1 << max_size);
 
+template<typename graph_t>
+graph_t get_3d_graph(index_t size, index_t adjacency);
 
+template<>
+ugraph get_3d_graph<ugraph>(index_t size, index_t adjacency) {
+    embedding_grid_3d embedding{size, size, size};
+    return (adjacency == 6) ? get_6_adjacency_graph(embedding) : get_26_adjacency_graph(embedding);
+}
+
+template<>
+regular_grid_graph_3d get_3d_graph<regular_grid_graph_3d>(index_t size, index_t adjacency) {
+    embedding_grid_3d embedding{size, size, size};
+    return (adjacency == 6) ? get_6_adjacency_implicit_graph(embedding) : get_26_adjacency_implicit_graph(embedding);
+}
+
+/*
+ * Watershed hierarchy by area of a random volume with L1 edge weights, graph construction included
+ * Arguments: size of the volume side, adjacency (6 or 26)
+ */
+template<typename graph_t>
+static void BM_watershed_hierarchy_3d(benchmark::State &state) {
+    index_t size = state.range(0);
+    index_t adjacency = state.range(1);
+    xt::random::seed(42);
+    array_1d<float> volume = xt::random::rand<float>({(size_t) (size * size * size)});
+    size_t memory = 0;
+
+    for (auto _ : state) {
+        memory = peak_memory_usage([&]() {
+            auto g = get_3d_graph<graph_t>(size, adjacency);
+            array_1d<float> edge_weights = weight_graph(g, volume, weight_functions::L1);
+            auto res = watershed_hierarchy_by_area(g, edge_weights);
+            benchmark::DoNotOptimize(res.altitudes(0));
+        });
+    }
+    state.counters["peak_bytes_per_voxel"] = (double) memory / (size * size * size);
+}
+
+/*
+ * Steps of the 3d pipeline: graph construction and edge weighting (step 0), canonical binary partition tree (step 1)
+ * Arguments: size of the volume side, adjacency (6 or 26), step
+ */
+template<typename graph_t>
+static void BM_pipeline_3d_step(benchmark::State &state) {
+    index_t size = state.range(0);
+    index_t adjacency = state.range(1);
+    index_t step = state.range(2);
+    xt::random::seed(42);
+    array_1d<float> volume = xt::random::rand<float>({(size_t) (size * size * size)});
+    auto g = get_3d_graph<graph_t>(size, adjacency);
+    array_1d<float> edge_weights = weight_graph(g, volume, weight_functions::L1);
+
+    for (auto _ : state) {
+        if (step == 0) {
+            auto g2 = get_3d_graph<graph_t>(size, adjacency);
+            array_1d<float> w = weight_graph(g2, volume, weight_functions::L1);
+            benchmark::DoNotOptimize(w.data());
+        } else {
+            auto res = bpt_canonical(g, edge_weights);
+            benchmark::DoNotOptimize(res.altitudes(0));
+        }
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_watershed_hierarchy_3d, ugraph)->ArgsProduct({{32, 64, 128}, {6, 26}})
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_watershed_hierarchy_3d, regular_grid_graph_3d)->ArgsProduct({{32, 64, 128}, {6, 26}})
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_pipeline_3d_step, ugraph)->ArgsProduct({{128}, {6, 26}, {0, 1}})
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_pipeline_3d_step, regular_grid_graph_3d)->ArgsProduct({{128}, {6, 26}, {0, 1}})
+        ->Unit(benchmark::kMillisecond);
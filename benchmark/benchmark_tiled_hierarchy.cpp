@@ -0,0 +1,76 @@
+/***************************************************************************
+* Copyright ESIEE Paris (2021)                                             *
+*                                                                          *
+* Contributor(s) : Benjamin Perret                                         *
+*                                                                          *
+* Distributed under the terms of the CECILL-B License.                     *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+
+#include <benchmark/benchmark.h>
+#include "utils.h"
+
+#include "higra/image/graph_image.hpp"
+#include "higra/algo/graph_weights.hpp"
+#include "higra/hierarchy/tiled_hierarchy.hpp"
+#include "xtensor/xrandom.hpp"
+
+using namespace xt;
+using namespace hg;
+
+/*
+ * Watershed hierarchy by area of a random image with L1 edge weights computed on the whole 4 adjacency graph
+ * Argument: size of the image side
+ */
+static void BM_watershed_hierarchy_by_area(benchmark::State &state) {
+    index_t size = state.range(0);
+    xt::random::seed(42);
+    array_1d<float> image = xt::random::rand<float>({(size_t) (size * size)});
+    size_t memory = 0;
+
+    for (auto _ : state) {
+        memory = peak_memory_usage([&]() {
+            auto g = get_4_adjacency_graph({size, size});
+            array_1d<float> edge_weights = weight_graph(g, image, weight_functions::L1);
+            auto res = watershed_hierarchy_by_area(g, edge_weights);
+            benchmark::DoNotOptimize(res.altitudes(0));
+        });
+    }
+    state.counters["peak_bytes_per_pixel"] = (double) memory / (size * size);
+}
+
+/*
+ * Same as BM_watershed_hierarchy_by_area with the tiled algorithm
+ * Arguments: size of the image side, memory budget per tile in MB
+ */
+static void BM_watershed_hierarchy_by_area_tiled(benchmark::State &state) {
+    index_t size = state.range(0);
+    size_t budget = state.range(1) << 20;
+    xt::random::seed(42);
+    array_1d<float> image = xt::random::rand<float>({(size_t) (size * size)});
+    auto reader = make_tile_reader_from_image({size, size}, image, [](float a, float b) { return std::abs(a - b); });
+    auto tile_shape = tile_shape_from_memory_budget(budget);
+    size_t memory = 0;
+    size_t tile_memory = 0;
+
+    for (auto _ : state) {
+        memory = peak_memory_usage([&]() {
+            auto res = watershed_hierarchy_by_area_tiled({size, size}, reader, tile_shape);
+            benchmark::DoNotOptimize(res.altitudes(0));
+        });
+    }
+    tile_memory = peak_memory_usage([&]() {
+        std::vector<index_t> indices;
+        std::vector<float> weights;
+        tiled_hierarchy_internal::tile_spanning_edges<float>(reader, 0, 0, tile_shape[0], tile_shape[1], size, size,
+                                                            indices, weights);
+    });
+    state.counters["peak_bytes_per_pixel"] = (double) memory / (size * size);
+    state.counters["tile_bytes_per_pixel"] = (double) tile_memory / (tile_shape[0] * tile_shape[1]);
+}
+
+BENCHMARK(BM_watershed_hierarchy_by_area)->Arg(1024)->Arg(2048)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_watershed_hierarchy_by_area_tiled)->Args({1024, 4})->Args({1024, 64})->Args({2048, 4})->Args({2048, 64})
+        ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,221 @@
+/***************************************************************************
+* Copyright ESIEE Paris (2021)                                             *
+*                                                                          *
+* Contributor(s) : Benjamin Perret                                         *
+*                                                                          *
+* Distributed under the terms of the CECILL-B License.                     *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <benchmark/benchmark.h>
+#include "utils.h"
+
+#include "higra/accumulator/tree_accumulator.hpp"
+#include "xtensor/xrandom.hpp"
+#include "tbb/global_control.h"
+
+using namespace xt;
+using namespace hg;
+
+/*
+ * Complete binary trees with 2^16 to 2^24 leaves (same trees as benchmark_tree_iterator)
+ */
+static void tree_sizes_and_threads(benchmark::internal::Benchmark *b) {
+    for (index_t size = 1 << 16; size <= (1 << 24); size *= 16)
+        for (index_t num_threads = 1; num_threads <= 16; num_threads *= 2)
+            b->Args({size, num_threads});
+    b->Unit(benchmark::kMillisecond);
+    b->UseRealTime();
+}
+
+/*
+ * Arguments: number of leaves, maximal number of threads
+ * dim: number of columns of the node weights (1 for scalar weights)
+ */
+template<index_t dim>
+static void BM_tree_accumulate_parallel_sum(benchmark::State &state) {
+    tbb::global_control control(tbb::global_control::max_allowed_parallelism, state.range(1));
+    auto t = get_complete_binary_tree(state.range(0));
+    xt::random::seed(42);
+    array_nd<double> input = (dim == 1) ?
+                             array_nd<double>(random::rand<double>({num_vertices(t)})) :
+                             array_nd<double>(random::rand<double>({num_vertices(t), (size_t) dim}));
+    t.compute_children();
+
+    for (auto _ : state) {
+        auto res = accumulate_parallel(t, input, accumulator_sum());
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+
+template<index_t dim>
+static void BM_tree_accumulate_sequential_sum(benchmark::State &state) {
+    tbb::global_control control(tbb::global_control::max_allowed_parallelism, state.range(1));
+    auto t = get_complete_binary_tree(state.range(0));
+    xt::random::seed(42);
+    array_nd<double> input = (dim == 1) ?
+                             array_nd<double>(random::rand<double>({num_leaves(t)})) :
+                             array_nd<double>(random::rand<double>({num_leaves(t), (size_t) dim}));
+    t.compute_children();
+    t.height_schedule();
+
+    for (auto _ : state) {
+        auto res = accumulate_sequential(t, input, accumulator_sum());
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+
+template<index_t dim>
+static void BM_tree_propagate_parallel(benchmark::State &state) {
+    tbb::global_control control(tbb::global_control::max_allowed_parallelism, state.range(1));
+    auto t = get_complete_binary_tree(state.range(0));
+    xt::random::seed(42);
+    array_nd<double> input = (dim == 1) ?
+                             array_nd<double>(random::rand<double>({num_vertices(t)})) :
+                             array_nd<double>(random::rand<double>({num_vertices(t), (size_t) dim}));
+    array_1d<bool> condition = random::randint<int>({num_vertices(t)}, 0, 2);
+
+    for (auto _ : state) {
+        auto res = propagate_parallel(t, input, condition);
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+
+template<index_t dim>
+static void BM_tree_propagate_sequential(benchmark::State &state) {
+    tbb::global_control control(tbb::global_control::max_allowed_parallelism, state.range(1));
+    auto t = get_complete_binary_tree(state.range(0));
+    xt::random::seed(42);
+    array_nd<double> input = (dim == 1) ?
+                             array_nd<double>(random::rand<double>({num_vertices(t)})) :
+                             array_nd<double>(random::rand<double>({num_vertices(t), (size_t) dim}));
+    array_1d<bool> condition = random::randint<int>({num_vertices(t)}, 0, 2);
+    t.depth_schedule();
+
+    for (auto _ : state) {
+        auto res = propagate_sequential(t, input, condition);
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+
+/*
+ * Single threaded reference: the engines used before the level schedules
+ */
+static void BM_tree_accumulate_sequential_sum_reference(benchmark::State &state) {
+    auto t = get_complete_binary_tree(state.range(0));
+    xt::random::seed(42);
+    array_1d<double> input = random::rand<double>({num_leaves(t)});
+    t.compute_children();
+
+    for (auto _ : state) {
+        auto res = tree_accumulator_detail::accumulate_sequential_impl<false>(t, input, accumulator_sum());
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+
+static void BM_tree_propagate_sequential_reference(benchmark::State &state) {
+    auto t = get_complete_binary_tree(state.range(0));
+    xt::random::seed(42);
+    array_1d<double> input = random::rand<double>({num_vertices(t)});
+    array_1d<bool> condition = random::randint<int>({num_vertices(t)}, 0, 2);
+
+    for (auto _ : state) {
+        auto res = tree_accumulator_detail::propagate_sequential_impl<false>(t, input, condition);
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+
+/*
+ * Sum, min, max and mean of the children of each node: one pass per accumulator versus one fused pass with a
+ * composite accumulator. The counter tree_passes is the number of traversals of the tree and of the input.
+ *
+ * Argument: number of leaves
+ */
+static void BM_tree_accumulate_parallel_separate(benchmark::State &state) {
+    auto t = get_complete_binary_tree(state.range(0));
+    xt::random::seed(42);
+    array_1d<double> input = random::rand<double>({num_vertices(t)});
+    t.compute_children();
+
+    for (auto _ : state) {
+        auto sum = accumulate_parallel(t, input, accumulator_sum());
+        auto min = accumulate_parallel(t, input, accumulator_min());
+        auto max = accumulate_parallel(t, input, accumulator_max());
+        auto mean = accumulate_parallel(t, input, accumulator_mean());
+        benchmark::DoNotOptimize(sum.data());
+        benchmark::DoNotOptimize(min.data());
+        benchmark::DoNotOptimize(max.data());
+        benchmark::DoNotOptimize(mean.data());
+    }
+    state.counters["tree_passes"] = 4;
+}
+
+static void BM_tree_accumulate_parallel_fused(benchmark::State &state) {
+    auto t = get_complete_binary_tree(state.range(0));
+    xt::random::seed(42);
+    array_1d<double> input = random::rand<double>({num_vertices(t)});
+    t.compute_children();
+    auto composite = make_accumulator_composite(accumulator_sum(), accumulator_min(), accumulator_max(),
+                                                accumulator_mean());
+
+    for (auto _ : state) {
+        auto res = accumulate_parallel(t, input, composite);
+        benchmark::DoNotOptimize(res[0].data());
+    }
+    state.counters["tree_passes"] = 1;
+}
+
+static void BM_tree_accumulate_sequential_separate(benchmark::State &state) {
+    auto t = get_complete_binary_tree(state.range(0));
+    xt::random::seed(42);
+    array_1d<double> input = random::rand<double>({num_leaves(t)});
+    t.compute_children();
+
+    for (auto _ : state) {
+        auto sum = accumulate_sequential(t, input, accumulator_sum());
+        auto min = accumulate_sequential(t, input, accumulator_min());
+        auto max = accumulate_sequential(t, input, accumulator_max());
+        auto mean = accumulate_sequential(t, input, accumulator_mean());
+        benchmark::DoNotOptimize(sum.data());
+        benchmark::DoNotOptimize(min.data());
+        benchmark::DoNotOptimize(max.data());
+        benchmark::DoNotOptimize(mean.data());
+    }
+    state.counters["tree_passes"] = 4;
+}
+
+static void BM_tree_accumulate_sequential_fused(benchmark::State &state) {
+    auto t = get_complete_binary_tree(state.range(0));
+    xt::random::seed(42);
+    array_1d<double> input = random::rand<double>({num_leaves(t)});
+    t.compute_children();
+    auto composite = make_accumulator_composite(accumulator_sum(), accumulator_min(), accumulator_max(),
+                                                accumulator_mean());
+
+    for (auto _ : state) {
+        auto res = accumulate_sequential(t, input, composite);
+        benchmark::DoNotOptimize(res[0].data());
+    }
+    state.counters["tree_passes"] = 1;
+}
+
+BENCHMARK_TEMPLATE(BM_tree_accumulate_parallel_sum, 1)->Apply(tree_sizes_and_threads);
+BENCHMARK_TEMPLATE(BM_tree_accumulate_parallel_sum, 3)->Apply(tree_sizes_and_threads);
+BENCHMARK_TEMPLATE(BM_tree_accumulate_sequential_sum, 1)->Apply(tree_sizes_and_threads);
+BENCHMARK_TEMPLATE(BM_tree_accumulate_sequential_sum, 3)->Apply(tree_sizes_and_threads);
+BENCHMARK_TEMPLATE(BM_tree_propagate_parallel, 1)->Apply(tree_sizes_and_threads);
+BENCHMARK_TEMPLATE(BM_tree_propagate_sequential, 1)->Apply(tree_sizes_and_threads);
+BENCHMARK_TEMPLATE(BM_tree_propagate_sequential, 3)->Apply(tree_sizes_and_threads);
+BENCHMARK(BM_tree_accumulate_sequential_sum_reference)->RangeMultiplier(16)->Range(1 << 16, 1 << 24)
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_tree_propagate_sequential_reference)->RangeMultiplier(16)->Range(1 << 16, 1 << 24)
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_tree_accumulate_parallel_separate)->RangeMultiplier(16)->Range(1 << 16, 1 << 24)
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_tree_accumulate_parallel_fused)->RangeMultiplier(16)->Range(1 << 16, 1 << 24)
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_tree_accumulate_sequential_separate)->RangeMultiplier(16)->Range(1 << 16, 1 << 24)
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_tree_accumulate_sequential_fused)->RangeMultiplier(16)->Range(1 << 16, 1 << 24)
+        ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,65 @@
+/***************************************************************************
+* Copyright ESIEE Paris (2021)                                             *
+*                                                                          *
+* Contributor(s) : Benjamin Perret                                         *
+*                                                                          *
+* Distributed under the terms of the CECILL-B License.                     *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <benchmark/benchmark.h>
+#include "utils.h"
+
+#include "higra/graph.hpp"
+#include "xtensor/xrandom.hpp"
+
+using namespace xt;
+using namespace hg;
+
+/*
+ * Complete binary trees with about 1e6, 1e7, 1e8, and 1e9 nodes (argument: log2 of the number of leaves)
+ */
+static void tree_sizes(benchmark::internal::Benchmark *b) {
+    for (auto log_num_leaves: {19, 22, 26, 29})
+        b->Arg(log_num_leaves);
+    b->Unit(benchmark::kMillisecond);
+}
+
+/*
+ * Time and peak memory of the computation of the children relation
+ */
+static void BM_tree_compute_children(benchmark::State &state) {
+    auto t = get_complete_binary_tree((size_t) 1 << state.range(0));
+    size_t peak_memory = 0;
+    for (auto _ : state) {
+        t.clear_children();
+        peak_memory = peak_memory_usage([&t]() { t.compute_children(); });
+    }
+    state.counters["num_nodes"] = (double) num_vertices(t);
+    state.counters["peak_memory_MB"] = (double) peak_memory / (1 << 20);
+}
+
+BENCHMARK(BM_tree_compute_children)->Apply(tree_sizes);
+
+/*
+ * Traversal of the children of each node from the leaves to the root (children sum)
+ */
+static void BM_tree_children_traversal(benchmark::State &state) {
+    auto t = get_complete_binary_tree((size_t) 1 << state.range(0));
+    t.compute_children();
+    array_1d<double> input = xt::random::rand<double>({num_vertices(t)});
+    array_1d<double> output = xt::zeros<double>({num_vertices(t)});
+    for (auto _ : state) {
+        for (auto i: leaves_to_root_iterator(t, leaves_it::exclude)) {
+            double sum = 0;
+            for (auto c: children_iterator(i, t)) {
+                sum += input(c);
+            }
+            output(i) = sum;
+        }
+        benchmark::DoNotOptimize(output(root(t)));
+    }
+}
+
+BENCHMARK(BM_tree_children_traversal)->Apply(tree_sizes);
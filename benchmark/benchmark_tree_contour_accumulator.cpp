@@ -0,0 +1,106 @@
+/***************************************************************************
+* Copyright ESIEE Paris (2021)                                             *
+*                                                                          *
+* Contributor(s) : Benjamin Perret                                         *
+*                                                                          *
+* Distributed under the terms of the CECILL-B License.                     *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <benchmark/benchmark.h>
+#include "utils.h"
+
+#include "higra/accumulator/tree_contour_accumulator.hpp"
+#include "higra/attribute/tree_attribute.hpp"
+#include "higra/image/graph_image.hpp"
+#include "higra/hierarchy/hierarchy_core.hpp"
+#include "higra/hierarchy/watershed_hierarchy.hpp"
+#include "xtensor/xrandom.hpp"
+
+using namespace xt;
+using namespace hg;
+
+/*
+ * Worst case for the contours: the pixels of the image are merged one by one in a random order, the depth of the tree
+ * is the number of pixels and the contour of most edges of the 4 adjacency graph cross a large part of the tree.
+ */
+static hg::tree get_chain_tree(index_t num_leaves) {
+    xt::random::seed(42);
+    array_1d<index_t> order = xt::arange<index_t>(num_leaves);
+    xt::random::shuffle(order);
+    array_1d<index_t> parents = array_1d<index_t>::from_shape({(size_t) (2 * num_leaves - 1)});
+    parents(order(0)) = num_leaves;
+    for (index_t i = 1; i < num_leaves; i++) {
+        parents(order(i)) = num_leaves + i - 1;
+    }
+    for (index_t n = num_leaves; n < 2 * num_leaves - 1; n++) {
+        parents(n) = (n == 2 * num_leaves - 2) ? n : n + 1;
+    }
+    return hg::tree(std::move(parents));
+}
+
+enum class contour_tree_kind {
+    chain, bpt_canonical, watershed_by_area
+};
+
+static hg::tree get_contour_tree(contour_tree_kind kind, const ugraph &g) {
+    if (kind == contour_tree_kind::chain) {
+        return get_chain_tree(num_vertices(g));
+    }
+    xt::random::seed(42);
+    array_1d<double> edge_weights = xt::random::rand<double>({num_edges(g)});
+    if (kind == contour_tree_kind::bpt_canonical) {
+        return bpt_canonical(g, edge_weights).tree;
+    }
+    return watershed_hierarchy_by_area(g, edge_weights).tree;
+}
+
+/*
+ * Argument: size of the side of the image
+ * chain and bpt_canonical (on random edge weights) trees are deep, watershed_by_area trees are shallow
+ */
+template<contour_tree_kind kind>
+static void BM_accumulate_on_contours(benchmark::State &state) {
+    index_t size = state.range(0);
+    auto g = get_4_adjacency_graph({size, size});
+    auto t = get_contour_tree(kind, g);
+    auto depth = attribute_depth(t);
+    array_1d<double> node_weights = xt::random::rand<double>({num_vertices(t)});
+
+    for (auto _ : state) {
+        auto res = accumulate_on_contours(g, t, node_weights, depth, accumulator_max());
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+
+/*
+ * Reference: each contour is obtained by walking up the tree from both extremities of the edge
+ */
+template<contour_tree_kind kind>
+static void BM_accumulate_on_contours_reference(benchmark::State &state) {
+    index_t size = state.range(0);
+    auto g = get_4_adjacency_graph({size, size});
+    auto t = get_contour_tree(kind, g);
+    auto depth = attribute_depth(t);
+    array_1d<double> node_weights = xt::random::rand<double>({num_vertices(t)});
+
+    for (auto _ : state) {
+        auto res = tree_contour_accumulator_detail::accumulate_on_contours_impl<false>(g, t, node_weights, depth,
+                                                                                        accumulator_max());
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_accumulate_on_contours, contour_tree_kind::chain)->RangeMultiplier(4)->Range(64, 1024)
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_accumulate_on_contours_reference, contour_tree_kind::chain)->RangeMultiplier(4)->Range(64, 256)
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_accumulate_on_contours, contour_tree_kind::bpt_canonical)->RangeMultiplier(4)->Range(64, 1024)
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_accumulate_on_contours_reference, contour_tree_kind::bpt_canonical)->RangeMultiplier(4)
+        ->Range(64, 256)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_accumulate_on_contours, contour_tree_kind::watershed_by_area)->RangeMultiplier(4)
+        ->Range(64, 1024)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_accumulate_on_contours_reference, contour_tree_kind::watershed_by_area)->RangeMultiplier(4)
+        ->Range(64, 1024)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,97 @@
+/***************************************************************************
+* Copyright ESIEE Paris (2021)                                             *
+*                                                                          *
+* Contributor(s) : Benjamin Perret                                         *
+*                                                                          *
+* Distributed under the terms of the CECILL-B License.                     *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+
+#include <benchmark/benchmark.h>
+#include "utils.h"
+
+#include "higra/image/graph_image.hpp"
+#include "higra/hierarchy/watershed_hierarchy.hpp"
+#include "higra/io/tree_codec.hpp"
+#include "xtensor/xrandom.hpp"
+
+using namespace xt;
+using namespace hg;
+using namespace hg::tree_codec;
+
+/*
+ * Watershed hierarchy by area of a size x size image: random edge weights if noise_only is true, and gradient
+ * of a smooth image with some noise otherwise
+ */
+static tree watershed_tree(index_t size, bool noise_only) {
+    xt::random::seed(42);
+    auto g = get_4_adjacency_graph({size, size});
+    array_1d<double> weights;
+    if (noise_only) {
+        weights = xt::random::rand<double>({num_edges(g)});
+    } else {
+        auto x = xt::arange<double>(size * size);
+        array_1d<double> image = xt::sin(xt::floor(x / size) / 20) * xt::cos(x / 35) * 10 +
+                                 xt::random::rand<double>({(size_t) (size * size)});
+        weights = weight_graph(g, image, weight_functions::L1);
+    }
+    return watershed_hierarchy_by_area(g, weights).tree;
+}
+
+/*
+ * Compression ratio (with respect to the 32 bits parents of save_tree) and throughput (bytes of 32 bits parents
+ * per second) of the parents codec
+ * Arguments: size of the image side, noise only
+ */
+template<packing packing_method, entropy entropy_method>
+static void BM_tree_codec_compress(benchmark::State &state) {
+    auto t = watershed_tree(state.range(0), state.range(1) != 0);
+    codec_options options;
+    options.packing_method = packing_method;
+    options.entropy_method = entropy_method;
+    size_t compressed_size = 0;
+
+    for (auto _ : state) {
+        compressed_parents c(parents(t), options);
+        compressed_size = c.compressed_size();
+        benchmark::DoNotOptimize(compressed_size);
+    }
+    size_t raw_size = num_vertices(t) * sizeof(int32_t);
+    state.SetBytesProcessed(state.iterations() * raw_size);
+    state.counters["compression_ratio"] = (double) raw_size / compressed_size;
+}
+
+template<packing packing_method, entropy entropy_method>
+static void BM_tree_codec_decompress(benchmark::State &state) {
+    auto t = watershed_tree(state.range(0), state.range(1) != 0);
+    codec_options options;
+    options.packing_method = packing_method;
+    options.entropy_method = entropy_method;
+    compressed_parents c(parents(t), options);
+
+    for (auto _ : state) {
+        auto p = c.decompress();
+        benchmark::DoNotOptimize(p[0]);
+    }
+    size_t raw_size = num_vertices(t) * sizeof(int32_t);
+    state.SetBytesProcessed(state.iterations() * raw_size);
+    state.counters["compression_ratio"] = (double) raw_size / c.compressed_size();
+}
+
+static void image_sizes(benchmark::internal::Benchmark *b) {
+    for (index_t size = 512; size <= 2048; size *= 2)
+        for (index_t noise_only = 0; noise_only <= 1; noise_only++)
+            b->Args({size, noise_only});
+    b->Unit(benchmark::kMillisecond);
+}
+
+BENCHMARK_TEMPLATE(BM_tree_codec_compress, packing::varint, entropy::none)->Apply(image_sizes);
+BENCHMARK_TEMPLATE(BM_tree_codec_compress, packing::varint, entropy::rans)->Apply(image_sizes);
+BENCHMARK_TEMPLATE(BM_tree_codec_compress, packing::bitpack, entropy::none)->Apply(image_sizes);
+BENCHMARK_TEMPLATE(BM_tree_codec_compress, packing::bitpack, entropy::rans)->Apply(image_sizes);
+BENCHMARK_TEMPLATE(BM_tree_codec_decompress, packing::varint, entropy::none)->Apply(image_sizes);
+BENCHMARK_TEMPLATE(BM_tree_codec_decompress, packing::varint, entropy::rans)->Apply(image_sizes);
+BENCHMARK_TEMPLATE(BM_tree_codec_decompress, packing::bitpack, entropy::none)->Apply(image_sizes);
+BENCHMARK_TEMPLATE(BM_tree_codec_decompress, packing::bitpack, entropy::rans)->Apply(image_sizes);
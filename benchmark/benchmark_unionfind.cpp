@@ -0,0 +1,108 @@
+/***************************************************************************
+* Copyright ESIEE Paris (2021)                                             *
+*                                                                          *
+* Contributor(s) : Benjamin Perret                                         *
+*                                                                          *
+* Distributed under the terms of the CECILL-B License.                     *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <benchmark/benchmark.h>
+
+#include "higra/image/graph_image.hpp"
+#include "higra/hierarchy/hierarchy_core.hpp"
+#include "higra/structure/unionfind.hpp"
+#include "xtensor/xrandom.hpp"
+
+using namespace xt;
+using namespace hg;
+
+/*
+ * Kruskal like union sequence: edges of a 4 adjacency grid in random order
+ * Arguments: size of the grid side
+ */
+template<typename uf_t>
+static void BM_union_find_kruskal(benchmark::State &state) {
+    index_t size = state.range(0);
+    auto g = get_4_adjacency_graph({size, size});
+    xt::random::seed(42);
+    array_1d<index_t> order = xt::random::permutation<index_t>(num_edges(g));
+    auto s = sources(g);
+    auto t = targets(g);
+
+    for (auto _ : state) {
+        uf_t uf(num_vertices(g));
+        for (auto ei: order) {
+            auto c1 = uf.find(s(ei));
+            auto c2 = uf.find(t(ei));
+            if (c1 != c2) {
+                uf.link(c1, c2);
+            }
+        }
+        benchmark::DoNotOptimize(uf.find(0));
+    }
+}
+
+/*
+ * Same union sequence performed in parallel with concurrent_union_find::unite
+ */
+template<typename idx_t>
+static void BM_concurrent_union_find_parallel_unite(benchmark::State &state) {
+    index_t size = state.range(0);
+    auto g = get_4_adjacency_graph({size, size});
+    xt::random::seed(42);
+    array_1d<index_t> order = xt::random::permutation<index_t>(num_edges(g));
+    auto s = sources(g);
+    auto t = targets(g);
+
+    for (auto _ : state) {
+        concurrent_union_find<idx_t> uf(num_vertices(g));
+        parfor(0, (index_t) order.size(), [&uf, &order, &s, &t](index_t i) {
+            uf.unite(s(order(i)), t(order(i)));
+        });
+        benchmark::DoNotOptimize(uf.find(0));
+    }
+}
+
+/*
+ * Canonical binary partition tree of a random 4 adjacency grid
+ */
+template<typename uf_t>
+static void BM_bpt_canonical_union_find(benchmark::State &state) {
+    index_t size = state.range(0);
+    auto g = get_4_adjacency_graph({size, size});
+    xt::random::seed(42);
+    array_1d<double> weights = xt::random::rand<double>({num_edges(g)});
+
+    for (auto _ : state) {
+        auto res = bpt_canonical<uf_t>(g, weights);
+        benchmark::DoNotOptimize(res.altitudes.data());
+    }
+}
+
+static void grid_sizes(benchmark::internal::Benchmark *b) {
+    for (index_t size = 256; size <= 4096; size *= 4)
+        b->Arg(size);
+    b->Unit(benchmark::kMillisecond);
+}
+
+using namespace union_find_policy;
+
+#define HG_BENCHMARK_UNION_FINDS(bm) \
+    BENCHMARK_TEMPLATE(bm, union_find)->Apply(grid_sizes); \
+    BENCHMARK_TEMPLATE(bm, basic_union_find<index_t, path_halving>)->Apply(grid_sizes); \
+    BENCHMARK_TEMPLATE(bm, basic_union_find<index_t, path_splitting>)->Apply(grid_sizes); \
+    BENCHMARK_TEMPLATE(bm, basic_union_find<index_t, path_compression, interleaved_storage>)->Apply(grid_sizes); \
+    BENCHMARK_TEMPLATE(bm, basic_union_find<index_t, path_halving, interleaved_storage>)->Apply(grid_sizes); \
+    BENCHMARK_TEMPLATE(bm, basic_union_find<int32_t, path_halving, interleaved_storage>)->Apply(grid_sizes); \
+    BENCHMARK_TEMPLATE(bm, concurrent_union_find<index_t>)->Apply(grid_sizes); \
+    BENCHMARK_TEMPLATE(bm, concurrent_union_find<int32_t>)->Apply(grid_sizes);
+
+HG_BENCHMARK_UNION_FINDS(BM_union_find_kruskal)
+HG_BENCHMARK_UNION_FINDS(BM_bpt_canonical_union_find)
+
+#undef HG_BENCHMARK_UNION_FINDS
+
+BENCHMARK_TEMPLATE(BM_concurrent_union_find_parallel_unite, index_t)->Apply(grid_sizes);
+BENCHMARK_TEMPLATE(BM_concurrent_union_find_parallel_unite, int32_t)->Apply(grid_sizes);
@@ -0,0 +1,86 @@
+############################################################################
+# Copyright ESIEE Paris (2021)                                             #
+#                                                                          #
+# Contributor(s) : Benjamin Perret                                         #
+#                                                                          #
+# Distributed under the terms of the CECILL-B License.                     #
+#                                                                          #
+# The full license is in the file LICENSE, distributed with this software. #
+############################################################################
+
+"""
+Throughput of Higra hierarchy constructions called concurrently from a Python thread pool.
+
+Each task processes an independent random image: as the bindings release the global interpreter lock while the
+C++ kernels run, the throughput should scale almost linearly with the number of threads (up to the number of
+physical cores).
+
+Usage: python benchmark_multithreading.py [--size 512] [--images 32] [--max_threads 8]
+"""
+
+import argparse
+import concurrent.futures
+import os
+import time
+
+import numpy as np
+import higra as hg
+
+
+def bpt_canonical(graph, image):
+    edge_weights = hg.weight_graph(graph, image, hg.WeightFunction.L1)
+    return hg.bpt_canonical(graph, edge_weights)
+
+
+def watershed_hierarchy_by_area(graph, image):
+    edge_weights = hg.weight_graph(graph, image, hg.WeightFunction.L1)
+    return hg.watershed_hierarchy_by_area(graph, edge_weights)
+
+
+def component_tree_max_tree(graph, image):
+    return hg.component_tree_max_tree(graph, image)
+
+
+def run(function, graph, images, num_threads):
+    with concurrent.futures.ThreadPoolExecutor(max_workers=num_threads) as executor:
+        start = time.perf_counter()
+        for _ in executor.map(lambda image: function(graph, image), images):
+            pass
+        return time.perf_counter() - start
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--size", type=int, default=512, help="side of the square test images")
+    parser.add_argument("--images", type=int, default=32, help="number of independent images processed per run")
+    parser.add_argument("--max_threads", type=int, default=os.cpu_count(), help="largest thread pool size tested")
+    args = parser.parse_args()
+
+    # the benchmark measures inter-image parallelism: disable intra-kernel parallelism
+    hg.set_num_threads(1)
+
+    graph = hg.get_4_adjacency_graph((args.size, args.size))
+    np.random.seed(42)
+    images = [np.random.rand(args.size * args.size).astype(np.float32) for _ in range(args.images)]
+
+    thread_counts = []
+    t = 1
+    while t < args.max_threads:
+        thread_counts.append(t)
+        t *= 2
+    thread_counts.append(args.max_threads)
+
+    print("%-30s %8s %12s %12s %8s" % ("function", "threads", "time (s)", "images/s", "speedup"))
+    for function in (bpt_canonical, watershed_hierarchy_by_area, component_tree_max_tree):
+        run(function, graph, images[:1], 1)  # warm up
+        reference = None
+        for num_threads in thread_counts:
+            elapsed = run(function, graph, images, num_threads)
+            if reference is None:
+                reference = elapsed
+            print("%-30s %8d %12.3f %12.2f %8.2f" % (function.__name__, num_threads, elapsed,
+                                                     len(images) / elapsed, reference / elapsed))
+
+
+if __name__ == '__main__':
+    main()
@@ -9,6 +9,9 @@
 ****************************************************************************/
 
 #include "utils.h"
+#include <cstdint>
+#include <cstdlib>
+#include <new>
 
 using namespace hg;
 
@@ -25,4 +28,39 @@ hg::tree get_complete_binary_tree(std::size_t num_leaves) {
     }
     parent(parent.size() - 1) = parent.size() - 1;
     return tree(std::move(parent));
-}
\ No newline at end of file
+}
+
+/*
+ * Peak heap memory tracking: global operator new and delete are replaced to track the number of bytes currently
+ * allocated with the C++ allocator. Blocks are aligned on 64 bytes as the fixed size xtensor containers (points of
+ * regular graphs) may be over-aligned for the available SIMD instruction set.
+ */
+std::atomic<size_t> allocated_bytes(0);
+std::atomic<size_t> peak_allocated_bytes(0);
+static const size_t allocation_alignment = 64;
+static const size_t allocation_header_size = 2 * sizeof(void *);
+
+void *operator new(size_t size) {
+    void *base = std::malloc(size + allocation_header_size + allocation_alignment);
+    if (base == nullptr) {
+        throw std::bad_alloc();
+    }
+    auto address = reinterpret_cast<std::uintptr_t>(base) + allocation_header_size;
+    address = (address + allocation_alignment - 1) & ~(std::uintptr_t) (allocation_alignment - 1);
+    void **header = reinterpret_cast<void **>(address) - 2;
+    header[0] = reinterpret_cast<void *>(size);
+    header[1] = base;
+    auto current = allocated_bytes += size;
+    auto peak = peak_allocated_bytes.load();
+    while (current > peak && !peak_allocated_bytes.compare_exchange_weak(peak, current));
+    return reinterpret_cast<void *>(address);
+}
+
+void operator delete(void *ptr) noexcept {
+    if (ptr == nullptr) {
+        return;
+    }
+    void **header = static_cast<void **>(ptr) - 2;
+    allocated_bytes -= reinterpret_cast<size_t>(header[0]);
+    std::free(header[1]);
+}
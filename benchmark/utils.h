@@ -10,5 +10,20 @@
 
 #pragma once
 #include "higra/graph.hpp"
+#include <atomic>
 
 hg::tree get_complete_binary_tree(std::size_t num_leaves);
+
+extern std::atomic<size_t> allocated_bytes;
+extern std::atomic<size_t> peak_allocated_bytes;
+
+/*
+ * Returns the peak memory allocated by f in bytes (tracked by the global operator new defined in utils.cpp)
+ */
+template<typename F>
+size_t peak_memory_usage(const F &f) {
+    auto base = allocated_bytes.load();
+    peak_allocated_bytes = base;
+    f();
+    return peak_allocated_bytes - base;
+}
@@ -33,11 +33,14 @@ struct def_accumulate_parallel {
     void def(C &c, const char *doc) {
         c.def("_accumulate_parallel", [](const graph_t &tree, const pyarray<value_t> &input,
                                          hg::accumulators accumulator) {
-                  return dispatch_accumulator(
-                          [&tree, &input](const auto &acc) {
-                              return hg::accumulate_parallel(tree, input, acc);
-                          },
-                          accumulator);
+                  prepare_tree_without_gil(tree);
+                  return call_without_gil([&]() {
+                      return dispatch_accumulator(
+                              [&tree, &input](const auto &acc) {
+                                  return hg::accumulate_parallel(tree, input, acc);
+                              },
+                              accumulator);
+                  });
               },
               doc,
               py::arg("tree"),
@@ -53,11 +56,14 @@ struct def_accumulate_sequential {
     void def(C &c, const char *doc) {
         c.def("_accumulate_sequential",
               [](const graph_t &tree, const pyarray<value_t> &vertex_data, hg::accumulators accumulator) {
-                  return dispatch_accumulator(
-                          [&tree, &vertex_data](const auto &acc) {
-                              return hg::accumulate_sequential(tree, vertex_data, acc);
-                          },
-                          accumulator);
+                  prepare_tree_without_gil(tree);
+                  return call_without_gil([&]() {
+                      return dispatch_accumulator(
+                              [&tree, &vertex_data](const auto &acc) {
+                                  return hg::accumulate_sequential(tree, vertex_data, acc);
+                              },
+                              accumulator);
+                  });
               },
               doc,
               py::arg("tree"),
@@ -66,6 +72,75 @@ struct def_accumulate_sequential {
     }
 };
 
+/**
+ * Composite of all the accumulators of the enumeration hg::accumulators where only the requested ones are enabled.
+ * Returns the index of each requested accumulator in the composite (the composite follows the order of the
+ * enumeration).
+ *
+ * A single composite is instantiated per value type instead of one per combination of accumulators (there are
+ * 2^10 of them): disabled accumulators are not allocated and are removed from the evaluation loop once before
+ * the traversal, each node then costs one indirect call per requested accumulator.
+ */
+auto make_fused_accumulator(const std::vector<hg::accumulators> &accumulators) {
+    auto composite = hg::make_accumulator_composite(hg::accumulator_first(), hg::accumulator_last(),
+                                                    hg::accumulator_mean(), hg::accumulator_min(),
+                                                    hg::accumulator_max(), hg::accumulator_counter(),
+                                                    hg::accumulator_sum(), hg::accumulator_prod(),
+                                                    hg::accumulator_argmin(), hg::accumulator_argmax());
+    for (std::size_t k = 0; k < decltype(composite)::size; k++) {
+        composite.set_enabled(k, false);
+    }
+    std::vector<std::size_t> positions;
+    for (auto accumulator: accumulators) {
+        auto k = static_cast<std::size_t>(accumulator);
+        composite.set_enabled(k, true);
+        positions.push_back(k);
+    }
+    return std::make_pair(composite, positions);
+}
+
+template<typename outputs_t>
+py::tuple fused_outputs_to_tuple(outputs_t &outputs, const std::vector<std::size_t> &positions) {
+    py::tuple result(positions.size());
+    for (std::size_t i = 0; i < positions.size(); i++) {
+        result[i] = py::cast(outputs[positions[i]]);
+    }
+    return result;
+}
+
+template<typename graph_t>
+struct def_accumulate_fused {
+    template<typename value_t, typename C>
+    static
+    void def(C &c, const char *doc) {
+        c.def("_accumulate_parallel_fused", [](const graph_t &tree, const pyarray<value_t> &input,
+                                               const std::vector<hg::accumulators> &accumulators) {
+                  auto composite = make_fused_accumulator(accumulators);
+                  prepare_tree_without_gil(tree);
+                  auto outputs = call_without_gil([&]() {
+                      return hg::accumulate_parallel(tree, input, composite.first);
+                  });
+                  return fused_outputs_to_tuple(outputs, composite.second);
+              },
+              doc,
+              py::arg("tree"),
+              py::arg("input"),
+              py::arg("accumulators"));
+        c.def("_accumulate_sequential_fused", [](const graph_t &tree, const pyarray<value_t> &vertex_data,
+                                                 const std::vector<hg::accumulators> &accumulators) {
+                  auto composite = make_fused_accumulator(accumulators);
+                  prepare_tree_without_gil(tree);
+                  auto outputs = call_without_gil([&]() {
+                      return hg::accumulate_sequential(tree, vertex_data, composite.first);
+                  });
+                  return fused_outputs_to_tuple(outputs, composite.second);
+              },
+              doc,
+              py::arg("tree"),
+              py::arg("leaf_data"),
+              py::arg("accumulators"));
+    }
+};
 
 struct functorMax {
     template<typename T1, typename T2>
@@ -104,11 +179,14 @@ struct def_accumulate_and_combine_sequential {
         c.def(name,
               [&f](const graph_t &tree, const pyarray<value_t> &input, const pyarray<value_t> &vertex_data,
                    hg::accumulators accumulator) {
-                  return dispatch_accumulator(
-                          [&tree, &input, &vertex_data, &f](const auto &acc) {
-                              return hg::accumulate_and_combine_sequential(tree, input, vertex_data, acc, f);
-                          },
-                          accumulator);
+                  prepare_tree_without_gil(tree);
+                  return call_without_gil([&]() {
+                      return dispatch_accumulator(
+                              [&tree, &input, &vertex_data, &f](const auto &acc) {
+                                  return hg::accumulate_and_combine_sequential(tree, input, vertex_data, acc, f);
+                              },
+                              accumulator);
+                  });
               },
               doc,
               py::arg("tree"),
@@ -127,7 +205,8 @@ struct def_propagate_sequential {
         c.def("_propagate_sequential",
               [](const graph_t &tree, const pyarray<value_t> &input,
                  const pyarray<bool> &condition) {
-                  return hg::propagate_sequential(tree, input, condition);
+                  prepare_tree_without_gil(tree);
+                  return call_without_gil([&]() { return hg::propagate_sequential(tree, input, condition); });
               },
               doc,
               py::arg("tree"),
@@ -144,11 +223,14 @@ struct def_propagate_parallel {
         c.def("_propagate_parallel",
               [](const graph_t &tree, const pyarray<value_t> &input,
                  const pyarray<bool> &condition) {
-                  if (condition.dimension() == 0) {
-                      return hg::propagate_parallel(tree, input);
-                  } else {
-                      return hg::propagate_parallel(tree, input, condition);
-                  }
+                  prepare_tree_without_gil(tree);
+                  return call_without_gil([&]() {
+                      if (condition.dimension() == 0) {
+                          return hg::propagate_parallel(tree, input);
+                      } else {
+                          return hg::propagate_parallel(tree, input, condition);
+                      }
+                  });
               },
               doc,
               py::arg("tree"),
@@ -165,11 +247,14 @@ struct def_propagate_sequential_and_accumulate {
     void def(C &c, const char *doc) {
         c.def("_propagate_sequential_and_accumulate",
               [](const graph_t &tree, const pyarray<value_t> &vertex_data, hg::accumulators accumulator) {
-                  return dispatch_accumulator(
-                          [&tree, &vertex_data](const auto &acc) {
-                              return hg::propagate_sequential_and_accumulate(tree, vertex_data, acc);
-                          },
-                          accumulator);
+                  prepare_tree_without_gil(tree);
+                  return call_without_gil([&]() {
+                      return dispatch_accumulator(
+                              [&tree, &vertex_data](const auto &acc) {
+                                  return hg::propagate_sequential_and_accumulate(tree, vertex_data, acc);
+                              },
+                              accumulator);
+                  });
               },
               doc,
               py::arg("tree"),
@@ -178,11 +263,14 @@ struct def_propagate_sequential_and_accumulate {
 
         c.def("_propagate_sequential_and_accumulate",
               [](const graph_t &tree, const pyarray<value_t> &vertex_data, hg::accumulators accumulator, const pyarray<bool> &condition) {
-                  return dispatch_accumulator(
-                          [&tree, &vertex_data, &condition](const auto &acc) {
-                              return hg::propagate_sequential_and_accumulate(tree, vertex_data, acc, condition);
-                          },
-                          accumulator);
+                  prepare_tree_without_gil(tree);
+                  return call_without_gil([&]() {
+                      return dispatch_accumulator(
+                              [&tree, &vertex_data, &condition](const auto &acc) {
+                                  return hg::propagate_sequential_and_accumulate(tree, vertex_data, acc, condition);
+                              },
+                              accumulator);
+                  });
               },
               doc,
               py::arg("tree"),
@@ -202,6 +290,10 @@ void py_init_tree_accumulator(pybind11::module &m) {
             (m,
              "");
 
+    add_type_overloads<def_accumulate_fused<graph_t>, HG_TEMPLATE_NUMERIC_TYPES>
+            (m,
+             "");
+
     add_type_overloads<def_accumulate_and_combine_sequential<graph_t>, HG_TEMPLATE_NUMERIC_TYPES>
             (m,
              "",
@@ -17,11 +17,17 @@ def accumulate_parallel(tree, node_weights, accumulator):
     Accumulates values of the children of every node :math:`i` in the :math:`node\_weights` array and puts the result
     in output: :math:`output(i) = accumulator(node\_weights(children(i)))`
 
+    If :attr:`accumulator` is a list of accumulators, all of them are evaluated in a single traversal of the tree
+    and a tuple holding the result of each accumulator is returned. Each requested accumulator costs one
+    indirect call per node on top of its own evaluation, accumulators that are not requested cost nothing.
+
     :param tree: input tree
     :param node_weights: Weights on the nodes of the tree
-    :param accumulator: see :class:`~higra.Accumulators`
-    :return: returns new tree node weights
+    :param accumulator: see :class:`~higra.Accumulators`, or a list of :class:`~higra.Accumulators`
+    :return: returns new tree node weights (a tuple of new tree node weights if :attr:`accumulator` is a list)
     """
+    if isinstance(accumulator, (list, tuple)):
+        return hg.cpp._accumulate_parallel_fused(tree, node_weights, accumulator)
     res = hg.cpp._accumulate_parallel(tree, node_weights, accumulator)
     return res
 
@@ -33,14 +39,20 @@ def accumulate_sequential(tree, leaf_data, accumulator, leaf_graph=None):
     For each leaf node :math:`i`, :math:`output(i) = leaf_data(i)`.
     For each node :math:`i` from the leaves (excluded) to the root, :math:`output(i) = accumulator(output(children(i)))`
 
+    If :attr:`accumulator` is a list of accumulators, all of them are evaluated in a single traversal of the tree
+    and a tuple holding the result of each accumulator is returned. Each requested accumulator costs one
+    indirect call per node on top of its own evaluation, accumulators that are not requested cost nothing.
+
     :param tree: input tree (Concept :class:`~higra.CptHierarchy`)
     :param leaf_data: array of weights on the leaves of the tree
-    :param accumulator: see :class:`~higra.Accumulators`
+    :param accumulator: see :class:`~higra.Accumulators`, or a list of :class:`~higra.Accumulators`
     :param leaf_graph: graph of the tree leaves (optional, deduced from :class:`~higra.CptHierarchy`)
-    :return: returns new tree node weights
+    :return: returns new tree node weights (a tuple of new tree node weights if :attr:`accumulator` is a list)
     """
     if leaf_graph is not None:
         leaf_data = hg.linearize_vertex_weights(leaf_data, leaf_graph)
+    if isinstance(accumulator, (list, tuple)):
+        return hg.cpp._accumulate_sequential_fused(tree, leaf_data, accumulator)
     res = hg.cpp._accumulate_sequential(tree, leaf_data, accumulator)
     return res
 
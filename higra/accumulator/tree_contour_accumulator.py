@@ -33,6 +33,10 @@ def accumulate_on_contours(tree, node_weights, accumulator, leaf_graph):
     :math:`k` the maximal depth of the tree (i.e. the number of edges on the longest downward path between
     the root and a leaf).
 
+    With the accumulators :attr:`~higra.Accumulators.sum`, :attr:`~higra.Accumulators.min`,
+    :attr:`~higra.Accumulators.max`, and :attr:`~higra.Accumulators.prod`, deep trees are handled with a heavy-light
+    decomposition of the tree in :math:`\mathcal{O}(m + n*\log(m))` with :math:`m` the number of nodes of the tree.
+
     :param tree: input tree (Concept :class:`~higra.CptHierarchy`)
     :param node_weights: weights on the nodes of the tree
     :param accumulator: see :class:`~higra.Accumulators`
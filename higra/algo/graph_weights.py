@@ -16,6 +16,11 @@ def weight_graph(graph, vertex_weights, weight_function):
     Compute the edge weights of a graph using source and target vertices values
     and specified weighting function (see :class:`~higra.WeightFunction` enumeration).
 
+    If the graph is an implicit regular graph (see :class:`~higra.RegularGraph2d` for example), the result is given
+    in the edge order of its explicit counterpart (see :func:`~higra.RegularGraph2d.as_explicit_graph`); for example
+    the edges of :func:`~higra.get_4_adjacency_implicit_graph` are weighted in the order of the edges of
+    :func:`~higra.get_4_adjacency_graph`. Regular graphs are processed row by row with vectorized kernels.
+
     :param graph: input graph
     :param vertex_weights: vertex weights of the input graph
     :param weight_function: see :class:`~higra.WeightFunction`
@@ -29,7 +29,7 @@ struct def_weight_graph {
     static
     void def(C &m, const char *doc) {
         m.def("_weight_graph", [](const graph_t &graph, const pyarray<type> &data, hg::weight_functions weight_f) {
-                  return hg::weight_graph(graph, data, weight_f);
+                  return call_without_gil([&]() { return hg::weight_graph(graph, data, weight_f); });
               },
               doc,
               py::arg("explicit_graph"),
@@ -38,6 +38,16 @@ struct def_weight_graph {
     }
 };
 
+template<int dim>
+void py_init_weight_regular_graph(pybind11::module &m) {
+    add_type_overloads<def_weight_graph<hg::regular_graph<hg::embedding_grid<dim>>>, HG_TEMPLATE_NUMERIC_TYPES>
+            (m,
+             "Compute the edge weights of a regular graph using source and target vertices values"
+             " and specified weighting function (see WeightFunction enumeration), in the edge order of"
+             " the equivalent explicit graph."
+            );
+}
+
 void py_init_graph_weights(pybind11::module &m) {
     xt::import_numpy();
 
@@ -66,5 +76,11 @@ void py_init_graph_weights(pybind11::module &m) {
              " and specified weighting function (see WeightFunction enumeration)."
             );
 
+    py_init_weight_regular_graph<1>(m);
+    py_init_weight_regular_graph<2>(m);
+    py_init_weight_regular_graph<3>(m);
+    py_init_weight_regular_graph<4>(m);
+    py_init_weight_regular_graph<5>(m);
+
 }
 
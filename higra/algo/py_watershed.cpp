@@ -26,7 +26,7 @@ struct def_labelisation_watershed {
     static
     void def(C &c, const char *doc) {
         c.def("_labelisation_watershed", [](const graph_t &graph, const pyarray<value_t> &edge_weights) {
-                  return hg::labelisation_watershed(graph, edge_weights);
+                  return call_without_gil([&]() { return hg::labelisation_watershed(graph, edge_weights); });
               },
               doc,
               py::arg("graph"),
@@ -44,7 +44,9 @@ struct def_labelisation_seeded_watershed {
                         const pyarray<value_t> &edge_weights,
                         const pyarray<hg::index_t> & vertex_seeds,
                         const hg::index_t background_label) {
-                  return hg::labelisation_seeded_watershed(graph, edge_weights, vertex_seeds, background_label);
+                  return call_without_gil([&]() {
+                      return hg::labelisation_seeded_watershed(graph, edge_weights, vertex_seeds, background_label);
+                  });
               },
               doc,
               py::arg("graph"),
@@ -28,12 +28,15 @@ struct def_contour_length_component_tree {
                  const hg::ugraph &graph,
                  const pyarray<T> &vertex_perimeter,
                  const pyarray<T> &edge_length) {
-                  return hg::attribute_contour_length_component_tree(
-                          tree,
-                          graph,
-                          vertex_perimeter,
-                          edge_length
-                  );
+                  prepare_tree_without_gil(tree);
+                  return call_without_gil([&]() {
+                      return hg::attribute_contour_length_component_tree(
+                              tree,
+                              graph,
+                              vertex_perimeter,
+                              edge_length
+                      );
+                  });
               },
               doc,
               py::arg("tree"),
@@ -50,10 +53,12 @@ struct def_attribute_extrema {
         m.def("_attribute_extrema",
               [](const hg::tree &tree,
                  const pyarray<T> &altitudes) {
-                  return hg::attribute_extrema(
-                          tree,
-                          altitudes
-                  );
+                  return call_without_gil([&]() {
+                      return hg::attribute_extrema(
+                              tree,
+                              altitudes
+                      );
+                  });
               },
               doc,
               py::arg("tree"),
@@ -69,11 +74,14 @@ struct def_attribute_height {
               [](const hg::tree &tree,
                  const pyarray<T> &altitudes,
                  bool increasing_altitudes) {
-                  return hg::attribute_height(
-                          tree,
-                          altitudes,
-                          increasing_altitudes
-                  );
+                  prepare_tree_without_gil(tree);
+                  return call_without_gil([&]() {
+                      return hg::attribute_height(
+                              tree,
+                              altitudes,
+                              increasing_altitudes
+                      );
+                  });
               },
               doc,
               py::arg("tree"),
@@ -91,12 +99,15 @@ struct def_attribute_extinction_value {
                  const pyarray<T> &altitudes,
                  const pyarray<T> &attribute,
                  bool increasing_altitudes) {
-                  return hg::attribute_extinction_value(
-                          tree,
-                          altitudes,
-                          attribute,
-                          increasing_altitudes
-                  );
+                  prepare_tree_without_gil(tree);
+                  return call_without_gil([&]() {
+                      return hg::attribute_extinction_value(
+                              tree,
+                              altitudes,
+                              attribute,
+                              increasing_altitudes
+                      );
+                  });
               },
               doc,
               py::arg("tree"),
@@ -113,10 +124,13 @@ struct def_attribute_children_pair_sum_product {
         m.def("_attribute_children_pair_sum_product",
               [](const hg::tree &tree,
                  const pyarray<T> &node_weights) {
-                  return hg::attribute_children_pair_sum_product(
-                          tree,
-                          node_weights
-                  );
+                  prepare_tree_without_gil(tree);
+                  return call_without_gil([&]() {
+                      return hg::attribute_children_pair_sum_product(
+                              tree,
+                              node_weights
+                      );
+                  });
               },
               doc,
               py::arg("tree"),
@@ -128,7 +142,8 @@ void py_init_attributes(pybind11::module &m) {
     xt::import_numpy();
     m.def("_attribute_sibling",
           [](const hg::tree &tree, hg::index_t skip) {
-              return hg::attribute_sibling(tree, skip);
+              prepare_tree_without_gil(tree);
+              return call_without_gil([&]() { return hg::attribute_sibling(tree, skip); });
           },
           "",
           pybind11::arg("tree"),
@@ -136,14 +151,15 @@ void py_init_attributes(pybind11::module &m) {
 
     m.def("_attribute_depth",
           [](const hg::tree &tree) {
-              return hg::attribute_depth(tree);
+              return call_without_gil([&]() { return hg::attribute_depth(tree); });
           },
           "",
           pybind11::arg("tree"));
 
     m.def("_attribute_child_number",
           [](const hg::tree &tree) {
-              return hg::attribute_child_number(tree);
+              prepare_tree_without_gil(tree);
+              return call_without_gil([&]() { return hg::attribute_child_number(tree); });
           },
           "",
           pybind11::arg("tree"));
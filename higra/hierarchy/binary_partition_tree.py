@@ -12,7 +12,7 @@ import higra as hg
 import numpy as np
 
 
-def binary_partition_tree_complete_linkage(graph, edge_weights):
+def binary_partition_tree_complete_linkage(graph, edge_weights, heap_policy=hg.BptHeapPolicy.fibonacci):
     """
     Binary partition tree with complete linkage distance.
 
@@ -27,17 +27,22 @@ def binary_partition_tree_complete_linkage(graph, edge_weights):
 
     :param graph: input graph
     :param edge_weights: edge weights of the input graph
+    :param heap_policy: heap used to order the edges, see :class:`~higra.BptHeapPolicy` (default:
+           ``hg.BptHeapPolicy.fibonacci``). With the other heaps, which are faster, ties between edges of equal
+           weights are broken with the edge indices and the result may differ from the default one.
+           ``hg.BptHeapPolicy.nn_chain`` uses the nearest-neighbor chain algorithm instead of a heap.
     :return: a tree (Concept :class:`~higra.CptHierarchy`) and its node altitudes
     """
 
-    tree, altitudes = hg.cpp._binary_partition_tree_complete_linkage(graph, edge_weights)
+    tree, altitudes = hg.cpp._binary_partition_tree_complete_linkage(graph, edge_weights, heap_policy)
 
     hg.CptHierarchy.link(tree, graph)
 
     return tree, altitudes
 
 
-def binary_partition_tree_average_linkage(graph, edge_weights, edge_weight_weights=None):
+def binary_partition_tree_average_linkage(graph, edge_weights, edge_weight_weights=None,
+                                          heap_policy=hg.BptHeapPolicy.fibonacci):
     """
     Binary partition tree with average linkage distance.
 
@@ -53,6 +58,10 @@ def binary_partition_tree_average_linkage(graph, edge_weights, edge_weight_weigh
     :param graph: input graph
     :param edge_weights: edge weights of the input graph
     :param edge_weight_weights: weighting of edge weights of the input graph (default to an array of ones)
+    :param heap_policy: heap used to order the edges, see :class:`~higra.BptHeapPolicy` (default:
+           ``hg.BptHeapPolicy.fibonacci``). With the other heaps, which are faster, ties between edges of equal
+           weights are broken with the edge indices and the result may differ from the default one.
+           ``hg.BptHeapPolicy.nn_chain`` uses the nearest-neighbor chain algorithm instead of a heap.
     :return: a tree (Concept :class:`~higra.CptHierarchy`) and its node altitudes
     """
 
@@ -61,14 +70,16 @@ def binary_partition_tree_average_linkage(graph, edge_weights, edge_weight_weigh
     else:
         edge_weights, edge_weight_weights = hg.cast_to_common_type(edge_weights, edge_weight_weights)
 
-    tree, altitudes = hg.cpp._binary_partition_tree_average_linkage(graph, edge_weights, edge_weight_weights)
+    tree, altitudes = hg.cpp._binary_partition_tree_average_linkage(graph, edge_weights, edge_weight_weights,
+                                                                    heap_policy)
 
     hg.CptHierarchy.link(tree, graph)
 
     return tree, altitudes
 
 
-def binary_partition_tree_exponential_linkage(graph, edge_weights, alpha, edge_weight_weights=None):
+def binary_partition_tree_exponential_linkage(graph, edge_weights, alpha, edge_weight_weights=None,
+                                              heap_policy=hg.BptHeapPolicy.fibonacci):
     """
     Binary partition tree with exponential linkage distance.
 
@@ -91,6 +102,10 @@ def binary_partition_tree_exponential_linkage(graph, edge_weights, alpha, edge_w
     :param edge_weights: edge weights of the input graph
     :param alpha: exponential parameter
     :param edge_weight_weights: weighting of edge weights of the input graph (default to an array of ones)
+    :param heap_policy: heap used to order the edges, see :class:`~higra.BptHeapPolicy` (default:
+           ``hg.BptHeapPolicy.fibonacci``). With the other heaps, which are faster, ties between edges of equal
+           weights are broken with the edge indices and the result may differ from the default one.
+           ``hg.BptHeapPolicy.nn_chain`` uses the nearest-neighbor chain algorithm instead of a heap.
     :return: a tree (Concept :class:`~higra.CptHierarchy`) and its node altitudes
     """
 
@@ -103,13 +118,15 @@ def binary_partition_tree_exponential_linkage(graph, edge_weights, alpha, edge_w
 
     # special cases: improve efficiency and avoid numerical issues
     if alpha == 0:
-        tree, altitudes = hg.binary_partition_tree_average_linkage(graph, edge_weights, edge_weight_weights)
+        tree, altitudes = hg.binary_partition_tree_average_linkage(graph, edge_weights, edge_weight_weights,
+                                                                   heap_policy)
     elif alpha == float('-inf'):
         tree, altitudes = hg.binary_partition_tree_single_linkage(graph, edge_weights)
     elif alpha == float('inf'):
-        tree, altitudes = hg.binary_partition_tree_complete_linkage(graph, edge_weights)
+        tree, altitudes = hg.binary_partition_tree_complete_linkage(graph, edge_weights, heap_policy)
     else:
-        tree, altitudes = hg.cpp._binary_partition_tree_exponential_linkage(graph, edge_weights, alpha, edge_weight_weights)
+        tree, altitudes = hg.cpp._binary_partition_tree_exponential_linkage(graph, edge_weights, alpha, edge_weight_weights,
+                                                                            heap_policy)
 
     hg.CptHierarchy.link(tree, graph)
 
@@ -137,7 +154,8 @@ def binary_partition_tree_single_linkage(graph, edge_weights):
     return hg.bpt_canonical(graph, edge_weights)
 
 
-def binary_partition_tree_ward_linkage(graph, vertex_centroids, vertex_sizes=None, altitude_correction="max"):
+def binary_partition_tree_ward_linkage(graph, vertex_centroids, vertex_sizes=None, altitude_correction="max",
+                                       heap_policy=hg.BptHeapPolicy.fibonacci):
     """
     Binary partition tree with the Ward linkage rule.
 
@@ -164,6 +182,11 @@ def binary_partition_tree_ward_linkage(graph, vertex_centroids, vertex_sizes=Non
     :param vertex_centroids: Centroids of the graph vertices (must be a 2d array)
     :param vertex_sizes: Size (number of elements) of the graph vertices (default to an array of ones)
     :param altitude_correction: can be ``"none"`` or ``"max"`` (default)
+    :param heap_policy: heap used to order the edges, see :class:`~higra.BptHeapPolicy` (default:
+           ``hg.BptHeapPolicy.fibonacci``). With the other heaps, which are faster, ties between edges of equal
+           weights are broken with the edge indices and the result may differ from the default one.
+           ``hg.BptHeapPolicy.nn_chain`` uses the nearest-neighbor chain algorithm instead of a heap: it gives the
+           same tree only if the graph is complete.
     :return: a tree (Concept :class:`~higra.CptHierarchy`) and its node altitudes
     """
 
@@ -172,14 +195,15 @@ def binary_partition_tree_ward_linkage(graph, vertex_centroids, vertex_sizes=Non
     else:
         vertex_centroids, vertex_sizes = hg.cast_to_common_type(vertex_centroids, vertex_sizes)
 
-    tree, altitudes = hg.cpp._binary_partition_tree_ward_linkage(graph, vertex_centroids, vertex_sizes, altitude_correction)
+    tree, altitudes = hg.cpp._binary_partition_tree_ward_linkage(graph, vertex_centroids, vertex_sizes, altitude_correction,
+                                                                 heap_policy)
 
     hg.CptHierarchy.link(tree, graph)
 
     return tree, altitudes
 
 
-def binary_partition_tree(graph, weight_function, edge_weights):
+def binary_partition_tree(graph, weight_function, edge_weights, heap_policy=hg.BptHeapPolicy.fibonacci):
     """
     Binary partition tree of the graph with a user provided cluster distance.
 
@@ -286,9 +310,13 @@ def binary_partition_tree(graph, weight_function, edge_weights):
     :param graph: input graph
     :param weight_function: see detailed description above
     :param edge_weights: edge weights of the input graph
+    :param heap_policy: heap used to order the edges, see :class:`~higra.BptHeapPolicy` (default:
+           ``hg.BptHeapPolicy.fibonacci``). With the other heaps, which are faster, ties between edges of equal
+           weights are broken with the edge indices and the result may differ from the default one.
+           ``hg.BptHeapPolicy.nn_chain`` is not supported as the custom linkage may not be reducible.
     :return: a tree (Concept :class:`~higra.CptHierarchy`) and its node altitudes
     """
-    tree, altitudes = hg.cpp._binary_partition_tree(graph, edge_weights, weight_function)
+    tree, altitudes = hg.cpp._binary_partition_tree(graph, edge_weights, weight_function, heap_policy)
 
     hg.CptHierarchy.link(tree, graph)
 
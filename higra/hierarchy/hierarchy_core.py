@@ -12,7 +12,8 @@ import higra as hg
 import numpy as np
 
 
-def bpt_canonical(graph, edge_weights=None, sorted_edge_indices=None, return_altitudes=True, compute_mst=True):
+def bpt_canonical(graph, edge_weights=None, sorted_edge_indices=None, return_altitudes=True, compute_mst=True,
+                  algorithm=hg.BptCanonicalAlgorithm.kruskal):
     """
     Computes the *canonical binary partition tree*, also called *binary partition tree by altitude ordering* or
     *connectivity constrained single min/linkage clustering* of the given graph.
@@ -121,6 +122,11 @@ def bpt_canonical(graph, edge_weights=None, sorted_edge_indices=None, return_alt
     Otherwise, the computation time is dominated by the sorting of the edge weights which is performed in linearithmic
     :math:`\mathcal{O}(n \log(n))` time.
 
+    The sorted edges are processed either sequentially (``hg.BptCanonicalAlgorithm.kruskal``) or with a
+    filter-Kruskal strategy (``hg.BptCanonicalAlgorithm.filter_kruskal``) which removes, in parallel, the edges
+    whose extremities are already connected after each block of edges. Both algorithms produce the same result; the
+    second one is only beneficial if Higra was compiled with Intel TBB support.
+
     :param graph: input graph or triplet of two arrays and an integer (sources, targets, num_vertices)
            defining all the edges of the graph and its number of vertices.
     :param edge_weights: edge weights of the input graph (may be omitted if :attr:`sorted_edge_indices` is given).
@@ -131,6 +137,8 @@ def bpt_canonical(graph, edge_weights=None, sorted_edge_indices=None, return_alt
     :param compute_mst: if ``True`` and if the input is a graph object computes an explicit undirected graph
            representing the minimum spanning tree associated to the hierarchy, accessible through the
            :class:`~higra.CptBinaryHierarchy` Concept (e.g. with ``tree.mst``). (default: ``True``).
+    :param algorithm: algorithm used to process the sorted edges, see :class:`~higra.BptCanonicalAlgorithm`
+           (default: ``hg.BptCanonicalAlgorithm.kruskal``).
     :return: a tree (Concept :class:`~higra.CptBinaryHierarchy` if the input is a graph object),
              and, if :attr:`return_altitudes` is ``True``, its node altitudes
     """
@@ -157,7 +165,7 @@ def bpt_canonical(graph, edge_weights=None, sorted_edge_indices=None, return_alt
         except Exception as e:
             raise ValueError("Invalid graph input.") from e
 
-    parents, mst_edge_map = hg.cpp._bpt_canonical(sources, targets, sorted_edge_indices, num_vertices)
+    parents, mst_edge_map = hg.cpp._bpt_canonical(sources, targets, sorted_edge_indices, num_vertices, algorithm)
     tree = hg.Tree(parents)
 
     if return_altitudes:
@@ -196,6 +204,144 @@ def bpt_canonical(graph, edge_weights=None, sorted_edge_indices=None, return_alt
         return tree, altitudes
 
 
+def bpt_canonical_batch(sources, targets, edge_weights, edge_offsets, vertex_offsets):
+    """
+    Computes the canonical binary partition trees of a batch of edge weighted graphs (see :func:`~higra.bpt_canonical`).
+
+    This function is designed to process efficiently a large number of small graphs: all the trees are
+    built in a single call, in parallel, and they are returned as flat arrays instead of :class:`~higra.Tree` objects.
+
+    The graphs are given in a CSR like format by the concatenation of their edge lists:
+
+    - the edges of the :math:`k`-th graph are stored in the range ``[edge_offsets[k], edge_offsets[k + 1])`` of
+      :attr:`sources`, :attr:`targets`, and :attr:`edge_weights`;
+    - the :math:`k`-th graph has ``vertex_offsets[k + 1] - vertex_offsets[k]`` vertices; and
+    - vertex indices in :attr:`sources` and :attr:`targets` are relative to the graph they belong to (the vertices of
+      every graph are numbered from 0).
+
+    The result is composed of 4 arrays ``parents``, ``altitudes``, ``mst_edge_map``, and ``node_offsets`` such that:
+
+    - the parents and the altitudes of the nodes of the :math:`k`-th tree are stored in the range
+      ``[node_offsets[k], node_offsets[k + 1])`` of ``parents`` and ``altitudes``, and parent indices are relative
+      to the first node of the tree: ``hg.Tree(parents[node_offsets[k]:node_offsets[k + 1]])`` is the :math:`k`-th tree;
+      and
+    - the building edges of the :math:`k`-th tree (see :func:`~higra.bpt_canonical`) are stored in the range
+      ``[node_offsets[k] - vertex_offsets[k], node_offsets[k + 1] - vertex_offsets[k + 1])`` of ``mst_edge_map``, and
+      edge indices are relative to the first edge of the :math:`k`-th graph.
+
+    A graph without vertices gives an empty tree.
+
+    :Example:
+
+    >>> # graph 0: 3 vertices and 3 edges, graph 1: 2 vertices and 1 edge
+    >>> sources = np.asarray((0, 1, 0, 0))
+    >>> targets = np.asarray((1, 2, 2, 1))
+    >>> edge_weights = np.asarray((3, 1, 2, 5))
+    >>> parents, altitudes, mst_edge_map, node_offsets = hg.bpt_canonical_batch(
+    >>>     sources, targets, edge_weights, edge_offsets=(0, 3, 4), vertex_offsets=(0, 3, 5))
+    >>> parents
+    array([4, 3, 3, 4, 4, 2, 2, 2])
+    >>> altitudes
+    array([0, 0, 0, 1, 2, 0, 0, 5])
+    >>> mst_edge_map
+    array([1, 2, 0])
+    >>> node_offsets
+    array([0, 5, 8])
+
+    :param sources: concatenated edge sources of all the graphs
+    :param targets: concatenated edge targets of all the graphs
+    :param edge_weights: concatenated edge weights of all the graphs (1d array)
+    :param edge_offsets: offsets of the edges of each graph (array of size number of graphs + 1)
+    :param vertex_offsets: offsets of the vertices of each graph (array of size number of graphs + 1)
+    :return: a tuple of 4 arrays (parents, altitudes, mst_edge_map, node_offsets)
+    """
+    sources = np.asarray(sources, dtype=np.int64)
+    targets = np.asarray(targets, dtype=np.int64)
+    edge_weights = np.asarray(edge_weights)
+    edge_offsets = np.asarray(edge_offsets, dtype=np.int64)
+    vertex_offsets = np.asarray(vertex_offsets, dtype=np.int64)
+
+    return hg.cpp._bpt_canonical_batch(sources, targets, edge_weights, edge_offsets, vertex_offsets)
+
+
+def bpt_canonical_update(graph, edge_weights, tree, altitudes, changed_edges, new_weights):
+    """
+    Updates the canonical binary partition tree of an edge weighted graph after the modification of the weights
+    of a subset of edges (see :func:`~higra.bpt_canonical`).
+
+    The result is identical to ``hg.bpt_canonical(graph, updated_edge_weights)`` where ``updated_edge_weights`` is
+    equal to :attr:`edge_weights` except on :attr:`changed_edges` where it is equal to :attr:`new_weights`. However,
+    only the nodes of :attr:`tree` that may be affected by the modifications are recomputed.
+
+    The function also returns a node map that gives, for each node of the new tree, the index of the
+    corresponding node in :attr:`tree` (same vertices, same building edge, and same altitude) or -1 if the node has
+    been recomputed.
+
+    If an edge appears several times in :attr:`changed_edges`, the last weight is used.
+
+    :Complexity:
+
+    :math:`\mathcal{O}(n + W + R\log(R) + C)` where :math:`n` is the number of nodes of :attr:`tree`, :math:`W` is the
+    total length of the walks in :attr:`tree` from the extremities of the modified edges and of the candidate edges to
+    the recomputed nodes, :math:`R` is the number of recomputed nodes, and :math:`C` is the number of edges adjacent to
+    the components of the minimum spanning tree explored when edges of the minimum spanning tree are increased. Each
+    walk is bounded by the depth of :attr:`tree`, which is often large for images. The linear term comes from the
+    renumbering of the nodes of the result; :class:`~higra.DynamicBptCanonical` updates a tree in place without it.
+
+    :Example:
+
+    >>> g = hg.get_4_adjacency_graph((2, 3))
+    >>> edge_weights = np.asarray((1, 0, 2, 1, 1, 1, 2))
+    >>> tree, altitudes = hg.bpt_canonical(g, edge_weights)
+    >>> new_tree, new_altitudes, node_map = hg.bpt_canonical_update(g, edge_weights, tree, altitudes, (2, 4), (0, 3))
+    >>> edge_weights[[2, 4]] = (0, 3)  # new_tree is the canonical bpt of g with the updated weights
+
+    :param graph: input graph (must be connected)
+    :param edge_weights: edge weights before the update (1d array)
+    :param tree: canonical binary partition tree of the graph weighted by :attr:`edge_weights`
+        (Concept :class:`~higra.CptBinaryHierarchy`)
+    :param altitudes: altitudes of the nodes of :attr:`tree`
+    :param changed_edges: indices of the modified edges
+    :param new_weights: new weights of the modified edges
+    :return: a tree (Concept :class:`~higra.CptBinaryHierarchy`), its node altitudes, and a node map
+    """
+    edge_weights = np.asarray(edge_weights)
+    altitudes = np.asarray(altitudes, dtype=edge_weights.dtype)
+    changed_edges = np.asarray(changed_edges, dtype=np.int64)
+    new_weights = np.asarray(new_weights, dtype=edge_weights.dtype)
+    mst_edge_map = hg.CptBinaryHierarchy.get_mst_edge_map(tree)
+
+    new_tree, new_altitudes, new_mst_edge_map, node_map = hg.cpp._bpt_canonical_update(
+        graph, edge_weights, tree, altitudes, mst_edge_map, changed_edges, new_weights)
+
+    hg.CptHierarchy.link(new_tree, hg.CptHierarchy.get_leaf_graph(tree))
+    hg.CptBinaryHierarchy.link(new_tree, new_mst_edge_map, None)
+
+    return new_tree, new_altitudes, node_map
+
+
+@hg.extend_class(hg.DynamicBptCanonical, method_name="canonical_tree")
+def __dynamic_bpt_canonical_canonical_tree(self):
+    """
+    Canonical binary partition tree of the graph weighted by the current edge weights: the result is identical to
+    ``hg.bpt_canonical(self.graph(), self.edge_weights())``. The internal node ``self.num_leaves() + i`` of the result
+    is the node ``self.num_leaves() + tree.mst_edge_map[i]`` of this dynamic tree.
+
+    :Complexity:
+
+    :math:`\mathcal{O}(m + n\log(n))` where :math:`m` is the number of edges of the graph and :math:`n` is the number
+    of nodes of the tree.
+
+    :return: a tree (Concept :class:`~higra.CptBinaryHierarchy`) and its node altitudes
+    """
+    tree, altitudes, mst_edge_map = self._canonical_tree()
+
+    hg.CptHierarchy.link(tree, self.graph())
+    hg.CptBinaryHierarchy.link(tree, mst_edge_map, None)
+
+    return tree, altitudes
+
+
 def quasi_flat_zone_hierarchy(graph, edge_weights):
     """
     Computes the quasi flat zone hierarchy of the given weighted graph.
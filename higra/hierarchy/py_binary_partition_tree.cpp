@@ -47,14 +47,23 @@ struct def_binary_partition_tree_average_linkage {
     static
     void def(pybind11::module &m, const char *doc) {
         m.def("_binary_partition_tree_average_linkage",
-              [](const hg::ugraph &graph, pyarray<T> &edge_weights, pyarray<T> &edge_weight_weights) {
-                  auto res = binary_partition_tree_average_linkage(graph, edge_weights, edge_weight_weights);
+              [](const hg::ugraph &graph,
+                 pyarray<T> &edge_weights,
+                 pyarray<T> &edge_weight_weights,
+                 const hg::bpt_heap_policy heap_policy) {
+                  auto res = call_without_gil([&]() {
+                      return binary_partition_tree_internal::dispatch_heap_policy(heap_policy, [&](auto heap) {
+                          return binary_partition_tree_average_linkage<decltype(heap)>(graph, edge_weights,
+                                                                                       edge_weight_weights);
+                      });
+                  });
                   return py::make_tuple(std::move(res.tree), std::move(res.altitudes));
               },
               doc,
               py::arg("graph"),
               py::arg("edge_weights"),
-              py::arg("edge_weight_weights"));
+              py::arg("edge_weight_weights"),
+              py::arg("heap_policy") = hg::bpt_heap_policy::fibonacci);
     }
 };
 
@@ -63,15 +72,25 @@ struct def_binary_partition_tree_exponential_linkage {
     static
     void def(pybind11::module &m, const char *doc) {
         m.def("_binary_partition_tree_exponential_linkage",
-              [](const hg::ugraph &graph, pyarray<T> &edge_weights, T alpha, pyarray<T> &edge_weight_weights) {
-                  auto res = binary_partition_tree_exponential_linkage(graph, edge_weights, alpha, edge_weight_weights);
+              [](const hg::ugraph &graph,
+                 pyarray<T> &edge_weights,
+                 T alpha,
+                 pyarray<T> &edge_weight_weights,
+                 const hg::bpt_heap_policy heap_policy) {
+                  auto res = call_without_gil([&]() {
+                      return binary_partition_tree_internal::dispatch_heap_policy(heap_policy, [&](auto heap) {
+                          return binary_partition_tree_exponential_linkage<decltype(heap)>(graph, edge_weights, alpha,
+                                                                                           edge_weight_weights);
+                      });
+                  });
                   return py::make_tuple(std::move(res.tree), std::move(res.altitudes));
               },
               doc,
               py::arg("graph"),
               py::arg("edge_weights"),
               py::arg("alpha"),
-              py::arg("edge_weight_weights"));
+              py::arg("edge_weight_weights"),
+              py::arg("heap_policy") = hg::bpt_heap_policy::fibonacci);
     }
 };
 
@@ -83,16 +102,23 @@ struct def_binary_partition_tree_ward_linkage {
               [](const hg::ugraph &graph,
                  const pyarray<T> &vertex_centroids,
                  const pyarray<T> &vertex_sizes,
-                 const std::string &altitude_correction) {
-                  auto res = binary_partition_tree_ward_linkage(graph, vertex_centroids, vertex_sizes,
-                                                                altitude_correction);
+                 const std::string &altitude_correction,
+                 const hg::bpt_heap_policy heap_policy) {
+                  auto res = call_without_gil([&]() {
+                      return binary_partition_tree_internal::dispatch_heap_policy(heap_policy, [&](auto heap) {
+                          return binary_partition_tree_ward_linkage<decltype(heap)>(graph, vertex_centroids,
+                                                                                    vertex_sizes,
+                                                                                    altitude_correction);
+                      });
+                  });
                   return py::make_tuple(std::move(res.tree), std::move(res.altitudes));
               },
               doc,
               py::arg("graph"),
               py::arg("vertex_centroids"),
               py::arg("vertex_sizes"),
-              py::arg("altitude_correction") = std::string("max"));
+              py::arg("altitude_correction") = std::string("max"),
+              py::arg("heap_policy") = hg::bpt_heap_policy::fibonacci);
     }
 };
 
@@ -103,7 +129,8 @@ struct def_binary_partition_tree_custom_linkage {
         m.def("_binary_partition_tree",
               [](const hg::ugraph &graph,
                  pyarray<T> &edge_weights,
-                 py::object weighting_function) {
+                 py::object weighting_function,
+                 const hg::bpt_heap_policy heap_policy) {
                   //using new_neighbours_type = const std::vector<binary_partition_tree_internal::new_neighbour<T> >;
                   auto weighter = [&weighting_function](
                           const undirected_graph<hg::undirected_graph_internal::hash_setS> &g,
@@ -115,15 +142,23 @@ struct def_binary_partition_tree_custom_linkage {
                       weighting_function(g, fusion_edge_index, new_region, merged_region1, merged_region2,
                                          pybind11::make_iterator(new_neighbours.begin(), new_neighbours.end()));
                   };
-                  auto res = hg::binary_partition_tree(graph,
-                                                       edge_weights,
-                                                       weighter);
+                  hg_assert(heap_policy != hg::bpt_heap_policy::nn_chain,
+                            "The nearest-neighbor chain algorithm requires a reducible linkage and cannot be used "
+                            "with a custom weighting function.");
+                  // the python weighting function works on an UndirectedGraphOptimizedDelete
+                  auto res = binary_partition_tree_internal::dispatch_heap_policy(heap_policy, [&](auto heap) {
+                      return hg::binary_partition_tree<decltype(heap),
+                              hg::undirected_graph<hg::undirected_graph_internal::hash_setS> >(graph,
+                                                                                               edge_weights,
+                                                                                               weighter);
+                  });
                   return py::make_tuple(std::move(res.tree), std::move(res.altitudes));
               },
               doc,
               py::arg("graph"),
               py::arg("edge_weights"),
-              py::arg("weighting_function"));
+              py::arg("weighting_function"),
+              py::arg("heap_policy") = hg::bpt_heap_policy::fibonacci);
     }
 };
 
@@ -132,19 +167,33 @@ struct def_binary_partition_tree_complete_linkage {
     static
     void def(pybind11::module &m, const char *doc) {
         m.def("_binary_partition_tree_complete_linkage",
-              [](const hg::ugraph &graph, pyarray<T> &edge_weights) {
-                  auto res = hg::binary_partition_tree_complete_linkage(graph, edge_weights);
+              [](const hg::ugraph &graph, pyarray<T> &edge_weights, const hg::bpt_heap_policy heap_policy) {
+                  auto res = call_without_gil([&]() {
+                      return binary_partition_tree_internal::dispatch_heap_policy(heap_policy, [&](auto heap) {
+                          return hg::binary_partition_tree_complete_linkage<decltype(heap)>(graph, edge_weights);
+                      });
+                  });
                   return py::make_tuple(std::move(res.tree), std::move(res.altitudes));
               },
               doc,
               py::arg("graph"),
-              py::arg("edge_weights"));
+              py::arg("edge_weights"),
+              py::arg("heap_policy") = hg::bpt_heap_policy::fibonacci);
     }
 };
 
 void py_init_binary_partition_tree(pybind11::module &m) {
     xt::import_numpy();
 
+    py::enum_<hg::bpt_heap_policy>(m, "BptHeapPolicy",
+                                   "Heaps available to order the edges in the binary partition tree algorithms "
+                                   "(nn_chain replaces the heap by the nearest-neighbor chain algorithm).")
+            .value("fibonacci", hg::bpt_heap_policy::fibonacci)
+            .value("pairing", hg::bpt_heap_policy::pairing)
+            .value("dary", hg::bpt_heap_policy::dary)
+            .value("automatic", hg::bpt_heap_policy::automatic)
+            .value("nn_chain", hg::bpt_heap_policy::nn_chain);
+
     add_type_overloads<def_binary_partition_tree_ward_linkage, HG_TEMPLATE_FLOAT_TYPES>(m, "");
     add_type_overloads<def_binary_partition_tree_average_linkage, HG_TEMPLATE_FLOAT_TYPES>(m, "");
     add_type_overloads<def_binary_partition_tree_complete_linkage, HG_TEMPLATE_FLOAT_TYPES>(m, "");
@@ -27,7 +27,7 @@ struct def_min_tree {
         c.def("_component_tree_min_tree",
               [](const graph_t &graph,
                  const pyarray<value_t> &vertex_weights) {
-                  auto res = hg::component_tree_min_tree(graph, vertex_weights);
+                  auto res = call_without_gil([&]() { return hg::component_tree_min_tree(graph, vertex_weights); });
                   return py::make_tuple(std::move(res.tree), std::move(res.altitudes));
               },
               doc,
@@ -44,7 +44,7 @@ struct def_max_tree {
         c.def("_component_tree_max_tree",
               [](const graph_t &graph,
                  const pyarray<value_t> &vertex_weights) {
-                  auto res = hg::component_tree_max_tree(graph, vertex_weights);
+                  auto res = call_without_gil([&]() { return hg::component_tree_max_tree(graph, vertex_weights); });
                   return py::make_tuple(std::move(res.tree), std::move(res.altitudes));
               },
               doc,
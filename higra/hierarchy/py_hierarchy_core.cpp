@@ -26,7 +26,7 @@ struct def_quasi_flat_zone_hierarchy {
     static
     void def(C &m, const char *doc) {
         m.def("_quasi_flat_zone_hierarchy", [](const graph_t &graph, const pyarray<value_t> &edge_weights) {
-                  auto res = hg::quasi_flat_zone_hierarchy(graph, edge_weights);
+                  auto res = call_without_gil([&]() { return hg::quasi_flat_zone_hierarchy(graph, edge_weights); });
                   return py::make_tuple(std::move(res.tree), std::move(res.altitudes));
               },
               doc,
@@ -36,6 +36,118 @@ struct def_quasi_flat_zone_hierarchy {
     }
 };
 
+struct def_bpt_canonical_batch {
+    template<typename value_t, typename C>
+    static
+    void def(C &m, const char *doc) {
+        m.def("_bpt_canonical_batch", [](const xt::pytensor<hg::index_t, 1> &sources,
+                                         const xt::pytensor<hg::index_t, 1> &targets,
+                                         const xt::pytensor<value_t, 1> &edge_weights,
+                                         const xt::pytensor<hg::index_t, 1> &edge_offsets,
+                                         const xt::pytensor<hg::index_t, 1> &vertex_offsets) {
+                  auto res = call_without_gil([&]() {
+                      return hg::bpt_canonical_batch(sources, targets, edge_weights, edge_offsets, vertex_offsets);
+                  });
+                  return py::make_tuple(std::move(res.parents),
+                                        std::move(res.altitudes),
+                                        std::move(res.mst_edge_map),
+                                        std::move(res.node_offsets));
+              },
+              doc,
+              py::arg("sources"),
+              py::arg("targets"),
+              py::arg("edge_weights"),
+              py::arg("edge_offsets"),
+              py::arg("vertex_offsets")
+        );
+    }
+};
+
+template<typename graph_t>
+struct def_bpt_canonical_update {
+    template<typename value_t, typename C>
+    static
+    void def(C &m, const char *doc) {
+        m.def("_bpt_canonical_update", [](const graph_t &graph,
+                                          const xt::pytensor<value_t, 1> &edge_weights,
+                                          const hg::tree &tree,
+                                          const xt::pytensor<value_t, 1> &altitudes,
+                                          const xt::pytensor<hg::index_t, 1> &mst_edge_map,
+                                          const xt::pytensor<hg::index_t, 1> &changed_edges,
+                                          const xt::pytensor<value_t, 1> &new_weights) {
+                  auto res = call_without_gil([&]() {
+                      return hg::bpt_canonical_update(graph, edge_weights, tree, altitudes, mst_edge_map,
+                                                      changed_edges, new_weights);
+                  });
+                  return py::make_tuple(std::move(res.tree),
+                                        std::move(res.altitudes),
+                                        std::move(res.mst_edge_map),
+                                        std::move(res.node_map));
+              },
+              doc,
+              py::arg("graph"),
+              py::arg("edge_weights"),
+              py::arg("tree"),
+              py::arg("altitudes"),
+              py::arg("mst_edge_map"),
+              py::arg("changed_edges"),
+              py::arg("new_weights")
+        );
+    }
+};
+
+template<typename M>
+void add_dynamic_bpt_canonical(M &m) {
+    using graph_t = hg::ugraph;
+    using class_t = hg::dynamic_bpt_canonical<graph_t, double>;
+    auto c = py::class_<class_t>(m,
+                                 "DynamicBptCanonical",
+                                 "Canonical binary partition tree of an edge weighted graph that can be updated in "
+                                 "place when the weights of a subset of edges are modified. The leaf i is the vertex "
+                                 "i of the graph and the internal node num_leaves() + ei is the node built by the "
+                                 "edge ei of the graph: node indices do not change during the updates.");
+    c.def(py::init([](const graph_t &graph, const xt::pytensor<double, 1> &edge_weights) {
+              return call_without_gil([&]() { return hg::make_dynamic_bpt_canonical(graph, edge_weights); });
+          }),
+          "Computes the canonical binary partition tree of the given edge weighted graph (the graph must be "
+          "connected and must not be modified while the object is used).",
+          py::arg("graph"),
+          py::arg("edge_weights"),
+          py::keep_alive<1, 2>());
+    c.def("graph", &class_t::graph, "The graph of the tree.", py::return_value_policy::reference_internal);
+    c.def("num_leaves", &class_t::num_leaves, "Number of leaves of the tree.");
+    c.def("root", &class_t::root, "Root of the tree.");
+    c.def("parent", &class_t::parent, "Parent of the given node.", py::arg("node"));
+    c.def("parents", &class_t::parents,
+          "Parent of each node index, -1 for the indices which are not nodes of the tree.",
+          py::return_value_policy::reference_internal);
+    c.def("is_node", &class_t::is_node,
+          "True if the given index is a leaf or a node built by an edge of the minimum spanning tree.",
+          py::arg("node"));
+    c.def("altitude", &class_t::altitude, "Altitude of the given node.", py::arg("node"));
+    c.def("building_edge", &class_t::building_edge, "Building edge of the given internal node.", py::arg("node"));
+    c.def("edge_weights", &class_t::edge_weights, "Current edge weights.",
+          py::return_value_policy::reference_internal);
+    c.def("update", [](class_t &self,
+                       const xt::pytensor<hg::index_t, 1> &changed_edges,
+                       const xt::pytensor<double, 1> &new_weights) {
+              auto res = call_without_gil([&]() { return self.update(changed_edges, new_weights); });
+              return py::make_tuple(std::move(res.removed_nodes),
+                                    std::move(res.added_nodes),
+                                    std::move(res.reparented_nodes));
+          },
+          "Modifies the weights of the given edges and repairs the tree in place. Returns the removed nodes, the "
+          "added nodes, and the kept nodes whose parent is an added node: the other nodes are unchanged. The time "
+          "depends on the number of repaired nodes and not on the size of the tree.",
+          py::arg("changed_edges"),
+          py::arg("new_weights"));
+    c.def("_canonical_tree", [](const class_t &self) {
+              auto res = call_without_gil([&]() { return self.canonical_tree(); });
+              return py::make_tuple(std::move(res.tree), std::move(res.altitudes), std::move(res.mst_edge_map));
+          },
+          "Canonical binary partition tree of the graph weighted by the current edge weights.");
+}
+
 template<typename M>
 void add_simplified_tree(M &m) {
     using class_t = hg::remapped_tree<hg::tree, hg::array_1d<hg::index_t>>;
@@ -54,29 +166,57 @@ void add_simplified_tree(M &m) {
 void py_init_hierarchy_core(pybind11::module &m) {
     xt::import_numpy();
 
+    py::enum_<hg::bpt_canonical_algorithm>(m, "BptCanonicalAlgorithm",
+                                           "Algorithms available to compute the canonical binary partition tree.")
+            .value("kruskal", hg::bpt_canonical_algorithm::kruskal)
+            .value("filter_kruskal", hg::bpt_canonical_algorithm::filter_kruskal);
+
     m.def("_bpt_canonical", [](const xt::pytensor<hg::index_t, 1> &sources,
                                const xt::pytensor<hg::index_t, 1> &targets,
                                const xt::pytensor<hg::index_t, 1> &sorted_edge_indices,
-                               const hg::index_t num_vertices) {
-        hg_assert(num_vertices >= 0, "Number of vertices must be a positive number.");
-        hg_assert((xt::amin)(sources)() >= 0, "Source vertex index cannot be negative.");
-        hg_assert((xt::amin)(targets)() >= 0, "Target vertex index cannot be negative.");
-        hg_assert((xt::amin)(sorted_edge_indices)() >= 0, "Edge index cannot be negative.");
-        hg_assert((xt::amax)(sources)() < num_vertices,
-                  "Source vertex index must be less than the number of vertices.");
-        hg_assert((xt::amax)(targets)() < num_vertices,
-                  "Target vertex index must be less than the number of vertices.");
-        hg_assert((xt::amax)(sorted_edge_indices)() < (hg::index_t) sorted_edge_indices.size(),
-                  "Edge index must be smaller than the number of edges in the graph/tree.");
-        auto res = hg::hierarchy_core_internal::bpt_canonical_from_sorted_edges(sources, targets, sorted_edge_indices,
-                                                                                num_vertices);
+                               const hg::index_t num_vertices,
+                               const hg::bpt_canonical_algorithm algorithm) {
+        auto res = call_without_gil([&]() {
+            hg_assert(num_vertices >= 0, "Number of vertices must be a positive number.");
+            hg_assert((xt::amin)(sources)() >= 0, "Source vertex index cannot be negative.");
+            hg_assert((xt::amin)(targets)() >= 0, "Target vertex index cannot be negative.");
+            hg_assert((xt::amin)(sorted_edge_indices)() >= 0, "Edge index cannot be negative.");
+            hg_assert((xt::amax)(sources)() < num_vertices,
+                      "Source vertex index must be less than the number of vertices.");
+            hg_assert((xt::amax)(targets)() < num_vertices,
+                      "Target vertex index must be less than the number of vertices.");
+            hg_assert((xt::amax)(sorted_edge_indices)() < (hg::index_t) sorted_edge_indices.size(),
+                      "Edge index must be smaller than the number of edges in the graph/tree.");
+            return hg::hierarchy_core_internal::bpt_canonical_from_sorted_edges(sources, targets, sorted_edge_indices,
+                                                                                num_vertices, algorithm);
+        });
         return py::make_tuple(std::move(res.first), std::move(res.second));
-    });
+    },
+          "",
+          py::arg("sources"),
+          py::arg("targets"),
+          py::arg("sorted_edge_indices"),
+          py::arg("num_vertices"),
+          py::arg("algorithm") = hg::bpt_canonical_algorithm::kruskal);
+
+    add_type_overloads<def_bpt_canonical_batch, HG_TEMPLATE_NUMERIC_TYPES>
+            (m,
+             "Compute the canonical binary partition trees of a batch of edge weighted graphs."
+            );
+
+    add_type_overloads<def_bpt_canonical_update<hg::ugraph>, HG_TEMPLATE_NUMERIC_TYPES>
+            (m,
+             "Update the canonical binary partition tree of an edge weighted graph after a modification of some edge "
+             "weights."
+            );
+
+    add_dynamic_bpt_canonical(m);
 
     add_simplified_tree(m);
     m.def("_simplify_tree",
           [](const hg::tree &t, pyarray<bool> &criterion, bool process_leaves) {
-              return hg::simplify_tree(t, criterion, process_leaves);
+              prepare_tree_without_gil(t);
+              return call_without_gil([&]() { return hg::simplify_tree(t, criterion, process_leaves); });
           },
           "",
           py::arg("tree"),
@@ -90,7 +230,8 @@ void py_init_hierarchy_core(pybind11::module &m) {
 
     m.def("_tree_2_binary_tree",
           [](const hg::tree &t) {
-              return hg::tree_2_binary_tree(t);
+              prepare_tree_without_gil(t);
+              return call_without_gil([&t]() { return hg::tree_2_binary_tree(t); });
           },
           "",
           py::arg("tree")
@@ -30,7 +30,17 @@ struct def_watershed_hierarchy_by_attribute {
                       // FIXME can we do better for return type ?
                  const std::function<pyarray<double>(const hg::tree &,
                                                      const hg::array_1d<value_t> &)> &attribute_functor) {
-                  auto res = hg::watershed_hierarchy_by_attribute(graph, edge_weights, attribute_functor);
+                  auto res = call_without_gil([&]() {
+                      return hg::watershed_hierarchy_by_attribute(
+                              graph,
+                              edge_weights,
+                              [&attribute_functor](const hg::tree &tree, const hg::array_1d<value_t> &altitudes) {
+                                  // the Python result is copied and released while the lock is held
+                                  py::gil_scoped_acquire acquire;
+                                  hg::array_1d<double> attribute = attribute_functor(tree, altitudes);
+                                  return attribute;
+                              });
+                  });
                   return py::make_tuple(
                           std::move(res.tree),
                           std::move(res.altitudes),
@@ -53,7 +63,9 @@ struct def_watershed_hierarchy_by_minima_ordering {
               [](const graph_t &graph,
                  const pyarray<value_t> &edge_weights,
                  const pyarray<size_t> &minima_ranks) {
-                  auto res = hg::watershed_hierarchy_by_minima_ordering(graph, edge_weights, minima_ranks);
+                  auto res = call_without_gil([&]() {
+                      return hg::watershed_hierarchy_by_minima_ordering(graph, edge_weights, minima_ranks);
+                  });
                   return py::make_tuple(
                           std::move(res.tree),
                           std::move(res.altitudes),
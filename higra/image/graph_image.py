@@ -176,6 +176,102 @@ def get_8_adjacency_implicit_graph(shape):
     return graph
 
 
+def __get_3d_cube_neighbours(max_non_zero):
+    neighbours = np.array([(z, y, x) for z in (-1, 0, 1) for y in (-1, 0, 1) for x in (-1, 0, 1)], dtype=np.int64)
+    non_zero = np.count_nonzero(neighbours, axis=1)
+    return neighbours[np.logical_and(non_zero > 0, non_zero <= max_non_zero)]
+
+
+def get_6_adjacency_implicit_graph(shape):
+    """
+    Create an implicit undirected 6 adjacency graph of the given 3d shape (edges are not stored).
+
+    Two voxels are adjacent if they share a face.
+
+    :param shape: a triplet (depth, height, width)
+    :return: a graph (Concept :class:`~higra.CptGridGraph`)
+    """
+    shape = hg.normalize_shape(shape)
+    if len(shape) != 3:
+        raise ValueError("Shape must be a 1d array of size 3.")
+
+    return get_nd_regular_implicit_graph(shape, __get_3d_cube_neighbours(1))
+
+
+def get_18_adjacency_implicit_graph(shape):
+    """
+    Create an implicit undirected 18 adjacency graph of the given 3d shape (edges are not stored).
+
+    Two voxels are adjacent if they share a face or an edge.
+
+    :param shape: a triplet (depth, height, width)
+    :return: a graph (Concept :class:`~higra.CptGridGraph`)
+    """
+    shape = hg.normalize_shape(shape)
+    if len(shape) != 3:
+        raise ValueError("Shape must be a 1d array of size 3.")
+
+    return get_nd_regular_implicit_graph(shape, __get_3d_cube_neighbours(2))
+
+
+def get_26_adjacency_implicit_graph(shape):
+    """
+    Create an implicit undirected 26 adjacency graph of the given 3d shape (edges are not stored).
+
+    Two voxels are adjacent if they share a face, an edge, or a corner.
+
+    :param shape: a triplet (depth, height, width)
+    :return: a graph (Concept :class:`~higra.CptGridGraph`)
+    """
+    shape = hg.normalize_shape(shape)
+    if len(shape) != 3:
+        raise ValueError("Shape must be a 1d array of size 3.")
+
+    return get_nd_regular_implicit_graph(shape, __get_3d_cube_neighbours(3))
+
+
+def get_6_adjacency_graph(shape):
+    """
+    Create an explicit undirected 6 adjacency graph of the given 3d shape.
+
+    :param shape: a triplet (depth, height, width)
+    :return: a graph (Concept :class:`~higra.CptGridGraph`)
+    """
+    shape = hg.normalize_shape(shape)
+    if len(shape) != 3:
+        raise ValueError("Shape must be a 1d array of size 3.")
+
+    return get_nd_regular_graph(shape, __get_3d_cube_neighbours(1))
+
+
+def get_18_adjacency_graph(shape):
+    """
+    Create an explicit undirected 18 adjacency graph of the given 3d shape.
+
+    :param shape: a triplet (depth, height, width)
+    :return: a graph (Concept :class:`~higra.CptGridGraph`)
+    """
+    shape = hg.normalize_shape(shape)
+    if len(shape) != 3:
+        raise ValueError("Shape must be a 1d array of size 3.")
+
+    return get_nd_regular_graph(shape, __get_3d_cube_neighbours(2))
+
+
+def get_26_adjacency_graph(shape):
+    """
+    Create an explicit undirected 26 adjacency graph of the given 3d shape.
+
+    :param shape: a triplet (depth, height, width)
+    :return: a graph (Concept :class:`~higra.CptGridGraph`)
+    """
+    shape = hg.normalize_shape(shape)
+    if len(shape) != 3:
+        raise ValueError("Shape must be a 1d array of size 3.")
+
+    return get_nd_regular_graph(shape, __get_3d_cube_neighbours(3))
+
+
 def get_nd_regular_implicit_graph(shape, neighbour_list):
     """
     Creates an implicit regular graph of the given :attr:`shape` with the adjacency given as a
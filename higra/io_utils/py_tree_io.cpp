@@ -10,14 +10,84 @@
 
 #include "py_tree_io.hpp"
 #include "higra/io/tree_io.hpp"
+#include "higra/io/tree_binary_io.hpp"
 #include "../py_common.hpp"
 #include "xtensor-python/pyarray.hpp"
 #include "xtensor-python/pytensor.hpp"
 #include <fstream>
+#include <memory>
 
 template<typename T>
 using pyarray = xt::pyarray<T>;
 
+template<typename T>
+bool try_add_binary_attribute(hg::tree_binary_io_internal::tree_binary_saver_helper &s,
+                              const std::string &name,
+                              const pybind11::array &array) {
+    if (!pybind11::isinstance<pybind11::array_t<T>>(array)) {
+        return false;
+    }
+    auto a = array.cast<pyarray<T>>();
+    s.add_attribute(name, a);
+    return true;
+}
+
+void add_binary_attribute(hg::tree_binary_io_internal::tree_binary_saver_helper &s,
+                          const std::string &name,
+                          const pybind11::array &array) {
+    if (!(try_add_binary_attribute<int8_t>(s, name, array) ||
+          try_add_binary_attribute<uint8_t>(s, name, array) ||
+          try_add_binary_attribute<int16_t>(s, name, array) ||
+          try_add_binary_attribute<uint16_t>(s, name, array) ||
+          try_add_binary_attribute<int32_t>(s, name, array) ||
+          try_add_binary_attribute<uint32_t>(s, name, array) ||
+          try_add_binary_attribute<int64_t>(s, name, array) ||
+          try_add_binary_attribute<uint64_t>(s, name, array) ||
+          try_add_binary_attribute<float>(s, name, array) ||
+          try_add_binary_attribute<double>(s, name, array))) {
+        throw std::runtime_error("Unsupported value type for attribute '" + name + "'.");
+    }
+}
+
+template<typename T>
+pybind11::array mmap_column(const std::shared_ptr<hg::tree_mmap> &file, const std::string &name) {
+    // the capsule keeps the file mapped as long as the numpy array is alive
+    auto owner = new std::shared_ptr<hg::tree_mmap>(file);
+    pybind11::capsule base(owner, [](void *p) { delete static_cast<std::shared_ptr<hg::tree_mmap> *>(p); });
+    // strides are explicit: the default strides would be computed from the itemsize of the array being built
+    return pybind11::array_t<T>({(pybind11::ssize_t) file->column_size(name)},
+                                {(pybind11::ssize_t) sizeof(T)},
+                                static_cast<const T *>(file->column_data(name)),
+                                base);
+}
+
+pybind11::array mmap_column(const std::shared_ptr<hg::tree_mmap> &file, const std::string &name) {
+    using ct = hg::tree_mmap::column_type;
+    switch (file->get_column_type(name)) {
+        case ct::int8:
+            return mmap_column<int8_t>(file, name);
+        case ct::uint8:
+            return mmap_column<uint8_t>(file, name);
+        case ct::int16:
+            return mmap_column<int16_t>(file, name);
+        case ct::uint16:
+            return mmap_column<uint16_t>(file, name);
+        case ct::int32:
+            return mmap_column<int32_t>(file, name);
+        case ct::uint32:
+            return mmap_column<uint32_t>(file, name);
+        case ct::int64:
+            return mmap_column<int64_t>(file, name);
+        case ct::uint64:
+            return mmap_column<uint64_t>(file, name);
+        case ct::float32:
+            return mmap_column<float>(file, name);
+        case ct::float64:
+            return mmap_column<double>(file, name);
+    }
+    throw std::runtime_error("Unsupported column type for column '" + name + "'.");
+}
+
 void py_init_tree_io(pybind11::module &m) {
     xt::import_numpy();
 
@@ -29,18 +99,59 @@ void py_init_tree_io(pybind11::module &m) {
           pybind11::arg("filename"));
 
     m.def("save_tree", [](const std::string &filename, const hg::tree &tree,
-                          const std::map<std::string, pyarray<double>> &attributes) {
+                          const std::map<std::string, pyarray<double>> &attributes,
+                          bool compress_parents) {
               std::ofstream file(filename);
-              auto s = hg::save_tree(file, tree);
+              auto s = compress_parents ?
+                       hg::save_tree(file, tree, hg::tree_codec::codec_options()) :
+                       hg::save_tree(file, tree);
               for (auto e: attributes) {
                   s.add_attribute(e.first, e.second);
               }
               s.finalize();
           },
           "Save a tree and scalar attributes to mixed ascii/binary format. "
-          "Attributes must be numpy 1d arrays stored in a dictionary with string keys (attribute names).",
+          "Attributes must be numpy 1d arrays stored in a dictionary with string keys (attribute names). "
+          "If compress_parents is true, the parent array is delta encoded, bit packed and entropy coded.",
           pybind11::arg("filename"),
           pybind11::arg("tree"),
-          pybind11::arg("attributes") = std::map<std::string, pyarray<double>>());
-}
+          pybind11::arg("attributes") = std::map<std::string, pyarray<double>>(),
+          pybind11::arg("compress_parents") = false);
 
+    m.def("_save_tree_binary", [](const std::string &filename, const hg::tree &tree,
+                                  const std::map<std::string, pybind11::array> &attributes,
+                                  bool children,
+                                  bool lca) {
+              std::ofstream file(filename, std::ios::binary);
+              hg_assert(file.is_open(), "Cannot open file '" + filename + "'.");
+              auto s = hg::save_tree_binary(file, tree);
+              for (auto &e: attributes) {
+                  add_binary_attribute(s, e.first, e.second);
+              }
+              if (children) {
+                  s.add_children();
+              }
+              if (lca) {
+                  s.add_lca();
+              }
+              s.finalize();
+          },
+          "Save a tree and typed scalar attributes in the binary tree format.",
+          pybind11::arg("filename"),
+          pybind11::arg("tree"),
+          pybind11::arg("attributes"),
+          pybind11::arg("children"),
+          pybind11::arg("lca"));
+
+    m.def("_read_tree_mmap", [](const std::string &filename) {
+              auto file = std::make_shared<hg::tree_mmap>(filename);
+              std::map<std::string, pybind11::array> attributes;
+              for (auto &name: file->attribute_names()) {
+                  attributes[name] = mmap_column(file, hg::tree_binary_io_internal::attribute_prefix + name);
+              }
+              return pybind11::make_tuple(file->get_tree(), attributes);
+          },
+          "Read a tree stored in the binary tree format. Return a pair with the tree and a map of attributes "
+          "(tree, dict[string => 1d array]), attribute arrays are views on the memory mapped file.",
+          pybind11::arg("filename"));
+}
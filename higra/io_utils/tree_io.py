@@ -29,6 +29,49 @@ def read_tree(filename):
     return tree, attribute_map
 
 
+def save_tree_binary(filename, tree, attributes=None, *, children=True, lca=False):
+    """
+    Save a tree and its attributes in a binary format that can be memory mapped with :func:`~higra.read_tree_mmap`.
+
+    Contrarily to :func:`~higra.save_tree`, attributes keep their numeric type.
+    Optionally, the children of the tree nodes and a lowest common ancestor structure can be stored in the file
+    to avoid recomputing them when the tree is read.
+
+    :param filename: path to the tree file
+    :param tree: input tree
+    :param attributes: dictionary of 1d numpy arrays (node attributes) with string keys (attribute names)
+    :param children: if ``True`` (default), the children of the tree nodes are stored in the file
+    :param lca: if ``True``, a lowest common ancestor structure is stored in the file (default ``False``)
+    :return: nothing
+    """
+    if attributes is None:
+        attributes = {}
+    attributes = {k: np.ascontiguousarray(v) for k, v in attributes.items()}
+    hg.cpp._save_tree_binary(filename, tree, attributes, children, lca)
+
+
+def read_tree_mmap(filename):
+    """
+    Read a tree stored in the binary format of :func:`~higra.save_tree_binary`.
+
+    The file is memory mapped: attributes are read only numpy arrays that directly use the mapped
+    memory, no copy is performed and the data are only loaded when they are accessed. The file remains mapped
+    as long as one of the attribute arrays is alive.
+
+    Attributes are also registered as tree object attributes.
+
+    :param filename: path to the tree file
+    :return: a pair (tree, attribute_map)
+    """
+    tree, attribute_map = hg.cpp._read_tree_mmap(filename)
+
+    for k in attribute_map:
+        attribute_map[k].flags.writeable = False
+        hg.set_attribute(tree, k, attribute_map[k])
+
+    return tree, attribute_map
+
+
 def print_partition_tree(tree, *,
                altitudes=None,
                attribute=None,
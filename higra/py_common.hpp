@@ -29,6 +29,29 @@ add_type_overloads(module_t & m, const char * doc, Args&&... args){
 };
 
 
+/**
+ * Calls fun() with the Python global interpreter lock released and returns its result.
+ *
+ * fun must not interact with the Python API: in particular it must not create, copy or destroy
+ * pyarray/pytensor objects (reading or writing the elements of existing ones is fine).
+ * Its result must thus be a pure C++ object, which is converted to Python after the lock has been re-acquired.
+ */
+template<typename F>
+decltype(auto) call_without_gil(F &&fun) {
+    pybind11::gil_scoped_release release;
+    return fun();
+}
+
+/**
+ * Lazily computed structures of a tree (children lists) are not thread safe: they must be
+ * computed while the global interpreter lock is still held, before calling call_without_gil.
+ */
+template<typename tree_t>
+const tree_t &prepare_tree_without_gil(const tree_t &tree) {
+    tree.compute_children();
+    return tree;
+}
+
 #if defined(__GNUC__) && !defined(__clang__)
 namespace workaround
 {
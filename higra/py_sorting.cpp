@@ -24,7 +24,7 @@ struct def_sort {
     static
     void def(C &c, const char *doc) {
         c.def("_sort", [](pyarray<value_t> &array) {
-                  hg::sort(array);
+                  call_without_gil([&array]() { hg::sort(array); });
               },
               doc,
               py::arg("array"));
@@ -36,7 +36,7 @@ struct def_stable_sort {
     static
     void def(C &c, const char *doc) {
         c.def("_stable_sort", [](pyarray<value_t> &array) {
-                  hg::stable_sort(array);
+                  call_without_gil([&array]() { hg::stable_sort(array); });
               },
               doc,
               py::arg("array"));
@@ -48,7 +48,7 @@ struct def_arg_sort {
     static
     void def(C &c, const char *doc) {
         c.def("_arg_sort", [](pyarray<value_t> &array) {
-                  return hg::arg_sort(array);
+                  return call_without_gil([&array]() { return hg::arg_sort(array); });
               },
               doc,
               py::arg("array"));
@@ -60,7 +60,7 @@ struct def_stable_arg_sort {
     static
     void def(C &c, const char *doc) {
         c.def("_stable_arg_sort", [](pyarray<value_t> &array) {
-                  return hg::stable_arg_sort(array);
+                  return call_without_gil([&array]() { return hg::stable_arg_sort(array); });
               },
               doc,
               py::arg("array"));
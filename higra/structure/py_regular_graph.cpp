@@ -84,6 +84,17 @@ void py_init_regular_graph_impl(pybind11::module &m) {
           },
           "Get the neighbour list defining the regular graph.");
 
+    c.def("num_edges", [](const graph_t &graph) { return hg::num_edges(graph); },
+          "Return the number of edges in the graph (edges are indexed in the order of the equivalent explicit graph).");
+
+    c.def("edge_from_index",
+          [](const graph_t &graph, hg::index_t edge_index) {
+              hg_assert_edge_index(graph, edge_index);
+              return cpp_edge_2_python(hg::edge_from_index(edge_index, graph));
+          },
+          "Get an edge from its index (edges are indexed in the order of the equivalent explicit graph).",
+          py::arg("edge_index"));
+
     add_edge_accessor_graph_concept<graph_t, decltype(c)>(c);
     add_incidence_graph_concept<graph_t, decltype(c)>(c);
     add_bidirectionnal_graph_concept<graph_t, decltype(c)>(c);
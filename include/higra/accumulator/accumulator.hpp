@@ -11,8 +11,12 @@
 #pragma once
 
 #include "../utils.hpp"
+#include <algorithm>
+#include <array>
 #include <functional>
 #include <limits>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 namespace hg {
@@ -34,6 +38,69 @@ namespace hg {
 
     namespace accumulator_detail {
 
+        template<typename fun_t, std::size_t... I>
+        void static_for_impl(const fun_t &fun, std::index_sequence<I...>) {
+            (void) std::initializer_list<int>{(fun(std::integral_constant<std::size_t, I>()), 0)...};
+        }
+
+        /**
+         * Calls fun(std::integral_constant<std::size_t, k>()) for k in [0, N)
+         */
+        template<std::size_t N, typename fun_t>
+        void static_for(const fun_t &fun) {
+            static_for_impl(fun, std::make_index_sequence<N>());
+        }
+
+        /**
+         * Number of elements processed by a task in the multi-threaded engines
+         */
+        const index_t parallel_chunk_size = 1 << 12;
+
+        /**
+         * Minimal number of elements for the multi-threaded engines to be used (requires HG_USE_TBB)
+         */
+        const index_t parallel_min_size = 1 << 16;
+
+        inline bool use_multi_threaded_engine(index_t size) {
+#ifdef HG_USE_TBB
+            return size >= parallel_min_size;
+#else
+            (void) size;
+            return false;
+#endif
+        }
+
+        /**
+         * Calls fun(begin, end) on consecutive chunks of [0, size), chunks are processed in parallel
+         */
+        template<typename fun_t>
+        void parfor_chunks(index_t size, const fun_t &fun) {
+            if (size <= parallel_chunk_size) {
+                if (size > 0) {
+                    fun(0, size);
+                }
+                return;
+            }
+            index_t num_chunks = (size + parallel_chunk_size - 1) / parallel_chunk_size;
+            parfor(0, num_chunks, [size, &fun](index_t c) {
+                fun(c * parallel_chunk_size, (std::min)((c + 1) * parallel_chunk_size, size));
+            });
+        }
+
+        /**
+         * True if accumulator_t is a marginal accumulator (sum, min, max, prod): its result is the reduction of the
+         * accumulated values by an associative and commutative operation. Such accumulators can accumulate
+         * partial results as if they were single values.
+         */
+        template<typename accumulator_t, typename = void>
+        struct is_marginal_accumulator : std::false_type {
+        };
+
+        template<typename accumulator_t>
+        struct is_marginal_accumulator<accumulator_t,
+                decltype((void) accumulator_t::template reduce<double>(0, 0))> : std::true_type {
+        };
+
         /**
         * Marginal processing accumulator
         * @tparam S the storage type
@@ -156,12 +223,14 @@ namespace hg {
             template<typename T = self_type, typename ...Args>
             typename std::enable_if_t<T::is_vectorial>
             initialize(Args &&...) {
+                m_counter = 0;
                 std::fill(m_storage_begin, m_storage_end, 0);
             }
 
             template<typename T = self_type, typename ...Args>
             typename std::enable_if_t<!T::is_vectorial>
             initialize(Args &&...) {
+                m_counter = 0;
                 *m_storage_begin = 0;
             }
 
@@ -757,4 +826,46 @@ namespace hg {
             return input_shape;
         }
     };
+
+    /**
+     * Compile-time tuple of accumulators evaluated together in a single traversal of a tree
+     * (see accumulate_parallel and accumulate_sequential): each accumulator produces its own output array.
+     *
+     * Accumulators can be disabled at runtime with set_enabled: they are skipped during the traversal and
+     * their output array is empty.
+     *
+     * @tparam accumulators_t types of the accumulators
+     */
+    template<typename... accumulators_t>
+    struct accumulator_composite {
+
+        static const std::size_t size = sizeof...(accumulators_t);
+
+        explicit accumulator_composite(const accumulators_t &... accumulators) :
+                m_accumulators(accumulators...) {
+            m_enabled.fill(true);
+        }
+
+        template<std::size_t k>
+        const auto &get() const {
+            return std::get<k>(m_accumulators);
+        }
+
+        bool enabled(std::size_t k) const {
+            return m_enabled[k];
+        }
+
+        void set_enabled(std::size_t k, bool enabled) {
+            m_enabled[k] = enabled;
+        }
+
+    private:
+        std::tuple<accumulators_t...> m_accumulators;
+        std::array<bool, sizeof...(accumulators_t)> m_enabled;
+    };
+
+    template<typename... accumulators_t>
+    auto make_accumulator_composite(const accumulators_t &... accumulators) {
+        return accumulator_composite<accumulators_t...>(accumulators...);
+    }
 }
@@ -17,6 +17,15 @@
 namespace hg {
 
     namespace at_accumulator_internal {
+
+        template<typename T, typename accumulator_t, typename output_t>
+        auto make_output(index_t size, const T &weights) {
+            auto data_shape = std::vector<size_t>(weights.shape().begin() + 1, weights.shape().end());
+            auto output_shape = accumulator_t::get_output_shape(data_shape);
+            output_shape.insert(output_shape.begin(), size);
+            return array_nd<output_t>::from_shape(output_shape);
+        }
+
         template<bool vectorial,
                 typename T,
                 typename accumulator_t,
@@ -30,10 +39,7 @@ namespace hg {
             hg_assert(weights.shape()[0] == indices.size(), "Weights dimension does not match rag map dimension.");
 
             index_t size = xt::amax(indices)() + 1;
-            auto data_shape = std::vector<size_t>(weights.shape().begin() + 1, weights.shape().end());
-            auto output_shape = accumulator_t::get_output_shape(data_shape);
-            output_shape.insert(output_shape.begin(), size);
-            array_nd<typename T::value_type> res = array_nd<typename T::value_type>::from_shape(output_shape);
+            auto res = make_output<T, accumulator_t, output_t>(size, weights);
 
             auto input_view = make_light_axis_view<vectorial>(weights);
             auto output_view = make_light_axis_view<vectorial>(res);
@@ -62,6 +68,144 @@ namespace hg {
 
             return res;
         }
+
+        /**
+         * Multi-threaded at_accumulate: sort by key and segmented reduction.
+         *
+         * The positions of the weights are sorted by indices with a parallel counting sort: the input is split into
+         * num_input_chunks contiguous chunks whose histograms are computed in parallel, and the positions of each
+         * chunk are then scattered in parallel. The number of input chunks is bounded such that the histograms
+         * (size * num_input_chunks counters) are not larger than the input, and the prefix sum of the histograms is
+         * computed in parallel over blocks of output elements. The sort is stable: the weights accumulated in a given output
+         * element are contiguous and in their original order, hence the result is the same as the sequential
+         * version for every accumulator, and output elements are independent. Output elements are finally split
+         * into chunks of about parallel_chunk_size elements and parallel_chunk_size weights which are processed
+         * in parallel.
+         */
+        template<bool vectorial,
+                typename T,
+                typename accumulator_t,
+                typename output_t = typename T::value_type>
+        auto
+        at_accumulate_sorted(const array_1d<index_t> &indices,
+                             const xt::xexpression<T> &xweights,
+                             const accumulator_t &accumulator,
+                             index_t num_input_chunks) {
+            HG_TRACE();
+            using accumulator_detail::parallel_chunk_size;
+            auto &weights = xweights.derived_cast();
+            hg_assert(weights.shape()[0] == indices.size(), "Weights dimension does not match rag map dimension.");
+
+            index_t size = xt::amax(indices)() + 1;
+            auto res = make_output<T, accumulator_t, output_t>(size, weights);
+
+            index_t map_size = indices.size();
+            num_input_chunks = (std::min)(num_input_chunks, map_size / parallel_chunk_size);
+            // memory used by the histograms: size * num_input_chunks <= map_size
+            num_input_chunks = (std::max)((index_t) 1, (std::min)(num_input_chunks, map_size / size));
+            index_t input_chunk_size = (map_size + num_input_chunks - 1) / num_input_chunks;
+            const index_t *indices_data = indices.data();
+
+            // counts[i * num_input_chunks + c]: number of weights of input chunk c accumulated in output element i,
+            // then position of the first of these weights in sorted
+            std::vector<index_t> counts(size * num_input_chunks, 0);
+            parfor(0, num_input_chunks, [&](index_t c) {
+                index_t end = (std::min)((c + 1) * input_chunk_size, map_size);
+                for (index_t j = c * input_chunk_size; j < end; j++) {
+                    if (indices_data[j] != invalid_index) {
+                        counts[indices_data[j] * num_input_chunks + c]++;
+                    }
+                }
+            });
+
+            // weights accumulated in output element i are at positions [offsets(i), offsets(i + 1)[ of sorted
+            // exclusive prefix sum of counts: totals of blocks of output elements, scan of the block totals, and
+            // local scan of each block
+            array_1d<index_t> offsets = array_1d<index_t>::from_shape({(size_t) (size + 1)});
+            index_t num_blocks = (size + parallel_chunk_size - 1) / parallel_chunk_size;
+            std::vector<index_t> block_offsets(num_blocks + 1, 0);
+            parfor(0, num_blocks, [&](index_t b) {
+                index_t end = (std::min)((b + 1) * parallel_chunk_size, size) * num_input_chunks;
+                index_t total = 0;
+                for (index_t k = b * parallel_chunk_size * num_input_chunks; k < end; k++) {
+                    total += counts[k];
+                }
+                block_offsets[b + 1] = total;
+            });
+            for (index_t b = 0; b < num_blocks; b++) {
+                block_offsets[b + 1] += block_offsets[b];
+            }
+            parfor(0, num_blocks, [&](index_t b) {
+                index_t end = (std::min)((b + 1) * parallel_chunk_size, size);
+                index_t num_sorted = block_offsets[b];
+                for (index_t i = b * parallel_chunk_size; i < end; i++) {
+                    offsets(i) = num_sorted;
+                    for (index_t c = 0; c < num_input_chunks; c++) {
+                        auto count = counts[i * num_input_chunks + c];
+                        counts[i * num_input_chunks + c] = num_sorted;
+                        num_sorted += count;
+                    }
+                }
+            });
+            index_t num_sorted = block_offsets[num_blocks];
+            offsets(size) = num_sorted;
+
+            array_1d<index_t> sorted = array_1d<index_t>::from_shape({(size_t) num_sorted});
+            parfor(0, num_input_chunks, [&](index_t c) {
+                index_t end = (std::min)((c + 1) * input_chunk_size, map_size);
+                for (index_t j = c * input_chunk_size; j < end; j++) {
+                    if (indices_data[j] != invalid_index) {
+                        sorted(counts[indices_data[j] * num_input_chunks + c]++) = j;
+                    }
+                }
+            });
+
+            std::vector<index_t> chunk_bounds;
+            for (index_t i = 0; i < size; i += parallel_chunk_size) {
+                chunk_bounds.push_back(i);
+            }
+            for (index_t p = parallel_chunk_size; p < num_sorted; p += parallel_chunk_size) {
+                chunk_bounds.push_back(indices_data[sorted(p)]);
+            }
+            chunk_bounds.push_back(size);
+            std::sort(chunk_bounds.begin(), chunk_bounds.end());
+            chunk_bounds.erase(std::unique(chunk_bounds.begin(), chunk_bounds.end()), chunk_bounds.end());
+
+            parfor(0, (index_t) chunk_bounds.size() - 1, [&](index_t c) {
+                auto input_view = make_light_axis_view<vectorial>(weights);
+                auto output_view = make_light_axis_view<vectorial>(res);
+                auto acc = accumulator.template make_accumulator<vectorial>(output_view);
+
+                for (index_t i = chunk_bounds[c]; i < chunk_bounds[c + 1]; i++) {
+                    output_view.set_position(i);
+                    acc.set_storage(output_view);
+                    acc.initialize();
+                    for (index_t p = offsets(i); p < offsets(i + 1); p++) {
+                        input_view.set_position(sorted(p));
+                        acc.accumulate(input_view.begin());
+                    }
+                    acc.finalize();
+                }
+            });
+
+            return res;
+        }
+
+        template<bool vectorial, typename T, typename accumulator_t, typename output_t>
+        auto at_accumulate_dispatch(const array_1d<index_t> &indices,
+                                    const xt::xexpression<T> &xweights,
+                                    const accumulator_t &accumulator) {
+            if (accumulator_detail::use_multi_threaded_engine(indices.size())) {
+#ifdef HG_USE_TBB
+                index_t num_input_chunks = tbb::this_task_arena::max_concurrency();
+#else
+                index_t num_input_chunks = 1;
+#endif
+                return at_accumulate_sorted<vectorial, T, accumulator_t, output_t>(indices, xweights, accumulator,
+                                                                                   num_input_chunks);
+            }
+            return at_accumulate<vectorial, T, accumulator_t, output_t>(indices, xweights, accumulator);
+        }
     }
 
     /**
@@ -86,13 +230,13 @@ namespace hg {
                        const xt::xexpression<T> &xweights,
                        const accumulator_t &accumulator) {
         if (xweights.derived_cast().dimension() == 1) {
-            return at_accumulator_internal::at_accumulate<false, T, accumulator_t, output_t>(indices,
-                                                                                             xweights,
-                                                                                             accumulator);
+            return at_accumulator_internal::at_accumulate_dispatch<false, T, accumulator_t, output_t>(indices,
+                                                                                                      xweights,
+                                                                                                      accumulator);
         } else {
-            return at_accumulator_internal::at_accumulate<true, T, accumulator_t, output_t>(indices,
-                                                                                            xweights,
-                                                                                            accumulator);
+            return at_accumulator_internal::at_accumulate_dispatch<true, T, accumulator_t, output_t>(indices,
+                                                                                                     xweights,
+                                                                                                     accumulator);
         }
     };
 
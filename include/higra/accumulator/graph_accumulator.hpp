@@ -37,19 +37,23 @@ namespace hg {
 
             array_nd<output_t> output = array_nd<output_t>::from_shape(output_shape);
 
-            auto input_view = make_light_axis_view<vectorial>(input);
-            auto output_view = make_light_axis_view<vectorial>(output);
-            auto acc = accumulator.template make_accumulator<vectorial>(output_view);
-
-            for (auto i: vertex_iterator(graph)) {
-                output_view.set_position(i);
-                acc.set_storage(output_view);
-                acc.initialize();
-                for (auto e: out_edge_iterator(i, graph)) {
-                    input_view.set_position(e);
-                    acc.accumulate(input_view.begin());
+            // vertices are independent
+            accumulator_detail::parfor_chunks(num_vertices(graph), [&](index_t begin, index_t end) {
+                auto input_view = make_light_axis_view<vectorial>(input);
+                auto output_view = make_light_axis_view<vectorial>(output);
+                auto acc = accumulator.template make_accumulator<vectorial>(output_view);
+
+                for (index_t i = begin; i < end; i++) {
+                    output_view.set_position(i);
+                    acc.set_storage(output_view);
+                    acc.initialize();
+                    for (auto e: out_edge_iterator(i, graph)) {
+                        input_view.set_position(e);
+                        acc.accumulate(input_view.begin());
+                    }
+                    acc.finalize();
                 }
-            }
+            });
 
             return output;
         };
@@ -72,19 +76,23 @@ namespace hg {
 
             array_nd<output_t> output = array_nd<output_t>::from_shape(output_shape);
 
-            auto input_view = make_light_axis_view<vectorial>(input);
-            auto output_view = make_light_axis_view<vectorial>(output);
-            auto acc = accumulator.template make_accumulator<vectorial>(output_view);
-
-            for (auto i: vertex_iterator(graph)) {
-                output_view.set_position(i);
-                acc.set_storage(output_view);
-                acc.initialize();
-                for (auto v: adjacent_vertex_iterator(i, graph)) {
-                    input_view.set_position(v);
-                    acc.accumulate(input_view.begin());
+            // vertices are independent
+            accumulator_detail::parfor_chunks(num_vertices(graph), [&](index_t begin, index_t end) {
+                auto input_view = make_light_axis_view<vectorial>(input);
+                auto output_view = make_light_axis_view<vectorial>(output);
+                auto acc = accumulator.template make_accumulator<vectorial>(output_view);
+
+                for (index_t i = begin; i < end; i++) {
+                    output_view.set_position(i);
+                    acc.set_storage(output_view);
+                    acc.initialize();
+                    for (auto v: adjacent_vertex_iterator(i, graph)) {
+                        input_view.set_position(v);
+                        acc.accumulate(input_view.begin());
+                    }
+                    acc.finalize();
                 }
-            }
+            });
 
             return output;
         };
@@ -13,6 +13,7 @@
 #include "../graph.hpp"
 #include "accumulator.hpp"
 #include "../structure/details/light_axis_view.hpp"
+#include <numeric>
 
 namespace hg {
 
@@ -470,6 +471,503 @@ namespace hg {
             return output;
         };
 
+
+        using accumulator_detail::parallel_chunk_size;
+        using accumulator_detail::parallel_min_size;
+        using accumulator_detail::parfor_chunks;
+
+        template<typename tree_t>
+        bool use_multi_threaded_engine(const tree_t &tree) {
+            return accumulator_detail::use_multi_threaded_engine(num_vertices(tree));
+        }
+
+        /**
+         * Multi-threaded accumulate_parallel: nodes are independent.
+         */
+        template<bool vectorial,
+                typename tree_t,
+                typename T,
+                typename accumulator_t,
+                typename output_t = typename T::value_type>
+        auto accumulate_parallel_multi_threaded_impl(const tree_t &tree,
+                                                     const xt::xexpression<T> &xinput,
+                                                     const accumulator_t accumulator) {
+            HG_TRACE();
+            auto &input = xinput.derived_cast();
+            hg_assert_node_weights(tree, input);
+
+            auto data_shape = std::vector<size_t>(input.shape().begin() + 1, input.shape().end());
+            auto output_shape = accumulator_t::get_output_shape(data_shape);
+            output_shape.insert(output_shape.begin(), num_vertices(tree));
+
+            array_nd <output_t> output = array_nd<output_t>::from_shape(output_shape);
+
+            tree.compute_children();
+            index_t numl = num_leaves(tree);
+
+            parfor_chunks(num_vertices(tree), [&](index_t begin, index_t end) {
+                auto input_view = make_light_axis_view<vectorial>(input);
+                auto output_view = make_light_axis_view<vectorial>(output);
+                auto acc = accumulator.template make_accumulator<vectorial>(output_view);
+                for (index_t i = begin; i < end; i++) {
+                    output_view.set_position(i);
+                    acc.set_storage(output_view);
+                    acc.initialize();
+                    if (i >= numl) {
+                        for (auto c : children_iterator(i, tree)) {
+                            input_view.set_position(c);
+                            acc.accumulate(input_view.begin());
+                        }
+                    }
+                    acc.finalize();
+                }
+            });
+
+            return output;
+        };
+
+        /**
+         * Multi-threaded accumulate_sequential: the levels of the height schedule of the tree are processed in
+         * increasing order, the nodes of a level are independent.
+         */
+        template<bool vectorial,
+                typename tree_t,
+                typename T,
+                typename accumulator_t,
+                typename output_t = typename T::value_type>
+        auto accumulate_sequential_multi_threaded_impl(const tree_t &tree,
+                                                       const xt::xexpression<T> &xvertex_data,
+                                                       const accumulator_t &accumulator) {
+            HG_TRACE();
+            auto &vertex_data = xvertex_data.derived_cast();
+            hg_assert_leaf_weights(tree, vertex_data);
+
+            auto data_shape = std::vector<size_t>(vertex_data.shape().begin() + 1, vertex_data.shape().end());
+            auto output_shape = accumulator_t::get_output_shape(data_shape);
+            output_shape.insert(output_shape.begin(), num_vertices(tree));
+
+            array_nd <output_t> output = array_nd<output_t>::from_shape(output_shape);
+
+            parfor_chunks(num_leaves(tree), [&](index_t begin, index_t end) {
+                auto vertex_data_view = make_light_axis_view<vectorial>(vertex_data);
+                auto output_view = make_light_axis_view<vectorial>(output);
+                for (index_t i = begin; i < end; i++) {
+                    output_view.set_position(i);
+                    vertex_data_view.set_position(i);
+                    output_view = vertex_data_view;
+                }
+            });
+
+            tree.compute_children();
+            auto &schedule = tree.height_schedule();
+
+            for (index_t l = 0; l < schedule.num_levels(); l++) {
+                auto nodes = schedule.level_begin(l);
+                parfor_chunks(schedule.level_size(l), [&](index_t begin, index_t end) {
+                    auto input_view = make_light_axis_view<vectorial>(output);
+                    auto output_view = make_light_axis_view<vectorial>(output);
+                    auto acc = accumulator.template make_accumulator<vectorial>(output_view);
+                    for (index_t k = begin; k < end; k++) {
+                        auto i = nodes[k];
+                        output_view.set_position(i);
+                        acc.set_storage(output_view);
+                        acc.initialize();
+                        for (auto c : children_iterator(i, tree)) {
+                            input_view.set_position(c);
+                            acc.accumulate(input_view.begin());
+                        }
+                        acc.finalize();
+                    }
+                });
+            }
+
+            return output;
+        };
+
+        /**
+         * Multi-threaded propagate_parallel: nodes are independent.
+         */
+        template<bool vectorial,
+                typename tree_t,
+                typename T1,
+                typename output_t = typename T1::value_type>
+        auto propagate_parallel_multi_threaded_impl(const tree_t &tree,
+                                                    const xt::xexpression<T1> &xinput) {
+            HG_TRACE();
+            auto &input = xinput.derived_cast();
+            hg_assert_node_weights(tree, input);
+
+            array_nd <output_t> output = array_nd<output_t>::from_shape(input.shape());
+
+            auto aparents = parents(tree).linear_begin();
+
+            parfor_chunks(num_vertices(tree), [&](index_t begin, index_t end) {
+                auto input_view = make_light_axis_view<vectorial>(input);
+                auto output_view = make_light_axis_view<vectorial>(output);
+                for (index_t i = begin; i < end; i++) {
+                    input_view.set_position(aparents[i]);
+                    output_view.set_position(i);
+                    output_view = input_view;
+                }
+            });
+            return output;
+        };
+
+        template<bool vectorial,
+                typename tree_t,
+                typename T1,
+                typename T2,
+                typename output_t = typename T1::value_type>
+        auto propagate_parallel_multi_threaded_impl(const tree_t &tree,
+                                                    const xt::xexpression<T1> &xinput,
+                                                    const xt::xexpression<T2> &xcondition) {
+            HG_TRACE();
+            auto &input = xinput.derived_cast();
+            auto &condition = xcondition.derived_cast();
+            hg_assert_node_weights(tree, input);
+            hg_assert_node_weights(tree, condition);
+
+            array_nd <output_t> output = array_nd<output_t>::from_shape(input.shape());
+
+            auto aparents = parents(tree).linear_begin();
+
+            parfor_chunks(num_vertices(tree), [&](index_t begin, index_t end) {
+                auto input_view = make_light_axis_view<vectorial>(input);
+                auto output_view = make_light_axis_view<vectorial>(output);
+                for (index_t i = begin; i < end; i++) {
+                    input_view.set_position(condition(i) ? aparents[i] : i);
+                    output_view.set_position(i);
+                    output_view = input_view;
+                }
+            });
+            return output;
+        };
+
+        /**
+         * Multi-threaded propagate_sequential: the levels of the depth schedule of the tree are processed in
+         * increasing order, the nodes of a level are independent.
+         */
+        template<bool vectorial,
+                typename tree_t,
+                typename T1,
+                typename T2,
+                typename output_t = typename T1::value_type>
+        auto propagate_sequential_multi_threaded_impl(const tree_t &tree,
+                                                      const xt::xexpression<T1> &xinput,
+                                                      const xt::xexpression<T2> &xcondition) {
+            HG_TRACE();
+            auto &input = xinput.derived_cast();
+            auto &condition = xcondition.derived_cast();
+            hg_assert_node_weights(tree, input);
+            hg_assert_node_weights(tree, condition);
+            hg_assert_1d_array(condition);
+
+            array_nd <output_t> output = array_nd<output_t>::from_shape(input.shape());
+
+            auto aparents = parents(tree).linear_begin();
+            auto &schedule = tree.depth_schedule();
+
+            // root cannot be deleted: level 0 only contains the root
+            for (index_t l = 0; l < schedule.num_levels(); l++) {
+                auto nodes = schedule.level_begin(l);
+                parfor_chunks(schedule.level_size(l), [&](index_t begin, index_t end) {
+                    auto input_view = make_light_axis_view<vectorial>(input);
+                    auto output_view = make_light_axis_view<vectorial>(output);
+                    auto inout_view = make_light_axis_view<vectorial>(output);
+                    for (index_t k = begin; k < end; k++) {
+                        auto i = nodes[k];
+                        output_view.set_position(i);
+                        if (l > 0 && condition(i)) {
+                            inout_view.set_position(aparents[i]);
+                            output_view = inout_view;
+                        } else {
+                            input_view.set_position(i);
+                            output_view = input_view;
+                        }
+                    }
+                });
+            }
+            return output;
+        };
+
+        /**
+         * Pointer to the elements of the given array in row major order: no copy is made if the array is
+         * already contiguous and row major.
+         */
+        template<typename T>
+        const typename T::value_type *contiguous_input_data(const T &array,
+                                                            array_1d<typename T::value_type> &storage,
+                                                            std::true_type) {
+            if (array.is_contiguous() && array.layout() == xt::layout_type::row_major) {
+                return array.data() + array.data_offset();
+            }
+            storage = xt::flatten(array);
+            return storage.data();
+        }
+
+        template<typename T>
+        const typename T::value_type *contiguous_input_data(const T &array,
+                                                            array_1d<typename T::value_type> &storage,
+                                                            std::false_type) {
+            storage = xt::flatten(array);
+            return storage.data();
+        }
+
+        /**
+         * Minimal view over the rows of a contiguous row major buffer
+         */
+        template<typename value_t>
+        struct pointer_axis_view {
+            using value_type = value_t;
+
+            pointer_axis_view() :
+                    m_data(nullptr),
+                    m_stride(0),
+                    m_position(0) {
+            }
+
+            pointer_axis_view(value_t *data, size_t stride) :
+                    m_data(data),
+                    m_stride(stride),
+                    m_position(0) {
+            }
+
+            void set_position(index_t i) {
+                m_position = i;
+            }
+
+            value_t *begin() const {
+                return m_data + m_position * m_stride;
+            }
+
+            value_t *end() const {
+                return begin() + m_stride;
+            }
+
+            value_t *row(index_t i) const {
+                return m_data + i * m_stride;
+            }
+
+        private:
+            value_t *m_data;
+            size_t m_stride;
+            index_t m_position;
+        };
+
+        /**
+         * Evaluates all the enabled accumulators of a composite accumulator on the nodes of a tree: the tree is
+         * traversed once and each node is processed by all the enabled accumulators in a row, while its children
+         * are in cache. The enabled accumulators are selected once per worker, through a table of member functions.
+         *
+         * If sequential is true, the input of each accumulator is its own output (leaves are initialized with
+         * the input data) as in accumulate_sequential, otherwise all the accumulators read the same input as in
+         * accumulate_parallel.
+         *
+         * Input and outputs are accessed through raw pointers: xtensor iterators are not reliably inlined once
+         * several accumulators share the loop body.
+         *
+         * A worker holds its own views and accumulator states: several workers can process disjoint sets of
+         * nodes concurrently.
+         */
+        template<bool vectorial, bool sequential, typename tree_t, typename input_value_t, typename output_t,
+                typename composite_t>
+        struct accumulate_composite_worker {
+
+            static const std::size_t N = composite_t::size;
+            using view_t = pointer_axis_view<output_t>;
+            using input_view_t = pointer_axis_view<const input_value_t>;
+
+            template<std::size_t... I>
+            static auto make_accumulators(const composite_t &composite,
+                                          std::array<view_t, N> &views,
+                                          std::index_sequence<I...>) {
+                return std::make_tuple(composite.template get<I>().template make_accumulator<vectorial>(views[I])...);
+            }
+
+            using accumulators_t = decltype(make_accumulators(std::declval<const composite_t &>(),
+                                                              std::declval<std::array<view_t, N> &>(),
+                                                              std::make_index_sequence<N>()));
+
+            accumulate_composite_worker(const tree_t &tree,
+                                        const input_value_t *input,
+                                        size_t input_stride,
+                                        std::array<array_nd<output_t>, N> &outputs,
+                                        const composite_t &composite) :
+                    m_tree(tree),
+                    m_input_view(input, input_stride),
+                    m_output_views(make_views(outputs)),
+                    m_accumulators(make_accumulators(composite, m_output_views, std::make_index_sequence<N>())) {
+                init_processors(composite, std::make_index_sequence<N>());
+            }
+
+            void process_leaf(index_t i) {
+                m_input_view.set_position(i);
+                for (std::size_t k = 0; k < m_num_enabled; k++) {
+                    (this->*m_leaf_processors[k])(i);
+                }
+            }
+
+            void process_node(index_t i) {
+                for (std::size_t k = 0; k < m_num_enabled; k++) {
+                    (this->*m_node_processors[k])(i);
+                }
+            }
+
+        private:
+
+            using processor_t = void (accumulate_composite_worker::*)(index_t);
+
+            template<std::size_t K>
+            void process_leaf_k(index_t i) {
+                auto &output_view = m_output_views[K];
+                output_view.set_position(i);
+                if (sequential) {
+                    if (vectorial) {
+                        std::copy_n(m_input_view.begin(), output_view.end() - output_view.begin(),
+                                    output_view.begin());
+                    } else {
+                        *output_view.begin() = *m_input_view.begin();
+                    }
+                } else {
+                    auto &acc = std::get<K>(m_accumulators);
+                    acc.set_storage(output_view);
+                    acc.initialize();
+                    acc.finalize();
+                }
+            }
+
+            template<std::size_t K>
+            void process_node_k(index_t i) {
+                auto &acc = std::get<K>(m_accumulators);
+                m_output_views[K].set_position(i);
+                acc.set_storage(m_output_views[K]);
+                acc.initialize();
+                for (auto c : children_iterator(i, m_tree)) {
+                    if (sequential) {
+                        acc.accumulate(m_output_views[K].row(c));
+                    } else {
+                        acc.accumulate(m_input_view.row(c));
+                    }
+                }
+                acc.finalize();
+            }
+
+            template<std::size_t... I>
+            void init_processors(const composite_t &composite, std::index_sequence<I...>) {
+                const processor_t leaf_processors[] = {&accumulate_composite_worker::process_leaf_k<I>...};
+                const processor_t node_processors[] = {&accumulate_composite_worker::process_node_k<I>...};
+                m_num_enabled = 0;
+                for (std::size_t k = 0; k < N; k++) {
+                    if (composite.enabled(k)) {
+                        m_leaf_processors[m_num_enabled] = leaf_processors[k];
+                        m_node_processors[m_num_enabled] = node_processors[k];
+                        m_num_enabled++;
+                    }
+                }
+            }
+
+            static std::array<view_t, N> make_views(std::array<array_nd<output_t>, N> &outputs) {
+                std::array<view_t, N> views;
+                for (std::size_t k = 0; k < N; k++) {
+                    // the output of a disabled accumulator is empty: its stride is computed from its shape
+                    auto &shape = outputs[k].shape();
+                    size_t stride = vectorial ? std::accumulate(shape.begin() + 1, shape.end(), (size_t) 1,
+                                                                std::multiplies<size_t>()) : 1;
+                    views[k] = view_t(outputs[k].data(), stride);
+                }
+                return views;
+            }
+
+            const tree_t &m_tree;
+            input_view_t m_input_view;
+            std::array<view_t, N> m_output_views;
+            accumulators_t m_accumulators;
+            // evaluation functions of the enabled accumulators only: disabled ones cost nothing per node
+            std::array<processor_t, N> m_leaf_processors;
+            std::array<processor_t, N> m_node_processors;
+            std::size_t m_num_enabled;
+        };
+
+        template<bool vectorial,
+                bool sequential,
+                typename tree_t,
+                typename T,
+                typename... accumulators_t,
+                typename output_t = typename T::value_type>
+        auto accumulate_composite_impl(const tree_t &tree,
+                                       const xt::xexpression<T> &xinput,
+                                       const accumulator_composite<accumulators_t...> &composite,
+                                       bool multi_threaded) {
+            HG_TRACE();
+            using composite_t = accumulator_composite<accumulators_t...>;
+            constexpr std::size_t N = composite_t::size;
+            using input_value_t = typename T::value_type;
+            auto &input = xinput.derived_cast();
+            if (sequential) {
+                hg_assert_leaf_weights(tree, input);
+            } else {
+                hg_assert_node_weights(tree, input);
+            }
+            array_1d<input_value_t> input_storage;
+            const input_value_t *input_data = contiguous_input_data(
+                    input, input_storage, std::integral_constant<bool, xt::has_data_interface<T>::value>());
+            size_t input_stride = vectorial ? input.size() / input.shape()[0] : 1;
+
+            auto data_shape = std::vector<size_t>(input.shape().begin() + 1, input.shape().end());
+
+            std::array<array_nd<output_t>, N> outputs;
+            accumulator_detail::static_for<N>([&](auto k) {
+                constexpr std::size_t K = decltype(k)::value;
+                using accumulator_t = std::decay_t<decltype(composite.template get<K>())>;
+                auto output_shape = accumulator_t::get_output_shape(data_shape);
+                // disabled accumulators are never evaluated and get an empty output
+                output_shape.insert(output_shape.begin(), composite.enabled(K) ? num_vertices(tree) : 0);
+                outputs[K] = array_nd<output_t>::from_shape(output_shape);
+            });
+
+            tree.compute_children();
+            using worker_t = accumulate_composite_worker<vectorial, sequential, tree_t, input_value_t, output_t,
+                    composite_t>;
+            index_t numl = num_leaves(tree);
+
+            if (multi_threaded) {
+                parfor_chunks(numl, [&](index_t begin, index_t end) {
+                    worker_t worker(tree, input_data, input_stride, outputs, composite);
+                    for (index_t i = begin; i < end; i++) {
+                        worker.process_leaf(i);
+                    }
+                });
+                if (sequential) {
+                    auto &schedule = tree.height_schedule();
+                    for (index_t l = 0; l < schedule.num_levels(); l++) {
+                        auto nodes = schedule.level_begin(l);
+                        parfor_chunks(schedule.level_size(l), [&](index_t begin, index_t end) {
+                            worker_t worker(tree, input_data, input_stride, outputs, composite);
+                            for (index_t k = begin; k < end; k++) {
+                                worker.process_node(nodes[k]);
+                            }
+                        });
+                    }
+                } else {
+                    parfor_chunks(num_vertices(tree) - numl, [&](index_t begin, index_t end) {
+                        worker_t worker(tree, input_data, input_stride, outputs, composite);
+                        for (index_t i = begin; i < end; i++) {
+                            worker.process_node(numl + i);
+                        }
+                    });
+                }
+            } else {
+                worker_t worker(tree, input_data, input_stride, outputs, composite);
+                for (auto i: leaves_iterator(tree)) {
+                    worker.process_leaf(i);
+                }
+                for (auto i : leaves_to_root_iterator(tree, leaves_it::exclude)) {
+                    worker.process_node(i);
+                }
+            }
+
+            return outputs;
+        };
     }
 
     template<typename tree_t, typename T, typename accumulator_t, typename output_t = typename T::value_type>
@@ -478,8 +976,16 @@ namespace hg {
                              const accumulator_t &accumulator) {
         auto &input = xinput.derived_cast();
         if (input.dimension() == 1) {
+            if (tree_accumulator_detail::use_multi_threaded_engine(tree)) {
+                return tree_accumulator_detail::accumulate_parallel_multi_threaded_impl<false>(tree, xinput,
+                                                                                               accumulator);
+            }
             return tree_accumulator_detail::accumulate_parallel_impl<false>(tree, xinput, accumulator);
         } else {
+            if (tree_accumulator_detail::use_multi_threaded_engine(tree)) {
+                return tree_accumulator_detail::accumulate_parallel_multi_threaded_impl<true>(tree, xinput,
+                                                                                              accumulator);
+            }
             return tree_accumulator_detail::accumulate_parallel_impl<true>(tree, xinput, accumulator);
         }
     };
@@ -492,12 +998,60 @@ namespace hg {
         auto &vertex_data = xvertex_data.derived_cast();
 
         if (vertex_data.dimension() == 1) {
+            if (tree_accumulator_detail::use_multi_threaded_engine(tree)) {
+                return tree_accumulator_detail::accumulate_sequential_multi_threaded_impl<false>(tree, xvertex_data,
+                                                                                                 accumulator);
+            }
             return tree_accumulator_detail::accumulate_sequential_impl<false>(tree, xvertex_data, accumulator);
         } else {
+            if (tree_accumulator_detail::use_multi_threaded_engine(tree)) {
+                return tree_accumulator_detail::accumulate_sequential_multi_threaded_impl<true>(tree, xvertex_data,
+                                                                                               accumulator);
+            }
             return tree_accumulator_detail::accumulate_sequential_impl<true>(tree, xvertex_data, accumulator);
         }
     };
 
+    /**
+     * Fused accumulate_parallel: evaluates all the accumulators of a composite accumulator
+     * (see make_accumulator_composite) in a single traversal of the tree.
+     *
+     * @return a std::array holding the output of each accumulator, in the order of the composite
+     */
+    template<typename tree_t, typename T, typename... accumulators_t>
+    auto accumulate_parallel(const tree_t &tree,
+                             const xt::xexpression<T> &xinput,
+                             const accumulator_composite<accumulators_t...> &accumulator) {
+        auto &input = xinput.derived_cast();
+        if (input.dimension() == 1) {
+            return tree_accumulator_detail::accumulate_composite_impl<false, false>(
+                    tree, xinput, accumulator, tree_accumulator_detail::use_multi_threaded_engine(tree));
+        } else {
+            return tree_accumulator_detail::accumulate_composite_impl<true, false>(
+                    tree, xinput, accumulator, tree_accumulator_detail::use_multi_threaded_engine(tree));
+        }
+    };
+
+    /**
+     * Fused accumulate_sequential: evaluates all the accumulators of a composite accumulator
+     * (see make_accumulator_composite) in a single traversal of the tree.
+     *
+     * @return a std::array holding the output of each accumulator, in the order of the composite
+     */
+    template<typename tree_t, typename T, typename... accumulators_t>
+    auto accumulate_sequential(const tree_t &tree,
+                               const xt::xexpression<T> &xvertex_data,
+                               const accumulator_composite<accumulators_t...> &accumulator) {
+        auto &vertex_data = xvertex_data.derived_cast();
+        if (vertex_data.dimension() == 1) {
+            return tree_accumulator_detail::accumulate_composite_impl<false, true>(
+                    tree, xvertex_data, accumulator, tree_accumulator_detail::use_multi_threaded_engine(tree));
+        } else {
+            return tree_accumulator_detail::accumulate_composite_impl<true, true>(
+                    tree, xvertex_data, accumulator, tree_accumulator_detail::use_multi_threaded_engine(tree));
+        }
+    };
+
     template<typename tree_t, typename T1, typename T2, typename accumulator_t, typename combination_fun_t, typename output_t = typename T1::value_type>
     auto accumulate_and_combine_sequential(const tree_t &tree,
                                            const xt::xexpression<T1> &xinput,
@@ -521,8 +1075,14 @@ namespace hg {
         auto &input = xinput.derived_cast();
 
         if (input.dimension() == 1) {
+            if (tree_accumulator_detail::use_multi_threaded_engine(tree)) {
+                return tree_accumulator_detail::propagate_parallel_multi_threaded_impl<false>(tree, xinput);
+            }
             return tree_accumulator_detail::propagate_parallel_impl<false>(tree, xinput);
         } else {
+            if (tree_accumulator_detail::use_multi_threaded_engine(tree)) {
+                return tree_accumulator_detail::propagate_parallel_multi_threaded_impl<true>(tree, xinput);
+            }
             return tree_accumulator_detail::propagate_parallel_impl<true>(tree, xinput);
         }
     };
@@ -534,8 +1094,14 @@ namespace hg {
         auto &input = xinput.derived_cast();
 
         if (input.dimension() == 1) {
+            if (tree_accumulator_detail::use_multi_threaded_engine(tree)) {
+                return tree_accumulator_detail::propagate_parallel_multi_threaded_impl<false>(tree, xinput, xcondition);
+            }
             return tree_accumulator_detail::propagate_parallel_impl<false>(tree, xinput, xcondition);
         } else {
+            if (tree_accumulator_detail::use_multi_threaded_engine(tree)) {
+                return tree_accumulator_detail::propagate_parallel_multi_threaded_impl<true>(tree, xinput, xcondition);
+            }
             return tree_accumulator_detail::propagate_parallel_impl<true>(tree, xinput, xcondition);
         }
     };
@@ -547,8 +1113,16 @@ namespace hg {
         auto &input = xinput.derived_cast();
 
         if (input.dimension() == 1) {
+            if (tree_accumulator_detail::use_multi_threaded_engine(tree)) {
+                return tree_accumulator_detail::propagate_sequential_multi_threaded_impl<false>(tree, xinput,
+                                                                                                xcondition);
+            }
             return tree_accumulator_detail::propagate_sequential_impl<false>(tree, xinput, xcondition);
         } else {
+            if (tree_accumulator_detail::use_multi_threaded_engine(tree)) {
+                return tree_accumulator_detail::propagate_sequential_multi_threaded_impl<true>(tree, xinput,
+                                                                                               xcondition);
+            }
             return tree_accumulator_detail::propagate_sequential_impl<true>(tree, xinput, xcondition);
         }
     };
@@ -12,6 +12,7 @@
 
 #include "../graph.hpp"
 #include "accumulator.hpp"
+#include "tree_accumulator.hpp"
 #include "../structure/details/light_axis_view.hpp"
 
 namespace hg {
@@ -44,45 +45,270 @@ namespace hg {
 
             array_nd<output_t> output = array_nd<output_t>::from_shape(output_shape);
 
-            auto input_view = make_light_axis_view<vectorial>(input);
-            auto output_view = make_light_axis_view<vectorial>(output);
-            auto acc = accumulator.template make_accumulator<vectorial>(output_view);
-
-            for (auto e: edge_iterator(graph)) {
-                auto n1 = source(e, graph);
-                auto n2 = target(e, graph);
-                auto i = index(e, graph);
-
-                output_view.set_position(i);
-                acc.set_storage(output_view);
-                acc.initialize();
-
-                while (n1 != n2) {
-                    auto dn1 = depth(n1);
-                    auto dn2 = depth(n2);
-                    auto new_n1 = n1;
-                    auto new_n2 = n2;
-                    if (dn1 >= dn2) {
-                        input_view.set_position(n1);
-                        acc.accumulate(input_view.begin());
-                        new_n1 = parent(n1, tree);
+            // edges are independent
+            tree_accumulator_detail::parfor_chunks(num_edges(graph), [&](index_t begin, index_t end) {
+                auto input_view = make_light_axis_view<vectorial>(input);
+                auto output_view = make_light_axis_view<vectorial>(output);
+                auto acc = accumulator.template make_accumulator<vectorial>(output_view);
+
+                for (index_t i = begin; i < end; i++) {
+                    const auto &e = edge_from_index(i, graph);
+                    index_t n1 = source(e, graph);
+                    index_t n2 = target(e, graph);
+
+                    output_view.set_position(i);
+                    acc.set_storage(output_view);
+                    acc.initialize();
+
+                    while (n1 != n2) {
+                        auto dn1 = depth(n1);
+                        auto dn2 = depth(n2);
+                        auto new_n1 = n1;
+                        auto new_n2 = n2;
+                        if (dn1 >= dn2) {
+                            input_view.set_position(n1);
+                            acc.accumulate(input_view.begin());
+                            new_n1 = parent(n1, tree);
+                        }
+                        if (dn2 >= dn1) {
+                            input_view.set_position(n2);
+                            acc.accumulate(input_view.begin());
+                            new_n2 = parent(n2, tree);
+                        }
+                        n1 = new_n1;
+                        n2 = new_n2;
                     }
-                    if (dn2 >= dn1) {
-                        input_view.set_position(n2);
+                    acc.finalize();
+                }
+            });
+
+            return output;
+        };
+
+        /**
+         * accumulate_on_contours for marginal accumulators (sum, min, max, prod), see
+         * accumulator_detail::is_marginal_accumulator.
+         *
+         * The tree is split into heavy paths (heavy-light decomposition): the heavy child of a node is its child
+         * with the largest subtree, and the nodes of a heavy path are stored at consecutive positions, the head
+         * (the highest node) of the path first. A path from a node to one of its ancestors crosses O(log(n))
+         * heavy paths: each heavy path, but the last one, is crossed from a node to its head, whose accumulated
+         * value is precomputed for every node, and the remaining part of the last heavy path is a range of
+         * consecutive positions accumulated with a segment tree in O(log(n)).
+         *
+         * The accumulated value of an edge {x, y} is thus computed in O(log(n)) and memory usage is linear.
+         */
+        template<bool vectorial,
+                typename graph_t,
+                typename tree_t,
+                typename T,
+                typename T2,
+                typename accumulator_t,
+                typename output_t = typename T::value_type>
+        auto accumulate_on_contours_heavy_path_impl(const graph_t &graph,
+                                                    const tree_t &tree,
+                                                    const xt::xexpression<T> &xinput,
+                                                    const xt::xexpression<T2> &xdetph,
+                                                    const accumulator_t accumulator) {
+            HG_TRACE();
+            auto &input = xinput.derived_cast();
+            hg_assert_node_weights(tree, input);
+            auto &depth = xdetph.derived_cast();
+            hg_assert_node_weights(tree, depth);
+            hg_assert_1d_array(depth);
+            hg_assert_integral_value_type(depth);
+
+            auto data_shape = std::vector<size_t>(input.shape().begin() + 1, input.shape().end());
+            auto output_shape = accumulator_t::get_output_shape(data_shape);
+            output_shape.insert(output_shape.begin(), num_edges(graph));
+
+            array_nd<output_t> output = array_nd<output_t>::from_shape(output_shape);
+
+            index_t num_nodes = num_vertices(tree);
+            index_t root = tree.root();
+            auto &parents = tree.parents();
+
+            // heavy-light decomposition, children have lower indices than their parent
+            std::vector<index_t> size(num_nodes, 1);
+            for (index_t n = 0; n < root; n++) {
+                size[parents(n)] += size[n];
+            }
+            std::vector<index_t> heavy_child(num_nodes, invalid_index);
+            for (index_t n = 0; n < root; n++) {
+                auto p = parents(n);
+                if (heavy_child[p] == invalid_index || size[n] > size[heavy_child[p]]) {
+                    heavy_child[p] = n;
+                }
+            }
+            // size: number of nodes of the heavy path below each node (the node included)
+            for (index_t n = 0; n < num_nodes; n++) {
+                size[n] = (heavy_child[n] == invalid_index) ? 1 : size[heavy_child[n]] + 1;
+            }
+            // for each node: head of its heavy path, depth and parent of this head, and position of the node
+            struct heavy_path_node {
+                index_t head;
+                index_t head_depth;
+                index_t head_parent;
+                index_t position;
+            };
+            std::vector<heavy_path_node> nodes(num_nodes);
+            nodes[root] = {root, (index_t) depth(root), invalid_index, 0};
+            index_t next_position = size[root];
+            for (index_t n = root - 1; n >= 0; n--) {
+                auto p = parents(n);
+                if (heavy_child[p] == n) {
+                    nodes[n] = nodes[p];
+                    nodes[n].position++;
+                } else {
+                    nodes[n] = {n, (index_t) depth(n), p, next_position};
+                    next_position += size[n];
+                }
+            }
+
+            auto buffer_shape = data_shape;
+            // segment tree: the value of the node at position i is stored in row num_nodes + i and row k > 0
+            // stores the accumulation of rows 2k and 2k + 1
+            buffer_shape.insert(buffer_shape.begin(), 2 * num_nodes);
+            array_nd<output_t> segment_tree = array_nd<output_t>::from_shape(buffer_shape);
+            // accumulation of the values from each node to the head of its heavy path
+            buffer_shape[0] = num_nodes;
+            array_nd<output_t> to_head = array_nd<output_t>::from_shape(buffer_shape);
+
+            {
+                auto input_view = make_light_axis_view<vectorial>(input);
+                auto segment_view = make_light_axis_view<vectorial>(segment_tree);
+                auto segment_child_view = make_light_axis_view<vectorial>(segment_tree);
+                auto to_head_view = make_light_axis_view<vectorial>(to_head);
+                auto to_head_parent_view = make_light_axis_view<vectorial>(to_head);
+
+                for (index_t n = 0; n < num_nodes; n++) {
+                    segment_view.set_position(num_nodes + nodes[n].position);
+                    input_view.set_position(n);
+                    segment_view = input_view;
+                }
+                auto acc = accumulator.template make_accumulator<vectorial>(segment_view);
+                for (index_t k = num_nodes - 1; k > 0; k--) {
+                    segment_view.set_position(k);
+                    acc.set_storage(segment_view);
+                    acc.initialize();
+                    segment_child_view.set_position(2 * k);
+                    acc.accumulate(segment_child_view.begin());
+                    segment_child_view.set_position(2 * k + 1);
+                    acc.accumulate(segment_child_view.begin());
+                    acc.finalize();
+                }
+
+                for (index_t n = root; n >= 0; n--) {
+                    to_head_view.set_position(n);
+                    input_view.set_position(n);
+                    if (nodes[n].head == n) {
+                        to_head_view = input_view;
+                    } else {
+                        acc.set_storage(to_head_view);
+                        acc.initialize();
                         acc.accumulate(input_view.begin());
-                        new_n2 = parent(n2, tree);
+                        to_head_parent_view.set_position(parents(n));
+                        acc.accumulate(to_head_parent_view.begin());
+                        acc.finalize();
                     }
-                    n1 = new_n1;
-                    n2 = new_n2;
                 }
-                acc.finalize();
             }
 
+            // edges are independent
+            tree_accumulator_detail::parfor_chunks(num_edges(graph), [&](index_t begin, index_t end) {
+                auto output_view = make_light_axis_view<vectorial>(output);
+                auto segment_view = make_light_axis_view<vectorial>(segment_tree);
+                auto to_head_view = make_light_axis_view<vectorial>(to_head);
+                auto acc = accumulator.template make_accumulator<vectorial>(output_view);
+
+                for (index_t i = begin; i < end; i++) {
+                    const auto &e = edge_from_index(i, graph);
+                    index_t n1 = source(e, graph);
+                    index_t n2 = target(e, graph);
+
+                    output_view.set_position(i);
+                    acc.set_storage(output_view);
+                    acc.initialize();
+
+                    // climb from the node whose heavy path head is the deepest
+                    const heavy_path_node *hn1 = &nodes[n1];
+                    const heavy_path_node *hn2 = &nodes[n2];
+                    while (hn1->head != hn2->head) {
+                        if (hn1->head_depth < hn2->head_depth) {
+                            std::swap(n1, n2);
+                            std::swap(hn1, hn2);
+                        }
+                        to_head_view.set_position(n1);
+                        acc.accumulate(to_head_view.begin());
+                        n1 = hn1->head_parent;
+                        hn1 = &nodes[n1];
+                    }
+
+                    // n1 and n2 are on the same heavy path, the highest one is the lowest common ancestor: accumulate
+                    // positions ]position(lca), position(other)]
+                    index_t first = (std::min)(hn1->position, hn2->position) + 1 + num_nodes;
+                    index_t last = (std::max)(hn1->position, hn2->position) + 1 + num_nodes;
+                    while (first < last) {
+                        if (first & 1) {
+                            segment_view.set_position(first++);
+                            acc.accumulate(segment_view.begin());
+                        }
+                        if (last & 1) {
+                            segment_view.set_position(--last);
+                            acc.accumulate(segment_view.begin());
+                        }
+                        first >>= 1;
+                        last >>= 1;
+                    }
+                    acc.finalize();
+                }
+            });
+
             return output;
         };
 
+        template<bool vectorial, typename graph_t, typename tree_t, typename T, typename T2, typename accumulator_t>
+        auto accumulate_on_contours_dispatch(const graph_t &graph,
+                                             const tree_t &tree,
+                                             const xt::xexpression<T> &xinput,
+                                             const xt::xexpression<T2> &xdetph,
+                                             const accumulator_t &accumulator,
+                                             std::true_type) {
+            // the walk from the extremities of an edge to their lowest common ancestor is faster than the
+            // heavy-light decomposition on shallow trees
+            auto &depth = xdetph.derived_cast();
+            index_t num_nodes = num_vertices(tree);
+            if (num_nodes > 1 && (double) xt::amax(depth)() > 4 * std::log2((double) num_nodes)) {
+                return accumulate_on_contours_heavy_path_impl<vectorial>(graph, tree, xinput, xdetph, accumulator);
+            }
+            return accumulate_on_contours_impl<vectorial>(graph, tree, xinput, xdetph, accumulator);
+        }
+
+        template<bool vectorial, typename graph_t, typename tree_t, typename T, typename T2, typename accumulator_t>
+        auto accumulate_on_contours_dispatch(const graph_t &graph,
+                                             const tree_t &tree,
+                                             const xt::xexpression<T> &xinput,
+                                             const xt::xexpression<T2> &xdetph,
+                                             const accumulator_t &accumulator,
+                                             std::false_type) {
+            return accumulate_on_contours_impl<vectorial>(graph, tree, xinput, xdetph, accumulator);
+        }
     }
 
+    /**
+     * For each edge {x, y} of the leaf graph, accumulates the weights of the nodes of the tree containing x or y but
+     * not both, i.e. the nodes on the paths from x and y to their lowest common ancestor (excluded).
+     *
+     * Edges are processed in parallel. Marginal accumulators (sum, min, max, prod) on deep trees use a heavy-light
+     * decomposition of the tree: each edge is then processed in O(log(n)) instead of O(depth).
+     *
+     * @param graph leaf graph of the tree
+     * @param tree input tree
+     * @param xinput node weights
+     * @param xdepth depth of the tree nodes
+     * @param accumulator accumulator
+     * @return edge weights of the leaf graph
+     */
     template<typename graph_t, typename tree_t, typename T, typename T1, typename accumulator_t, typename output_t = typename T::value_type>
     auto accumulate_on_contours(const graph_t &graph,
                                 const tree_t &tree,
@@ -91,18 +317,14 @@ namespace hg {
                                 const accumulator_t &accumulator) {
         auto &input = xinput.derived_cast();
         if (input.dimension() == 1) {
-            return tree_contour_accumulator_detail::accumulate_on_contours_impl<false>(graph,
-                                                                                       tree,
-                                                                                       xinput,
-                                                                                       xdepth,
-                                                                                       accumulator);
+            return tree_contour_accumulator_detail::accumulate_on_contours_dispatch<false>(
+                    graph, tree, xinput, xdepth, accumulator,
+                    accumulator_detail::is_marginal_accumulator<accumulator_t>());
         } else {
-            return tree_contour_accumulator_detail::accumulate_on_contours_impl<true>(graph,
-                                                                                      tree,
-                                                                                      xinput,
-                                                                                      xdepth,
-                                                                                      accumulator);
+            return tree_contour_accumulator_detail::accumulate_on_contours_dispatch<true>(
+                    graph, tree, xinput, xdepth, accumulator,
+                    accumulator_detail::is_marginal_accumulator<accumulator_t>());
         }
     };
 
-}
\ No newline at end of file
+}
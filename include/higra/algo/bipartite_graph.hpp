@@ -79,6 +79,7 @@ namespace hg {
      *
      * If the graph is not bipartite, the function returns a pair of a boolean set to false and an empty array.
      *
+     * @tparam uf_t union find implementation (see unionfind.hpp)
      * @tparam T type of the input arrays
      * @param xsources source vertices of the edges
      * @param xtargets target vertices of the edges
@@ -88,7 +89,7 @@ namespace hg {
      * If the graph is bipartite, the array contains the color of each vertex.
      * If the graph is not bipartite, the array is empty.
      */
-    template<typename T>
+    template<typename uf_t = union_find, typename T>
     std::pair<bool, array_1d<unsigned char>> is_bipartite_graph(const xt::xexpression<T> &xsources,
                                                          const xt::xexpression<T> &xtargets,
                                                          index_t num_vertices) {
@@ -100,7 +101,7 @@ namespace hg {
         hg_assert_integral_value_type(sources);
         hg_assert_integral_value_type(targets);
 
-        union_find uf(num_vertices);
+        uf_t uf(num_vertices);
         array_1d<index_t> map({(size_t) num_vertices}, invalid_index);
         array_1d<unsigned char> color({(size_t) num_vertices}, 0);
 
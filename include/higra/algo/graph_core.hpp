@@ -119,13 +119,15 @@ namespace hg {
      *
      * If the input graph is not connected, the result is indeed a minimum spanning forest.
      *
+     * @tparam uf_t union find implementation (see unionfind.hpp)
      * @tparam graph_t Input graph type
      * @tparam T Input edge weights type
      * @param graph Input graph
      * @param xedge_weights  Input edge weights
      * @return a mst structure
      */
-    template<typename graph_t,
+    template<typename uf_t = union_find,
+            typename graph_t,
             typename T>
     auto minimum_spanning_tree(const graph_t &graph,
                                const xt::xexpression<T> &xedge_weights) {
@@ -142,7 +144,7 @@ namespace hg {
         ugraph mst(num_points);
         array_1d<index_t> mst_edge_map = xt::empty<index_t>({num_edge_mst_max});
 
-        union_find uf(num_points);
+        uf_t uf(num_points);
 
         size_t num_edge_found = 0;
         index_t i = 0;
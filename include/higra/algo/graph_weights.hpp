@@ -13,6 +13,11 @@
 #include "../graph.hpp"
 #include "xtensor/xexpression.hpp"
 #include "../structure/details/light_axis_view.hpp"
+#include "../structure/regular_graph.hpp"
+
+#ifdef XTENSOR_USE_XSIMD
+#include "xtensor/xtensor_simd.hpp"
+#endif
 
 namespace hg {
 
@@ -251,4 +256,434 @@ namespace hg {
         }
         throw std::runtime_error("Unknown weight function.");
     };
+
+    namespace graph_weights_internal {
+
+#ifdef XTENSOR_USE_XSIMD
+        using xsimd::min;
+        using xsimd::max;
+        using xsimd::abs;
+        using xsimd::sqrt;
+        using xsimd::select;
+
+        template<typename T>
+        struct use_simd : public std::integral_constant<bool,
+                std::is_same<T, float>::value || std::is_same<T, double>::value> {
+        };
+
+        /**
+         * out[i] = f(a[i], b[i]) for i in [0, n), processed by blocks of xsimd batches
+         */
+        template<typename T, typename F>
+        void simd_transform(const T *a, const T *b, T *out, index_t n, const F &f, std::true_type) {
+            using batch_t = xsimd::batch<T>;
+            constexpr index_t step = batch_t::size;
+            index_t i = 0;
+            for (; i + step <= n; i += step) {
+                batch_t r = f(batch_t::load_unaligned(a + i), batch_t::load_unaligned(b + i));
+                r.store_unaligned(out + i);
+            }
+            for (; i < n; i++) {
+                out[i] = f(a[i], b[i]);
+            }
+        }
+
+        /**
+         * acc[i] = f(acc[i], a[i], b[i]) for i in [0, n), processed by blocks of xsimd batches
+         */
+        template<typename T, typename F>
+        void simd_accumulate(const T *a, const T *b, T *acc, index_t n, const F &f, std::true_type) {
+            using batch_t = xsimd::batch<T>;
+            constexpr index_t step = batch_t::size;
+            index_t i = 0;
+            for (; i + step <= n; i += step) {
+                batch_t r = f(batch_t::load_unaligned(acc + i),
+                              batch_t::load_unaligned(a + i),
+                              batch_t::load_unaligned(b + i));
+                r.store_unaligned(acc + i);
+            }
+            for (; i < n; i++) {
+                acc[i] = f(acc[i], a[i], b[i]);
+            }
+        }
+#else
+        using std::min;
+        using std::max;
+        using std::abs;
+        using std::sqrt;
+
+        template<typename T>
+        inline T select(bool cond, const T &true_value, const T &false_value) {
+            return cond ? true_value : false_value;
+        }
+
+        template<typename T>
+        struct use_simd : public std::false_type {
+        };
+#endif
+
+        template<typename T, typename F>
+        void simd_transform(const T *a, const T *b, T *out, index_t n, const F &f, std::false_type) {
+            for (index_t i = 0; i < n; i++) {
+                out[i] = f(a[i], b[i]);
+            }
+        }
+
+        template<typename T, typename F>
+        void simd_accumulate(const T *a, const T *b, T *acc, index_t n, const F &f, std::false_type) {
+            for (index_t i = 0; i < n; i++) {
+                acc[i] = f(acc[i], a[i], b[i]);
+            }
+        }
+
+        template<typename T, typename F>
+        void simd_transform(const T *a, const T *b, T *out, index_t n, const F &f) {
+            simd_transform(a, b, out, n, f, use_simd<T>());
+        }
+
+        template<typename T, typename F>
+        void simd_accumulate(const T *a, const T *b, T *acc, index_t n, const F &f) {
+            simd_accumulate(a, b, acc, n, f, use_simd<T>());
+        }
+
+        /**
+         * Pointer to the row major linearized content of the given array converted to value_t.
+         * No copy is made if the array is already contiguous, row major and of type value_t.
+         */
+        template<typename value_t, typename T>
+        const value_t *contiguous_data(const T &array, array_1d<value_t> &storage, std::true_type) {
+            if (array.is_contiguous() && array.layout() == xt::layout_type::row_major) {
+                return array.data() + array.data_offset();
+            }
+            storage = xt::flatten(array);
+            return storage.data();
+        }
+
+        template<typename value_t, typename T>
+        const value_t *contiguous_data(const T &array, array_1d<value_t> &storage, std::false_type) {
+            storage = xt::cast<value_t>(xt::flatten(array));
+            return storage.data();
+        }
+
+        template<typename value_t, typename T>
+        const value_t *contiguous_data(const T &array, array_1d<value_t> &storage) {
+            return contiguous_data(array, storage,
+                                   std::integral_constant<bool, xt::has_data_interface<T>::value &&
+                                                                std::is_same<typename T::value_type, value_t>::value>());
+        }
+
+        /**
+         * Channel planar version of the given vertex weights: the k-th channel of the vertex i is stored at
+         * position k * num_vertices + i.
+         */
+        template<typename value_t, typename T>
+        const value_t *planar_data(const T &vertex_weights,
+                                   index_t num_v,
+                                   index_t num_channels,
+                                   array_1d<value_t> &storage,
+                                   array_1d<value_t> &planar_storage) {
+            const value_t *data = contiguous_data(vertex_weights, storage);
+            if (num_channels == 1) {
+                return data;
+            }
+            planar_storage = array_1d<value_t>::from_shape({(size_t) (num_v * num_channels)});
+            value_t *planes = planar_storage.data();
+            for (index_t i = 0; i < num_v; i++) {
+                for (index_t k = 0; k < num_channels; k++) {
+                    planes[k * num_v + i] = data[i * num_channels + k];
+                }
+            }
+            return planes;
+        }
+
+        /**
+         * Weights the edges of an implicit regular graph.
+         *
+         * The vertices are processed row by row (a row is a line of the grid along its last axis). In a row, the
+         * edges associated to a same neighbour form a contiguous run of vertex pairs separated by a constant linear
+         * offset: the function compute(start, offset, n, out) must set out[i] to the weight of the pair of vertices
+         * (start + i, start + i + offset) for i in [0, n). The runs are then interleaved to produce the edge weights
+         * in the edge order of the graph copy_graph(graph).
+         */
+        template<typename result_value_t, typename kernel_value_t, typename embedding_t, typename compute_t>
+        auto weight_regular_graph(const regular_graph<embedding_t> &graph, const compute_t &compute) {
+            constexpr index_t dim = embedding_t::_dim;
+            const auto &shape = graph.embedding().shape();
+            const index_t num_v = num_vertices(graph);
+            if (num_v == 0) {
+                return array_1d<result_value_t>::from_shape({0});
+            }
+            const index_t width = shape[dim - 1];
+            const index_t num_rows = num_v / width;
+
+            // forward neighbours, i.e. with a positive linear offset, in the order of the neighbour list
+            std::vector<point<index_t, dim>> neighbours;
+            std::vector<index_t> offsets;
+            for (const auto &n: graph.neighbours()) {
+                index_t offset = 0;
+                for (index_t i = 0; i < dim; i++) {
+                    offset = offset * shape[i] + n[i];
+                }
+                if (offset > 0) {
+                    neighbours.push_back(n);
+                    offsets.push_back(offset);
+                }
+            }
+            const index_t num_neighbours = neighbours.size();
+
+            // range [lo, hi) of the positions in the given row having a valid k-th neighbour
+            auto row_ranges = [&shape, &neighbours, num_neighbours, width](index_t row, index_t *lo, index_t *hi) {
+                std::array<index_t, dim> coordinates;
+                for (index_t i = dim - 2; i >= 0; i--) {
+                    coordinates[i] = row % shape[i];
+                    row /= shape[i];
+                }
+                for (index_t k = 0; k < num_neighbours; k++) {
+                    const auto &n = neighbours[k];
+                    bool inside = true;
+                    for (index_t i = 0; i < dim - 1; i++) {
+                        index_t c = coordinates[i] + n[i];
+                        if (c < 0 || c >= shape[i]) {
+                            inside = false;
+                        }
+                    }
+                    lo[k] = (std::max)((index_t) 0, -n[dim - 1]);
+                    hi[k] = (inside) ? (std::max)(lo[k], (std::min)(width, width - n[dim - 1])) : lo[k];
+                }
+            };
+
+            array_1d<index_t> row_offsets = array_1d<index_t>::from_shape({(size_t) num_rows + 1});
+            {
+                std::vector<index_t> lo(num_neighbours);
+                std::vector<index_t> hi(num_neighbours);
+                row_offsets(0) = 0;
+                for (index_t r = 0; r < num_rows; r++) {
+                    row_ranges(r, lo.data(), hi.data());
+                    index_t num_row_edges = 0;
+                    for (index_t k = 0; k < num_neighbours; k++) {
+                        num_row_edges += hi[k] - lo[k];
+                    }
+                    row_offsets(r + 1) = row_offsets(r) + num_row_edges;
+                }
+            }
+
+            auto result = array_1d<result_value_t>::from_shape({(size_t) row_offsets(num_rows)});
+            result_value_t *out = result.data();
+
+            const index_t rows_per_chunk = (std::max)((index_t) 1, (index_t) (1 << 16) / width);
+            const index_t num_chunks = (num_rows + rows_per_chunk - 1) / rows_per_chunk;
+
+            parfor(0, num_chunks, [&](index_t chunk) {
+                std::vector<kernel_value_t> buffer(num_neighbours * width);
+                std::vector<index_t> lo(num_neighbours);
+                std::vector<index_t> hi(num_neighbours);
+                std::vector<const kernel_value_t *> runs;
+                std::vector<index_t> run_lo;
+                std::vector<index_t> run_hi;
+                const index_t row_end = (std::min)(num_rows, (chunk + 1) * rows_per_chunk);
+                for (index_t r = chunk * rows_per_chunk; r < row_end; r++) {
+                    row_ranges(r, lo.data(), hi.data());
+                    runs.clear();
+                    run_lo.clear();
+                    run_hi.clear();
+                    index_t inner_lo = 0;
+                    index_t inner_hi = width;
+                    for (index_t k = 0; k < num_neighbours; k++) {
+                        if (lo[k] < hi[k]) {
+                            kernel_value_t *run = buffer.data() + k * width;
+                            compute(r * width + lo[k], offsets[k], hi[k] - lo[k], run + lo[k]);
+                            runs.push_back(run);
+                            run_lo.push_back(lo[k]);
+                            run_hi.push_back(hi[k]);
+                            inner_lo = (std::max)(inner_lo, lo[k]);
+                            inner_hi = (std::min)(inner_hi, hi[k]);
+                        }
+                    }
+                    const index_t num_runs = runs.size();
+                    inner_hi = (std::max)(inner_lo, inner_hi);
+
+                    result_value_t *row_out = out + row_offsets(r);
+                    auto border = [&](index_t x) {
+                        for (index_t j = 0; j < num_runs; j++) {
+                            if (x >= run_lo[j] && x < run_hi[j]) {
+                                *(row_out++) = static_cast<result_value_t>(runs[j][x]);
+                            }
+                        }
+                    };
+                    for (index_t x = 0; x < inner_lo; x++) {
+                        border(x);
+                    }
+                    // every run is valid in [inner_lo, inner_hi)
+                    for (index_t x = inner_lo; x < inner_hi; x++) {
+                        for (index_t j = 0; j < num_runs; j++) {
+                            *(row_out++) = static_cast<result_value_t>(runs[j][x]);
+                        }
+                    }
+                    for (index_t x = inner_hi; x < width; x++) {
+                        border(x);
+                    }
+                }
+            });
+
+            return result;
+        }
+
+        template<typename result_value_t, typename promoted_type, typename embedding_t, typename T>
+        auto weight_regular_graph(const regular_graph<embedding_t> &graph,
+                                  const T &vertex_weights,
+                                  weight_functions weight) {
+            using value_type = typename T::value_type;
+            const index_t num_v = num_vertices(graph);
+            const index_t num_channels = (vertex_weights.dimension() > 1) ? vertex_weights.size() / num_v : 1;
+
+            // pairwise functions on scalar vertex weights
+            auto pairwise = [&graph, &vertex_weights, num_v](auto kernel_value, const auto &f) {
+                using kernel_value_t = decltype(kernel_value);
+                array_1d<kernel_value_t> storage;
+                const kernel_value_t *data = contiguous_data(vertex_weights, storage);
+                return weight_regular_graph<result_value_t, kernel_value_t>(
+                        graph,
+                        [data, &f](index_t start, index_t offset, index_t n, kernel_value_t *out) {
+                            simd_transform(data + start, data + start + offset, out, n, f);
+                        });
+            };
+
+            // channel wise accumulation (first, accumulate) then finalization of the result
+            auto reduce = [&graph, &vertex_weights, num_v, num_channels](auto kernel_value,
+                                                                         const auto &first,
+                                                                         const auto &accumulate,
+                                                                         auto finalize) {
+                using kernel_value_t = decltype(kernel_value);
+                array_1d<kernel_value_t> storage;
+                array_1d<kernel_value_t> planar_storage;
+                const kernel_value_t *planes = planar_data(vertex_weights, num_v, num_channels, storage,
+                                                           planar_storage);
+                return weight_regular_graph<result_value_t, kernel_value_t>(
+                        graph,
+                        [planes, num_v, num_channels, &first, &accumulate](index_t start,
+                                                                            index_t offset,
+                                                                            index_t n,
+                                                                            kernel_value_t *out) {
+                            simd_transform(planes + start, planes + start + offset, out, n, first);
+                            for (index_t k = 1; k < num_channels; k++) {
+                                const kernel_value_t *plane = planes + k * num_v + start;
+                                simd_accumulate(plane, plane + offset, out, n, accumulate);
+                            }
+                            if (decltype(finalize)::value) {
+                                simd_transform(out, out, out, n, [](const auto &a, const auto &) {
+                                    return sqrt(a);
+                                });
+                            }
+                        });
+            };
+
+            auto abs_diff = [](const auto &a, const auto &b) {
+                return abs(a - b);
+            };
+            auto squared_diff = [](const auto &a, const auto &b) {
+                auto d = a - b;
+                return d * d;
+            };
+            auto sum_abs_diff = [](const auto &acc, const auto &a, const auto &b) {
+                return acc + abs(a - b);
+            };
+            auto sum_squared_diff = [](const auto &acc, const auto &a, const auto &b) {
+                auto d = a - b;
+                return acc + d * d;
+            };
+
+            switch (weight) {
+                case weight_functions::mean: {
+                    hg_assert_1d_array(vertex_weights);
+                    return pairwise(promoted_type(), [](const auto &a, const auto &b) {
+                        using batch_t = std::decay_t<decltype(a)>;
+                        return (a + b) / batch_t(2);
+                    });
+                }
+                case weight_functions::min: {
+                    hg_assert_1d_array(vertex_weights);
+                    return pairwise(value_type(), [](const auto &a, const auto &b) {
+                        return (min)(a, b);
+                    });
+                }
+                case weight_functions::max: {
+                    hg_assert_1d_array(vertex_weights);
+                    return pairwise(value_type(), [](const auto &a, const auto &b) {
+                        return (max)(a, b);
+                    });
+                }
+                case weight_functions::L0: {
+                    return reduce(value_type(),
+                                  [](const auto &a, const auto &b) {
+                                      using batch_t = std::decay_t<decltype(a)>;
+                                      return select(a != b, batch_t(1), batch_t(0));
+                                  },
+                                  [](const auto &acc, const auto &a, const auto &b) {
+                                      using batch_t = std::decay_t<decltype(a)>;
+                                      return select(a != b, batch_t(1), acc);
+                                  },
+                                  std::false_type());
+                }
+                case weight_functions::L1:
+                    return reduce(promoted_type(), abs_diff, sum_abs_diff, std::false_type());
+                case weight_functions::L2:
+                    return reduce(promoted_type(), squared_diff, sum_squared_diff, std::true_type());
+                case weight_functions::L_infinity:
+                    return reduce(promoted_type(), abs_diff,
+                                  [](const auto &acc, const auto &a, const auto &b) {
+                                      return (max)(acc, abs(a - b));
+                                  },
+                                  std::false_type());
+                case weight_functions::L2_squared:
+                    return reduce(promoted_type(), squared_diff, sum_squared_diff, std::false_type());
+                case weight_functions::source: {
+                    hg_assert_1d_array(vertex_weights);
+                    return pairwise(value_type(), [](const auto &a, const auto &) {
+                        return a;
+                    });
+                }
+                case weight_functions::target: {
+                    hg_assert_1d_array(vertex_weights);
+                    return pairwise(value_type(), [](const auto &, const auto &b) {
+                        return b;
+                    });
+                }
+            }
+            throw std::runtime_error("Unknown weight function.");
+        }
+    }
+
+    /**
+     * Compute edge-weights of an implicit regular graph from the vertex-weights and a predefined weighting function
+     * (see weight_functions enum).
+     *
+     * A regular graph does not index its edges: the i-th value of the result is the weight of the i-th edge of
+     * the explicit graph copy_graph(graph). For example, the result obtained with get_4_adjacency_implicit_graph(embedding)
+     * is equal to the result of the generic function applied to get_4_adjacency_graph(embedding).
+     *
+     * Edges are processed row by row, as contiguous runs of pairs of vertices, with xsimd vectorized kernels
+     * (when XTENSOR_USE_XSIMD is defined).
+     *
+     * @tparam result_value_t The value type of the result
+     * @tparam promoted_type The value type used for internal computation
+     * @tparam embedding_t
+     * @tparam T
+     * @param graph
+     * @param xvertex_weights
+     * @param weight
+     * @return
+     */
+    template<typename result_value_t = double,
+            typename promoted_type = double,
+            typename embedding_t,
+            typename T>
+    auto weight_graph(const regular_graph<embedding_t> &graph,
+                      const xt::xexpression<T> &xvertex_weights,
+                      weight_functions weight) {
+        HG_TRACE();
+        const auto &vertex_weights = xvertex_weights.derived_cast();
+        hg_assert_vertex_weights(graph, vertex_weights);
+        return graph_weights_internal::weight_regular_graph<result_value_t, promoted_type>(graph, vertex_weights,
+                                                                                          weight);
+    };
 }
\ No newline at end of file
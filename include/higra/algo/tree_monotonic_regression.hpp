@@ -31,7 +31,7 @@ namespace hg {
         using heap_type = fibonacci_heap<heap_node>;
         using heap_element_type = heap_type::value_handle;
 
-        template<typename tree_t, typename T, typename Tw>
+        template<typename uf_t, typename tree_t, typename T, typename Tw>
         auto tree_monotonic_regression_least_square(const tree_t &tree, const xt::xexpression<T> &xaltitudes,
                                                     const xt::xexpression<Tw> &xweights) {
             auto &altitudes = xaltitudes.derived_cast();
@@ -58,7 +58,7 @@ namespace hg {
             auto node_average_weight = node_block_weighted_sum / node_block_total_weight;
 
             index_t num_v = num_vertices(tree);
-            union_find uf(num_v); // Block maintenance
+            uf_t uf(num_v); // Block maintenance
 
             /*
              * Main loop IRT_BIN
@@ -135,6 +135,7 @@ namespace hg {
      *     `'Algorithms for a Class of Isotonic Regression Problems.' <https://link.springer.com/article/10.1007/PL00009258>`_
      *     Algorithmica (1999) 23: 211. doi:10.1007/PL00009258
      *
+     * @tparam uf_t union find implementation used by the mode "least_square" (see unionfind.hpp)
      * @tparam tree_t
      * @tparam T
      * @tparam Tw
@@ -144,7 +145,7 @@ namespace hg {
      * @param mode "min", "max", or " least_square"
      * @return
      */
-    template<typename tree_t, typename T, typename Tw>
+    template<typename uf_t = union_find, typename tree_t, typename T, typename Tw>
     auto tree_monotonic_regression(const tree_t &tree, const xt::xexpression<T> &xaltitudes,
                                    const xt::xexpression<Tw> &xweights, const std::string &mode) {
         auto &altitudes = xaltitudes.derived_cast();
@@ -183,14 +184,14 @@ namespace hg {
             return propagate_sequential_and_accumulate(tree, altitudes, accumulator_min());
         } else if (mode == "least_square") {
             if (has_weights) {
-                return tree_monotonic_regression_internal::tree_monotonic_regression_least_square(tree, altitudes,
-                                                                                                  weights);
+                return tree_monotonic_regression_internal::tree_monotonic_regression_least_square<uf_t>(tree,
+                                                                                                        altitudes,
+                                                                                                        weights);
             } else {
-                return tree_monotonic_regression_internal::tree_monotonic_regression_least_square(tree,
-                                                                                                  altitudes,
-                                                                                                  xt::ones<double>(
-                                                                                                          {num_vertices(
-                                                                                                                  tree)}));
+                return tree_monotonic_regression_internal::tree_monotonic_regression_least_square<uf_t>(
+                        tree,
+                        altitudes,
+                        xt::ones<double>({num_vertices(tree)}));
             }
 
         } else {
@@ -198,8 +199,8 @@ namespace hg {
         }
     }
 
-    template<typename tree_t, typename T>
+    template<typename uf_t = union_find, typename tree_t, typename T>
     auto tree_monotonic_regression(const tree_t &tree, const xt::xexpression<T> &xaltitudes, const std::string &mode) {
-        return tree_monotonic_regression(tree, xaltitudes, array_1d<double>{}, mode);
+        return tree_monotonic_regression<uf_t>(tree, xaltitudes, array_1d<double>{}, mode);
     }
 }
@@ -13,12 +13,91 @@
 #include "../graph.hpp"
 #include "../attribute/tree_attribute.hpp"
 #include "../accumulator/tree_accumulator.hpp"
+#include <unordered_map>
 
 namespace hg {
 
     using namespace xt;
     using namespace xt::placeholders;
 
+    namespace dendrogram_purity_internal {
+
+        /**
+         * Sparse histogram of the labels of the leaves of a sub-tree
+         */
+        using label_histogram = std::unordered_map<index_t, index_t>;
+
+        /**
+         * Computes the histogram of a non leaf node i by merging the histograms of its children small into large:
+         * the histogram of the child with the largest histogram is reused and the other ones are merged into it
+         * and released.
+         *
+         * The number of pairs of leaves of class k whose lca is i is accumulated during the merge, as well as the
+         * sum of the purities of those pairs: they are stored in weights(i) and purities(i).
+         */
+        template<typename tree_t, typename T1, typename T2>
+        void merge_children_histograms(const tree_t &tree,
+                                       const T1 &leaf_labels,
+                                       const T2 &area,
+                                       index_t i,
+                                       std::vector<label_histogram> &histograms,
+                                       array_1d<double> &weights,
+                                       array_1d<double> &purities) {
+            auto histogram_size = [&tree, &histograms](index_t c) {
+                return is_leaf(c, tree) ? (size_t) 1 : histograms[c].size();
+            };
+
+            index_t largest = child(0, i, tree);
+            for (auto c: children_iterator(i, tree)) {
+                if (histogram_size(c) > histogram_size(largest)) {
+                    largest = c;
+                }
+            }
+
+            label_histogram histogram;
+            if (is_leaf(largest, tree)) {
+                histogram.emplace((index_t) leaf_labels(largest), 1);
+            } else {
+                std::swap(histogram, histograms[largest]);
+            }
+
+            label_histogram pairs;
+            auto merge = [&histogram, &pairs](index_t label, index_t count) {
+                auto it = histogram.find(label);
+                if (it == histogram.end()) {
+                    histogram.emplace(label, count);
+                } else {
+                    pairs[label] += it->second * count;
+                    it->second += count;
+                }
+            };
+
+            for (auto c: children_iterator(i, tree)) {
+                if (c == largest) {
+                    continue;
+                }
+                if (is_leaf(c, tree)) {
+                    merge((index_t) leaf_labels(c), 1);
+                } else {
+                    for (const auto &e: histograms[c]) {
+                        merge(e.first, e.second);
+                    }
+                    label_histogram().swap(histograms[c]);
+                }
+            }
+
+            double weight = 0;
+            double purity = 0;
+            for (const auto &e: pairs) {
+                weight += (double) e.second;
+                purity += (double) e.second * (double) histogram[e.first] / (double) area(i);
+            }
+            weights(i) = weight;
+            purities(i) = purity;
+            std::swap(histograms[i], histogram);
+        }
+    }
+
     /**
      * Weighted average of the purity of each node of the tree with respect to a ground truth
      * labelization of the tree leaves.
@@ -48,8 +127,11 @@ namespace hg {
      *
      * :Complexity:
      *
-     * The dendrogram purity is computed in :math:`\mathcal{O}(N\\times K \\times C^2)` with :math:`N` the number of nodes
-     * in the tree, :math:`K` the number of classes, and :math:`C` the maximal number of children of a node in the tree.
+     * The label histograms of the nodes are merged small into large while traversing the tree from the leaves to
+     * the root: the dendrogram purity is computed in :math:`\mathcal{O}(N\log(N))` expected time with :math:`N` the
+     * number of nodes in the tree, and the histograms alive at any time contain at most one entry per leaf.
+     * If Higra is compiled with TBB support, large trees are processed in parallel, one level of the height
+     * schedule of the tree at a time.
      *
      * @tparam tree_t
      * @tparam T
@@ -64,23 +146,36 @@ namespace hg {
         hg_assert_leaf_weights(tree, leaf_labels);
         hg_assert_integral_value_type(leaf_labels);
 
+        tree.compute_children();
+        auto num_v = num_vertices(tree);
         auto num_l = num_leaves(tree);
         auto area = attribute_area(tree);
 
-        auto max_label = xt::amax(leaf_labels)();
-        size_t num_labels = max_label + 1;
-        array_2d<double> label_histo_leaves = zeros<double>({num_l, num_labels});
-        for (index_t i = 0; i < (index_t) num_l; i++) {
-            label_histo_leaves(i, leaf_labels(i)) = 1;
-        }
+        std::vector<dendrogram_purity_internal::label_histogram> histograms(num_v);
+        array_1d<double> weights = xt::zeros<double>({num_v});
+        array_1d<double> purities = xt::zeros<double>({num_v});
 
-        auto label_histo = accumulate_sequential(tree, label_histo_leaves, accumulator_sum());
-        auto class_purity = label_histo / view(area, all(), newaxis());
+        if (tree_accumulator_detail::use_multi_threaded_engine(tree)) {
+            // nodes of a level of the height schedule have disjoint sub-trees
+            auto &schedule = tree.height_schedule();
+            for (index_t l = 0; l < schedule.num_levels(); l++) {
+                auto nodes = schedule.level_begin(l);
+                tree_accumulator_detail::parfor_chunks(schedule.level_size(l), [&](index_t begin, index_t end) {
+                    for (index_t k = begin; k < end; k++) {
+                        dendrogram_purity_internal::merge_children_histograms(
+                                tree, leaf_labels, area, nodes[k], histograms, weights, purities);
+                    }
+                });
+            }
+        } else {
+            for (auto i: leaves_to_root_iterator(tree, leaves_it::exclude)) {
+                dendrogram_purity_internal::merge_children_histograms(
+                        tree, leaf_labels, area, i, histograms, weights, purities);
+            }
+        }
 
-        auto weights = attribute_children_pair_sum_product(tree, label_histo);
-        double Z = sum(weights)();
-        double total = sum(view(class_purity, range(num_l, _), all()) *
-                           view(weights, range(num_l, _), all()))();
+        double Z = sum(view(weights, range(num_l, _)))();
+        double total = sum(view(purities, range(num_l, _)))();
 
         return total / Z;
     }
@@ -15,6 +15,7 @@
 #include "../algo/tree.hpp"
 #include "../algo/rag.hpp"
 #include "../algo/horizontal_cuts.hpp"
+#include "partition.hpp"
 #include <xtensor/xsort.hpp>
 
 namespace hg {
@@ -88,6 +89,23 @@ namespace hg {
             size_t back_track_k_right; // number of regions coming from right/second  child
         };
 
+        /**
+         * Sparse cardinals of the intersections between the regions of the tree nodes (rows) and the regions of
+         * the ground truth (columns).
+         *
+         * The rows of the leaves are obtained by sorting the (leaf, ground truth label) pairs, and the row of
+         * a non leaf node is obtained by summing the rows of its children in a dense scratch array of size
+         * num_regions_ground_truth and by sorting the non empty columns: the time complexity is
+         * O(m log(m) + num_regions_ground_truth) and the memory usage is O(m + num_regions_ground_truth), with m the
+         * number of non empty intersections.
+         *
+         * @tparam value_t type of the cardinals
+         * @param tree input tree
+         * @param xground_truth ground truth labelisation of the tree leaves (or of the rag vertices if vertex_map
+         * is not empty)
+         * @param vertex_map super-vertices map (if tree is built on a rag, leave empty otherwise)
+         * @return a sparse_card_intersection with num_vertices(tree) rows
+         */
         template<typename value_t=index_t, typename tree_t, typename T>
         auto compute_card_intersection_tree_ground_truth(
                 const tree_t &tree,
@@ -97,21 +115,46 @@ namespace hg {
             hg_assert_1d_array(ground_truth);
 
             auto num_regions_ground_truth = xt::amax(ground_truth)() + 1;
-            array_2d<index_t> card_intersection_leaves({num_leaves(tree), (size_t) num_regions_ground_truth}, 0);
+            sparse_card_intersection<value_t> card_intersection((size_t) num_regions_ground_truth);
             if (vertex_map.size() <= 1) { // no rag
                 hg_assert_leaf_weights(tree, ground_truth);
-                for (auto i: leaves_iterator(tree)) {
-                    card_intersection_leaves(i, ground_truth(i))++;
-                }
+                partition_internal::append_card_intersection_rows(card_intersection,
+                                                                  xt::arange<index_t>(num_leaves(tree)),
+                                                                  ground_truth,
+                                                                  num_leaves(tree));
             } else { // tree on rag
                 hg_assert(vertex_map.size() == ground_truth.size(), "Vertex map and ground truth sizes do not match.");
-                for (index_t i = 0; i < (index_t) vertex_map.size(); i++) {
-                    card_intersection_leaves(vertex_map(i), ground_truth(i))++;
-                }
+                partition_internal::append_card_intersection_rows(card_intersection,
+                                                                  vertex_map,
+                                                                  ground_truth,
+                                                                  num_leaves(tree));
             }
 
-            array_2d<value_t> card_intersection = accumulate_sequential(tree, card_intersection_leaves,
-                                                                        accumulator_sum());
+            tree.compute_children();
+            auto &columns = card_intersection.columns();
+            auto &values = card_intersection.values();
+            // the rows of the children are summed in a dense array indexed by ground truth region, the touched
+            // columns are then sorted: O(sum of the sizes of the children rows + t log(t)) for a row of size t
+            std::vector<value_t> dense_values((size_t) num_regions_ground_truth, 0);
+            std::vector<index_t> touched_columns;
+            for (auto i: leaves_to_root_iterator(tree, leaves_it::exclude)) {
+                touched_columns.clear();
+                for (auto c: children_iterator(i, tree)) {
+                    for (index_t k = card_intersection.row_begin(c); k < card_intersection.row_end(c); k++) {
+                        // stored intersection cardinals are positive
+                        if (dense_values[columns[k]] == 0) {
+                            touched_columns.push_back(columns[k]);
+                        }
+                        dense_values[columns[k]] += values[k];
+                    }
+                }
+                std::sort(touched_columns.begin(), touched_columns.end());
+                for (auto column: touched_columns) {
+                    card_intersection.push_back(column, dense_values[column]);
+                    dense_values[column] = 0;
+                }
+                card_intersection.end_row();
+            }
             return card_intersection;
         };
 
@@ -165,51 +208,27 @@ namespace hg {
 
             m_num_regions_ground_truth = xt::count_nonzero(region_gt_areas)();
 
-// TODO remove when xtensor MSVC witht he bug with xt::view(region_tree_area, xt::all(), xt::newaxis()) on 1d tensor
-#ifndef _MSC_VER
-            array_1d<index_t> region_tree_area;
-#else
-            array_nd<index_t> region_tree_area;
-#endif
-
             // for a tree node i, a gt region j: card_intersection(i, j) is the number of pixels in R_i cap R_j
-            array_2d<index_t> card_intersection_leaves{{num_leaves(m_tree), region_gt_areas.size()}, 0};
-            if (vertex_map.size() <= 1) { // no rag
-                hg_assert_leaf_weights(m_tree, ground_truth);
-                for (auto i: leaves_iterator(m_tree)) {
-                    card_intersection_leaves(i, ground_truth(i))++;
-                }
-                region_tree_area = attribute_area(m_tree);
-            } else { // tree on rag
-                hg_assert(vertex_map.size() == ground_truth.size(), "Vertex map and ground truth sizes do not match.");
-                for (index_t i = 0; i < (index_t) vertex_map.size(); i++) {
-                    card_intersection_leaves(vertex_map(i), ground_truth(i))++;
+            auto card_intersection = fragmentation_curve_internal::compute_card_intersection_tree_ground_truth(
+                    m_tree, ground_truth, vertex_map);
+
+            array_1d<double> scores = xt::empty<double>({num_vertices(m_tree)});
+            auto compute_scores = [&card_intersection, &region_gt_areas, &scores, this](const auto &scorer) {
+                for (auto i: leaves_to_root_iterator(m_tree)) {
+                    scores(i) = scorer.row_score(card_intersection, i,
+                                                 (double) card_intersection.row_area(i), region_gt_areas);
                 }
-                region_tree_area = attribute_area(m_tree,
-                                                  rag_accumulate(vertex_map, xt::ones<index_t>(vertex_map.shape()),
-                                                                 accumulator_counter()));
-            }
-
-            array_2d<double> card_intersection = accumulate_sequential(m_tree, card_intersection_leaves,
-                                                                       accumulator_sum());
-
-            array_1d<double> scores;
+            };
 
             switch (measure) {
                 case optimal_cut_measure::BCE:
-                    scores = xt::eval(xt::sum(
-                            card_intersection *
-                            xt::minimum(card_intersection / region_gt_areas,
-                                        card_intersection / xt::view(region_tree_area, xt::all(), xt::newaxis())),
-                            {1}));
+                    compute_scores(scorer_partition_BCE());
                     break;
                 case optimal_cut_measure::DHamming:
-                    scores = xt::eval(xt::amax(card_intersection, {1}));
+                    compute_scores(scorer_partition_DHamming());
                     break;
                 case optimal_cut_measure::DCovering:
-                    auto card_union = xt::eval(-card_intersection + region_gt_areas +
-                                               xt::view(region_tree_area, xt::all(), xt::newaxis()));
-                    scores = xt::eval(xt::amax(card_intersection / card_union, {1}) * region_tree_area);
+                    compute_scores(scorer_partition_DCovering());
                     break;
             }
 
@@ -404,7 +423,7 @@ namespace hg {
         hg_assert_1d_array(ground_truth);
         max_regions = (std::min)(max_regions, num_leaves(tree));
 
-        auto card_intersection = fragmentation_curve_internal::compute_card_intersection_tree_ground_truth<double>(
+        auto card_intersection = fragmentation_curve_internal::compute_card_intersection_tree_ground_truth(
                 tree, ground_truth, vertex_map);
 
         auto hc_explorer = make_horizontal_cut_explorer(tree, altitudes);
@@ -419,10 +438,11 @@ namespace hg {
 
         for (index_t i = 0; i < num_cuts; i++) {
             auto hc = hc_explorer.horizontal_cut_from_index(i);
-            scores(i) = partition_scorer.score(xt::view(card_intersection, xt::keep(hc.nodes), xt::all()));
+            scores(i) = partition_scorer.score(card_intersection, hc.nodes);
         }
 
-        size_t num_regions_ground_truth = xt::count_nonzero(xt::view(card_intersection, root(tree), xt::all()))();;
+        size_t num_regions_ground_truth =
+                card_intersection.row_end(root(tree)) - card_intersection.row_begin(root(tree));
 
         return hg::fragmentation_curve<>{std::move(num_regions),
                                          std::move(scores),
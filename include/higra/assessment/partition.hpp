@@ -11,6 +11,7 @@
 #pragma once
 
 #include "../structure/array.hpp"
+#include <numeric>
 #include <vector>
 #include <xtensor/xview.hpp>
 
@@ -22,37 +23,223 @@ namespace hg {
         DCovering
     };
 
+    /**
+     * Sparse matrix of the cardinals of the intersections between the regions of a candidate partition (rows)
+     * and the regions of a ground-truth partition (columns).
+     *
+     * The non zero entries are stored row by row in compressed row format, and each row is sorted by increasing
+     * column index: the memory usage is thus proportional to the number of non empty intersections.
+     *
+     * Rows are appended one after the other with push_back and end_row.
+     *
+     * @tparam value_type type of the cardinals
+     */
+    template<typename value_type=index_t>
+    class sparse_card_intersection {
+    public:
+
+        explicit sparse_card_intersection(size_t num_columns = 0) :
+                m_num_columns(num_columns),
+                m_row_offsets{0} {
+        }
+
+        /**
+         * Append a non zero entry to the current row (columns must be given in increasing order).
+         */
+        void push_back(index_t column, value_type value) {
+            m_columns.push_back(column);
+            m_values.push_back(value);
+        }
+
+        /**
+         * Close the current row.
+         */
+        void end_row() {
+            m_row_offsets.push_back(m_columns.size());
+        }
+
+        auto num_rows() const {
+            return m_row_offsets.size() - 1;
+        }
+
+        auto num_columns() const {
+            return m_num_columns;
+        }
+
+        /**
+         * Number of non zero entries of the matrix.
+         */
+        auto num_non_zeros() const {
+            return m_columns.size();
+        }
+
+        /**
+         * Position of the first non zero entry of the given row in columns() and values().
+         */
+        auto row_begin(index_t row) const {
+            return m_row_offsets[row];
+        }
+
+        /**
+         * Position after the last non zero entry of the given row in columns() and values().
+         */
+        auto row_end(index_t row) const {
+            return m_row_offsets[row + 1];
+        }
+
+        const auto &columns() const {
+            return m_columns;
+        }
+
+        const auto &values() const {
+            return m_values;
+        }
+
+        /**
+         * Sum of the entries of the given row, i.e. the area of the corresponding candidate region.
+         */
+        value_type row_area(index_t row) const {
+            value_type area = 0;
+            for (index_t k = row_begin(row); k < row_end(row); k++) {
+                area += m_values[k];
+            }
+            return area;
+        }
+
+        /**
+         * Sum of the entries of each column over the given rows.
+         */
+        template<typename T>
+        auto column_areas(const xt::xexpression<T> &xrows) const {
+            auto &rows = xrows.derived_cast();
+            array_1d<value_type> areas = xt::zeros<value_type>({m_num_columns});
+            for (auto row: rows) {
+                for (index_t k = row_begin(row); k < row_end(row); k++) {
+                    areas(m_columns[k]) += m_values[k];
+                }
+            }
+            return areas;
+        }
+
+        auto column_areas() const {
+            return column_areas(xt::arange<index_t>(num_rows()));
+        }
+
+        /**
+         * Dense matrix of shape (num_rows, num_columns) holding the same entries.
+         */
+        auto to_dense() const {
+            array_2d<value_type> dense = xt::zeros<value_type>({num_rows(), m_num_columns});
+            for (index_t i = 0; i < (index_t) num_rows(); i++) {
+                for (index_t k = row_begin(i); k < row_end(i); k++) {
+                    dense(i, m_columns[k]) = m_values[k];
+                }
+            }
+            return dense;
+        }
+
+    private:
+        size_t m_num_columns;
+        std::vector<index_t> m_row_offsets;
+        std::vector<index_t> m_columns;
+        std::vector<value_type> m_values;
+    };
+
+    namespace partition_internal {
+
+        /**
+         * Append to card_intersection the rows 0 to num_rows - 1 of the cardinals of the intersections between the
+         * regions of row_labels and the regions of column_labels.
+         *
+         * Elements are sorted by (row label, column label) with two counting sorts, so that each row is produced
+         * directly in increasing column order: the time complexity is linear and the memory usage does not
+         * depend on num_rows * num_columns.
+         */
+        template<typename value_type, typename T1, typename T2>
+        void append_card_intersection_rows(sparse_card_intersection<value_type> &card_intersection,
+                                           const T1 &row_labels,
+                                           const T2 &column_labels,
+                                           size_t num_rows) {
+            size_t num_columns = card_intersection.num_columns();
+            size_t num_elements = row_labels.size();
+
+            std::vector<index_t> column_order(num_elements);
+            {
+                std::vector<index_t> offsets(num_columns + 1, 0);
+                for (index_t i = 0; i < (index_t) num_elements; i++) {
+                    offsets[column_labels(i) + 1]++;
+                }
+                std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+                for (index_t i = 0; i < (index_t) num_elements; i++) {
+                    column_order[offsets[column_labels(i)]++] = i;
+                }
+            }
+
+            std::vector<index_t> row_offsets(num_rows + 1, 0);
+            for (index_t i = 0; i < (index_t) num_elements; i++) {
+                row_offsets[row_labels(i) + 1]++;
+            }
+            std::partial_sum(row_offsets.begin(), row_offsets.end(), row_offsets.begin());
+            std::vector<index_t> order(num_elements);
+            {
+                std::vector<index_t> positions(row_offsets.begin(), row_offsets.end() - 1);
+                for (auto i: column_order) {
+                    order[positions[row_labels(i)]++] = i;
+                }
+            }
+            column_order = std::vector<index_t>();
+
+            for (index_t r = 0; r < (index_t) num_rows; r++) {
+                index_t k = row_offsets[r];
+                while (k < row_offsets[r + 1]) {
+                    auto column = column_labels(order[k]);
+                    value_type count = 0;
+                    for (; k < row_offsets[r + 1] && column_labels(order[k]) == column; k++) {
+                        count++;
+                    }
+                    card_intersection.push_back(column, count);
+                }
+                card_intersection.end_row();
+            }
+        }
+    }
+
+    /**
+     * Sparse cardinals of the intersections between the regions of a candidate partition and the regions of
+     * one or several ground-truth partitions (see card_intersections).
+     *
+     * @tparam value_type type of the cardinals
+     * @param xcandidate candidate labelisation
+     * @param xground_truths ground-truth labelisation, or stack of ground-truth labelisations
+     * @return a vector of sparse_card_intersection, one for each ground truth
+     */
     template<typename value_type=index_t, typename T1, typename T2>
-    auto card_intersections(const xt::xexpression<T1> &xcandidate,
-                            const xt::xexpression<T2> &xground_truths) {
+    auto sparse_card_intersections(const xt::xexpression<T1> &xcandidate,
+                                   const xt::xexpression<T2> &xground_truths) {
         auto &candidate = xcandidate.derived_cast();
         auto &ground_truths = xground_truths.derived_cast();
 
         hg_assert_integral_value_type(candidate);
         hg_assert_integral_value_type(ground_truths);
 
-        std::vector<array_2d<value_type>> result;
+        std::vector<sparse_card_intersection<value_type>> result;
         auto num_regions_candidate = xt::amax(candidate)() + 1;
+        const auto &cf = xt::flatten(candidate);
 
-        auto compute = [&candidate, &result, num_regions_candidate](const auto &ground_truth) {
+        auto compute = [&cf, &candidate, &result, num_regions_candidate](const auto &ground_truth) {
             hg_assert_same_shape(candidate, ground_truth);
             auto num_regions_ground_truth = xt::amax(ground_truth)() + 1;
-            typename array_2d<value_type>::shape_type shape_result{(size_t) num_regions_candidate,
-                                                                   (size_t) num_regions_ground_truth};
-            result.emplace_back(shape_result, 0);
-            auto &r = result.back();
-
-            const auto &cf = xt::flatten(candidate);
-            const auto &gtf = xt::flatten(ground_truth);
-            for (index_t i = 0; i < (index_t)cf.size(); i++) {
-                r(cf(i), gtf(i))++;
-            }
+            result.emplace_back((size_t) num_regions_ground_truth);
+            partition_internal::append_card_intersection_rows(result.back(),
+                                                              cf,
+                                                              xt::flatten(ground_truth),
+                                                              (size_t) num_regions_candidate);
         };
 
         if (xt::same_shape(candidate.shape(), ground_truths.shape())) {
             compute(ground_truths);
         } else {
-            for (index_t i = 0; i < (index_t)ground_truths.shape()[0]; i++) {
+            for (index_t i = 0; i < (index_t) ground_truths.shape()[0]; i++) {
                 compute(xt::view(ground_truths, i));
             }
         }
@@ -60,6 +247,44 @@ namespace hg {
         return result;
     }
 
+    template<typename value_type=index_t, typename T1, typename T2>
+    auto card_intersections(const xt::xexpression<T1> &xcandidate,
+                            const xt::xexpression<T2> &xground_truths) {
+        auto &candidate = xcandidate.derived_cast();
+        auto &ground_truths = xground_truths.derived_cast();
+
+        hg_assert_integral_value_type(candidate);
+        hg_assert_integral_value_type(ground_truths);
+
+        std::vector<array_2d<value_type>> result;
+        for (const auto &card_intersection: sparse_card_intersections<value_type>(candidate, ground_truths)) {
+            result.push_back(card_intersection.to_dense());
+        }
+        return result;
+    }
+
+    namespace partition_internal {
+
+        /**
+         * Score of the given rows of a sparse intersection matrix: sum of the row scores given by
+         * scorer_t::row_score, divided by the total area of the rows.
+         */
+        template<typename scorer_t, typename value_type, typename T>
+        double score_sparse(const sparse_card_intersection<value_type> &card_intersection,
+                            const xt::xexpression<T> &xrows) {
+            auto &rows = xrows.derived_cast();
+            auto column_areas = card_intersection.column_areas(rows);
+            double score = 0;
+            double total_area = 0;
+            for (auto row: rows) {
+                double row_area = (double) card_intersection.row_area(row);
+                score += scorer_t::row_score(card_intersection, row, row_area, column_areas);
+                total_area += row_area;
+            }
+            return score / total_area;
+        }
+    }
+
     struct scorer_partition_BCE {
         template<typename T>
         static
@@ -74,6 +299,37 @@ namespace hg {
 
             return score / xt::sum(candidate_regions_area)();
         }
+
+        template<typename value_type, typename T>
+        static
+        double score(const sparse_card_intersection<value_type> &card_intersection, const xt::xexpression<T> &xrows) {
+            return partition_internal::score_sparse<scorer_partition_BCE>(card_intersection, xrows);
+        }
+
+        template<typename value_type>
+        static
+        double score(const sparse_card_intersection<value_type> &card_intersection) {
+            return score(card_intersection, xt::arange<index_t>(card_intersection.num_rows()));
+        }
+
+        /**
+         * Unnormalized score of a single candidate region (row) of a sparse intersection matrix.
+         */
+        template<typename value_type, typename T>
+        static
+        double row_score(const sparse_card_intersection<value_type> &card_intersection,
+                         index_t row,
+                         double row_area,
+                         const T &column_areas) {
+            auto &columns = card_intersection.columns();
+            auto &values = card_intersection.values();
+            double score = 0;
+            for (index_t k = card_intersection.row_begin(row); k < card_intersection.row_end(row); k++) {
+                double value = (double) values[k];
+                score += value * (std::min)(value / (double) column_areas(columns[k]), value / row_area);
+            }
+            return score;
+        }
     };
 
     struct scorer_partition_DHamming {
@@ -84,6 +340,35 @@ namespace hg {
 
             return (xt::sum(xt::amax(card_intersection, {1}))() / xt::sum(card_intersection)());
         }
+
+        template<typename value_type, typename T>
+        static
+        double score(const sparse_card_intersection<value_type> &card_intersection, const xt::xexpression<T> &xrows) {
+            return partition_internal::score_sparse<scorer_partition_DHamming>(card_intersection, xrows);
+        }
+
+        template<typename value_type>
+        static
+        double score(const sparse_card_intersection<value_type> &card_intersection) {
+            return score(card_intersection, xt::arange<index_t>(card_intersection.num_rows()));
+        }
+
+        /**
+         * Unnormalized score of a single candidate region (row) of a sparse intersection matrix.
+         */
+        template<typename value_type, typename T>
+        static
+        double row_score(const sparse_card_intersection<value_type> &card_intersection,
+                         index_t row,
+                         double,
+                         const T &) {
+            auto &values = card_intersection.values();
+            double score = 0;
+            for (index_t k = card_intersection.row_begin(row); k < card_intersection.row_end(row); k++) {
+                score = (std::max)(score, (double) values[k]);
+            }
+            return score;
+        }
     };
 
     struct scorer_partition_DCovering {
@@ -100,6 +385,37 @@ namespace hg {
 
             return score / xt::sum(candidate_regions_area)();
         }
+
+        template<typename value_type, typename T>
+        static
+        double score(const sparse_card_intersection<value_type> &card_intersection, const xt::xexpression<T> &xrows) {
+            return partition_internal::score_sparse<scorer_partition_DCovering>(card_intersection, xrows);
+        }
+
+        template<typename value_type>
+        static
+        double score(const sparse_card_intersection<value_type> &card_intersection) {
+            return score(card_intersection, xt::arange<index_t>(card_intersection.num_rows()));
+        }
+
+        /**
+         * Unnormalized score of a single candidate region (row) of a sparse intersection matrix.
+         */
+        template<typename value_type, typename T>
+        static
+        double row_score(const sparse_card_intersection<value_type> &card_intersection,
+                         index_t row,
+                         double row_area,
+                         const T &column_areas) {
+            auto &columns = card_intersection.columns();
+            auto &values = card_intersection.values();
+            double score = 0;
+            for (index_t k = card_intersection.row_begin(row); k < card_intersection.row_end(row); k++) {
+                double value = (double) values[k];
+                score = (std::max)(score, value / (row_area + (double) column_areas(columns[k]) - value));
+            }
+            return score * row_area;
+        }
     };
 
     template<typename T, typename scorer_t>
@@ -115,7 +431,7 @@ namespace hg {
     auto assess_partition(const xt::xexpression<T1> &xcandidate,
                           const xt::xexpression<T2> &xground_truths,
                           const scorer_t &scorer) {
-        auto card_intersections = hg::card_intersections<double>(xcandidate, xground_truths);
+        auto card_intersections = hg::sparse_card_intersections<index_t>(xcandidate, xground_truths);
         return assess_partition(card_intersections, scorer);
     }
 
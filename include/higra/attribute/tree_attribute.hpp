@@ -131,7 +131,7 @@ namespace hg {
 
         tree.compute_children();
         if (increasing_altitudes) {
-            auto min_depth = xt::empty_like(altitudes);
+            auto min_depth = array_1d<value_type>::from_shape({num_vertices(tree)});
             xt::noalias(xt::view(min_depth, xt::range(0, num_leaves(tree)))) =
                     xt::view(xt::index_view(altitudes, tree.parents()), xt::range(0, num_leaves(tree)));
             for (auto n: leaves_to_root_iterator(tree, leaves_it::exclude)) {
@@ -151,7 +151,7 @@ namespace hg {
             }
             return xt::eval(xt::index_view(altitudes, tree.parents()) - min_depth);
         } else {
-            auto max_depth = xt::empty_like(altitudes);
+            auto max_depth = array_1d<value_type>::from_shape({num_vertices(tree)});
             xt::noalias(xt::view(max_depth, xt::range(0, num_leaves(tree)))) =
                     xt::view(xt::index_view(altitudes, tree.parents()), xt::range(0, num_leaves(tree)));
             for (auto n: leaves_to_root_iterator(tree, leaves_it::exclude)) {
@@ -261,7 +261,7 @@ namespace hg {
         // identify path to the deepest extrema
         array_1d<index_t> ref_son({num_vertices(tree)}, invalid_index);
         if (increasing_altitudes) {
-            auto min_depth = xt::empty_like(altitudes);
+            auto min_depth = array_1d<value_type>::from_shape({num_vertices(tree)});
             for (auto n: leaves_to_root_iterator(tree, leaves_it::exclude)) {
                 min_depth(n) = (std::numeric_limits<value_type>::max)();
                 bool flag = true;
@@ -279,7 +279,7 @@ namespace hg {
                 }
             }
         } else {
-            auto max_depth = xt::empty_like(altitudes);
+            auto max_depth = array_1d<value_type>::from_shape({num_vertices(tree)});
             for (auto n: leaves_to_root_iterator(tree, leaves_it::exclude)) {
                 max_depth(n) = std::numeric_limits<value_type>::lowest();
                 bool flag = true;
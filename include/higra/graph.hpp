@@ -11,6 +11,7 @@
 
 #include "utils.hpp"
 #include "structure/undirected_graph.hpp"
+#include "structure/region_merging_graph.hpp"
 #include "structure/regular_graph.hpp"
 #include "structure/tree_graph.hpp"
 
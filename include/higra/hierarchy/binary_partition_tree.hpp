@@ -14,32 +14,164 @@
 #include "../graph.hpp"
 #include "hierarchy_core.hpp"
 #include "../structure/fibonacci_heap.hpp"
+#include "../structure/indexed_dary_heap.hpp"
+#include "../structure/pairing_heap.hpp"
 #include "xtensor/xview.hpp"
 #include "xtensor/xnoalias.hpp"
 #include <string>
 
 namespace hg {
 
+    /**
+     * Heap policies of binary_partition_tree: the heap stores the edges of the graph ordered by increasing weight.
+     */
+    namespace bpt_heap {
+        /**
+         * Fibonacci heap (structure/fibonacci_heap.hpp), default policy: edges are compared with their weights only
+         * and ties between edges of equal weights are resolved by the heap as in the historical implementation.
+         */
+        struct fibonacci {
+        };
+
+        /**
+         * Pairing heap (structure/pairing_heap.hpp)
+         */
+        struct pairing {
+        };
+
+        /**
+         * Indexed 4-ary heap (structure/indexed_dary_heap.hpp)
+         */
+        struct dary {
+        };
+
+        /**
+         * Chooses the heap according to the size of the graph: indexed 4-ary heap for small graphs and indexed
+         * 8-ary heap (shallower, fewer cache misses per operation) for graphs with more than large_graph_threshold edges.
+         */
+        struct automatic {
+            static const index_t large_graph_threshold = 1000000;
+        };
+
+        /**
+         * No global heap: merges are found with the nearest-neighbor chain algorithm. Valid only if the linkage is
+         * reducible, which is the case of the complete, average, and exponential linkages, and of the Ward linkage
+         * on complete graphs.
+         */
+        struct nn_chain {
+        };
+    }
+
+    /**
+     * Runtime selection of the heap policies of binary_partition_tree (see namespace bpt_heap), including the
+     * nearest-neighbor chain algorithm.
+     */
+    enum class bpt_heap_policy {
+        fibonacci,
+        pairing,
+        dary,
+        automatic,
+        nn_chain
+    };
+
     namespace binary_partition_tree_internal {
 
-        template<typename T>
+        /**
+         * Edge of the heap of binary_partition_tree.
+         *
+         * If index_tie_break is true, ties between edges of equal weights are broken with the edge index: the merging
+         * order does not depend on the heap implementation. Otherwise, edges are compared with their weights only
+         * and ties are resolved by the heap.
+         */
+        template<typename T, bool index_tie_break = true>
         struct heap_element {
-            using self_t = heap_element<T>;
+            using self_t = heap_element<T, index_tie_break>;
             T value;
             index_t index;
 
-            bool operator==(const self_t &rhs) const { return value == rhs.value; }
+            bool operator==(const self_t &rhs) const {
+                return value == rhs.value && (!index_tie_break || index == rhs.index);
+            }
+
+            bool operator!=(const self_t &rhs) const { return !(*this == rhs); }
+
+            bool operator<(const self_t &rhs) const {
+                return value < rhs.value || (index_tie_break && !(rhs.value < value) && index < rhs.index);
+            }
+
+            bool operator>(const self_t &rhs) const { return rhs < *this; }
+
+            bool operator<=(const self_t &rhs) const { return !(rhs < *this); }
+
+            bool operator>=(const self_t &rhs) const { return !(*this < rhs); }
+
+        };
+
+        /**
+         * Adapts a heap providing handles (fibonacci_heap, pairing_heap) to the interface of indexed_dary_heap:
+         * elements are identified by their index in [0, capacity).
+         *
+         * @tparam heap_template
+         * @tparam T
+         */
+        template<template<typename> class heap_template, typename T, bool index_tie_break = true>
+        struct handle_heap_adapter {
+        private:
+            using heap_t = heap_template<heap_element<T, index_tie_break>>;
+            heap_t m_heap;
+            std::vector<typename heap_t::value_handle> m_handles;
+
+        public:
+
+            handle_heap_adapter(index_t capacity) : m_handles(capacity, nullptr) {
 
-            bool operator!=(const self_t &rhs) const { return value != rhs.value; }
+            }
 
-            bool operator<(const self_t &rhs) const { return value < rhs.value; }
+            bool empty() const {
+                return m_heap.empty();
+            }
 
-            bool operator>(const self_t &rhs) const { return value > rhs.value; }
+            void push(index_t index, const T &value) {
+                m_handles[index] = m_heap.push({value, index});
+            }
 
-            bool operator<=(const self_t &rhs) const { return value <= rhs.value; }
+            index_t top() {
+                return m_heap.top()->get_value().index;
+            }
+
+            T top_value() {
+                return m_heap.top()->get_value().value;
+            }
+
+            void pop() {
+                m_handles[top()] = nullptr;
+                m_heap.pop();
+            }
 
-            bool operator>=(const self_t &rhs) const { return value >= rhs.value; }
+            void update(index_t index, const T &value) {
+                m_heap.update(m_handles[index], {value, index});
+            }
+        };
+
+        /**
+         * Heap used by binary_partition_tree with the given heap policy
+         */
+        template<typename heap_policy, typename T>
+        struct heap_selector;
+
+        template<typename T>
+        struct heap_selector<bpt_heap::fibonacci, T> {
+            using type = handle_heap_adapter<fibonacci_heap, T, false>;
+        };
+
+        template<typename T>
+        struct heap_selector<bpt_heap::pairing, T> {
+            using type = handle_heap_adapter<pairing_heap, T>;
+        };
 
+        template<typename T>
+        struct heap_selector<bpt_heap::dary, T> {
+            using type = indexed_dary_heap<T, 4>;
         };
 
         /**
@@ -431,7 +563,309 @@ namespace hg {
             }
         };
 
+        /**
+         * Merges the two extremities of the given edge of the region graph g into a new region.
+         *
+         * The edges linking the merged regions to a same neighbour are fused: the weight of the fused edge is computed
+         * by the weighting function. removed_edge(e) is called for each edge that disappears from the graph and
+         * updated_edge(e, w) for each edge linking the new region to one of its neighbours, with w its new weight.
+         *
+         * @return the new region
+         */
+        template<typename region_graph_t, typename weight_t, typename weighter, typename removed_edge_f,
+                typename updated_edge_f>
+        index_t merge_regions(region_graph_t &g,
+                              index_t fusion_edge_index,
+                              array_1d<index_t> &new_neighbour_indices,
+                              std::vector<new_neighbour<weight_t> > &new_neighbours,
+                              weighter &weight_function,
+                              removed_edge_f &&removed_edge,
+                              updated_edge_f &&updated_edge) {
+            const decltype(new_neighbours) &const_new_neighbours = new_neighbours;
+
+            auto new_parent = g.add_vertex();
+            auto fusion_edge = edge_from_index(fusion_edge_index, g);
+            auto region1 = source(fusion_edge, g);
+            auto region2 = target(fusion_edge, g);
+
+            // remove fusion edge
+            remove_edge(fusion_edge_index, g);
+            removed_edge(fusion_edge_index);
+
+            // search for neighbours of region1 and region2 and store them in new_neighbours
+            new_neighbours.clear();
+            auto explore_region = [&removed_edge, &g, &new_neighbours, &new_neighbour_indices](
+                    index_t region, index_t other_region) {
+                for (auto e: out_edge_iterator(region, g)) {
+                    auto n = other_vertex(e, region, g);
+                    if (n != other_region) { // may happen with multiple edges
+                        if (new_neighbour_indices[n] != invalid_index) {
+                            new_neighbours[new_neighbour_indices[n]].second_edge_index() = e;
+                        } else {
+                            new_neighbour_indices[n] = new_neighbours.size();
+                            new_neighbours.emplace_back(n, e);
+                        }
+                    } else {
+                        removed_edge(index(e, g));
+                    }
+                }
+            };
+
+            explore_region(region1, region2);
+            explore_region(region2, region1);
+            for (auto &n: new_neighbours) {
+                new_neighbour_indices[n.neighbour_vertex()] = invalid_index;
+            }
+
+            // update edge weights
+            if (!new_neighbours.empty()) { // should only happen at last iteration
+                // external callback : compute new edge weights
+                weight_function(g, fusion_edge_index, new_parent, region1, region2, const_new_neighbours);
+
+                // process new weights, update heap and things
+                for (auto &nn: new_neighbours) {
+                    if (nn.num_edges() > 1) {
+                        removed_edge(nn.second_edge_index());
+                        remove_edge(nn.second_edge_index(), g);
+                    }
+                    set_edge(nn.first_edge_index(), nn.neighbour_vertex(), new_parent, g);
+                    updated_edge(nn.first_edge_index(), nn.new_edge_weight());
+                }
+            }
+            return new_parent;
+        }
+
+        template<typename heap_t, typename region_graph_t, typename graph_t, typename weighter, typename T>
+        auto binary_partition_tree_impl(const graph_t &graph, const T &edge_weights, weighter &weight_function) {
+            using weight_t = typename T::value_type;
+
+            auto g = copy_graph<region_graph_t>(graph); // optimized for removal
+
+            auto num_points = num_vertices(g);
+            auto num_nodes_tree = num_points * 2 - 1;
 
+            array_1d<index_t> parents = xt::arange(num_nodes_tree);
+            array_1d<weight_t> levels = xt::zeros<weight_t>({num_nodes_tree});
+
+            // optimization to detect already visited neighbours during neighbour search
+            array_1d<index_t> new_neighbour_indices({num_nodes_tree}, invalid_index);
+
+            // active edges are in the heap and still present in the graph (removed edges are leazily left in the heap)
+            // TODO: check for performance impact
+            array_1d<bool> active = xt::zeros<bool>({num_edges(g)});
+
+            // special structure to store the list of neighbours adjacent to the fused regions.
+            std::vector<new_neighbour<weight_t> > new_neighbours;
+
+            // init heap
+            heap_t heap(num_edges(g));
+
+            for (auto v: vertex_iterator(graph)) {
+                for (auto &e: out_edge_iterator(v, g)) {
+                    if (!active(e)) {
+                        heap.push(e, edge_weights(e));
+                        active(e) = true;
+                    }
+                }
+            }
+
+            // main loop
+            size_t current_num_nodes_tree = num_points;
+            while (!heap.empty() && current_num_nodes_tree < num_nodes_tree) {
+
+                auto fusion_edge_index = heap.top();
+                auto fusion_edge_weight = heap.top_value();
+
+                heap.pop();
+
+                if (active[fusion_edge_index]) {
+                    // create new region, update tree
+                    auto fusion_edge = edge_from_index(fusion_edge_index, g);
+                    auto region1 = source(fusion_edge, g);
+                    auto region2 = target(fusion_edge, g);
+                    auto new_parent = merge_regions(
+                            g, fusion_edge_index, new_neighbour_indices, new_neighbours, weight_function,
+                            [&active](index_t e) {
+                                // not removed from heap: maybe not necessary
+                                active[e] = false;
+                            },
+                            [&active, &heap](index_t e, weight_t weight) {
+                                heap.update(e, weight);
+                                active[e] = true;
+                            });
+                    parents[region1] = new_parent;
+                    parents[region2] = new_parent;
+                    levels[new_parent] = fusion_edge_weight;
+                    current_num_nodes_tree++;
+                }
+            }
+            return make_node_weighted_tree(tree(parents), std::move(levels));
+        }
+
+        /**
+         * Binary partition tree computed with the nearest-neighbor chain algorithm: a chain of regions, where each
+         * region is the nearest neighbour of the previous one, is grown until its two last regions are reciprocal
+         * nearest neighbours; those two regions are then merged and the chain is resumed from its remaining regions.
+         * This is only valid if the linkage is reducible:
+         *      d(X, Y) <= min(d(X, Z), d(Y, Z)) => d(X, Z) <= d(X u Y, Z)
+         *
+         * Edges are compared with their weights and, in case of equality, with their indices. The merges are finally
+         * sorted by increasing altitudes (in a stable way) so that the nodes of the tree are numbered in the same order
+         * as with the global heap algorithm.
+         */
+        template<typename region_graph_t, typename graph_t, typename weighter, typename T>
+        auto binary_partition_tree_nn_chain_impl(const graph_t &graph, const T &edge_weights,
+                                                 weighter &weight_function) {
+            using weight_t = typename T::value_type;
+
+            auto g = copy_graph<region_graph_t>(graph);
+
+            index_t num_points = num_vertices(g);
+            index_t num_nodes_tree = num_points * 2 - 1;
+
+            // current weight of each edge of the region graph
+            array_1d<weight_t> weights = edge_weights;
+
+            array_1d<index_t> new_neighbour_indices({(size_t) num_nodes_tree}, invalid_index);
+            std::vector<new_neighbour<weight_t> > new_neighbours;
+
+            // merged[r]: region r has been merged into a larger region
+            std::vector<bool> merged(num_nodes_tree, false);
+
+            // i-th merge creates region num_points + i by merging merge_children[i]
+            std::vector<std::pair<index_t, index_t>> merge_children;
+            merge_children.reserve(num_points - 1);
+            array_1d<weight_t> merge_altitudes = array_1d<weight_t>::from_shape({(size_t) num_points - 1});
+
+            auto nearest_edge = [&g, &weights](index_t region) {
+                index_t res = invalid_index;
+                for (auto e: out_edge_iterator(region, g)) {
+                    auto ei = index(e, g);
+                    if (res == invalid_index || weights[ei] < weights[res] ||
+                        (!(weights[res] < weights[ei]) && ei < res)) {
+                        res = ei;
+                    }
+                }
+                return res;
+            };
+
+            std::vector<index_t> chain;
+            index_t next_start = 0;
+            while ((index_t) merge_children.size() < num_points - 1) {
+                if (chain.empty()) {
+                    while (next_start < (index_t) num_vertices(g) && (merged[next_start] || degree(next_start, g) == 0)) {
+                        next_start++;
+                    }
+                    if (next_start == (index_t) num_vertices(g)) { // graph is not connected
+                        break;
+                    }
+                    chain.push_back(next_start);
+                }
+
+                auto region = chain.back();
+                auto ei = nearest_edge(region);
+                auto neighbour = other_vertex(edge_from_index(ei, g), region, g);
+
+                if (chain.size() > 1 && neighbour == chain[chain.size() - 2]) {
+                    chain.pop_back();
+                    chain.pop_back();
+                    auto fusion_edge = edge_from_index(ei, g);
+                    auto region1 = source(fusion_edge, g);
+                    auto region2 = target(fusion_edge, g);
+                    merge_altitudes[merge_children.size()] = weights[ei];
+                    merge_children.emplace_back(region1, region2);
+                    merge_regions(g, ei, new_neighbour_indices, new_neighbours, weight_function,
+                                  [](index_t) {},
+                                  [&weights](index_t e, weight_t weight) { weights[e] = weight; });
+                    merged[region1] = true;
+                    merged[region2] = true;
+                } else {
+                    chain.push_back(neighbour);
+                }
+            }
+            index_t num_merges = merge_children.size();
+
+            // sort merges by increasing altitudes: sort keys are made increasing from the leaves to the root so that a
+            // node is always numbered after its children whatever the rounding errors on the altitudes
+            array_1d<weight_t> keys = array_1d<weight_t>::from_shape({(size_t) num_merges});
+            for (index_t i = 0; i < num_merges; i++) {
+                keys[i] = merge_altitudes[i];
+                for (auto c: {merge_children[i].first, merge_children[i].second}) {
+                    if (c >= num_points && keys[i] < keys[c - num_points]) {
+                        keys[i] = keys[c - num_points];
+                    }
+                }
+            }
+            array_1d<index_t> sorted_merges = xt::arange<index_t>(num_merges);
+            std::stable_sort(sorted_merges.begin(), sorted_merges.end(),
+                             [&keys](index_t i, index_t j) { return keys[i] < keys[j]; });
+            array_1d<index_t> rank = array_1d<index_t>::from_shape({(size_t) num_merges});
+            for (index_t i = 0; i < num_merges; i++) {
+                rank[sorted_merges[i]] = i;
+            }
+
+            array_1d<index_t> parents = xt::arange(num_nodes_tree);
+            array_1d<weight_t> levels = xt::zeros<weight_t>({(size_t) num_nodes_tree});
+            for (index_t i = 0; i < num_merges; i++) {
+                auto node = num_points + rank[i];
+                levels[node] = merge_altitudes[i];
+                for (auto c: {merge_children[i].first, merge_children[i].second}) {
+                    parents[(c < num_points) ? c : num_points + rank[c - num_points]] = node;
+                }
+            }
+            return make_node_weighted_tree(tree(parents), std::move(levels));
+        }
+
+        template<typename weight_t, typename region_graph_t, typename heap_policy, typename graph_t,
+                typename weighter, typename T>
+        auto binary_partition_tree_dispatch(heap_policy, const graph_t &graph, const T &edge_weights,
+                                            weighter &weight_function) {
+            using heap_t = typename heap_selector<heap_policy, weight_t>::type;
+            return binary_partition_tree_impl<heap_t, region_graph_t>(graph, edge_weights, weight_function);
+        }
+
+        template<typename weight_t, typename region_graph_t, typename graph_t, typename weighter, typename T>
+        auto binary_partition_tree_dispatch(bpt_heap::automatic, const graph_t &graph, const T &edge_weights,
+                                            weighter &weight_function) {
+            if ((index_t) num_edges(graph) <= bpt_heap::automatic::large_graph_threshold) {
+                return binary_partition_tree_impl<indexed_dary_heap<weight_t, 4>, region_graph_t>(
+                        graph, edge_weights, weight_function);
+            } else {
+                return binary_partition_tree_impl<indexed_dary_heap<weight_t, 8>, region_graph_t>(
+                        graph, edge_weights, weight_function);
+            }
+        }
+
+        template<typename weight_t, typename region_graph_t, typename graph_t, typename weighter, typename T>
+        auto binary_partition_tree_dispatch(bpt_heap::nn_chain, const graph_t &graph, const T &edge_weights,
+                                            weighter &weight_function) {
+            return binary_partition_tree_nn_chain_impl<region_graph_t>(graph, edge_weights, weight_function);
+        }
+
+        /**
+         * Calls f with the heap policy of namespace bpt_heap corresponding to the given runtime value, for example:
+         *
+         *     dispatch_heap_policy(policy, [&](auto heap) {
+         *         return binary_partition_tree_complete_linkage<decltype(heap)>(graph, edge_weights);
+         *     });
+         */
+        template<typename F>
+        auto dispatch_heap_policy(bpt_heap_policy policy, F f) {
+            switch (policy) {
+                case bpt_heap_policy::fibonacci:
+                    return f(bpt_heap::fibonacci());
+                case bpt_heap_policy::pairing:
+                    return f(bpt_heap::pairing());
+                case bpt_heap_policy::dary:
+                    return f(bpt_heap::dary());
+                case bpt_heap_policy::automatic:
+                    return f(bpt_heap::automatic());
+                case bpt_heap_policy::nn_chain:
+                    return f(bpt_heap::nn_chain());
+                default:
+                    throw std::runtime_error("Unsupported binary partition tree heap policy.");
+            }
+        }
     }
 
     /**
@@ -478,6 +912,27 @@ namespace hg {
      *
      * Example of weighting function: binary_partition_tree_min_linkage
      *
+     * The heap storing the edges of the graph is chosen with the heap_policy template parameter (see namespace bpt_heap).
+     * With the default bpt_heap::fibonacci policy, ties between edges of equal weights are resolved by the Fibonacci
+     * heap. With the other heap policies (bpt_heap::dary, bpt_heap::pairing, and bpt_heap::automatic, which are faster),
+     * ties are broken with the edge indices and the resulting tree does not depend on the heap. All policies give the
+     * same tree if there are no ties. The order in which the Fibonacci heap resolves ties depends on its internal
+     * structure and cannot be reproduced by another heap: bpt_heap::fibonacci thus remains the default policy so that
+     * existing results are unchanged. The policy can be chosen at runtime with bpt_heap_policy (see
+     * binary_partition_tree_internal::dispatch_heap_policy).
+     *
+     * The input graph is copied into a mutable graph of type region_graph_t, which is modified during the merging
+     * process and passed to the weighting function: it must provide add_vertex, remove_edge, and set_edge.
+     * The default region_merging_graph stores adjacency lists in contiguous vectors and is much more compact than
+     * undirected_graph<hash_setS>.
+     *
+     * With the bpt_heap::nn_chain policy, the global heap is replaced by the nearest-neighbor chain algorithm which
+     * gives the same tree (up to the ordering of merges of equal altitudes) if the linkage defined by the weighting
+     * function is reducible.
+     *
+     * @tparam heap_policy bpt_heap::fibonacci (default), bpt_heap::automatic, bpt_heap::dary, bpt_heap::pairing, or
+     * bpt_heap::nn_chain
+     * @tparam region_graph_t region_merging_graph (default) or undirected_graph<hash_setS>
      * @tparam graph_t
      * @tparam weighter
      * @tparam T
@@ -486,121 +941,16 @@ namespace hg {
      * @param weight_function
      * @return a node weighted tree
      */
-    template<typename graph_t, typename weighter, typename T>
+    template<typename heap_policy = bpt_heap::fibonacci, typename region_graph_t = region_merging_graph,
+            typename graph_t, typename weighter, typename T>
     auto
     binary_partition_tree(const graph_t &graph, const xt::xexpression<T> &xedge_weights, weighter weight_function) {
         using weight_t = typename T::value_type;
-        using heap_t = fibonacci_heap<binary_partition_tree_internal::heap_element<weight_t> >;
-
         auto &edge_weights = xedge_weights.derived_cast();
         hg_assert_edge_weights(graph, edge_weights);
 
-        auto g = copy_graph<undirected_graph<hash_setS> >(graph); // optimized for removal
-
-        auto num_points = num_vertices(g);
-        auto num_nodes_tree = num_points * 2 - 1;
-
-        array_1d<index_t> parents = xt::arange(num_nodes_tree);
-        array_1d<weight_t> levels = xt::zeros<weight_t>({num_nodes_tree});
-
-        // optimization to detect already visited neighbours during neighbour search
-        array_1d<index_t> new_neighbour_indices({num_nodes_tree}, invalid_index);
-
-        // active edges are in the heap and still present in the graph (removed edges are leazily left in the heap)
-        // TODO: check for performance impact
-        array_1d<bool> active = xt::zeros<bool>({num_edges(g)});
-
-        // special structure to store the list of neighbours adjacent to the fused regions.
-        std::vector<binary_partition_tree_internal::new_neighbour<weight_t> > new_neighbours;
-        const decltype(new_neighbours) &const_new_neighbours = new_neighbours;
-
-        // init heap
-        heap_t heap;
-        array_1d<typename heap_t::value_handle> heap_handles({num_edges(g)}, nullptr);
-
-        for (auto v: vertex_iterator(graph)) {
-            for (auto &e: out_edge_iterator(v, g)) {
-                if (!active(e)) {
-                    heap_handles(e) = heap.push({edge_weights(e), e});
-                    active(e) = true;
-                }
-            }
-        }
-
-        // main loop
-        size_t current_num_nodes_tree = num_points;
-        while (!heap.empty() && current_num_nodes_tree < num_nodes_tree) {
-
-            auto heap_handle = heap.top();
-            auto min_element = heap_handle->get_value();
-
-            auto fusion_edge_index = min_element.index;
-            auto fusion_edge_weight = min_element.value;
-
-            heap.pop();
-            heap_handles[fusion_edge_index] = nullptr;
-
-            if (active[fusion_edge_index]) {
-                active[fusion_edge_index] = false;
-                // create new region, update tree
-                auto new_parent = g.add_vertex();
-                auto fusion_edge = edge_from_index(fusion_edge_index, g);
-                auto region1 = source(fusion_edge, g);
-                auto region2 = target(fusion_edge, g);
-                parents[region1] = new_parent;
-                parents[region2] = new_parent;
-                levels[new_parent] = fusion_edge_weight;
-                current_num_nodes_tree++;
-
-                // remove fusion edge
-                remove_edge(fusion_edge_index, g);
-                active[fusion_edge_index] = false;
-
-                // search for neighbours of region1 and region2 and store them in new_neighbours
-                new_neighbours.clear();
-                auto explore_region = [&active, &g, &new_neighbours, &new_neighbour_indices](
-                        index_t region, index_t other_region) {
-                    for (auto e: out_edge_iterator(region, g)) {
-                        auto n = other_vertex(e, region, g);
-                        if (n != other_region) { // may happen with multiple edges
-                            if (new_neighbour_indices[n] != invalid_index) {
-                                new_neighbours[new_neighbour_indices[n]].second_edge_index() = e;
-                            } else {
-                                new_neighbour_indices[n] = new_neighbours.size();
-                                new_neighbours.emplace_back(n, e);
-                            }
-                        } else {
-                            active[index(e, g)] = false;
-                        }
-                    }
-                };
-
-                explore_region(region1, region2);
-                explore_region(region2, region1);
-                for (auto &n: new_neighbours) {
-                    new_neighbour_indices[n.neighbour_vertex()] = invalid_index;
-                }
-
-                // update edge weights
-                if (!new_neighbours.empty()) { // should only happen at last iteration
-                    // external callback : compute new edge weights
-                    weight_function(g, fusion_edge_index, new_parent, region1, region2, const_new_neighbours);
-
-                    // process new weights, update heap and things
-                    for (auto &nn: new_neighbours) {
-                        if (nn.num_edges() > 1) {
-                            active[nn.second_edge_index()] = false;
-                            // not removed from heap: maybe not necessary
-                            remove_edge(nn.second_edge_index(), g);
-                        }
-                        set_edge(nn.first_edge_index(), nn.neighbour_vertex(), new_parent, g);
-                        heap.update(heap_handles[nn.first_edge_index()], {nn.new_edge_weight(), nn.first_edge_index()});
-                        active[nn.first_edge_index()] = true;
-                    }
-                }
-            }
-        }
-        return make_node_weighted_tree(tree(parents), std::move(levels));
+        return binary_partition_tree_internal::binary_partition_tree_dispatch<weight_t, region_graph_t>(
+                heap_policy(), graph, edge_weights, weight_function);
     }
 
 
@@ -640,15 +990,16 @@ namespace hg {
      *
      * Regions are then iteratively merged following the above distance (closest first) until a single region remains
      *
+     * @tparam heap_policy see binary_partition_tree
      * @tparam graph_t
      * @tparam T
      * @param graph
      * @param xedge_weights
      * @return a node weighted tree
      */
-    template<typename graph_t, typename T>
+    template<typename heap_policy = bpt_heap::fibonacci, typename graph_t, typename T>
     auto binary_partition_tree_complete_linkage(const graph_t &graph, const xt::xexpression<T> &xedge_weights) {
-        return binary_partition_tree(
+        return binary_partition_tree<heap_policy>(
                 graph,
                 xedge_weights,
                 binary_partition_tree_internal::binary_partition_tree_complete_linkage_weighting_functor<T>(
@@ -669,6 +1020,7 @@ namespace hg {
      *
      * Regions are then iteratively merged following the above distance (closest first) until a single region remains
      *
+     * @tparam heap_policy see binary_partition_tree
      * @tparam graph_t
      * @tparam T
      * @param graph
@@ -676,11 +1028,11 @@ namespace hg {
      * @param xedge_weight_weights
      * @return a node weighted tree
      */
-    template<typename graph_t, typename T>
+    template<typename heap_policy = bpt_heap::fibonacci, typename graph_t, typename T>
     auto binary_partition_tree_average_linkage(const graph_t &graph,
                                                const xt::xexpression<T> &xedge_weights,
                                                const xt::xexpression<T> &xedge_weight_weights) {
-        return binary_partition_tree(
+        return binary_partition_tree<heap_policy>(
                 graph,
                 xedge_weights,
                 binary_partition_tree_internal::binary_partition_tree_average_linkage_weighting_functor<T>(
@@ -714,6 +1066,7 @@ namespace hg {
      *      Supervised Hierarchical Clustering with Exponential Linkage
      *      Proceedings of the 36th International Conference on Machine Learning, PMLR 97:6973-6983, 2019.
      *
+     * @tparam heap_policy see binary_partition_tree
      * @tparam graph_t
      * @tparam T
      * @param graph
@@ -722,12 +1075,12 @@ namespace hg {
      * @param xedge_weight_weights
      * @return a node weighted tree
      */
-    template<typename graph_t, typename T>
+    template<typename heap_policy = bpt_heap::fibonacci, typename graph_t, typename T>
     auto binary_partition_tree_exponential_linkage(const graph_t &graph,
                                                const xt::xexpression<T> &xedge_weights,
                                                const typename T::value_type &alpha,
                                                const xt::xexpression<T> &xedge_weight_weights) {
-        return binary_partition_tree(
+        return binary_partition_tree<heap_policy>(
                 graph,
                 xedge_weights,
                 binary_partition_tree_internal::binary_partition_tree_exponential_linkage_weighting_functor<T>(
@@ -758,6 +1111,10 @@ namespace hg {
      *      - ``"max"``: the altitude of a node :math:`n` is defined as the maximum of the the Ward distance associated
      *          to each node in the subtree rooted in :math:`n`.
      *
+     * The Ward linkage is reducible only on complete graphs: on other graphs, the heap policy bpt_heap::nn_chain
+     * gives a valid hierarchy which may differ from the one obtained with a global heap.
+     *
+     * @tparam heap_policy see binary_partition_tree
      * @tparam graph_t
      * @tparam T1
      * @tparam T2
@@ -767,7 +1124,7 @@ namespace hg {
      * @param altitude_correction can be ``"none"`` or ``"max"`` (default)
      * @return a node weighted tree
      */
-    template<typename graph_t, typename T1, typename T2>
+    template<typename heap_policy = bpt_heap::fibonacci, typename graph_t, typename T1, typename T2>
     auto binary_partition_tree_ward_linkage(const graph_t &graph,
                                             const xt::xexpression<T1> &xvertex_centroids,
                                             const xt::xexpression<T2> &xvertex_sizes,
@@ -776,7 +1133,7 @@ namespace hg {
         auto f = binary_partition_tree_internal::binary_partition_tree_ward_linkage_weighting_functor<T1, T2>
                 (xvertex_centroids, xvertex_sizes);
 
-        auto res = binary_partition_tree(
+        auto res = binary_partition_tree<heap_policy>(
                 graph,
                 f.get_weights(graph),
                 f);
@@ -12,42 +12,98 @@
 
 #include "common.hpp"
 #include "higra/structure/unionfind.hpp"
+#include "higra/structure/integer_level_multi_queue.hpp"
 #include "higra/graph.hpp"
 #include "higra/sorting.hpp"
 #include "xtensor/xadapt.hpp"
+#include "xtensor/xview.hpp"
 
 namespace hg {
+
+    /**
+     * Algorithms used to compute the min and max trees of a vertex weighted graph
+     */
+    namespace component_tree_engine {
+        /**
+         * Sequential union find based algorithm (works on any graph)
+         */
+        struct sequential {
+        };
+
+        /**
+         * Tile based parallel algorithm: the pre-trees of horizontal tiles are computed independently and merged
+         * along the tile borders (regular graphs only)
+         */
+        struct tiled {
+            static index_t num_tiles() {
+#ifdef HG_USE_TBB
+                return 4 * (index_t) tbb::this_task_arena::max_concurrency();
+#else
+                return 1;
+#endif
+            }
+        };
+
+        /**
+         * Flooding algorithm with a hierarchical queue: no sorting and no union find (integral vertex weights only).
+         * Memory: O(num_vertices) for the parent relation and the node numbering (as the other engines) plus
+         * O(max_level - min_level + 1) for the hierarchical queue.
+         */
+        struct hierarchical_queue {
+        };
+
+        /**
+         * Tiled engine for large regular graphs when parallelism is enabled (HG_USE_TBB), hierarchical queue engine
+         * for integral vertex weights with a small range (at most max_num_levels and at most the number of vertices)
+         * and sequential engine otherwise
+         */
+        struct automatic {
+            static const index_t tiled_min_size = 1 << 20;
+            static const index_t max_num_levels = 1 << 16;
+        };
+    }
+
     namespace component_tree_internal {
 
         /**
-         * Generic pre-tree construction from ordered vertex values
+         * Pre-tree construction restricted to the block of vertices [vertex_begin, vertex_end): edges leading outside
+         * of the block are ignored.
          *
+         * The parent relation of the vertices of the block is written in parent.
+         *
+         * @tparam uf_t union find implementation (see unionfind.hpp)
          * @tparam graph_t
-         * @tparam T
          * @tparam E
+         * @tparam P
          * @param graph
-         * @param vertex_values
-         * @param sorted_vertex_indices
-         * @return
+         * @param sorted_vertex_indices array whose elements in the range [vertex_begin, vertex_end) are the vertices of
+         * the block sorted in increasing order
+         * @param vertex_begin first vertex of the block
+         * @param vertex_end last vertex of the block (excluded)
+         * @param parent parent relation (modified in-place)
          */
-        template<typename graph_t, typename E>
-        auto pre_tree_construction(const graph_t &graph,
-                                   const E &sorted_vertex_indices) {
-            auto nbe = num_vertices(graph);
-            array_1d<index_t> parent = array_1d<index_t>::from_shape({nbe});
+        template<typename uf_t = union_find, typename graph_t, typename E, typename P>
+        void pre_tree_construction_block(const graph_t &graph,
+                                         const E &sorted_vertex_indices,
+                                         index_t vertex_begin,
+                                         index_t vertex_end,
+                                         P &parent) {
+            auto nbe = (size_t) (vertex_end - vertex_begin);
             array_1d<index_t> representing = array_1d<index_t>::from_shape({nbe});
             array_1d<bool> processed({nbe}, false);
-            union_find uf(nbe);
+            uf_t uf(nbe);
 
-            for (index_t i = nbe - 1; i >= 0; i--) {
+            for (index_t i = vertex_end - 1; i >= vertex_begin; i--) {
                 auto current_vertex = sorted_vertex_indices[i];
+                auto current_vertex_local = current_vertex - vertex_begin;
                 parent(current_vertex) = current_vertex;
-                representing(current_vertex) = current_vertex;
-                processed(current_vertex) = true;
-                auto current_vertex_reprez = current_vertex;
+                representing(current_vertex_local) = current_vertex;
+                processed(current_vertex_local) = true;
+                auto current_vertex_reprez = current_vertex_local;
                 for (auto n: adjacent_vertex_iterator(current_vertex, graph)) {
-                    if (processed(n)) {
-                        auto neighbor_component = uf.find(n);
+                    index_t n_local = n - vertex_begin;
+                    if (n >= vertex_begin && n < vertex_end && processed(n_local)) {
+                        auto neighbor_component = uf.find(n_local);
                         if (neighbor_component != current_vertex_reprez) {
                             parent[representing[neighbor_component]] = current_vertex;
                             current_vertex_reprez = uf.link(neighbor_component, current_vertex_reprez);
@@ -56,6 +112,24 @@ namespace hg {
                     }
                 }
             }
+        }
+
+        /**
+         * Generic pre-tree construction from ordered vertex values
+         *
+         * @tparam uf_t union find implementation (see unionfind.hpp)
+         * @tparam graph_t
+         * @tparam E
+         * @param graph
+         * @param sorted_vertex_indices
+         * @return
+         */
+        template<typename uf_t = union_find, typename graph_t, typename E>
+        auto pre_tree_construction(const graph_t &graph,
+                                   const E &sorted_vertex_indices) {
+            auto nbe = num_vertices(graph);
+            array_1d<index_t> parent = array_1d<index_t>::from_shape({nbe});
+            pre_tree_construction_block<uf_t>(graph, sorted_vertex_indices, 0, nbe, parent);
             return parent;
         }
 
@@ -82,6 +156,176 @@ namespace hg {
             }
         }
 
+        /**
+         * Level root of the vertex x in a (partially) canonized parent relation: the first ancestor of x whose parent
+         * has a different level (path halving is applied on the way).
+         */
+        template<typename P, typename T>
+        index_t level_root(P &parent, const T &vertex_weights, index_t x) {
+            while (parent[x] != x && vertex_weights[parent[x]] == vertex_weights[x]) {
+                auto par = parent[x];
+                if (vertex_weights[parent[par]] == vertex_weights[x]) {
+                    parent[x] = parent[par];
+                }
+                x = par;
+            }
+            return x;
+        }
+
+        /**
+         * Merges the component trees containing the vertices x and y after the addition of an edge between x and y
+         * (merging procedure of [1]): the chains of level roots above x and y are merged into a single chain.
+         *
+         * Nodes are compared with their rank in the sorted vertex indices: when two level roots of same level are
+         * merged, the one with the smallest rank remains the level root, as in canonize_tree.
+         *
+         * @tparam P
+         * @tparam T
+         * @tparam R
+         * @param parent partially canonized parent relation (modified in-place)
+         * @param vertex_weights
+         * @param rank rank of each vertex in the sorted vertex indices
+         * @param x
+         * @param y
+         */
+        template<typename P, typename T, typename R>
+        void merge_canonized_trees(P &parent, const T &vertex_weights, const R &rank, index_t x, index_t y) {
+            x = level_root(parent, vertex_weights, x);
+            y = level_root(parent, vertex_weights, y);
+            if (rank[x] < rank[y]) {
+                std::swap(x, y);
+            }
+            // invariant: rank[x] > rank[y] or x == y
+            while (x != y) {
+                auto z = (parent[x] == x) ? x : level_root(parent, vertex_weights, parent[x]);
+                if (z != x && rank[z] >= rank[y]) {
+                    x = z;
+                } else {
+                    parent[x] = y;
+                    if (z == x) {
+                        break;
+                    }
+                    x = y;
+                    y = z;
+                }
+            }
+        }
+
+        /**
+         * Parallel computation of the canonized parent relation on a regular graph.
+         *
+         * The domain is cut into tiles along its first axis, the canonized trees of the tiles are computed
+         * independently and are then merged pairwise along the tile borders, following [1].
+         * The result is identical to the parent relation obtained with pre_tree_construction followed by
+         * canonize_tree.
+         *
+         * [1] M. H. F. Wilkinson, H. Gao, W. H. Hesselink, J.-E. Jonker, and A. Meijster, "Concurrent Computation of
+         * Attribute Filters on Shared Memory Parallel Machines," IEEE TPAMI, vol. 30, no. 10, pp. 1800-1813, 2008.
+         *
+         * @tparam uf_t union find implementation (see unionfind.hpp)
+         * @tparam embedding_t
+         * @tparam T
+         * @tparam E
+         * @param graph
+         * @param vertex_weights
+         * @param sorted_vertex_indices
+         * @param num_tiles requested number of tiles (the actual number of tiles may be smaller for small domains)
+         * @return
+         */
+        template<typename uf_t = union_find, typename embedding_t, typename T, typename E>
+        auto canonized_tree_construction_tiled(const regular_graph<embedding_t> &graph,
+                                               const T &vertex_weights,
+                                               const E &sorted_vertex_indices,
+                                               index_t num_tiles) {
+            index_t nbe = num_vertices(graph);
+            index_t height = (nbe == 0) ? 0 : graph.embedding().shape()[0];
+            index_t row_size = (height == 0) ? 0 : nbe / height;
+
+            // vertices linked by an edge are at most reach rows apart
+            index_t reach = 0;
+            for (const auto &n: graph.neighbours()) {
+                reach = (std::max)(reach, (index_t) std::abs(n[0]));
+            }
+
+            // tiles must be at least reach rows high such that tile borders only link adjacent tiles
+            num_tiles = (std::min)(num_tiles, height / (std::max)(reach, (index_t) 1));
+            if (num_tiles <= 1) {
+                auto parent = pre_tree_construction<uf_t>(graph, sorted_vertex_indices);
+                canonize_tree(parent, vertex_weights, sorted_vertex_indices);
+                return parent;
+            }
+
+            index_t tile_size = (height / num_tiles) * row_size;
+            std::vector<index_t> tile_begin(num_tiles + 1);
+            for (index_t t = 0; t < num_tiles; t++) {
+                tile_begin[t] = t * tile_size;
+            }
+            tile_begin[num_tiles] = nbe;
+            auto tile_of = [tile_size, num_tiles](index_t v) {
+                return (std::min)(v / tile_size, num_tiles - 1);
+            };
+
+            array_1d<index_t> rank = array_1d<index_t>::from_shape({(size_t) nbe});
+            parfor(0, nbe, [&rank, &sorted_vertex_indices](index_t i) {
+                rank[sorted_vertex_indices[i]] = i;
+            });
+
+            // stable partition of the sorted vertices by tiles: the vertices of tile t are stored in the range
+            // [tile_begin[t], tile_begin[t + 1]) in increasing order
+            index_t num_chunks = num_tiles;
+            index_t chunk_size = (nbe + num_chunks - 1) / num_chunks;
+            std::vector<index_t> offsets(num_chunks * num_tiles, 0);
+            parfor(0, num_chunks, [&](index_t c) {
+                auto chunk_end = (std::min)((c + 1) * chunk_size, nbe);
+                for (index_t i = c * chunk_size; i < chunk_end; i++) {
+                    offsets[c * num_tiles + tile_of(sorted_vertex_indices[i])]++;
+                }
+            });
+            for (index_t t = 0; t < num_tiles; t++) {
+                index_t offset = tile_begin[t];
+                for (index_t c = 0; c < num_chunks; c++) {
+                    auto count = offsets[c * num_tiles + t];
+                    offsets[c * num_tiles + t] = offset;
+                    offset += count;
+                }
+            }
+            array_1d<index_t> tiled_sorted_vertex_indices = array_1d<index_t>::from_shape({(size_t) nbe});
+            parfor(0, num_chunks, [&](index_t c) {
+                auto chunk_end = (std::min)((c + 1) * chunk_size, nbe);
+                for (index_t i = c * chunk_size; i < chunk_end; i++) {
+                    auto v = sorted_vertex_indices[i];
+                    tiled_sorted_vertex_indices[offsets[c * num_tiles + tile_of(v)]++] = v;
+                }
+            });
+
+            array_1d<index_t> parent = array_1d<index_t>::from_shape({(size_t) nbe});
+            parfor(0, num_tiles, [&](index_t t) {
+                pre_tree_construction_block<uf_t>(graph, tiled_sorted_vertex_indices, tile_begin[t], tile_begin[t + 1],
+                                                  parent);
+                canonize_tree(parent, vertex_weights,
+                              xt::view(tiled_sorted_vertex_indices, xt::range(tile_begin[t], tile_begin[t + 1])));
+            });
+
+            // pairwise merge of groups of tiles: at each level, the merged groups are disjoint
+            for (index_t step = 1; step < num_tiles; step *= 2) {
+                parfor(0, num_tiles - step, [&](index_t t) {
+                    index_t border = tile_begin[t + step];
+                    index_t border_end = (std::min)(border + reach * row_size, tile_begin[t + step + 1]);
+                    for (index_t v = border; v < border_end; v++) {
+                        for (auto n: adjacent_vertex_iterator(v, graph)) {
+                            if (n < border) {
+                                merge_canonized_trees(parent, vertex_weights, rank, n, v);
+                            }
+                        }
+                    }
+                }, 2 * step);
+            }
+
+            // merges leave chains of nodes of same level
+            canonize_tree(parent, vertex_weights, sorted_vertex_indices);
+            return parent;
+        }
+
         /**
          * Expand a canonized parent relation to a regular parent relation (each node is represented individually)
          * @tparam T1
@@ -125,17 +369,270 @@ namespace hg {
             return std::make_pair(std::move(new_parents), std::move(altitudes));
         }
 
-        template<typename graph_t, typename T1, typename T2>
-        auto
-        tree_from_sorted_vertices(const graph_t &graph, const T1 &vertex_weights, const T2 &sorted_vertex_indices) {
-            auto parents = pre_tree_construction(graph, sorted_vertex_indices);
-            canonize_tree(parents, vertex_weights, sorted_vertex_indices);
+        template<typename T1, typename T2>
+        auto tree_from_canonized_tree(const array_1d<index_t> &parents,
+                                      const T1 &vertex_weights,
+                                      const T2 &sorted_vertex_indices) {
             auto res = expand_canonized_parent_relation(parents, vertex_weights, sorted_vertex_indices);
             array_1d<typename T1::value_type> altitudes = xt::adapt(res.second, {res.second.size()});
             return make_node_weighted_tree(
                     tree(xt::adapt(res.first, {res.first.size()}), tree_category::component_tree),
                     std::move(altitudes));
         }
+
+        template<typename graph_t, typename T1, typename T2>
+        auto tree_from_sorted_vertices(const graph_t &graph,
+                                       const T1 &vertex_weights,
+                                       const T2 &sorted_vertex_indices) {
+            auto parents = pre_tree_construction(graph, sorted_vertex_indices);
+            canonize_tree(parents, vertex_weights, sorted_vertex_indices);
+            return tree_from_canonized_tree(parents, vertex_weights, sorted_vertex_indices);
+        }
+
+        template<typename T>
+        array_1d<index_t> sort_vertices(const T &vertex_weights, bool max_tree) {
+            if (max_tree) {
+                return stable_arg_sort(vertex_weights);
+            } else {
+                return stable_arg_sort(vertex_weights, std::greater<typename T::value_type>());
+            }
+        }
+
+        /**
+         * Component tree computation by flooding with a hierarchical queue [1] (non recursive version of [2]).
+         *
+         * The nodes of the resulting tree are numbered as in tree_from_sorted_vertices: the node numbering is
+         * obtained with a bucket sort of the level components of the graph.
+         *
+         * Besides the output tree, the algorithm uses two arrays of num_vertices indices (the parent relation of the
+         * vertices, also used to mark visited vertices, and the node numbering), a stack of at most num_vertices
+         * level roots, and a hierarchical queue holding at most num_vertices vertices in max_level - min_level + 1
+         * buckets.
+         *
+         * The graph must have at least one vertex.
+         *
+         * [1] Ph. Salembier, A. Oliveras, and L. Garrido, "Anti-extensive connected operators for image
+         * and sequence processing," IEEE Trans. Image Process., vol. 7, no. 4, pp. 555-570, Apr. 1998.
+         *
+         * [2] E. Carlinet and T. Geraud, "A Comparative Review of Component Tree Computation Algorithms,"
+         * IEEE Trans. Image Process., vol. 23, no. 9, pp. 3885-3895, Sep. 2014.
+         *
+         * @tparam graph_t
+         * @tparam T
+         * @param graph
+         * @param vertex_weights integral vertex weights
+         * @param max_tree true for a max tree and false for a min tree
+         * @return a node weighted tree
+         */
+        template<typename graph_t, typename T>
+        auto tree_by_flooding(const graph_t &graph, const T &vertex_weights, bool max_tree) {
+            using value_type = typename T::value_type;
+            static_assert(std::is_integral<value_type>::value,
+                          "Hierarchical queue component tree requires integral vertex weights.");
+            index_t nbv = num_vertices(graph);
+            hg_assert(nbv > 0, "Graph cannot be empty.");
+            const value_type min_level = xt::amin(vertex_weights)();
+            const value_type max_level = xt::amax(vertex_weights)();
+            // flooding goes from the root to the leaves: toward the highest levels for a max tree
+            auto deeper = [max_tree](value_type a, value_type b) {
+                return max_tree ? a > b : a < b;
+            };
+
+            integer_level_multi_queue<value_type, index_t> queue(min_level, max_level);
+            std::vector<index_t> stack;
+            // parent[v] is the level root of v if v is not a level root and the parent level root of v otherwise,
+            // it is invalid_index while v has not been visited and v while v is in the queue
+            array_1d<index_t> parent({(size_t) nbv}, invalid_index);
+
+            for (index_t seed = 0; seed < nbv; seed++) {
+                if (parent(seed) != invalid_index) {
+                    continue;
+                }
+                parent(seed) = seed;
+                queue.push(vertex_weights(seed), seed);
+                stack.push_back(seed);
+                value_type level = vertex_weights(seed);
+
+                while (!queue.empty()) {
+                    auto p = queue.top(level);
+                    bool go_deeper = false;
+                    for (auto n: adjacent_vertex_iterator(p, graph)) {
+                        if (parent(n) == invalid_index) {
+                            parent(n) = n;
+                            queue.push(vertex_weights(n), n);
+                            if (deeper(vertex_weights(n), level)) {
+                                stack.push_back(n);
+                                level = vertex_weights(n);
+                                go_deeper = true;
+                                break;
+                            }
+                        }
+                    }
+                    if (go_deeper) {
+                        continue;
+                    }
+                    // all the neighbours of p have been seen
+                    queue.pop(level);
+                    if (p != stack.back()) {
+                        parent(p) = stack.back();
+                    }
+                    if (queue.empty()) {
+                        break;
+                    }
+                    while (queue.level_empty(level)) {
+                        level = max_tree ? level - 1 : level + 1;
+                    }
+                    // close the level components deeper than the new flooding level
+                    if (deeper(vertex_weights(stack.back()), level)) {
+                        auto r = stack.back();
+                        stack.pop_back();
+                        while (!stack.empty() && deeper(vertex_weights(stack.back()), level)) {
+                            parent(r) = stack.back();
+                            r = stack.back();
+                            stack.pop_back();
+                        }
+                        if (stack.empty() || deeper(level, vertex_weights(stack.back()))) {
+                            stack.push_back(queue.top(level));
+                        }
+                        parent(r) = stack.back();
+                    }
+                }
+
+                // remaining level roots form a chain
+                auto r = stack.back();
+                stack.pop_back();
+                while (!stack.empty()) {
+                    parent(r) = stack.back();
+                    r = stack.back();
+                    stack.pop_back();
+                }
+                parent(r) = r;
+            }
+
+            auto is_level_root = [&parent, &vertex_weights](index_t v) {
+                return parent(v) == v || vertex_weights(parent(v)) != vertex_weights(v);
+            };
+
+            // number the level components in decreasing order of (depth, largest vertex index) by a bucket sort
+            index_t num_levels = (index_t) max_level - (index_t) min_level + 1;
+            auto bucket = [max_tree, min_level, max_level](value_type l) {
+                return max_tree ? (index_t) max_level - (index_t) l : (index_t) l - (index_t) min_level;
+            };
+            std::vector<index_t> bucket_start(num_levels + 1, 0);
+            // invalid_index: not seen yet, 0: counted but not numbered (node numbers are greater than 0)
+            array_1d<index_t> node_number({(size_t) nbv}, invalid_index);
+            for (index_t v = nbv - 1; v >= 0; v--) {
+                auto root = is_level_root(v) ? v : parent(v);
+                if (node_number(root) == invalid_index) {
+                    node_number(root) = 0;
+                    bucket_start[bucket(vertex_weights(root)) + 1]++;
+                }
+            }
+            for (index_t i = 0; i < num_levels; i++) {
+                bucket_start[i + 1] += bucket_start[i];
+            }
+            index_t num_nodes = bucket_start[num_levels];
+            for (index_t v = nbv - 1; v >= 0; v--) {
+                auto root = is_level_root(v) ? v : parent(v);
+                if (node_number(root) == 0) {
+                    node_number(root) = nbv + bucket_start[bucket(vertex_weights(root))]++;
+                }
+            }
+
+            array_1d<index_t> new_parents = array_1d<index_t>::from_shape({(size_t) (nbv + num_nodes)});
+            array_1d<value_type> altitudes = array_1d<value_type>::from_shape({(size_t) (nbv + num_nodes)});
+            for (index_t v = 0; v < nbv; v++) {
+                altitudes(v) = vertex_weights(v);
+                if (is_level_root(v)) {
+                    auto node = node_number(v);
+                    altitudes(node) = vertex_weights(v);
+                    // as in expand_canonized_parent_relation, the parent of a root is the previous node
+                    new_parents(node) = (parent(v) == v) ? node - 1 : node_number(parent(v));
+                    new_parents(v) = node;
+                } else {
+                    new_parents(v) = node_number(parent(v));
+                }
+            }
+            new_parents(nbv + num_nodes - 1) = nbv + num_nodes - 1;
+
+            return make_node_weighted_tree(tree(std::move(new_parents), tree_category::component_tree),
+                                           std::move(altitudes));
+        }
+
+        template<typename graph_t, typename T>
+        auto component_tree(const graph_t &graph,
+                            const T &vertex_weights,
+                            bool max_tree,
+                            component_tree_engine::sequential) {
+            array_1d<index_t> sorted_vertex_indices = sort_vertices(vertex_weights, max_tree);
+            return tree_from_sorted_vertices(graph, vertex_weights, sorted_vertex_indices);
+        }
+
+        template<typename embedding_t, typename T>
+        auto component_tree(const regular_graph<embedding_t> &graph,
+                            const T &vertex_weights,
+                            bool max_tree,
+                            component_tree_engine::tiled) {
+            array_1d<index_t> sorted_vertex_indices = sort_vertices(vertex_weights, max_tree);
+            auto parents = canonized_tree_construction_tiled(graph, vertex_weights, sorted_vertex_indices,
+                                                             component_tree_engine::tiled::num_tiles());
+            return tree_from_canonized_tree(parents, vertex_weights, sorted_vertex_indices);
+        }
+
+        template<typename graph_t, typename T>
+        auto component_tree(const graph_t &graph,
+                            const T &vertex_weights,
+                            bool max_tree,
+                            component_tree_engine::hierarchical_queue) {
+            return tree_by_flooding(graph, vertex_weights, max_tree);
+        }
+
+        template<typename graph_t, typename T>
+        auto component_tree_automatic(const graph_t &graph,
+                                      const T &vertex_weights,
+                                      bool max_tree,
+                                      std::false_type /* integral weights */) {
+            return component_tree(graph, vertex_weights, max_tree, component_tree_engine::sequential());
+        }
+
+        template<typename graph_t, typename T>
+        auto component_tree_automatic(const graph_t &graph,
+                                      const T &vertex_weights,
+                                      bool max_tree,
+                                      std::true_type /* integral weights */) {
+            index_t nbv = num_vertices(graph);
+            if (nbv > 0) {
+                double num_levels = (double) xt::amax(vertex_weights)() - (double) xt::amin(vertex_weights)() + 1;
+                if (num_levels <= component_tree_engine::automatic::max_num_levels && num_levels <= nbv) {
+                    return component_tree(graph, vertex_weights, max_tree,
+                                          component_tree_engine::hierarchical_queue());
+                }
+            }
+            return component_tree(graph, vertex_weights, max_tree, component_tree_engine::sequential());
+        }
+
+        template<typename graph_t, typename T>
+        auto component_tree(const graph_t &graph,
+                            const T &vertex_weights,
+                            bool max_tree,
+                            component_tree_engine::automatic) {
+            return component_tree_automatic(graph, vertex_weights, max_tree,
+                                            std::is_integral<typename T::value_type>());
+        }
+
+        template<typename embedding_t, typename T>
+        auto component_tree(const regular_graph<embedding_t> &graph,
+                            const T &vertex_weights,
+                            bool max_tree,
+                            component_tree_engine::automatic) {
+#ifdef HG_USE_TBB
+            if ((index_t) num_vertices(graph) >= component_tree_engine::automatic::tiled_min_size) {
+                return component_tree(graph, vertex_weights, max_tree, component_tree_engine::tiled());
+            }
+#endif
+            return component_tree_automatic(graph, vertex_weights, max_tree,
+                                            std::is_integral<typename T::value_type>());
+        }
     }
 
     /**
@@ -154,21 +651,22 @@ namespace hg {
      * Component Tree Computation with Application to Pattern Recognition in Astronomical Imaging,"
      * IEEE ICIP 2007.
      *
+     * @tparam engine_t component_tree_engine::automatic, sequential, tiled (regular graphs only), or hierarchical_queue
+    *         (integral vertex weights only)
      * @tparam graph_t
      * @tparam T
      * @param graph input graph
      * @param vertex_weights graph vertex weights
      * @return a node weighted tree
      */
-    template<typename graph_t, typename T>
+    template<typename engine_t = component_tree_engine::automatic, typename graph_t, typename T>
     auto component_tree_max_tree(const graph_t &graph, const xt::xexpression<T> &xvertex_weights) {
         HG_TRACE();
         auto &vertex_weights = xvertex_weights.derived_cast();
         hg_assert_vertex_weights(graph, vertex_weights);
         hg_assert_1d_array(vertex_weights);
 
-        array_1d<index_t> sorted_vertex_indices = stable_arg_sort(vertex_weights);
-        return component_tree_internal::tree_from_sorted_vertices(graph, vertex_weights, sorted_vertex_indices);
+        return component_tree_internal::component_tree(graph, vertex_weights, true, engine_t());
     }
 
     /**
@@ -187,22 +685,22 @@ namespace hg {
     * Component Tree Computation with Application to Pattern Recognition in Astronomical Imaging,"
     * IEEE ICIP 2007.
     *
+    * @tparam engine_t component_tree_engine::automatic, sequential, tiled (regular graphs only), or hierarchical_queue
+    *         (integral vertex weights only)
     * @tparam graph_t
     * @tparam T
     * @param graph input graph
     * @param vertex_weights graph vertex weights
     * @return a node weighted tree
     */
-    template<typename graph_t, typename T>
+    template<typename engine_t = component_tree_engine::automatic, typename graph_t, typename T>
     auto component_tree_min_tree(const graph_t &graph, const xt::xexpression<T> &xvertex_weights) {
         HG_TRACE();
         auto &vertex_weights = xvertex_weights.derived_cast();
         hg_assert_vertex_weights(graph, vertex_weights);
         hg_assert_1d_array(vertex_weights);
 
-        array_1d<index_t> sorted_vertex_indices = stable_arg_sort(vertex_weights,
-                                                                  std::greater<typename T::value_type>());
-        return component_tree_internal::tree_from_sorted_vertices(graph, vertex_weights, sorted_vertex_indices);
+        return component_tree_internal::component_tree(graph, vertex_weights, false, engine_t());
     }
 
 }
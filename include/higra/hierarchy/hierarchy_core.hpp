@@ -22,6 +22,8 @@
 #include <utility>
 #include <tuple>
 #include <queue>
+#include <numeric>
+#include <unordered_map>
 
 namespace hg {
 
@@ -51,8 +53,150 @@ namespace hg {
                                                               std::forward<array_1d<index_t> >(mst_edge_map)};
     }
 
+    /**
+     * Algorithms available to compute the canonical binary partition tree from a sorted list of edges.
+     *
+     *  - kruskal: sequential Kruskal like algorithm
+     *  - filter_kruskal: edges are processed by blocks of increasing sizes, after each block the remaining edges
+     *    whose extremities are already connected are removed in parallel. The result is identical to the one of the
+     *    sequential algorithm.
+     */
+    enum class bpt_canonical_algorithm {
+        kruskal,
+        filter_kruskal
+    };
+
     namespace hierarchy_core_internal {
-        template<typename E1, typename E2, typename T>
+
+        /**
+         * Removes, in parallel, the edges of candidates[start, end) whose extremities are already in the same
+         * set of the given union find. The relative order of the remaining edges is preserved and they are
+         * written in output[0, r) where r is the returned value.
+         */
+        template<typename E1, typename E2, typename uf_t>
+        index_t filter_connected_edges(const E1 &sources,
+                                       const E2 &targets,
+                                       const array_1d<index_t> &candidates,
+                                       const index_t start,
+                                       const index_t end,
+                                       const uf_t &uf,
+                                       array_1d<index_t> &output) {
+            const index_t chunk_size = 1 << 14;
+            const index_t num_candidates = end - start;
+            const index_t num_chunks = (num_candidates + chunk_size - 1) / chunk_size;
+
+            array_1d<bool> keep = array_1d<bool>::from_shape({(size_t) num_candidates});
+            array_1d<index_t> chunk_offsets = xt::zeros<index_t>({(size_t) num_chunks + 1});
+
+            parfor(0, num_chunks, [&](index_t c) {
+                index_t chunk_end = (std::min)((c + 1) * chunk_size, num_candidates);
+                index_t count = 0;
+                for (index_t i = c * chunk_size; i < chunk_end; i++) {
+                    auto ei = candidates(start + i);
+                    keep(i) = uf.find_no_compression(sources(ei)) != uf.find_no_compression(targets(ei));
+                    count += keep(i);
+                }
+                chunk_offsets(c + 1) = count;
+            });
+
+            for (index_t c = 0; c < num_chunks; c++) {
+                chunk_offsets(c + 1) += chunk_offsets(c);
+            }
+
+            parfor(0, num_chunks, [&](index_t c) {
+                index_t chunk_end = (std::min)((c + 1) * chunk_size, num_candidates);
+                index_t pos = chunk_offsets(c);
+                for (index_t i = c * chunk_size; i < chunk_end; i++) {
+                    if (keep(i)) {
+                        output(pos++) = candidates(start + i);
+                    }
+                }
+            });
+
+            return chunk_offsets(num_chunks);
+        }
+
+        /**
+         * Filter-Kruskal variant of bpt_canonical_from_sorted_edges.
+         *
+         * Edges are processed sequentially by blocks of increasing size (the first block contains
+         * initial_block_size edges, the size is doubled after each block). After each block, the remaining
+         * edges whose extremities are already connected are removed in parallel, they would have been
+         * skipped by the sequential algorithm anyway: the result is thus strictly identical.
+         *
+         * @param initial_block_size size of the first block of edges, if 0 it is set to the number of vertices
+         */
+        template<typename uf_t = union_find, typename E1, typename E2, typename T>
+        auto bpt_canonical_from_sorted_edges_filter_kruskal(const xt::xexpression<E1> &xsources,
+                                                            const xt::xexpression<E2> &xtargets,
+                                                            const xt::xexpression<T> &xsorted_edge_indices,
+                                                            const index_t num_vertices,
+                                                            index_t initial_block_size = 0) {
+            HG_TRACE();
+            auto &sorted_edge_indices = xsorted_edge_indices.derived_cast();
+            auto &sources = xsources.derived_cast();
+            auto &targets = xtargets.derived_cast();
+            hg_assert_1d_array(sources);
+            hg_assert_same_shape(sources, targets);
+            hg_assert_same_shape(sources, sorted_edge_indices);
+            hg_assert_integral_value_type(sources);
+            hg_assert_integral_value_type(targets);
+            hg_assert_integral_value_type(sorted_edge_indices);
+            hg_assert(initial_block_size >= 0, "Initial block size cannot be negative.");
+
+            auto num_edge_mst = num_vertices - 1;
+
+            array_1d<index_t> mst_edge_map = xt::empty<index_t>({num_edge_mst});
+
+            uf_t uf(num_vertices);
+
+            array_1d<index_t> roots = xt::arange<index_t>(num_vertices);
+            array_1d<index_t> parents = xt::arange<index_t>(num_vertices * 2 - 1);
+
+            array_1d<index_t> candidates = sorted_edge_indices;
+            array_1d<index_t> buffer = array_1d<index_t>::from_shape({candidates.size()});
+            index_t num_candidates = candidates.size();
+            index_t block_size = (initial_block_size > 0) ? initial_block_size : (std::max)(num_vertices,
+                                                                                            (index_t) 1);
+
+            index_t num_nodes = num_vertices;
+            index_t num_edge_found = 0;
+            index_t i = 0;
+
+            while (num_edge_found < num_edge_mst && i < num_candidates) {
+                index_t block_end = (std::min)(i + block_size, num_candidates);
+                while (num_edge_found < num_edge_mst && i < block_end) {
+                    auto ei = candidates(i);
+                    auto c1 = uf.find(sources(ei));
+                    auto c2 = uf.find(targets(ei));
+                    if (c1 != c2) {
+                        parents[roots[c1]] = num_nodes;
+                        parents[roots[c2]] = num_nodes;
+                        auto newRoot = uf.link(c1, c2);
+                        roots[newRoot] = num_nodes;
+                        mst_edge_map(num_edge_found) = ei;
+                        num_nodes++;
+                        num_edge_found++;
+                    }
+                    i++;
+                }
+
+                if (num_edge_found < num_edge_mst && i < num_candidates) {
+                    num_candidates = filter_connected_edges(sources, targets, candidates, i, num_candidates, uf,
+                                                            buffer);
+                    std::swap(candidates, buffer);
+                    i = 0;
+                    block_size *= 2;
+                }
+            }
+            hg_assert(num_edge_found == num_edge_mst, "Input graph must be connected.");
+
+            return std::make_pair(
+                    parents,
+                    std::move(mst_edge_map));
+        };
+
+        template<typename uf_t = union_find, typename E1, typename E2, typename T>
         auto bpt_canonical_from_sorted_edges(const xt::xexpression<E1> &xsources,
                                              const xt::xexpression<E2> &xtargets,
                                              const xt::xexpression<T> &xsorted_edge_indices,
@@ -72,7 +216,7 @@ namespace hg {
 
             array_1d<index_t> mst_edge_map = xt::empty<index_t>({num_edge_mst});
 
-            union_find uf(num_vertices);
+            uf_t uf(num_vertices);
 
             array_1d<index_t> roots = xt::arange<index_t>(num_vertices);
             array_1d<index_t> parents = xt::arange<index_t>(num_vertices * 2 - 1);
@@ -102,6 +246,24 @@ namespace hg {
                     parents,
                     std::move(mst_edge_map));
         };
+
+        template<typename uf_t = union_find, typename E1, typename E2, typename T>
+        auto bpt_canonical_from_sorted_edges(const xt::xexpression<E1> &xsources,
+                                             const xt::xexpression<E2> &xtargets,
+                                             const xt::xexpression<T> &xsorted_edge_indices,
+                                             const index_t num_vertices,
+                                             bpt_canonical_algorithm algorithm) {
+            switch (algorithm) {
+                case bpt_canonical_algorithm::kruskal:
+                    return bpt_canonical_from_sorted_edges<uf_t>(xsources, xtargets, xsorted_edge_indices,
+                                                                 num_vertices);
+                case bpt_canonical_algorithm::filter_kruskal:
+                    return bpt_canonical_from_sorted_edges_filter_kruskal<uf_t>(xsources, xtargets,
+                                                                                xsorted_edge_indices, num_vertices);
+                default:
+                    throw std::runtime_error("Unsupported bpt canonical algorithm.");
+            }
+        }
     }
 
     /**
@@ -116,14 +278,21 @@ namespace hg {
      * L. Najman, J. Cousty, B. Perret. Playing with Kruskal: algorithms for morphological trees in edge-weighted graphs.
      * In, 11th International Symposium on Mathematical Morphology, ISMM 2013, Uppsala, Sweden, Mai 2013.
      *
+     * The edges are processed either with a sequential Kruskal like algorithm or with a filter-Kruskal algorithm
+     * whose filtering steps run in parallel (see bpt_canonical_algorithm): both algorithms give the same result.
+     *
+     * @tparam uf_t union find implementation (see unionfind.hpp)
      * @tparam graph_t
      * @tparam T
      * @param graph
      * @param xedge_weights
+     * @param algorithm algorithm used to process the sorted edges
      * @return
      */
-    template<typename graph_t, typename T>
-    auto bpt_canonical(const graph_t &graph, const xt::xexpression<T> &xedge_weights) {
+    template<typename uf_t = union_find, typename graph_t, typename T>
+    auto bpt_canonical(const graph_t &graph,
+                       const xt::xexpression<T> &xedge_weights,
+                       bpt_canonical_algorithm algorithm = bpt_canonical_algorithm::kruskal) {
         HG_TRACE();
         auto &edge_weights = xedge_weights.derived_cast();
         hg_assert_edge_weights(graph, edge_weights);
@@ -131,10 +300,11 @@ namespace hg {
 
         array_1d<index_t> sorted_edges_indices = stable_arg_sort(edge_weights);
 
-        auto res = hierarchy_core_internal::bpt_canonical_from_sorted_edges(sources(graph),
-                                                                            targets(graph),
-                                                                            sorted_edges_indices,
-                                                                            num_vertices(graph));
+        auto res = hierarchy_core_internal::bpt_canonical_from_sorted_edges<uf_t>(sources(graph),
+                                                                                  targets(graph),
+                                                                                  sorted_edges_indices,
+                                                                                  num_vertices(graph),
+                                                                                  algorithm);
         auto &parents = res.first;
         auto &mst_edge_map = res.second;
 
@@ -151,6 +321,1171 @@ namespace hg {
     };
 
 
+    /**
+     * A simple structure to hold the result of bpt_canonical_batch: a forest of binary partition trees stored as
+     * flat arrays.
+     *
+     * The nodes of the k-th tree are stored in the range [node_offsets(k), node_offsets(k + 1)) of parents and
+     * altitudes, and parent indices are relative to the first node of the tree. The building edges of the k-th tree are
+     * stored in the range [node_offsets(k) - vertex_offsets(k), node_offsets(k + 1) - vertex_offsets(k + 1)) of
+     * mst_edge_map, and edge indices are relative to the first edge of the k-th graph.
+     *
+     * @tparam altitude_t
+     */
+    template<typename altitude_t>
+    struct node_weighted_forest_and_mst {
+        array_1d<index_t> parents;
+        altitude_t altitudes;
+        array_1d<index_t> mst_edge_map;
+        array_1d<index_t> node_offsets;
+    };
+
+    /**
+     * Computes the canonical binary partition trees of a batch of edge weighted graphs.
+     *
+     * The graphs are given in a CSR like format: the edges of the k-th graph are stored in the range
+     * [edge_offsets(k), edge_offsets(k + 1)) of sources, targets and edge_weights, and the k-th graph has
+     * vertex_offsets(k + 1) - vertex_offsets(k) vertices. Vertex indices in sources and targets are relative to
+     * the graph they belong to (the vertices of any graph are numbered from 0).
+     *
+     * The trees are computed in parallel with the same algorithm as bpt_canonical and the result is a forest
+     * stored as flat arrays (see node_weighted_forest_and_mst). A graph with no vertex gives an empty tree.
+     *
+     * @tparam E1
+     * @tparam E2
+     * @tparam T
+     * @tparam O1
+     * @tparam O2
+     * @param xsources concatenated edge sources of all the graphs
+     * @param xtargets concatenated edge targets of all the graphs
+     * @param xedge_weights concatenated edge weights of all the graphs
+     * @param xedge_offsets offsets of the edges of each graph (size: number of graphs + 1)
+     * @param xvertex_offsets offsets of the vertices of each graph (size: number of graphs + 1)
+     * @return a node_weighted_forest_and_mst
+     */
+    template<typename E1, typename E2, typename T, typename O1, typename O2>
+    auto bpt_canonical_batch(const xt::xexpression<E1> &xsources,
+                             const xt::xexpression<E2> &xtargets,
+                             const xt::xexpression<T> &xedge_weights,
+                             const xt::xexpression<O1> &xedge_offsets,
+                             const xt::xexpression<O2> &xvertex_offsets) {
+        HG_TRACE();
+        auto &sources = xsources.derived_cast();
+        auto &targets = xtargets.derived_cast();
+        auto &edge_weights = xedge_weights.derived_cast();
+        auto &edge_offsets = xedge_offsets.derived_cast();
+        auto &vertex_offsets = xvertex_offsets.derived_cast();
+        hg_assert_1d_array(sources);
+        hg_assert_same_shape(sources, targets);
+        hg_assert_same_shape(sources, edge_weights);
+        hg_assert_integral_value_type(sources);
+        hg_assert_integral_value_type(targets);
+        hg_assert_1d_array(edge_offsets);
+        hg_assert_same_shape(edge_offsets, vertex_offsets);
+        hg_assert_integral_value_type(edge_offsets);
+        hg_assert_integral_value_type(vertex_offsets);
+        hg_assert(edge_offsets.size() > 0, "Offset arrays cannot be empty.");
+        using value_type = typename T::value_type;
+
+        const index_t num_graphs = edge_offsets.size() - 1;
+        hg_assert(edge_offsets(0) == 0 && (index_t) edge_offsets(num_graphs) == (index_t) sources.size(),
+                  "Edge offsets must start at 0 and end at the total number of edges.");
+        hg_assert(vertex_offsets(0) == 0, "Vertex offsets must start at 0.");
+
+        array_1d<index_t> node_offsets = array_1d<index_t>::from_shape({(size_t) num_graphs + 1});
+        node_offsets(0) = 0;
+        for (index_t k = 0; k < num_graphs; k++) {
+            hg_assert(edge_offsets(k) <= edge_offsets(k + 1), "Edge offsets must be increasing.");
+            hg_assert(vertex_offsets(k) <= vertex_offsets(k + 1), "Vertex offsets must be increasing.");
+            index_t num_v = vertex_offsets(k + 1) - vertex_offsets(k);
+            node_offsets(k + 1) = node_offsets(k) + ((num_v > 0) ? num_v * 2 - 1 : 0);
+        }
+
+        const index_t num_nodes = node_offsets(num_graphs);
+        const index_t num_mst_edges = num_nodes - (index_t) vertex_offsets(num_graphs);
+        array_1d<index_t> parents = array_1d<index_t>::from_shape({(size_t) num_nodes});
+        array_1d<value_type> altitudes = array_1d<value_type>::from_shape({(size_t) num_nodes});
+        array_1d<index_t> mst_edge_map = array_1d<index_t>::from_shape({(size_t) num_mst_edges});
+
+        parfor(0, num_graphs, [&](index_t k) {
+            const index_t num_v = vertex_offsets(k + 1) - vertex_offsets(k);
+            if (num_v == 0) {
+                return;
+            }
+            auto edge_range = xt::range((index_t) edge_offsets(k), (index_t) edge_offsets(k + 1));
+            auto graph_sources = xt::view(sources, edge_range);
+            auto graph_targets = xt::view(targets, edge_range);
+            auto graph_edge_weights = xt::view(edge_weights, edge_range);
+            for (index_t i = 0; i < (index_t) graph_sources.size(); i++) {
+                hg_assert(graph_sources(i) >= 0 && graph_sources(i) < num_v &&
+                          graph_targets(i) >= 0 && graph_targets(i) < num_v,
+                          "Vertex indices must be smaller than the number of vertices of their graph.");
+            }
+
+            array_1d<index_t> sorted_edges_indices = stable_arg_sort(graph_edge_weights);
+            auto res = hierarchy_core_internal::bpt_canonical_from_sorted_edges(graph_sources,
+                                                                                graph_targets,
+                                                                                sorted_edges_indices,
+                                                                                num_v);
+            auto &graph_parents = res.first;
+            auto &graph_mst_edge_map = res.second;
+
+            const index_t node_offset = node_offsets(k);
+            const index_t mst_offset = node_offset - vertex_offsets(k);
+            for (index_t i = 0; i < num_v * 2 - 1; i++) {
+                parents(node_offset + i) = graph_parents(i);
+            }
+            for (index_t i = 0; i < num_v; i++) {
+                altitudes(node_offset + i) = 0;
+            }
+            for (index_t i = 0; i < num_v - 1; i++) {
+                mst_edge_map(mst_offset + i) = graph_mst_edge_map(i);
+                altitudes(node_offset + num_v + i) = graph_edge_weights(graph_mst_edge_map(i));
+            }
+        });
+
+        return node_weighted_forest_and_mst<array_1d<value_type>>{std::move(parents),
+                                                                  std::move(altitudes),
+                                                                  std::move(mst_edge_map),
+                                                                  std::move(node_offsets)};
+    }
+
+
+    /**
+     * A simple structure to hold the result of bpt_canonical_update: the updated canonical binary partition tree,
+     * its altitudes, its minimum spanning tree, and a node map that gives for each node of the updated tree the index
+     * of the corresponding node in the previous tree, or invalid_index if the node has been rebuilt.
+     *
+     * @tparam tree_t
+     * @tparam altitude_t
+     */
+    template<typename tree_t, typename altitude_t>
+    struct remapped_node_weighted_tree_and_mst {
+        tree_t tree;
+        altitude_t altitudes;
+        array_1d<index_t> mst_edge_map;
+        array_1d<index_t> node_map;
+    };
+
+    namespace hierarchy_core_internal {
+
+        /**
+         * Strict total order on the edges used by bpt_canonical: edges are sorted by increasing weights and
+         * ties are broken by edge indices.
+         */
+        template<typename value_type>
+        bool edge_key_less(const value_type w1, const index_t e1, const value_type w2, const index_t e2) {
+            return w1 < w2 || (!(w2 < w1) && e1 < e2);
+        }
+
+        /**
+         * Scratch map from indices in [0, capacity) to values, unset elements are equal to a default value.
+         *
+         * Elements are stored in a hash map while the map holds few elements, and in a dense array of size capacity
+         * once the number of elements exceeds capacity / dense_ratio: the memory and the initialization time are
+         * proportional to the number of elements set, and large maps do not pay the cost of hashing.
+         */
+        template<typename value_t>
+        struct adaptive_index_map {
+            static const index_t dense_ratio = 64;
+
+            adaptive_index_map(index_t capacity, value_t default_value) :
+                    m_capacity(capacity), m_default_value(default_value) {}
+
+            value_t get(index_t i) const {
+                if (!m_dense.empty()) {
+                    return m_dense[i];
+                }
+                auto it = m_sparse.find(i);
+                return (it == m_sparse.end()) ? m_default_value : it->second;
+            }
+
+            void set(index_t i, value_t value) {
+                if (!m_dense.empty()) {
+                    m_dense[i] = value;
+                    return;
+                }
+                m_sparse[i] = value;
+                if ((index_t) m_sparse.size() > m_capacity / dense_ratio) {
+                    m_dense.assign(m_capacity, m_default_value);
+                    for (auto &e: m_sparse) {
+                        m_dense[e.first] = e.second;
+                    }
+                    std::unordered_map<index_t, value_t>().swap(m_sparse);
+                }
+            }
+
+        private:
+            index_t m_capacity;
+            value_t m_default_value;
+            std::unordered_map<index_t, value_t> m_sparse;
+            std::vector<value_t> m_dense;
+        };
+
+        /**
+         * Result of bpt_canonical_repair: the nodes of the previous tree that must be rebuilt and the nodes that
+         * replace them.
+         *
+         * The replacing nodes are numbered as in a Kruskal algorithm on the maximal kept sub-trees whose parent is
+         * rebuilt: the node n < frontier_nodes.size() is the kept sub-tree rooted in frontier_nodes[n], and the node
+         * frontier_nodes.size() + j is the j-th new node, built by the edge rebuilt_edges[j].
+         */
+        struct bpt_canonical_repair_result {
+            // rebuilt nodes of the previous tree, by decreasing key
+            std::vector<index_t> rebuilt_nodes;
+            // roots of the maximal kept sub-trees whose parent is rebuilt
+            std::vector<index_t> frontier_nodes;
+            // position of each frontier node in frontier_nodes
+            std::unordered_map<index_t, index_t> frontier_index;
+            // parent of the kept sub-trees and of the new nodes, invalid_index for the highest new node of a region
+            std::vector<index_t> new_parents;
+            // building edges of the new nodes, by increasing key
+            std::vector<index_t> rebuilt_edges;
+            // highest rebuilt node of the previous tree in the region of each new node
+            std::vector<index_t> rebuilt_regions;
+        };
+
+        /**
+         * Finds the nodes of a canonical binary partition tree which must be rebuilt after the modification of the
+         * weights of some edges, and rebuilds them (see bpt_canonical_update for the description of the algorithm).
+         *
+         * The previous tree is accessed through tree_view which must provide:
+         *
+         *  - root(): the root of the tree
+         *  - parent(n): the parent of the node n
+         *  - altitude(n) and edge(n): the altitude and the building edge of the internal node n
+         *  - is_mst_edge(x, ei, w): true if the edge ei, of extremity x and of weight w, belongs to the minimum
+         *    spanning tree
+         *  - in_mst(ei): true if the edge ei belongs to the minimum spanning tree, used by the traversals of the
+         *    minimum spanning tree
+         *
+         * The indices of the nodes must be in [0, num_node_indices) and the nodes must be ordered by their keys
+         * (altitude and building edge, see edge_key_less) and not by their indices. The memory and the time are
+         * proportional to the number of rebuilt nodes, to the length of the walks from the extremities of the
+         * modified edges to their ancestors, and to the size of the components of the minimum spanning tree explored
+         * when edges of the minimum spanning tree are increased.
+         */
+        template<typename graph_t, typename tree_view_t, typename T, typename value_type>
+        auto bpt_canonical_repair(const graph_t &graph,
+                                  tree_view_t &tv,
+                                  const index_t num_node_indices,
+                                  const T &edge_weights,
+                                  const std::unordered_map<index_t, value_type> &modified_weights) {
+            const index_t num_points = num_vertices(graph);
+            const index_t root = tv.root();
+
+            auto weight = [&edge_weights, &modified_weights](index_t ei) -> value_type {
+                auto it = modified_weights.find(ei);
+                return (it == modified_weights.end()) ? edge_weights(ei) : it->second;
+            };
+            auto key_less = [&tv](index_t n1, index_t n2) {
+                return edge_key_less(tv.altitude(n1), tv.edge(n1), tv.altitude(n2), tv.edge(n2));
+            };
+
+            bpt_canonical_repair_result res;
+            auto &rebuilt_nodes = res.rebuilt_nodes;
+
+            // scratch structures are sparse: their size is proportional to the number of nodes reached by the
+            // walks and not to the size of the tree
+            // region(n): highest rebuilt node of the connected region of rebuilt nodes containing the rebuilt node n,
+            // invalid_index if n is kept. While the nodes are marked, region(n) is only a rebuilt ancestor of n in its
+            // region (see highest_rebuilt).
+            adaptive_index_map<index_t> region(num_node_indices, invalid_index);
+            std::vector<index_t> candidate_edges;
+            std::vector<index_t> path;
+
+            auto is_rebuilt = [&region](index_t n) {
+                return region.get(n) != invalid_index;
+            };
+
+            auto mark_rebuilt = [&region, &rebuilt_nodes, &is_rebuilt](index_t n) {
+                if (!is_rebuilt(n)) {
+                    region.set(n, n);
+                    rebuilt_nodes.push_back(n);
+                }
+            };
+
+            // highest node of the region of the rebuilt node n among the marked nodes, the paths are compressed as in
+            // a union-find
+            auto highest_rebuilt = [&](index_t n) {
+                path.clear();
+                index_t r = n;
+                while (true) {
+                    auto up = region.get(r);
+                    if (up == r) {
+                        if (r == root || !is_rebuilt(tv.parent(r))) {
+                            break;
+                        }
+                        up = tv.parent(r);
+                    }
+                    path.push_back(r);
+                    r = up;
+                }
+                for (auto p: path) {
+                    region.set(p, r);
+                }
+                return r;
+            };
+
+            // When the weight of an edge {x, y} decreases, the components above the lowest common ancestor of x and y
+            // do not change: the ancestors of x and y are marked from the bottom in increasing key order until they
+            // meet. The walks jump over the nodes already marked: all the ancestors of a rebuilt node up to the
+            // highest node of its region are rebuilt.
+            auto mark_ancestors_decrease = [&](index_t x, index_t y, value_type low, index_t ei) {
+                x = tv.parent(x);
+                y = tv.parent(y);
+                while (x != y) {
+                    auto &z = key_less(x, y) ? x : y;
+                    if (is_rebuilt(z)) {
+                        auto h = highest_rebuilt(z);
+                        if (h != z) {
+                            // the lowest common ancestor may be below h: keys are compared again before going above h
+                            z = h;
+                            continue;
+                        }
+                    } else if (!edge_key_less(tv.altitude(z), tv.edge(z), low, ei)) {
+                        mark_rebuilt(z);
+                    }
+                    z = tv.parent(z);
+                }
+                if (!edge_key_less(tv.altitude(x), tv.edge(x), low, ei)) {
+                    mark_rebuilt(x);
+                }
+            };
+
+            // When the weight of an edge of the mst increases, the ancestors of its extremities whose key is in
+            // [(lows[i], edges[i]), (highs[i], edges[i])] are marked. Those walks can be long, walked_by(n) is the
+            // increase with the largest upper bound whose walk went through n.
+            std::vector<value_type> lows;
+            std::vector<value_type> highs;
+            std::vector<index_t> increased_edges;
+            adaptive_index_map<index_t> walked_by(num_node_indices, invalid_index);
+
+            auto mark_ancestors_increase = [&](index_t x, index_t i) {
+                auto low = lows[i];
+                auto high = highs[i];
+                auto ei = increased_edges[i];
+                while (x != root) {
+                    x = tv.parent(x);
+                    auto nw = tv.altitude(x);
+                    auto ne = tv.edge(x);
+                    if (edge_key_less(high, ei, nw, ne)) {
+                        break;
+                    }
+                    auto j = walked_by.get(x);
+                    if (j != invalid_index) {
+                        auto ej = increased_edges[j];
+                        if (!edge_key_less(highs[j], ej, high, ei) &&
+                            (!edge_key_less(low, ei, lows[j], ej) || !edge_key_less(nw, ne, lows[j], ej))) {
+                            // the remaining ancestors have already been marked by the walk of the j-th increase
+                            break;
+                        }
+                    }
+                    if (j == invalid_index || edge_key_less(highs[j], increased_edges[j], high, ei)) {
+                        walked_by.set(x, i);
+                    }
+                    if (!edge_key_less(nw, ne, low, ei)) {
+                        mark_rebuilt(x);
+                    }
+                }
+            };
+
+            for (auto &modification: modified_weights) {
+                auto ei = modification.first;
+                value_type old_weight = edge_weights(ei);
+                value_type new_weight = modification.second;
+                if (!(old_weight < new_weight) && !(new_weight < old_weight)) {
+                    continue;
+                }
+                candidate_edges.push_back(ei);
+                auto e = edge_from_index(ei, graph);
+                if (new_weight < old_weight) {
+                    mark_ancestors_decrease(source(e, graph), target(e, graph), new_weight, ei);
+                } else if (tv.is_mst_edge(source(e, graph), ei, old_weight)) {
+                    // if the edge does not belong to the mst, its extremities remain linked by smaller edges
+                    lows.push_back(old_weight);
+                    highs.push_back(new_weight);
+                    increased_edges.push_back(ei);
+                    mark_ancestors_increase(source(e, graph), increased_edges.size() - 1);
+                    mark_ancestors_increase(target(e, graph), increased_edges.size() - 1);
+                }
+            }
+
+            if (rebuilt_nodes.empty()) {
+                return res;
+            }
+
+            // rebuilt nodes are grouped in connected regions identified by their highest node: parents have larger
+            // keys than their children
+            std::sort(rebuilt_nodes.begin(), rebuilt_nodes.end(),
+                      [&key_less](index_t n1, index_t n2) { return key_less(n2, n1); });
+            for (auto n: rebuilt_nodes) {
+                region.set(n, (n != root && is_rebuilt(tv.parent(n))) ? region.get(tv.parent(n)) : n);
+                candidate_edges.push_back(tv.edge(n));
+            }
+
+            // frontier(x) is the largest kept node containing the kept node x (its parent is rebuilt), or
+            // invalid_index if no ancestor of x is rebuilt (memoized on the walked paths)
+            const index_t unknown = -2;
+            adaptive_index_map<index_t> frontier(num_node_indices, unknown);
+            auto find_frontier = [&](index_t x) {
+                path.clear();
+                index_t res;
+                while ((res = frontier.get(x)) == unknown && x != root && !is_rebuilt(tv.parent(x))) {
+                    path.push_back(x);
+                    x = tv.parent(x);
+                }
+                if (res == unknown) {
+                    res = (x == root) ? invalid_index : x;
+                    frontier.set(x, res);
+                }
+                for (auto n: path) {
+                    frontier.set(n, res);
+                }
+                return res;
+            };
+            // regions may be nested: a kept node containing a leaf x is a descendant of a rebuilt node of several
+            // regions, the i-th element of the chain is the largest kept node containing x in the i-th region above x
+            std::vector<index_t> source_chain;
+            auto frontier_chain_next = [&](index_t f) {
+                auto r = region.get(tv.parent(f));
+                return (r == root) ? invalid_index : find_frontier(tv.parent(r));
+            };
+
+            // edges that may replace increased mst edges: an unmodified edge g can only enter the mst if the path
+            // linking its extremities in the previous mst contains an increased edge e, i.e. if g links two
+            // components of the previous mst without the increased edges, and if g lies between the previous and the
+            // new weight of e. Those components are explored with interleaved traversals which stop when all of them
+            // but one (usually the largest) are complete: the candidates are the edges leaving the complete
+            // components.
+            if (!increased_edges.empty()) {
+                // the traversals follow the edges of the mst without the increased edges
+                auto is_increased = [&edge_weights, &modified_weights](index_t ei) {
+                    auto it = modified_weights.find(ei);
+                    return it != modified_weights.end() && edge_weights(ei) < it->second;
+                };
+                value_type low = 0, high = 0;
+                index_t low_edge = invalid_index, high_edge = invalid_index;
+                for (auto ei: increased_edges) {
+                    if (low_edge == invalid_index || edge_key_less(edge_weights(ei), ei, low, low_edge)) {
+                        low = edge_weights(ei);
+                        low_edge = ei;
+                    }
+                    if (high_edge == invalid_index || edge_key_less(high, high_edge, weight(ei), ei)) {
+                        high = weight(ei);
+                        high_edge = ei;
+                    }
+                }
+
+                // a traversal is started from each extremity of each increased edge, traversals that meet are merged.
+                // The vertices of a traversal are stored in the order of their discovery: vertices[0, head) have
+                // already been processed.
+                struct traversal {
+                    std::vector<index_t> vertices;
+                    index_t head;
+                };
+                std::vector<traversal> traversals;
+                adaptive_index_map<index_t> traversal_of(num_points, invalid_index);
+                for (auto ei: increased_edges) {
+                    auto e = edge_from_index(ei, graph);
+                    for (auto v: {source(e, graph), target(e, graph)}) {
+                        if (traversal_of.get(v) == invalid_index) {
+                            traversal_of.set(v, traversals.size());
+                            traversals.push_back({{v}, 0});
+                        }
+                    }
+                }
+                union_find traversal_uf(traversals.size());
+                auto merge_traversals = [&traversals, &traversal_uf](index_t k1, index_t k2) {
+                    auto r = traversal_uf.link(k1, k2);
+                    auto &tr = traversals[r];
+                    auto &to = traversals[(r == k1) ? k2 : k1];
+                    tr.vertices.insert(tr.vertices.begin() + tr.head, to.vertices.begin(),
+                                       to.vertices.begin() + to.head);
+                    tr.head += to.head;
+                    tr.vertices.insert(tr.vertices.end(), to.vertices.begin() + to.head, to.vertices.end());
+                    std::vector<index_t>().swap(to.vertices);
+                    return r;
+                };
+
+                std::vector<index_t> active(traversals.size());
+                std::iota(active.begin(), active.end(), 0);
+                std::vector<index_t> next_active;
+                std::vector<index_t> complete;
+                const index_t num_components = increased_edges.size() + 1;
+                while ((index_t) complete.size() < num_components - 1) {
+                    next_active.clear();
+                    for (auto k: active) {
+                        if (traversal_uf.find(k) != k) {
+                            continue;
+                        }
+                        if (traversals[k].head == (index_t) traversals[k].vertices.size()) {
+                            complete.push_back(k);
+                            continue;
+                        }
+                        auto v = traversals[k].vertices[traversals[k].head++];
+                        for (auto oe: out_edge_iterator(v, graph)) {
+                            auto oi = index(oe, graph);
+                            if (!tv.in_mst(oi) || is_increased(oi)) {
+                                continue;
+                            }
+                            auto w = target(oe, graph);
+                            auto kv = traversal_uf.find(k);
+                            auto tw = traversal_of.get(w);
+                            if (tw == invalid_index) {
+                                traversal_of.set(w, kv);
+                                traversals[kv].vertices.push_back(w);
+                            } else {
+                                auto kw = traversal_uf.find(tw);
+                                if (kv != kw) {
+                                    merge_traversals(kv, kw);
+                                }
+                            }
+                        }
+                        next_active.push_back(traversal_uf.find(k));
+                    }
+                    std::sort(next_active.begin(), next_active.end());
+                    next_active.erase(std::unique(next_active.begin(), next_active.end()), next_active.end());
+                    active.swap(next_active);
+                }
+
+                for (auto k: complete) {
+                    for (auto v: traversals[k].vertices) {
+                        for (auto oe: out_edge_iterator(v, graph)) {
+                            auto w = target(oe, graph);
+                            auto gi = index(oe, graph);
+                            auto tw = traversal_of.get(w);
+                            if ((tw == invalid_index || traversal_uf.find(tw) != k) &&
+                                edge_key_less(low, low_edge, edge_weights(gi), gi) &&
+                                edge_key_less(edge_weights(gi), gi, high, high_edge)) {
+                                candidate_edges.push_back(gi);
+                            }
+                        }
+                    }
+                }
+            }
+
+            std::sort(candidate_edges.begin(), candidate_edges.end());
+            candidate_edges.erase(std::unique(candidate_edges.begin(), candidate_edges.end()), candidate_edges.end());
+
+            // edges linking two kept sub-trees of the same region, kept sub-trees are numbered in order of appearance
+            struct candidate_edge {
+                index_t edge;
+                value_type weight;
+                index_t source_set;
+                index_t target_set;
+                index_t region;
+            };
+            std::vector<candidate_edge> edges;
+            auto &frontier_index = res.frontier_index;
+            auto &frontier_nodes = res.frontier_nodes;
+            auto get_frontier_index = [&frontier_index, &frontier_nodes](index_t n) {
+                auto it = frontier_index.insert({n, (index_t) frontier_nodes.size()});
+                if (it.second) {
+                    frontier_nodes.push_back(n);
+                }
+                return it.first->second;
+            };
+            for (auto ei: candidate_edges) {
+                auto e = edge_from_index(ei, graph);
+                // an edge belongs to the lowest region containing its two extremities
+                source_chain.clear();
+                for (auto f = find_frontier(source(e, graph)); f != invalid_index; f = frontier_chain_next(f)) {
+                    source_chain.push_back(f);
+                }
+                for (auto ft = find_frontier(target(e, graph)); ft != invalid_index; ft = frontier_chain_next(ft)) {
+                    auto r = region.get(tv.parent(ft));
+                    auto it = std::find_if(source_chain.begin(), source_chain.end(),
+                                           [&](index_t fs) { return region.get(tv.parent(fs)) == r; });
+                    if (it != source_chain.end()) {
+                        if (*it != ft) {
+                            edges.push_back({ei, weight(ei), get_frontier_index(*it), get_frontier_index(ft), r});
+                        }
+                        break;
+                    }
+                }
+            }
+            std::sort(edges.begin(), edges.end(), [](const candidate_edge &a, const candidate_edge &b) {
+                return edge_key_less(a.weight, a.edge, b.weight, b.edge);
+            });
+
+            // Kruskal on the kept sub-trees: tree nodes are either kept sub-trees (index < num_frontiers) or
+            // rebuilt nodes (index num_frontiers + i for the i-th rebuilt node)
+            const index_t num_frontiers = frontier_nodes.size();
+            const index_t num_rebuilt = rebuilt_nodes.size();
+            union_find uf(num_frontiers);
+            std::vector<index_t> roots(num_frontiers);
+            std::iota(roots.begin(), roots.end(), 0);
+            auto &new_parents = res.new_parents;
+            auto &rebuilt_edges = res.rebuilt_edges;
+            auto &rebuilt_regions = res.rebuilt_regions;
+            new_parents.assign(num_frontiers + num_rebuilt, invalid_index);
+            rebuilt_edges.reserve(num_rebuilt);
+            rebuilt_regions.reserve(num_rebuilt);
+            for (auto &e: edges) {
+                auto c1 = uf.find(e.source_set);
+                auto c2 = uf.find(e.target_set);
+                if (c1 != c2) {
+                    hg_assert((index_t) rebuilt_edges.size() < num_rebuilt,
+                              "The given tree is not the canonical binary partition tree of the given edge weighted graph.");
+                    index_t n = num_frontiers + rebuilt_edges.size();
+                    new_parents[roots[c1]] = n;
+                    new_parents[roots[c2]] = n;
+                    roots[uf.link(c1, c2)] = n;
+                    rebuilt_edges.push_back(e.edge);
+                    rebuilt_regions.push_back(e.region);
+                }
+            }
+            hg_assert((index_t) rebuilt_edges.size() == num_rebuilt,
+                      "The given tree is not the canonical binary partition tree of the given edge weighted graph.");
+            return res;
+        }
+
+        /**
+         * Map from the modified edges to their new weights (the last weight is kept for an edge appearing several
+         * times in changed_edges).
+         */
+        template<typename value_type, typename graph_t, typename T1, typename T2>
+        auto make_modified_weights(const graph_t &graph, const T1 &changed_edges, const T2 &new_weights) {
+            hg_assert_1d_array(changed_edges);
+            hg_assert_integral_value_type(changed_edges);
+            hg_assert_same_shape(changed_edges, new_weights);
+            std::unordered_map<index_t, value_type> modified_weights;
+            for (index_t i = 0; i < (index_t) changed_edges.size(); i++) {
+                hg_assert(changed_edges(i) >= 0 && changed_edges(i) < (index_t) num_edges(graph),
+                          "Invalid edge index in changed edges.");
+                modified_weights[changed_edges(i)] = new_weights(i);
+            }
+            return modified_weights;
+        }
+
+        /**
+         * Access to a canonical binary partition tree for bpt_canonical_repair
+         */
+        template<typename graph_t, typename T2, typename T3>
+        struct canonical_bpt_view {
+            canonical_bpt_view(const graph_t &graph, const tree &t, const T2 &altitudes, const T3 &mst_edge_map) :
+                    m_graph(graph), m_tree(t), m_altitudes(altitudes), m_mst_edge_map(mst_edge_map),
+                    m_num_points(num_leaves(t)) {}
+
+            index_t root() const {
+                return m_tree.root();
+            }
+
+            index_t parent(index_t n) const {
+                return hg::parent(n, m_tree);
+            }
+
+            auto altitude(index_t n) const {
+                return m_altitudes(n);
+            }
+
+            index_t edge(index_t n) const {
+                return m_mst_edge_map(n - m_num_points);
+            }
+
+            // the edge ei of extremity x belongs to the mst iff it is the building edge of the lowest ancestor of x
+            // whose key is not smaller than the key of ei
+            template<typename value_type>
+            bool is_mst_edge(index_t x, index_t ei, value_type w) const {
+                do {
+                    x = parent(x);
+                } while (x != root() && edge_key_less(altitude(x), edge(x), w, ei));
+                return edge(x) == ei;
+            }
+
+            // mask of the mst edges, allocated on first use
+            bool in_mst(index_t ei) {
+                if (m_in_mst.empty()) {
+                    m_in_mst.assign(num_edges(m_graph), false);
+                    for (auto e: m_mst_edge_map) {
+                        m_in_mst[e] = true;
+                    }
+                }
+                return m_in_mst[ei];
+            }
+
+        private:
+            const graph_t &m_graph;
+            const tree &m_tree;
+            const T2 &m_altitudes;
+            const T3 &m_mst_edge_map;
+            index_t m_num_points;
+            std::vector<char> m_in_mst;
+        };
+    }
+
+    /**
+     * Updates the canonical binary partition tree of an edge weighted graph after the modification of the weights
+     * of a subset of edges.
+     *
+     * The result is identical to the one of bpt_canonical on the graph weighted by the new edge weights, but only the
+     * parts of the tree that can be affected by the modifications are recomputed. For a threshold k, the components
+     * of the graph made of the edges smaller than k can only change if they contain an extremity of an edge whose
+     * previous and new weights are on both sides of k. Hence, a node of the previous tree is kept (with the same
+     * building edge and the same altitude) unless it contains an extremity of a modified edge e and its altitude is
+     * between the previous and the new weight of e (or between the new weight of e and the altitude of the lowest
+     * common ancestor of its extremities if the weight decreases). The other nodes are rebuilt with a Kruskal
+     * algorithm on the graph whose vertices are the maximal kept sub-trees and whose edges are:
+     *
+     *  - the building edges of the rebuilt nodes,
+     *  - the modified edges, and
+     *  - the edges that may replace an increased edge of the minimum spanning tree (cut property): those edges
+     *    leave a component of the previous minimum spanning tree without the increased edges, and all those
+     *    components except one are explored.
+     *
+     * Increases of edges that do not belong to the minimum spanning tree do not lead to any recomputation.
+     *
+     * Complexity: O(n + W + R log(R) + C), where n is the number of nodes of the tree, W is the total length of the
+     * walks from the extremities of the modified edges and of the edges of the Kruskal algorithm to the rebuilt
+     * nodes, R is the number of rebuilt nodes, and C is the number of edges adjacent to the components of the minimum
+     * spanning tree explored when edges of the minimum spanning tree are increased (a mask of num_edges(graph) bytes
+     * is then also allocated). Each walk is bounded by the depth of the tree: canonical trees of images are often
+     * deep and W can be a large fraction of n. The O(n) term comes from the renumbering of the nodes: the nodes of a
+     * canonical tree are numbered in the order of their building edges. dynamic_bpt_canonical updates a tree whose
+     * node indices do not change in place, without this term.
+     *
+     * If an edge appears several times in changed_edges, the last weight is used.
+     *
+     * @tparam graph_t
+     * @tparam T1
+     * @tparam T2
+     * @tparam T3
+     * @tparam T4
+     * @tparam T5
+     * @param graph input graph (must be connected)
+     * @param xedge_weights edge weights before the update
+     * @param t canonical binary partition tree of the graph weighted by xedge_weights (see bpt_canonical)
+     * @param xaltitudes altitudes of the nodes of t
+     * @param xmst_edge_map building edge of each internal node of t
+     * @param xchanged_edges indices of the modified edges
+     * @param xnew_weights new weights of the modified edges
+     * @return a remapped_node_weighted_tree_and_mst
+     */
+    template<typename graph_t, typename T1, typename T2, typename T3, typename T4, typename T5>
+    auto bpt_canonical_update(const graph_t &graph,
+                              const xt::xexpression<T1> &xedge_weights,
+                              const tree &t,
+                              const xt::xexpression<T2> &xaltitudes,
+                              const xt::xexpression<T3> &xmst_edge_map,
+                              const xt::xexpression<T4> &xchanged_edges,
+                              const xt::xexpression<T5> &xnew_weights) {
+        HG_TRACE();
+        auto &edge_weights = xedge_weights.derived_cast();
+        auto &altitudes = xaltitudes.derived_cast();
+        auto &mst_edge_map = xmst_edge_map.derived_cast();
+        hg_assert_1d_array(edge_weights);
+        hg_assert_edge_weights(graph, edge_weights);
+        hg_assert_node_weights(t, altitudes);
+        hg_assert_1d_array(mst_edge_map);
+        hg_assert_integral_value_type(mst_edge_map);
+        hg_assert((index_t) num_leaves(t) == (index_t) num_vertices(graph),
+                  "The number of leaves of the tree must be equal to the number of vertices of the graph.");
+        hg_assert((index_t) mst_edge_map.size() == (index_t) (num_vertices(t) - num_leaves(t)),
+                  "The size of the mst edge map must be equal to the number of internal nodes of the tree.");
+        using value_type = typename T1::value_type;
+        using hierarchy_core_internal::edge_key_less;
+
+        const index_t num_points = num_leaves(t);
+        const index_t num_nodes = num_vertices(t);
+        const index_t root = t.root();
+
+        auto modified_weights = hierarchy_core_internal::make_modified_weights<value_type>(
+                graph, xchanged_edges.derived_cast(), xnew_weights.derived_cast());
+        auto weight = [&edge_weights, &modified_weights](index_t ei) -> value_type {
+            auto it = modified_weights.find(ei);
+            return (it == modified_weights.end()) ? edge_weights(ei) : it->second;
+        };
+
+        hierarchy_core_internal::canonical_bpt_view<graph_t, T2, T3> view(graph, t, altitudes, mst_edge_map);
+        auto repair = hierarchy_core_internal::bpt_canonical_repair(graph, view, num_nodes, edge_weights,
+                                                                    modified_weights);
+        auto &rebuilt_nodes = repair.rebuilt_nodes;
+        auto &frontier_nodes = repair.frontier_nodes;
+        auto &rebuilt_edges = repair.rebuilt_edges;
+
+        if (rebuilt_nodes.empty()) {
+            return remapped_node_weighted_tree_and_mst<hg::tree, array_1d<value_type>>{
+                    t,
+                    array_1d<value_type>(altitudes),
+                    array_1d<index_t>(mst_edge_map),
+                    xt::arange<index_t>(num_nodes)};
+        }
+
+        const index_t num_frontiers = frontier_nodes.size();
+        const index_t num_rebuilt = rebuilt_nodes.size();
+
+        // merge kept and rebuilt internal nodes in the order of their building edges, new_index(n) is invalid_index
+        // for a rebuilt node n
+        array_1d<index_t> new_index = array_1d<index_t>::from_shape({(size_t) num_nodes});
+        for (auto n: rebuilt_nodes) {
+            new_index(n) = invalid_index;
+        }
+        // rebuilt_nodes is sorted by decreasing key, i.e. by decreasing index in a canonical tree
+        auto next_rebuilt = rebuilt_nodes.rbegin();
+        std::vector<index_t> rebuilt_index(num_rebuilt);
+        array_1d<index_t> node_map = array_1d<index_t>::from_shape({(size_t) num_nodes});
+        array_1d<value_type> new_altitudes = array_1d<value_type>::from_shape({(size_t) num_nodes});
+        array_1d<index_t> new_mst_edge_map = array_1d<index_t>::from_shape({(size_t) (num_nodes - num_points)});
+        for (index_t i = 0; i < num_points; i++) {
+            new_index(i) = i;
+            node_map(i) = i;
+            new_altitudes(i) = altitudes(i);
+        }
+        for (index_t k = num_points, i = num_points, j = 0; k < num_nodes; k++) {
+            while (next_rebuilt != rebuilt_nodes.rend() && i == *next_rebuilt) {
+                i++;
+                next_rebuilt++;
+            }
+            if (i < num_nodes &&
+                (j == num_rebuilt ||
+                 edge_key_less(altitudes(i), mst_edge_map(i - num_points), weight(rebuilt_edges[j]), rebuilt_edges[j]))) {
+                new_index(i) = k;
+                node_map(k) = i;
+                new_altitudes(k) = altitudes(i);
+                new_mst_edge_map(k - num_points) = mst_edge_map(i - num_points);
+                i++;
+            } else {
+                rebuilt_index[j] = k;
+                node_map(k) = invalid_index;
+                new_altitudes(k) = weight(rebuilt_edges[j]);
+                new_mst_edge_map(k - num_points) = rebuilt_edges[j];
+                j++;
+            }
+        }
+
+        auto new_node_index = [&](index_t n) {
+            return (n < num_frontiers) ? new_index(frontier_nodes[n]) : rebuilt_index[n - num_frontiers];
+        };
+        array_1d<index_t> parents = array_1d<index_t>::from_shape({(size_t) num_nodes});
+        for (index_t i = 0; i < num_nodes; i++) {
+            if (new_index(i) == invalid_index) {
+                continue;
+            }
+            auto p = parent(i, t);
+            if (i == root) {
+                parents(new_index(i)) = new_index(i);
+            } else if (new_index(p) != invalid_index) {
+                parents(new_index(i)) = new_index(p);
+            } else {
+                auto it = repair.frontier_index.find(i);
+                hg_assert(it != repair.frontier_index.end(),
+                          "The given tree is not the canonical binary partition tree of the given edge weighted graph.");
+                parents(new_index(i)) = new_node_index(repair.new_parents[it->second]);
+            }
+        }
+        for (index_t j = 0; j < num_rebuilt; j++) {
+            auto n = num_frontiers + j;
+            if (repair.new_parents[n] != invalid_index) {
+                parents(rebuilt_index[j]) = new_node_index(repair.new_parents[n]);
+            } else {
+                // highest node of a region: its parent is the parent of the highest previous node of the region
+                auto r = repair.rebuilt_regions[j];
+                parents(rebuilt_index[j]) = (r == root) ? rebuilt_index[j] : new_index(parent(r, t));
+            }
+        }
+
+        return remapped_node_weighted_tree_and_mst<hg::tree, array_1d<value_type>>{
+                hg::tree(std::move(parents)),
+                std::move(new_altitudes),
+                std::move(new_mst_edge_map),
+                std::move(node_map)};
+    }
+
+    /**
+     * Nodes modified by an update of a dynamic_bpt_canonical: the nodes which do not appear in these arrays are
+     * unchanged (same parent, same building edge, and same altitude).
+     *
+     *  - removed_nodes: nodes of the previous tree which have been rebuilt,
+     *  - added_nodes: nodes which replace the removed nodes,
+     *  - reparented_nodes: nodes which have been kept but whose parent is an added node.
+     *
+     * A node which appears in both removed_nodes and added_nodes has been rebuilt with the same building edge: its
+     * parent, its children, or its altitude may have changed.
+     */
+    struct dynamic_bpt_canonical_changes {
+        array_1d<index_t> removed_nodes;
+        array_1d<index_t> added_nodes;
+        array_1d<index_t> reparented_nodes;
+    };
+
+    /**
+     * Canonical binary partition tree of an edge weighted graph that can be updated in place when the weights of
+     * a subset of edges are modified (see bpt_canonical and bpt_canonical_update).
+     *
+     * Node indices do not change during the updates: the leaf i is the vertex i of the graph and the internal node
+     * num_leaves() + ei is the node built by the edge ei of the graph. The tree is stored as a parent array of size
+     * num_vertices(graph) + num_edges(graph) where only the nodes built by an edge of the minimum spanning tree are
+     * valid (see is_node). Unlike in the tree returned by bpt_canonical, the parent of a node may have a smaller
+     * index than the node.
+     *
+     * An update only modifies the rebuilt nodes (see bpt_canonical_update): it runs in O(W + R log(R) + C), with the
+     * notations of bpt_canonical_update, and not in the size of the tree (the walks W are still bounded by its
+     * depth). canonical_tree builds the tree that
+     * bpt_canonical would return in O(num_edges(graph) + n log(n)) where n is the number of nodes of the tree.
+     *
+     * The graph is stored by reference and must not be modified nor destroyed while the object is used.
+     *
+     * @tparam graph_t
+     * @tparam value_type type of the edge weights
+     */
+    template<typename graph_t, typename value_type>
+    struct dynamic_bpt_canonical {
+
+        template<typename T>
+        dynamic_bpt_canonical(const graph_t &graph, const xt::xexpression<T> &xedge_weights):
+                m_graph(graph),
+                m_edge_weights(xedge_weights.derived_cast()),
+                m_num_points(num_vertices(graph)) {
+            auto bpt = bpt_canonical(graph, m_edge_weights);
+            auto &t = bpt.tree;
+            auto &mst_edge_map = bpt.mst_edge_map;
+            index_t num_edges_graph = num_edges(graph);
+
+            m_in_mst = array_1d<bool>::from_shape({(size_t) num_edges_graph});
+            m_in_mst.fill(false);
+            m_parents = array_1d<index_t>::from_shape({(size_t) (m_num_points + num_edges_graph)});
+            m_parents.fill(invalid_index);
+
+            auto node_index = [&](index_t n) {
+                return (n < m_num_points) ? n : m_num_points + mst_edge_map(n - m_num_points);
+            };
+            for (auto ei: mst_edge_map) {
+                m_in_mst(ei) = true;
+            }
+            for (auto n: leaves_to_root_iterator(t)) {
+                m_parents(node_index(n)) = node_index(hg::parent(n, t));
+            }
+            m_root = node_index(t.root());
+        }
+
+        const graph_t &graph() const {
+            return m_graph;
+        }
+
+        index_t num_leaves() const {
+            return m_num_points;
+        }
+
+        index_t root() const {
+            return m_root;
+        }
+
+        /**
+         * True if the given index is the index of a node of the tree: a leaf or a node built by an edge of the
+         * minimum spanning tree.
+         */
+        bool is_node(index_t n) const {
+            return n < m_num_points || m_in_mst(n - m_num_points);
+        }
+
+        index_t parent(index_t n) const {
+            return m_parents(n);
+        }
+
+        /**
+         * Parent of each node index, invalid_index for the indices which are not nodes of the tree.
+         */
+        const array_1d<index_t> &parents() const {
+            return m_parents;
+        }
+
+        value_type altitude(index_t n) const {
+            return (n < m_num_points) ? 0 : m_edge_weights(n - m_num_points);
+        }
+
+        index_t building_edge(index_t n) const {
+            return n - m_num_points;
+        }
+
+        const array_1d<value_type> &edge_weights() const {
+            return m_edge_weights;
+        }
+
+        /**
+         * Modifies the weights of the given edges and repairs the tree in place.
+         *
+         * If an edge appears several times in changed_edges, the last weight is used.
+         *
+         * @param xchanged_edges indices of the modified edges
+         * @param xnew_weights new weights of the modified edges
+         * @return the nodes removed from, added to, and moved in the tree (see dynamic_bpt_canonical_changes)
+         */
+        template<typename T1, typename T2>
+        dynamic_bpt_canonical_changes update(const xt::xexpression<T1> &xchanged_edges,
+                                             const xt::xexpression<T2> &xnew_weights) {
+            HG_TRACE();
+            auto modified_weights = hierarchy_core_internal::make_modified_weights<value_type>(
+                    m_graph, xchanged_edges.derived_cast(), xnew_weights.derived_cast());
+
+            tree_view view(*this);
+            auto repair = hierarchy_core_internal::bpt_canonical_repair(m_graph, view,
+                                                                        (index_t) m_parents.size(),
+                                                                        m_edge_weights, modified_weights);
+            auto &rebuilt_nodes = repair.rebuilt_nodes;
+            auto &frontier_nodes = repair.frontier_nodes;
+            auto &rebuilt_edges = repair.rebuilt_edges;
+            const index_t num_frontiers = frontier_nodes.size();
+            const index_t num_rebuilt = rebuilt_nodes.size();
+
+            auto new_node_index = [&](index_t n) {
+                return (n < num_frontiers) ? frontier_nodes[n] : m_num_points + rebuilt_edges[n - num_frontiers];
+            };
+
+            // the new parents are computed before the removal of the rebuilt nodes: the highest new node of a region
+            // takes the parent of the highest previous node of the region
+            std::vector<index_t> new_parents(num_frontiers + num_rebuilt);
+            index_t new_root = m_root;
+            for (index_t n = 0; n < num_frontiers + num_rebuilt; n++) {
+                if (repair.new_parents[n] != invalid_index) {
+                    new_parents[n] = new_node_index(repair.new_parents[n]);
+                } else {
+                    hg_assert(n >= num_frontiers,
+                              "The tree is not the canonical binary partition tree of the edge weighted graph.");
+                    auto r = repair.rebuilt_regions[n - num_frontiers];
+                    if (r == m_root) {
+                        new_root = new_node_index(n);
+                        new_parents[n] = new_root;
+                    } else {
+                        new_parents[n] = m_parents(r);
+                    }
+                }
+            }
+
+            for (auto n: rebuilt_nodes) {
+                m_parents(n) = invalid_index;
+                m_in_mst(n - m_num_points) = false;
+            }
+            for (auto ei: rebuilt_edges) {
+                m_in_mst(ei) = true;
+            }
+            for (index_t n = 0; n < num_frontiers + num_rebuilt; n++) {
+                m_parents(new_node_index(n)) = new_parents[n];
+            }
+            m_root = new_root;
+            for (auto &modification: modified_weights) {
+                m_edge_weights(modification.first) = modification.second;
+            }
+
+            dynamic_bpt_canonical_changes changes{array_1d<index_t>::from_shape({(size_t) num_rebuilt}),
+                                                  array_1d<index_t>::from_shape({(size_t) num_rebuilt}),
+                                                  array_1d<index_t>::from_shape({(size_t) num_frontiers})};
+            for (index_t j = 0; j < num_rebuilt; j++) {
+                changes.removed_nodes(j) = rebuilt_nodes[j];
+                changes.added_nodes(j) = m_num_points + rebuilt_edges[j];
+            }
+            std::copy(frontier_nodes.begin(), frontier_nodes.end(), changes.reparented_nodes.begin());
+            return changes;
+        }
+
+        /**
+         * Canonical binary partition tree (as returned by bpt_canonical) of the graph weighted by the current edge
+         * weights: the internal node num_leaves() + i of the result is the internal node
+         * num_leaves() + mst_edge_map(i) of this tree.
+         *
+         * @return a node_weighted_tree_and_mst
+         */
+        auto canonical_tree() const {
+            HG_TRACE();
+            index_t num_edges_graph = num_edges(m_graph);
+            std::vector<index_t> mst_edges;
+            mst_edges.reserve(std::max<index_t>(m_num_points - 1, 0));
+            for (index_t ei = 0; ei < num_edges_graph; ei++) {
+                if (m_in_mst(ei)) {
+                    mst_edges.push_back(ei);
+                }
+            }
+            std::sort(mst_edges.begin(), mst_edges.end(), [this](index_t e1, index_t e2) {
+                return hierarchy_core_internal::edge_key_less(m_edge_weights(e1), e1, m_edge_weights(e2), e2);
+            });
+
+            index_t num_nodes = m_num_points + mst_edges.size();
+            array_1d<index_t> canonical_index = array_1d<index_t>::from_shape({(size_t) num_edges_graph});
+            array_1d<index_t> mst_edge_map = array_1d<index_t>::from_shape({mst_edges.size()});
+            array_1d<value_type> altitudes = array_1d<value_type>::from_shape({(size_t) num_nodes});
+            for (index_t i = 0; i < (index_t) mst_edges.size(); i++) {
+                canonical_index(mst_edges[i]) = m_num_points + i;
+                mst_edge_map(i) = mst_edges[i];
+                altitudes(m_num_points + i) = m_edge_weights(mst_edges[i]);
+            }
+            auto to_canonical = [&](index_t n) {
+                return (n < m_num_points) ? n : canonical_index(n - m_num_points);
+            };
+
+            array_1d<index_t> parents = array_1d<index_t>::from_shape({(size_t) num_nodes});
+            for (index_t i = 0; i < m_num_points; i++) {
+                parents(i) = to_canonical(m_parents(i));
+                altitudes(i) = 0;
+            }
+            for (index_t i = 0; i < (index_t) mst_edges.size(); i++) {
+                parents(m_num_points + i) = to_canonical(m_parents(m_num_points + mst_edges[i]));
+            }
+
+            return make_node_weighted_tree_and_mst(tree(std::move(parents)),
+                                                   std::move(altitudes),
+                                                   std::move(mst_edge_map));
+        }
+
+    private:
+
+        /**
+         * Access to the tree for bpt_canonical_repair
+         */
+        struct tree_view {
+            const dynamic_bpt_canonical &m_bpt;
+
+            tree_view(const dynamic_bpt_canonical &bpt) : m_bpt(bpt) {}
+
+            index_t root() const {
+                return m_bpt.m_root;
+            }
+
+            index_t parent(index_t n) const {
+                return m_bpt.m_parents(n);
+            }
+
+            value_type altitude(index_t n) const {
+                return m_bpt.m_edge_weights(n - m_bpt.m_num_points);
+            }
+
+            index_t edge(index_t n) const {
+                return n - m_bpt.m_num_points;
+            }
+
+            bool is_mst_edge(index_t, index_t ei, value_type) const {
+                return m_bpt.m_in_mst(ei);
+            }
+
+            bool in_mst(index_t ei) const {
+                return m_bpt.m_in_mst(ei);
+            }
+        };
+
+        const graph_t &m_graph;
+        array_1d<value_type> m_edge_weights;
+        index_t m_num_points;
+        index_t m_root;
+        array_1d<index_t> m_parents;
+        array_1d<bool> m_in_mst;
+    };
+
+    /**
+     * Creates a dynamic_bpt_canonical from an edge weighted graph (see dynamic_bpt_canonical).
+     *
+     * @tparam graph_t
+     * @tparam T
+     * @param graph input graph (must be connected)
+     * @param xedge_weights edge weights
+     * @return a dynamic_bpt_canonical
+     */
+    template<typename graph_t, typename T>
+    auto make_dynamic_bpt_canonical(const graph_t &graph, const xt::xexpression<T> &xedge_weights) {
+        auto &edge_weights = xedge_weights.derived_cast();
+        hg_assert_edge_weights(graph, edge_weights);
+        hg_assert_1d_array(edge_weights);
+        return dynamic_bpt_canonical<graph_t, typename T::value_type>(graph, edge_weights);
+    }
+
     /**
      * Creates a copy of the current Tree and deletes the nodes such that the criterion function is true.
      * Also returns an array that maps any node index i of the new tree, to the index of this node in the original tree.
@@ -367,9 +1702,18 @@ namespace hg {
                       const tree_t &tree,
                       const xt::xexpression<T> &xaltitudes) {
         auto &altitudes = xaltitudes.derived_cast();
-        lca_fast lca(tree);
-        auto lca_edges = lca.lca(edge_iterator(graph));
-        return xt::eval(xt::index_view(altitudes, lca_edges));
+        // the lca structure is the main memory consumer: use 32 bits indices when possible.
+        // lca_offline does not build an index but is slower and uses more memory than lca_preorder_block
+        // whatever the number of edges (see benchmark_lca)
+        if (num_vertices(tree) < (size_t) (std::numeric_limits<int32_t>::max)()) {
+            lca_preorder_block_32 lca(tree);
+            auto lca_edges = lca.lca(edge_iterator(graph));
+            return xt::eval(xt::index_view(altitudes, lca_edges));
+        } else {
+            lca_fast lca(tree);
+            auto lca_edges = lca.lca(edge_iterator(graph));
+            return xt::eval(xt::index_view(altitudes, lca_edges));
+        }
     }
 
     /**
@@ -0,0 +1,360 @@
+/***************************************************************************
+* Copyright ESIEE Paris (2021)                                             *
+*                                                                          *
+* Contributor(s) : Benjamin Perret                                         *
+*                                                                          *
+* Distributed under the terms of the CECILL-B License.                     *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#pragma once
+
+#include "hierarchy_core.hpp"
+#include "watershed_hierarchy.hpp"
+#include "../structure/embedding.hpp"
+#include <array>
+#include <cmath>
+
+namespace hg {
+
+    /*
+     * Tiled computation of hierarchies on the 4 adjacency graph of large 2d images.
+     *
+     * Edge weights are read tile by tile with a tile reader: a function object
+     *
+     *     reader(y0, x0, height, width)
+     *
+     * returning a 3d array r of shape (height, width, 2) such that, for the pixel p = (y0 + y, x0 + x),
+     * r(y, x, 0) is the weight of the edge linking p to its right neighbour and r(y, x, 1) is the weight of the
+     * edge linking p to its bottom neighbour (values corresponding to edges outside of the image are ignored).
+     * When higra is compiled with TBB, the reader may be called concurrently on different tiles.
+     *
+     * The minimum spanning tree of each tile is computed independently: by the cycle property, an edge
+     * removed from a tile cannot belong to the minimum spanning tree of the image, hence the minimum spanning tree of
+     * the image is the minimum spanning tree of the union of the tile minimum spanning trees and of the edges
+     * crossing tile borders. Ties are broken with the index of the edges in the 4 adjacency graph (see
+     * get_4_adjacency_graph): the results are identical to the ones obtained on the whole graph.
+     *
+     * Only one tile per thread is in memory during the first pass, the second pass works on a graph with
+     * approximately one edge per pixel instead of two, and neither the 4 adjacency graph nor the full edge weight
+     * array are ever built.
+     */
+
+    /**
+     * Estimation of the peak memory used per pixel of a tile while its minimum spanning tree is computed.
+     */
+    const index_t tiled_hierarchy_bytes_per_tile_pixel = 160;
+
+    namespace tiled_hierarchy_internal {
+
+        /**
+         * Index of the edge linking the pixel (y, x) to its right neighbour in the 4 adjacency graph of a
+         * height x width grid
+         */
+        inline
+        index_t right_edge_index(index_t y, index_t x, index_t height, index_t width) {
+            return y * (2 * width - 1) + ((y < height - 1) ? 2 * x : x);
+        }
+
+        /**
+         * Index of the edge linking the pixel (y, x) to its bottom neighbour in the 4 adjacency graph of a
+         * height x width grid
+         */
+        inline
+        index_t bottom_edge_index(index_t y, index_t x, index_t width) {
+            return y * (2 * width - 1) + ((x < width - 1) ? 2 * x + 1 : 2 * (width - 1));
+        }
+
+        /**
+         * Extremities of the edge of index ei in the 4 adjacency graph of a height x width grid
+         */
+        inline
+        std::pair<index_t, index_t> edge_extremities(index_t ei, index_t height, index_t width) {
+            index_t y = ei / (2 * width - 1);
+            index_t r = ei % (2 * width - 1);
+            if (y == height - 1) {
+                index_t s = y * width + r;
+                return {s, s + 1};
+            }
+            if (r == 2 * (width - 1)) {
+                index_t s = y * width + width - 1;
+                return {s, s + width};
+            }
+            index_t s = y * width + r / 2;
+            return {s, (r % 2 == 0) ? s + 1 : s + width};
+        }
+
+        /**
+         * Minimum spanning tree edges of the given tile and edges linking the tile to its right and bottom
+         * neighbour tiles. Edges are given by their index in the 4 adjacency graph of the image.
+         */
+        template<typename value_type, typename tile_reader_t>
+        void tile_spanning_edges(const tile_reader_t &reader,
+                                 index_t y0, index_t x0, index_t h, index_t w,
+                                 index_t height, index_t width,
+                                 std::vector<index_t> &edge_indices,
+                                 std::vector<value_type> &edge_weights) {
+            array_3d<value_type> tile_weights = reader(y0, x0, h, w);
+            hg_assert(tile_weights.shape()[0] == (size_t) h && tile_weights.shape()[1] == (size_t) w &&
+                      tile_weights.shape()[2] == 2, "Tile reader returned an array with an invalid shape.");
+
+            // edges inside the tile are enumerated in the order of the 4 adjacency graph of the image
+            index_t num_inner_edges = h * (w - 1) + (h - 1) * w;
+            array_1d<index_t> sources = array_1d<index_t>::from_shape({(size_t) num_inner_edges});
+            array_1d<index_t> targets = array_1d<index_t>::from_shape({(size_t) num_inner_edges});
+            array_1d<value_type> weights = array_1d<value_type>::from_shape({(size_t) num_inner_edges});
+            array_1d<index_t> indices = array_1d<index_t>::from_shape({(size_t) num_inner_edges});
+
+            index_t e = 0;
+            for (index_t y = 0; y < h; y++) {
+                for (index_t x = 0; x < w; x++) {
+                    index_t v = y * w + x;
+                    index_t gy = y0 + y;
+                    index_t gx = x0 + x;
+                    if (x + 1 < w) {
+                        sources(e) = v;
+                        targets(e) = v + 1;
+                        weights(e) = tile_weights(y, x, 0);
+                        indices(e) = right_edge_index(gy, gx, height, width);
+                        e++;
+                    } else if (gx + 1 < width) {
+                        edge_indices.push_back(right_edge_index(gy, gx, height, width));
+                        edge_weights.push_back(tile_weights(y, x, 0));
+                    }
+                    if (y + 1 < h) {
+                        sources(e) = v;
+                        targets(e) = v + w;
+                        weights(e) = tile_weights(y, x, 1);
+                        indices(e) = bottom_edge_index(gy, gx, width);
+                        e++;
+                    } else if (gy + 1 < height) {
+                        edge_indices.push_back(bottom_edge_index(gy, gx, width));
+                        edge_weights.push_back(tile_weights(y, x, 1));
+                    }
+                }
+            }
+
+            array_1d<index_t> sorted_edges_indices = stable_arg_sort(weights);
+            auto res = hierarchy_core_internal::bpt_canonical_from_sorted_edges(sources, targets,
+                                                                                sorted_edges_indices, h * w);
+            for (auto ei: res.second) {
+                edge_indices.push_back(indices(ei));
+                edge_weights.push_back(weights(ei));
+            }
+        }
+    }
+
+    /**
+     * Shape of the square tiles such that the memory used to process a tile is approximately equal to the given
+     * memory budget (see tiled_hierarchy_bytes_per_tile_pixel).
+     *
+     * @param memory_budget memory budget per tile in bytes
+     * @return tile shape {height, width}
+     */
+    inline
+    std::array<index_t, 2> tile_shape_from_memory_budget(size_t memory_budget) {
+        auto side = (std::max)((index_t) std::sqrt((double) memory_budget / tiled_hierarchy_bytes_per_tile_pixel),
+                               (index_t) 1);
+        return {side, side};
+    }
+
+    /**
+     * Tile reader on the edge weights of the 4 adjacency graph of an image (see get_4_adjacency_graph).
+     *
+     * The edge weights can be any 1d xtensor expression, for example an adaptor on a memory mapped raw file.
+     * The edge weights must remain valid as long as the reader is used.
+     *
+     * @param embedding image shape
+     * @param xedge_weights edge weights of the 4 adjacency graph of the image
+     * @return a tile reader
+     */
+    template<typename T>
+    auto make_tile_reader_from_edge_weights(const embedding_grid_2d &embedding, const xt::xexpression<T> &xedge_weights) {
+        using namespace tiled_hierarchy_internal;
+        auto &edge_weights = xedge_weights.derived_cast();
+        hg_assert_1d_array(edge_weights);
+        index_t height = embedding.shape()[0];
+        index_t width = embedding.shape()[1];
+        hg_assert((index_t) edge_weights.size() == height * (width - 1) + (height - 1) * width,
+                  "Edge weights size does not match the number of edges of the 4 adjacency graph.");
+        using value_type = typename T::value_type;
+        return [&edge_weights, height, width](index_t y0, index_t x0, index_t h, index_t w) {
+            array_3d<value_type> result = xt::zeros<value_type>({(size_t) h, (size_t) w, (size_t) 2});
+            for (index_t y = 0; y < h; y++) {
+                for (index_t x = 0; x < w; x++) {
+                    if (x0 + x + 1 < width) {
+                        result(y, x, 0) = edge_weights(right_edge_index(y0 + y, x0 + x, height, width));
+                    }
+                    if (y0 + y + 1 < height) {
+                        result(y, x, 1) = edge_weights(bottom_edge_index(y0 + y, x0 + x, width));
+                    }
+                }
+            }
+            return result;
+        };
+    }
+
+    /**
+     * Tile reader computing the edge weights of the 4 adjacency graph from the pixel values of an image.
+     *
+     * The image can be any xtensor expression whose elements are stored in row major order (accessed with flat),
+     * for example an adaptor on the pixels of a memory mapped pnm file. The image must remain valid as long as the
+     * reader is used.
+     *
+     * @param embedding image shape
+     * @param ximage pixel values
+     * @param weight_function function computing the weight of an edge from the values of its extremities
+     * @return a tile reader
+     */
+    template<typename T, typename F>
+    auto make_tile_reader_from_image(const embedding_grid_2d &embedding,
+                                     const xt::xexpression<T> &ximage,
+                                     const F &weight_function) {
+        auto &image = ximage.derived_cast();
+        index_t height = embedding.shape()[0];
+        index_t width = embedding.shape()[1];
+        hg_assert((index_t) image.size() == height * width, "Image size does not match the embedding size.");
+        using value_type = std::decay_t<decltype(weight_function(image.flat(0), image.flat(0)))>;
+        return [&image, weight_function, height, width](index_t y0, index_t x0, index_t h, index_t w) {
+            array_3d<value_type> result = xt::zeros<value_type>({(size_t) h, (size_t) w, (size_t) 2});
+            for (index_t y = 0; y < h; y++) {
+                for (index_t x = 0; x < w; x++) {
+                    index_t p = (y0 + y) * width + x0 + x;
+                    if (x0 + x + 1 < width) {
+                        result(y, x, 0) = weight_function(image.flat(p), image.flat(p + 1));
+                    }
+                    if (y0 + y + 1 < height) {
+                        result(y, x, 1) = weight_function(image.flat(p), image.flat(p + width));
+                    }
+                }
+            }
+            return result;
+        };
+    }
+
+    /**
+     * Canonical binary partition tree of the 4 adjacency graph of a 2d image whose edge weights are read tile by
+     * tile (see tiled_hierarchy.hpp).
+     *
+     * The result is identical to bpt_canonical(get_4_adjacency_graph(embedding), edge_weights): in particular the
+     * mst edge map contains indices of edges of the 4 adjacency graph.
+     *
+     * @param embedding image shape
+     * @param reader tile reader
+     * @param tile_shape maximal tile shape {height, width} (see tile_shape_from_memory_budget)
+     * @return a node_weighted_tree_and_mst
+     */
+    template<typename tile_reader_t>
+    auto bpt_canonical_tiled(const embedding_grid_2d &embedding,
+                             const tile_reader_t &reader,
+                             const std::array<index_t, 2> &tile_shape) {
+        HG_TRACE();
+        using namespace tiled_hierarchy_internal;
+        using value_type = typename std::decay_t<decltype(reader(0, 0, 1, 1))>::value_type;
+        hg_assert(embedding.dimension() == 2, "Only 2d images are supported.");
+        hg_assert(tile_shape[0] > 0 && tile_shape[1] > 0, "Tile shape must be positive.");
+        index_t height = embedding.shape()[0];
+        index_t width = embedding.shape()[1];
+        index_t num_points = height * width;
+        index_t num_tiles_y = (height + tile_shape[0] - 1) / tile_shape[0];
+        index_t num_tiles_x = (width + tile_shape[1] - 1) / tile_shape[1];
+        index_t num_tiles = num_tiles_y * num_tiles_x;
+
+        std::vector<std::vector<index_t>> tile_edge_indices(num_tiles);
+        std::vector<std::vector<value_type>> tile_edge_weights(num_tiles);
+        parfor(0, num_tiles, [&](index_t t) {
+            index_t y0 = (t / num_tiles_x) * tile_shape[0];
+            index_t x0 = (t % num_tiles_x) * tile_shape[1];
+            tile_spanning_edges(reader, y0, x0,
+                                (std::min)(tile_shape[0], height - y0),
+                                (std::min)(tile_shape[1], width - x0),
+                                height, width,
+                                tile_edge_indices[t], tile_edge_weights[t]);
+        });
+
+        size_t num_edges = 0;
+        for (auto &e: tile_edge_indices) {
+            num_edges += e.size();
+        }
+        array_1d<index_t> edge_indices = array_1d<index_t>::from_shape({num_edges});
+        array_1d<value_type> edge_weights = array_1d<value_type>::from_shape({num_edges});
+        size_t pos = 0;
+        for (index_t t = 0; t < num_tiles; t++) {
+            std::copy(tile_edge_indices[t].begin(), tile_edge_indices[t].end(), edge_indices.begin() + pos);
+            std::copy(tile_edge_weights[t].begin(), tile_edge_weights[t].end(), edge_weights.begin() + pos);
+            pos += tile_edge_indices[t].size();
+            std::vector<index_t>().swap(tile_edge_indices[t]);
+            std::vector<value_type>().swap(tile_edge_weights[t]);
+        }
+
+        // edges are ordered by index and then stable sorted by weight, as in bpt_canonical
+        {
+            array_1d<index_t> order = stable_arg_sort(edge_indices);
+            array_1d<index_t> tmp_indices = xt::index_view(edge_indices, order);
+            array_1d<value_type> tmp_weights = xt::index_view(edge_weights, order);
+            edge_indices = std::move(tmp_indices);
+            edge_weights = std::move(tmp_weights);
+        }
+        array_1d<index_t> sources = array_1d<index_t>::from_shape({num_edges});
+        array_1d<index_t> targets = array_1d<index_t>::from_shape({num_edges});
+        parfor(0, num_edges, [&](index_t i) {
+            auto e = edge_extremities(edge_indices(i), height, width);
+            sources(i) = e.first;
+            targets(i) = e.second;
+        });
+        array_1d<index_t> sorted_edges_indices = stable_arg_sort(edge_weights);
+
+        auto res = hierarchy_core_internal::bpt_canonical_from_sorted_edges(sources, targets, sorted_edges_indices,
+                                                                            num_points);
+        auto &parents = res.first;
+        auto &mst_edge_map = res.second;
+
+        array_1d<value_type> levels = xt::zeros<value_type>({parents.size()});
+        for (index_t i = 0; i < (index_t) mst_edge_map.size(); i++) {
+            levels(num_points + i) = edge_weights(mst_edge_map(i));
+            mst_edge_map(i) = edge_indices(mst_edge_map(i));
+        }
+
+        return make_node_weighted_tree_and_mst(
+                tree(std::move(parents)),
+                std::move(levels),
+                std::move(mst_edge_map));
+    }
+
+    /**
+     * Hierarchical watershed by area of the 4 adjacency graph of a 2d image whose edge weights are read tile by
+     * tile (see tiled_hierarchy.hpp).
+     *
+     * The result is identical to watershed_hierarchy_by_area(get_4_adjacency_graph(embedding), edge_weights).
+     *
+     * @param embedding image shape
+     * @param reader tile reader
+     * @param tile_shape maximal tile shape {height, width} (see tile_shape_from_memory_budget)
+     * @return a node_weighted_tree_and_mst
+     */
+    template<typename tile_reader_t>
+    auto watershed_hierarchy_by_area_tiled(const embedding_grid_2d &embedding,
+                                           const tile_reader_t &reader,
+                                           const std::array<index_t, 2> &tile_shape) {
+        HG_TRACE();
+        auto bptc = bpt_canonical_tiled(embedding, reader, tile_shape);
+
+        index_t height = embedding.shape()[0];
+        index_t width = embedding.shape()[1];
+        auto num_mst_edges = bptc.mst_edge_map.size();
+        array_1d<index_t> mst_sources = array_1d<index_t>::from_shape({num_mst_edges});
+        array_1d<index_t> mst_targets = array_1d<index_t>::from_shape({num_mst_edges});
+        parfor(0, num_mst_edges, [&](index_t i) {
+            auto e = tiled_hierarchy_internal::edge_extremities(bptc.mst_edge_map(i), height, width);
+            mst_sources(i) = e.first;
+            mst_targets(i) = e.second;
+        });
+
+        return watershed_hierarchy_internal::watershed_hierarchy_from_bpt(
+                bptc, mst_sources, mst_targets,
+                [](const tree &t, const auto &) {
+                    return attribute_area(t);
+                });
+    }
+}
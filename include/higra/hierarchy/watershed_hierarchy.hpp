@@ -26,7 +26,7 @@ namespace hg {
                                    const T2 &attribute) {
             using value_type = typename T2::value_type;
             tree.compute_children();
-            array_1d<value_type> result = xt::empty_like(attribute);
+            auto result = array_1d<value_type>::from_shape({num_vertices(tree)});
             for (auto n: leaves_iterator(tree)) {
                 result(n) = 0;
             }
@@ -44,6 +44,44 @@ namespace hg {
             result(root(tree)) = attribute(root(tree));
             return result;
         };
+
+        /**
+         * Hierarchical watershed computed from the canonical binary partition tree of the edge weighted graph and
+         * the extremities of the edges of its minimum spanning tree (the i-th edge is the building edge of the i-th
+         * internal node of the tree).
+         *
+         * The result is the canonical binary partition tree of the minimum spanning tree weighted by the
+         * persistence of its edges: the mst edge map contains indices of edges of the minimum spanning tree.
+         */
+        template<typename bpt_t, typename T1, typename T2, typename F>
+        auto watershed_hierarchy_from_bpt(const bpt_t &bptc,
+                                          const T1 &mst_sources,
+                                          const T2 &mst_targets,
+                                          const F &attribute_functor) {
+            auto &bpt = bptc.tree;
+            auto &altitude = bptc.altitudes;
+
+            auto bpt_attribute = attribute_functor(bpt, altitude);
+            auto corrected_attribute = correct_attribute_BPT(bpt, altitude, bpt_attribute);
+            auto persistence = accumulate_parallel(bpt, corrected_attribute, accumulator_min());
+            using value_type = typename decltype(persistence)::value_type;
+            index_t num_points = num_leaves(bpt);
+
+            array_1d<value_type> mst_edge_weights = xt::view(persistence, xt::range(num_points, num_vertices(bpt)));
+            array_1d<index_t> sorted_edges_indices = stable_arg_sort(mst_edge_weights);
+            auto res = hierarchy_core_internal::bpt_canonical_from_sorted_edges(mst_sources, mst_targets,
+                                                                                sorted_edges_indices, num_points);
+            auto &parents = res.first;
+            auto &mst_edge_map = res.second;
+
+            array_1d<value_type> levels = xt::zeros<value_type>({parents.size()});
+            xt::noalias(xt::view(levels, xt::range(num_points, levels.size()))) = xt::index_view(mst_edge_weights,
+                                                                                                 mst_edge_map);
+            return make_node_weighted_tree_and_mst(
+                    tree(std::move(parents)),
+                    std::move(levels),
+                    std::move(mst_edge_map));
+        }
     }
 
     /**
@@ -78,19 +116,11 @@ namespace hg {
         hg_assert_1d_array(edge_weights);
 
         auto bptc = bpt_canonical(graph, edge_weights);
-        auto &bpt = bptc.tree;
-        auto &altitude = bptc.altitudes;
-        auto &mst_edge_map = bptc.mst_edge_map;
-        auto mst = subgraph_spanning(graph, mst_edge_map);
+        array_1d<index_t> mst_sources = xt::index_view(sources(graph), bptc.mst_edge_map);
+        array_1d<index_t> mst_targets = xt::index_view(targets(graph), bptc.mst_edge_map);
 
-        auto bpt_attribute = attribute_functor(bpt, altitude);
-        auto corrected_attribute = watershed_hierarchy_internal::correct_attribute_BPT(bpt, altitude, bpt_attribute);
-        auto persistence = accumulate_parallel(bpt, corrected_attribute, accumulator_min());
-        xt::view(persistence, xt::range(0, num_leaves(bpt))) = 0;
-
-        auto mst_edge_weights = xt::view(persistence, xt::range(num_leaves(bpt), num_vertices(bpt)));
-
-        return bpt_canonical(mst, mst_edge_weights);
+        return watershed_hierarchy_internal::watershed_hierarchy_from_bpt(bptc, mst_sources, mst_targets,
+                                                                          attribute_functor);
     };
 
     /**
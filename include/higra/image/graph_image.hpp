@@ -70,6 +70,89 @@ namespace hg {
         return hg::copy_graph<ugraph>(get_8_adjacency_implicit_graph(embedding));
     }
 
+    namespace graph_image_internal {
+
+        /**
+         * Neighbours of the 3d unit cube centered on the origin having at most max_non_zero non zero coordinates,
+         * in raster order.
+         */
+        inline
+        auto get_3d_cube_neighbours(index_t max_non_zero) {
+            std::vector<point_3d_i> neighbours;
+            for (index_t z = -1; z <= 1; z++) {
+                for (index_t y = -1; y <= 1; y++) {
+                    for (index_t x = -1; x <= 1; x++) {
+                        index_t non_zero = (z != 0) + (y != 0) + (x != 0);
+                        if (non_zero > 0 && non_zero <= max_non_zero) {
+                            neighbours.push_back({{z, y, x}});
+                        }
+                    }
+                }
+            }
+            return neighbours;
+        }
+    }
+
+    /**
+     * Create a 6 adjacency implicit regular graph for the given 3d embedding (face neighbours)
+     * @param embedding
+     * @return
+     */
+    inline
+    auto get_6_adjacency_implicit_graph(const embedding_grid_3d &embedding) {
+        return regular_grid_graph_3d(embedding, graph_image_internal::get_3d_cube_neighbours(1));
+    }
+
+    /**
+     * Create a 18 adjacency implicit regular graph for the given 3d embedding (face and edge neighbours)
+     * @param embedding
+     * @return
+     */
+    inline
+    auto get_18_adjacency_implicit_graph(const embedding_grid_3d &embedding) {
+        return regular_grid_graph_3d(embedding, graph_image_internal::get_3d_cube_neighbours(2));
+    }
+
+    /**
+     * Create a 26 adjacency implicit regular graph for the given 3d embedding (face, edge and corner neighbours)
+     * @param embedding
+     * @return
+     */
+    inline
+    auto get_26_adjacency_implicit_graph(const embedding_grid_3d &embedding) {
+        return regular_grid_graph_3d(embedding, graph_image_internal::get_3d_cube_neighbours(3));
+    }
+
+    /**
+     * Create a 6 adjacency explicit regular graph for the given 3d embedding
+     * @param embedding
+     * @return
+     */
+    inline
+    auto get_6_adjacency_graph(const embedding_grid_3d &embedding) {
+        return hg::copy_graph<ugraph>(get_6_adjacency_implicit_graph(embedding));
+    }
+
+    /**
+     * Create a 18 adjacency explicit regular graph for the given 3d embedding
+     * @param embedding
+     * @return
+     */
+    inline
+    auto get_18_adjacency_graph(const embedding_grid_3d &embedding) {
+        return hg::copy_graph<ugraph>(get_18_adjacency_implicit_graph(embedding));
+    }
+
+    /**
+     * Create a 26 adjacency explicit regular graph for the given 3d embedding
+     * @param embedding
+     * @return
+     */
+    inline
+    auto get_26_adjacency_graph(const embedding_grid_3d &embedding) {
+        return hg::copy_graph<ugraph>(get_26_adjacency_implicit_graph(embedding));
+    }
+
 
     /**
      * Represents a 4 adjacency edge weighted regular graph in 2d Khalimsky space
@@ -0,0 +1,679 @@
+/***************************************************************************
+* Copyright ESIEE Paris (2021)                                             *
+*                                                                          *
+* Contributor(s) : Benjamin Perret                                         *
+*                                                                          *
+* Distributed under the terms of the CECILL-B License.                     *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#pragma once
+
+#include "../graph.hpp"
+#include "../structure/lca_fast.hpp"
+#include "xtensor/xadapt.hpp"
+#include <cstring>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#endif
+
+namespace hg {
+
+    /*
+     * Binary tree format (version 1)
+     *
+     * The file is made of a header, a sequence of columns, and a directory describing the columns.
+     * All values are stored in little endian order and each column starts at an offset multiple of
+     * tree_binary_io_internal::alignment: columns can thus be used in place when the file is memory mapped.
+     *
+     * Header (64 bytes):
+     *   - magic string "HGTREEB" (8 bytes with the trailing 0)
+     *   - format version (uint32)
+     *   - byte order mark 0x01020304 (uint32)
+     *   - number of nodes (int64)
+     *   - number of columns (uint64)
+     *   - offset of the directory (uint64)
+     *
+     * Directory: one entry of 128 bytes per column:
+     *   - name (96 bytes, 0 terminated)
+     *   - offset of the column (uint64)
+     *   - number of elements of the column (uint64)
+     *   - column type (uint32, see tree_binary_io_internal::column_type)
+     *   - size of an element in bytes (uint32)
+     *
+     * Columns:
+     *   - "parents": parent of each node (int32 or int64)
+     *   - "children_offsets", "children_indices": optional compressed sparse row representation of the children
+     *     of the internal nodes, as computed by tree::compute_children (same type as parents)
+     *   - "lca_preorder_rank", "lca_preorder_parents", "lca_rmq_masks", "lca_rmq_sparse_table": optional state of
+     *     a lca_preorder_rmq structure (lca_preorder_block_32 if parents are int32 and lca_preorder_block otherwise)
+     *   - "attribute:<name>": 1d node attributes of any numeric type
+     */
+
+    namespace tree_binary_io_internal {
+
+        const char magic[8] = "HGTREEB";
+        const uint32_t version = 1;
+        const uint32_t byte_order_mark = 0x01020304;
+        const uint64_t alignment = 64;
+        const uint64_t header_size = 64;
+        const uint64_t directory_entry_size = 128;
+        const uint64_t max_name_size = 96;
+        const std::string attribute_prefix = "attribute:";
+
+        enum class column_type : uint32_t {
+            int8 = 1, uint8, int16, uint16, int32, uint32, int64, uint64, float32, float64
+        };
+
+        template<typename T>
+        struct column_type_of;
+
+#define HG_TREE_BINARY_IO_COLUMN_TYPE(type, code) \
+        template<> \
+        struct column_type_of<type> { \
+            static const column_type value = column_type::code; \
+        };
+
+        HG_TREE_BINARY_IO_COLUMN_TYPE(int8_t, int8)
+        HG_TREE_BINARY_IO_COLUMN_TYPE(uint8_t, uint8)
+        HG_TREE_BINARY_IO_COLUMN_TYPE(int16_t, int16)
+        HG_TREE_BINARY_IO_COLUMN_TYPE(uint16_t, uint16)
+        HG_TREE_BINARY_IO_COLUMN_TYPE(int32_t, int32)
+        HG_TREE_BINARY_IO_COLUMN_TYPE(uint32_t, uint32)
+        HG_TREE_BINARY_IO_COLUMN_TYPE(int64_t, int64)
+        HG_TREE_BINARY_IO_COLUMN_TYPE(uint64_t, uint64)
+        HG_TREE_BINARY_IO_COLUMN_TYPE(float, float32)
+        HG_TREE_BINARY_IO_COLUMN_TYPE(double, float64)
+
+#undef HG_TREE_BINARY_IO_COLUMN_TYPE
+
+        /**
+         * Size in bytes of an element of the given column type, 0 if the type is unknown.
+         */
+        inline uint32_t column_type_size(column_type type) {
+            switch (type) {
+                case column_type::int8:
+                case column_type::uint8:
+                    return 1;
+                case column_type::int16:
+                case column_type::uint16:
+                    return 2;
+                case column_type::int32:
+                case column_type::uint32:
+                case column_type::float32:
+                    return 4;
+                case column_type::int64:
+                case column_type::uint64:
+                case column_type::float64:
+                    return 8;
+                default:
+                    return 0;
+            }
+        }
+
+        struct column_info {
+            std::string name;
+            uint64_t offset;
+            uint64_t size;
+            column_type type;
+            uint32_t element_size;
+        };
+
+        template<typename T>
+        void write_value(char *buffer, T value) {
+            std::memcpy(buffer, &value, sizeof(T));
+        }
+
+        template<typename T>
+        T read_value(const char *buffer) {
+            T value;
+            std::memcpy(&value, buffer, sizeof(T));
+            return value;
+        }
+
+        /**
+         * Checks that the children columns read from a file are the compressed sparse row representation of the
+         * children of the internal nodes of t (see compute_children_csr): offsets start at 0, never decrease and end
+         * at num_vertices - 1, and the children of each node are in increasing order and have this node as parent.
+         *
+         * The children of the tree are used without bound checks: an invalid representation must not be set.
+         */
+        template<typename T1, typename T2>
+        bool valid_children_csr(const tree &t, const T1 &offsets, const T2 &indices) {
+            index_t num_leaves = t.num_leaves();
+            index_t root = t.root();
+            index_t num_internal_nodes = root - num_leaves + 1;
+            auto &parents = t.parents();
+            if ((index_t) offsets.size() != num_internal_nodes + 1 || (index_t) indices.size() != root ||
+                offsets(0) != 0 || offsets(num_internal_nodes) != root) {
+                return false;
+            }
+            for (index_t i = 0; i < num_internal_nodes; i++) {
+                index_t start = offsets(i);
+                index_t end = offsets(i + 1);
+                if (start > end || end > root) {
+                    return false;
+                }
+                for (index_t j = start; j < end; j++) {
+                    index_t c = indices(j);
+                    if (c < 0 || c >= root || parents(c) != i + num_leaves || (j > start && indices(j - 1) >= c)) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        /**
+         * Checks that the columns of a lca_preorder_rmq structure read from a file are consistent with the parents of
+         * the tree: all the positions used by the queries are then in bounds.
+         *
+         * - preorder_rank is a permutation of [0, num_vertices) with the root at rank 0;
+         * - preorder_parents(preorder_rank(n)) is the parent of n;
+         * - the mask of the element i of a block contains the bit of i and no bit of an element after i;
+         * - the sparse table has the size expected for num_vertices elements and contains positions smaller than
+         *   num_vertices.
+         */
+        template<typename lca_t, typename T1, typename T2, typename T3, typename T4, typename T5>
+        bool valid_lca_state(const T1 &parents,
+                             const T2 &preorder_rank,
+                             const T3 &preorder_parents,
+                             const T4 &masks,
+                             const T5 &sparse_table) {
+            using mask_t = typename T4::value_type;
+            const index_t block_size = lca_t::rmq_type::block_size;
+            index_t num_nodes = parents.size();
+            if (num_nodes == 0 || (index_t) preorder_rank.size() != num_nodes ||
+                (index_t) preorder_parents.size() != num_nodes || (index_t) masks.size() != num_nodes) {
+                return false;
+            }
+            index_t num_blocks = (num_nodes + block_size - 1) / block_size;
+            index_t sparse_table_size = 0;
+            for (index_t lvl = 0; ((index_t) 1 << lvl) <= num_blocks; lvl++) {
+                sparse_table_size += num_blocks - ((index_t) 1 << lvl) + 1;
+            }
+            if ((index_t) sparse_table.size() != sparse_table_size) {
+                return false;
+            }
+
+            index_t root = num_nodes - 1;
+            std::vector<char> rank_used(num_nodes, false);
+            for (index_t n = 0; n < num_nodes; n++) {
+                index_t rank = preorder_rank(n);
+                if (rank < 0 || rank >= num_nodes || rank_used[rank] || (rank == 0) != (n == root)) {
+                    return false;
+                }
+                rank_used[rank] = true;
+                if ((index_t) preorder_parents(rank) != ((n == root) ? root : (index_t) parents(n))) {
+                    return false;
+                }
+            }
+            for (index_t i = 0; i < num_nodes; i++) {
+                if ((mask_t) (masks(i) >> (i % block_size)) != 1) {
+                    return false;
+                }
+            }
+            for (index_t i = 0; i < sparse_table_size; i++) {
+                if (sparse_table(i) < 0 || (index_t) sparse_table(i) >= num_nodes) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /**
+         * Writes a tree and its attributes in the binary tree format.
+         *
+         * Columns are written as they are added, the directory is written by finalize.
+         */
+        struct tree_binary_saver_helper {
+
+            using out_type = std::ostream &;
+
+            /**
+             * Parents are stored as int32 if the tree has less than 2^31 nodes and as int64 otherwise.
+             */
+            tree_binary_saver_helper(out_type out, const tree &t) :
+                    m_tree(t),
+                    m_out(out),
+                    m_use_int32(num_vertices(t) < (size_t) (std::numeric_limits<int32_t>::max)()) {
+                init();
+            }
+
+            ~tree_binary_saver_helper() {
+                finalize();
+            }
+
+            template<typename T>
+            tree_binary_saver_helper &add_attribute(const std::string &name, const xt::xexpression<T> &xarray) {
+                auto &array = xarray.derived_cast();
+                hg_assert(array.dimension() == 1, "Only scalar attributes are supported.");
+                hg_assert(array.size() == m_tree.num_vertices(), "Attribute size does not match the size of the tree.");
+                const auto &data = xt::eval(array);
+                write_column(attribute_prefix + name, data.data(), data.size());
+                return *this;
+            }
+
+            /**
+             * Stores the children of the tree nodes: the children do not have to be recomputed when the tree is read.
+             */
+            tree_binary_saver_helper &add_children() {
+                std::vector<index_t> offsets;
+                std::vector<index_t> indices;
+                tree_internal::compute_children_csr(parents(m_tree), num_leaves(m_tree), offsets, indices);
+                write_index_column("children_offsets", offsets);
+                write_index_column("children_indices", indices);
+                return *this;
+            }
+
+            /**
+             * Stores a lowest common ancestor structure (lca_preorder_block_32 if the tree has less than
+             * 2^31 nodes and lca_preorder_block otherwise)
+             */
+            tree_binary_saver_helper &add_lca() {
+                if (m_use_int32) {
+                    write_lca(lca_preorder_block_32(m_tree));
+                } else {
+                    write_lca(lca_preorder_block(m_tree));
+                }
+                return *this;
+            }
+
+            void finalize() {
+                if (!m_finalized) {
+                    uint64_t directory_offset = pad();
+                    std::vector<char> directory(m_columns.size() * directory_entry_size, 0);
+                    for (size_t i = 0; i < m_columns.size(); i++) {
+                        auto entry = directory.data() + i * directory_entry_size;
+                        auto &c = m_columns[i];
+                        std::memcpy(entry, c.name.c_str(), c.name.size());
+                        write_value(entry + max_name_size, c.offset);
+                        write_value(entry + max_name_size + 8, c.size);
+                        write_value(entry + max_name_size + 16, (uint32_t) c.type);
+                        write_value(entry + max_name_size + 20, c.element_size);
+                    }
+                    m_out.write(directory.data(), std::streamsize(directory.size()));
+                    auto end = m_out.tellp();
+
+                    char buffer[16];
+                    write_value(buffer, (uint64_t) m_columns.size());
+                    write_value(buffer + 8, directory_offset);
+                    m_out.seekp(m_start + std::streamoff(24));
+                    m_out.write(buffer, 16);
+                    m_out.seekp(end);
+                    m_finalized = true;
+                }
+            }
+
+        private:
+
+            void init() {
+                m_start = m_out.tellp();
+                char header[header_size] = {0};
+                std::memcpy(header, magic, sizeof(magic));
+                write_value(header + 8, version);
+                write_value(header + 12, byte_order_mark);
+                write_value(header + 16, (int64_t) num_vertices(m_tree));
+                m_out.write(header, header_size);
+                write_index_column("parents", parents(m_tree));
+            }
+
+            template<typename lca_t>
+            void write_lca(const lca_t &lca) {
+                auto state = lca.get_state();
+                write_column("lca_preorder_rank", state.preorder_rank.data(), state.preorder_rank.size());
+                write_column("lca_preorder_parents", state.preorder_parents.data(), state.preorder_parents.size());
+                write_column("lca_rmq_masks", state.rmq_state.masks.data(), state.rmq_state.masks.size());
+                write_column("lca_rmq_sparse_table", state.rmq_state.sparse_table.data(),
+                             state.rmq_state.sparse_table.size());
+            }
+
+            template<typename T>
+            void write_index_column(const std::string &name, const T &values) {
+                if (m_use_int32) {
+                    std::vector<int32_t> tmp(values.begin(), values.end());
+                    write_column(name, tmp.data(), tmp.size());
+                } else {
+                    std::vector<int64_t> tmp(values.begin(), values.end());
+                    write_column(name, tmp.data(), tmp.size());
+                }
+            }
+
+            template<typename value_type>
+            void write_column(const std::string &name, const value_type *data, size_t size) {
+                hg_assert(name.size() < max_name_size, "Column name '" + name + "' is too long.");
+                for (auto &c: m_columns) {
+                    hg_assert(c.name != name, "Column name '" + name + "' is already used.");
+                }
+                uint64_t offset = pad();
+                m_columns.push_back({name, offset, size, column_type_of<value_type>::value, sizeof(value_type)});
+                m_out.write(reinterpret_cast<const char *>(data), std::streamsize(size * sizeof(value_type)));
+            }
+
+            /**
+             * Pads the output to the next aligned offset and returns this offset (relative to the start of the tree)
+             */
+            uint64_t pad() {
+                uint64_t position = m_out.tellp() - m_start;
+                uint64_t padding = (alignment - position % alignment) % alignment;
+                const char zeros[alignment] = {0};
+                m_out.write(zeros, std::streamsize(padding));
+                return position + padding;
+            }
+
+            const tree &m_tree;
+            out_type m_out;
+            bool m_use_int32;
+            std::streampos m_start;
+            std::vector<column_info> m_columns;
+            bool m_finalized = false;
+        };
+    }
+
+    /**
+     * Saves a tree in the binary tree format (see tree_binary_io.hpp).
+     *
+     * Attributes, children and lowest common ancestor structure can be added with the returned object:
+     *
+     *     save_tree_binary(out, tree).add_attribute("altitudes", altitudes).add_children().finalize();
+     *
+     * @param out output stream (opened in binary mode)
+     * @param t tree
+     * @return a helper object used to add attributes
+     */
+    inline
+    auto
+    save_tree_binary(std::ostream &out, const tree &t) {
+        return tree_binary_io_internal::tree_binary_saver_helper(out, t);
+    }
+
+    /**
+     * Read only memory mapping of a file in the binary tree format (see tree_binary_io.hpp).
+     *
+     * Columns are exposed as xtensor adaptors on the mapped memory: no copy is performed and the pages are
+     * only loaded when they are accessed. The adaptors must not be used after the destruction of the
+     * tree_mmap object.
+     */
+    class tree_mmap {
+    public:
+
+        using column_type = tree_binary_io_internal::column_type;
+
+        explicit tree_mmap(const std::string &filename) {
+            try {
+                map_file(filename);
+                read_directory();
+            } catch (...) {
+                unmap_file();
+                throw;
+            }
+        }
+
+        tree_mmap(const tree_mmap &) = delete;
+
+        tree_mmap &operator=(const tree_mmap &) = delete;
+
+        ~tree_mmap() {
+            unmap_file();
+        }
+
+        index_t num_vertices() const {
+            return m_num_vertices;
+        }
+
+        bool has_column(const std::string &name) const {
+            return find_column(name) != nullptr;
+        }
+
+        column_type get_column_type(const std::string &name) const {
+            return get_column_info(name).type;
+        }
+
+        /**
+         * Zero copy 1d adaptor on the given column.
+         *
+         * @tparam T value type of the column (must match the stored type)
+         * @param name name of the column
+         * @return a read only 1d xtensor adaptor
+         */
+        template<typename T>
+        auto column(const std::string &name) const {
+            auto &info = get_column_info(name);
+            hg_assert(info.type == tree_binary_io_internal::column_type_of<T>::value,
+                      "Column '" + name + "' does not have the requested type.");
+            std::array<size_t, 1> shape{(size_t) info.size};
+            return xt::adapt(reinterpret_cast<const T *>(m_data + info.offset), (size_t) info.size, xt::no_ownership(),
+                             shape);
+        }
+
+        /**
+         * Pointer to the first element of the given column
+         */
+        const void *column_data(const std::string &name) const {
+            return m_data + get_column_info(name).offset;
+        }
+
+        size_t column_size(const std::string &name) const {
+            return get_column_info(name).size;
+        }
+
+        std::vector<std::string> attribute_names() const {
+            std::vector<std::string> names;
+            auto &prefix = tree_binary_io_internal::attribute_prefix;
+            for (auto &c: m_columns) {
+                if (c.name.compare(0, prefix.size(), prefix) == 0) {
+                    names.push_back(c.name.substr(prefix.size()));
+                }
+            }
+            return names;
+        }
+
+        column_type get_attribute_type(const std::string &name) const {
+            return get_column_type(tree_binary_io_internal::attribute_prefix + name);
+        }
+
+        template<typename T>
+        auto attribute(const std::string &name) const {
+            return column<T>(tree_binary_io_internal::attribute_prefix + name);
+        }
+
+        bool has_children() const {
+            return has_column("children_offsets") && has_column("children_indices");
+        }
+
+        bool has_lca() const {
+            return has_column("lca_preorder_rank");
+        }
+
+        /**
+         * Builds the tree stored in the file: parents are converted to index_t and the children are restored
+         * if they are stored in the file. The returned tree owns copies of these columns.
+         *
+         * The parents and the children read from the file are validated: an exception is thrown if the parents do
+         * not define a tree or if the children do not match the parents.
+         */
+        tree get_tree() const {
+            if (get_column_type("parents") == column_type::int32) {
+                return make_tree<int32_t>();
+            } else {
+                return make_tree<int64_t>();
+            }
+        }
+
+        /**
+         * Builds the lowest common ancestor structure stored in the file.
+         *
+         * The columns of the structure are validated against the parents of the tree through adaptors on the
+         * mapped memory, they are then copied into the returned object (lca_preorder_rmq owns its arrays): this
+         * avoids the linear time preprocessing of the structure, not the copy of the index.
+         *
+         * @tparam lca_t lca_preorder_block_32 if parents are stored as int32 and lca_preorder_block otherwise
+         */
+        template<typename lca_t>
+        lca_t get_lca() const {
+            using state_t = typename lca_t::template internal_state<array_1d>;
+            using idx_t = typename std::remove_reference_t<decltype(std::declval<state_t>().preorder_rank)>::value_type;
+            using mask_t = typename std::remove_reference_t<decltype(std::declval<state_t>().rmq_state.masks)>::value_type;
+            hg_assert(has_lca(), "The file does not contain a lowest common ancestor structure.");
+            auto preorder_rank = column<idx_t>("lca_preorder_rank");
+            auto preorder_parents = column<idx_t>("lca_preorder_parents");
+            auto masks = column<mask_t>("lca_rmq_masks");
+            auto sparse_table = column<idx_t>("lca_rmq_sparse_table");
+            hg_assert(tree_binary_io_internal::valid_lca_state<lca_t>(column<idx_t>("parents"), preorder_rank,
+                                                                      preorder_parents, masks, sparse_table),
+                      "Invalid lowest common ancestor columns in binary tree file.");
+            index_t data_size = preorder_parents.size();
+            state_t state(array_1d<idx_t>(preorder_rank),
+                          array_1d<idx_t>(preorder_parents),
+                          typename state_t::rmq_state_type(data_size, array_1d<mask_t>(masks),
+                                                           array_1d<idx_t>(sparse_table)));
+            return lca_t::make_from_state(std::move(state));
+        }
+
+    private:
+
+        template<typename T>
+        tree make_tree() const {
+            array_1d<index_t> parents = column<T>("parents");
+            // the constructor of the tree checks the order of the nodes but not the upper bound of the parents
+            index_t num_vertices = parents.size();
+            for (index_t v = 0; v < num_vertices; v++) {
+                hg_assert(parents(v) < num_vertices, "Invalid parents column in binary tree file.");
+            }
+            tree t(std::move(parents));
+            if (has_children()) {
+                auto offsets = column<T>("children_offsets");
+                auto indices = column<T>("children_indices");
+                hg_assert(tree_binary_io_internal::valid_children_csr(t, offsets, indices),
+                          "Invalid children columns in binary tree file.");
+                t.set_children(offsets, indices);
+            }
+            return t;
+        }
+
+        const tree_binary_io_internal::column_info *find_column(const std::string &name) const {
+            for (auto &c: m_columns) {
+                if (c.name == name) {
+                    return &c;
+                }
+            }
+            return nullptr;
+        }
+
+        const tree_binary_io_internal::column_info &get_column_info(const std::string &name) const {
+            auto c = find_column(name);
+            hg_assert(c != nullptr, "Column '" + name + "' does not exist.");
+            return *c;
+        }
+
+        void read_directory() {
+            using namespace tree_binary_io_internal;
+            hg_assert(m_size >= header_size && std::memcmp(m_data, magic, sizeof(magic)) == 0,
+                      "Invalid binary tree file.");
+            hg_assert(read_value<uint32_t>(m_data + 8) == version, "Unsupported binary tree file version.");
+            hg_assert(read_value<uint32_t>(m_data + 12) == byte_order_mark,
+                      "Binary tree file byte order does not match the byte order of the system.");
+            m_num_vertices = read_value<int64_t>(m_data + 16);
+            auto num_columns = read_value<uint64_t>(m_data + 24);
+            auto directory_offset = read_value<uint64_t>(m_data + 32);
+            hg_assert(directory_offset <= m_size &&
+                      num_columns <= (m_size - directory_offset) / directory_entry_size,
+                      "Truncated binary tree file.");
+
+            for (uint64_t i = 0; i < num_columns; i++) {
+                auto entry = m_data + directory_offset + i * directory_entry_size;
+                column_info c;
+                c.name = std::string(entry, strnlen(entry, max_name_size));
+                c.offset = read_value<uint64_t>(entry + max_name_size);
+                c.size = read_value<uint64_t>(entry + max_name_size + 8);
+                c.type = (column_type) read_value<uint32_t>(entry + max_name_size + 16);
+                c.element_size = read_value<uint32_t>(entry + max_name_size + 20);
+                // the bounds are checked without overflow: offset + size * element_size <= m_size
+                hg_assert(c.element_size != 0 && c.element_size == column_type_size(c.type) &&
+                          c.offset % alignment == 0 && c.offset <= m_size &&
+                          c.size <= (m_size - c.offset) / c.element_size,
+                          "Invalid column '" + c.name + "' in binary tree file.");
+                m_columns.push_back(c);
+            }
+            hg_assert(has_column("parents") && column_size("parents") == (size_t) m_num_vertices,
+                      "Missing or invalid parents column in binary tree file.");
+        }
+
+#ifdef _WIN32
+
+        void map_file(const std::string &filename) {
+            m_file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                 FILE_ATTRIBUTE_NORMAL, nullptr);
+            hg_assert(m_file != INVALID_HANDLE_VALUE, "Cannot open file '" + filename + "'.");
+            LARGE_INTEGER size;
+            GetFileSizeEx(m_file, &size);
+            m_size = (size_t) size.QuadPart;
+            m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            hg_assert(m_mapping != nullptr, "Cannot map file '" + filename + "'.");
+            m_data = static_cast<const char *>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+            hg_assert(m_data != nullptr, "Cannot map file '" + filename + "'.");
+        }
+
+        void unmap_file() {
+            if (m_data != nullptr) {
+                UnmapViewOfFile(m_data);
+            }
+            if (m_mapping != nullptr) {
+                CloseHandle(m_mapping);
+            }
+            if (m_file != INVALID_HANDLE_VALUE) {
+                CloseHandle(m_file);
+            }
+        }
+
+        HANDLE m_file = INVALID_HANDLE_VALUE;
+        HANDLE m_mapping = nullptr;
+#else
+
+        void map_file(const std::string &filename) {
+            int fd = open(filename.c_str(), O_RDONLY);
+            hg_assert(fd >= 0, "Cannot open file '" + filename + "'.");
+            struct stat st;
+            if (fstat(fd, &st) != 0) {
+                close(fd);
+                hg_assert(false, "Cannot read the size of file '" + filename + "'.");
+            }
+            m_size = (size_t) st.st_size;
+            void *data = (m_size > 0) ? mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+            // the mapping remains valid after the file descriptor is closed
+            close(fd);
+            hg_assert(data != MAP_FAILED, "Cannot map file '" + filename + "'.");
+            m_data = static_cast<const char *>(data);
+        }
+
+        void unmap_file() {
+            if (m_data != nullptr) {
+                munmap(const_cast<char *>(m_data), m_size);
+            }
+        }
+
+#endif
+
+        const char *m_data = nullptr;
+        size_t m_size = 0;
+        index_t m_num_vertices = 0;
+        std::vector<tree_binary_io_internal::column_info> m_columns;
+    };
+
+}
@@ -0,0 +1,568 @@
+/***************************************************************************
+* Copyright ESIEE Paris (2021)                                             *
+*                                                                          *
+* Contributor(s) : Benjamin Perret                                         *
+*                                                                          *
+* Distributed under the terms of the CECILL-B License.                     *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#pragma once
+
+#include "../graph.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+namespace hg {
+
+    /*
+     * Compression of tree parent arrays.
+     *
+     * Consecutive nodes often have close parents (neighbour leaves, nodes created by successive merges): each
+     * parent is first replaced by its zigzag encoded difference with the parent of the previous node (the first
+     * node of a block uses its own index), then differences are packed (varint or bit packing), and the packed
+     * bytes are finally encoded by an entropy stage.
+     *
+     * The parent array is cut into blocks of fixed size that are compressed independently: blocks can be
+     * decompressed in parallel and a range of nodes can be decompressed without decompressing the whole array.
+     *
+     * Serialized format (all values in little endian order):
+     *   - number of nodes (uint64)
+     *   - block size (uint64)
+     *   - packing (uint8), entropy stage (uint8), 6 bytes of padding
+     *   - number of blocks (uint64)
+     *   - for each block: end offset of the block payload (uint64) and size of the packed data (uint64)
+     *   - block payloads
+     */
+    namespace tree_codec {
+
+        /**
+         * Packing of the zigzag encoded differences between consecutive parents
+         */
+        enum class packing : uint8_t {
+            varint = 0, // LEB128 variable length integers
+            bitpack = 1 // fixed bit width per block
+        };
+
+        /**
+         * Entropy stage applied to the packed bytes of each block
+         */
+        enum class entropy : uint8_t {
+            none = 0, // packed bytes are stored as is
+            rans = 1 // static order 0 range asymmetric numeral system coder
+        };
+
+        struct codec_options {
+            packing packing_method = packing::bitpack;
+            entropy entropy_method = entropy::rans;
+            index_t block_size = 1 << 16;
+        };
+
+        namespace tree_codec_internal {
+
+            template<typename T>
+            void write_value(std::vector<uint8_t> &out, T value) {
+                auto size = out.size();
+                out.resize(size + sizeof(T));
+                std::memcpy(out.data() + size, &value, sizeof(T));
+            }
+
+            template<typename T>
+            T read_value(const uint8_t *in) {
+                T value;
+                std::memcpy(&value, in, sizeof(T));
+                return value;
+            }
+
+            inline uint64_t zigzag_encode(int64_t value) {
+                return ((uint64_t) value << 1) ^ (uint64_t) (value >> 63);
+            }
+
+            inline int64_t zigzag_decode(uint64_t value) {
+                return (int64_t) (value >> 1) ^ -(int64_t) (value & 1);
+            }
+
+            inline
+            void varint_pack(const uint64_t *values, index_t size, std::vector<uint8_t> &out) {
+                for (index_t i = 0; i < size; i++) {
+                    auto v = values[i];
+                    while (v >= 0x80) {
+                        out.push_back((uint8_t) (v | 0x80));
+                        v >>= 7;
+                    }
+                    out.push_back((uint8_t) v);
+                }
+            }
+
+            inline
+            void varint_unpack(const uint8_t *in, size_t in_size, uint64_t *values, index_t size) {
+                const uint8_t *end = in + in_size;
+                for (index_t i = 0; i < size; i++) {
+                    uint64_t v = 0;
+                    int shift = 0;
+                    uint8_t byte;
+                    do {
+                        hg_assert(in < end && shift < 64, "Corrupted varint stream.");
+                        byte = *in++;
+                        v |= (uint64_t) (byte & 0x7f) << shift;
+                        shift += 7;
+                    } while (byte & 0x80);
+                    values[i] = v;
+                }
+            }
+
+            /**
+             * Bit packed block: bit width (uint8) followed by the values packed in 64 bits words.
+             */
+            inline
+            void bit_pack(const uint64_t *values, index_t size, std::vector<uint8_t> &out) {
+                uint64_t max_value = 0;
+                for (index_t i = 0; i < size; i++) {
+                    max_value |= values[i];
+                }
+                int width = 0;
+                while (width < 64 && (max_value >> width) != 0) {
+                    width++;
+                }
+                out.push_back((uint8_t) width);
+                if (width == 0) {
+                    return;
+                }
+
+                std::vector<uint64_t> words(((size_t) size * width + 63) / 64, 0);
+                size_t position = 0;
+                for (index_t i = 0; i < size; i++) {
+                    auto word = position >> 6;
+                    auto offset = position & 63;
+                    words[word] |= values[i] << offset;
+                    if (offset + width > 64) {
+                        words[word + 1] |= values[i] >> (64 - offset);
+                    }
+                    position += width;
+                }
+                auto begin = out.size();
+                out.resize(begin + words.size() * sizeof(uint64_t));
+                std::memcpy(out.data() + begin, words.data(), words.size() * sizeof(uint64_t));
+            }
+
+            inline
+            void bit_unpack(const uint8_t *in, size_t in_size, uint64_t *values, index_t size) {
+                hg_assert(in_size >= 1, "Corrupted bit packed stream.");
+                int width = in[0];
+                hg_assert(width <= 64, "Corrupted bit packed stream.");
+                if (width == 0) {
+                    std::fill(values, values + size, 0);
+                    return;
+                }
+                size_t num_words = ((size_t) size * width + 63) / 64;
+                hg_assert(in_size == 1 + num_words * sizeof(uint64_t), "Corrupted bit packed stream.");
+                const uint8_t *words = in + 1;
+                uint64_t mask = (width == 64) ? ~(uint64_t) 0 : (((uint64_t) 1 << width) - 1);
+                size_t position = 0;
+                for (index_t i = 0; i < size; i++) {
+                    auto word = position >> 6;
+                    auto offset = position & 63;
+                    uint64_t v = read_value<uint64_t>(words + word * sizeof(uint64_t)) >> offset;
+                    if (offset + width > 64) {
+                        v |= read_value<uint64_t>(words + (word + 1) * sizeof(uint64_t)) << (64 - offset);
+                    }
+                    values[i] = v & mask;
+                    position += width;
+                }
+            }
+
+            /**
+             * Identity entropy stage.
+             */
+            struct entropy_none {
+
+                static void encode(const std::vector<uint8_t> &in, std::vector<uint8_t> &out) {
+                    out.insert(out.end(), in.begin(), in.end());
+                }
+
+                static void decode(const uint8_t *in, size_t in_size, uint8_t *out, size_t out_size) {
+                    hg_assert(in_size == out_size, "Corrupted block.");
+                    std::memcpy(out, in, in_size);
+                }
+            };
+
+            /**
+             * Static order 0 rANS coder with byte wise renormalization. Two rANS states are interleaved (even and odd
+             * symbols) to break the dependency chain of the decoder.
+             *
+             * Encoded block: symbol frequencies (256 uint16) followed by the rANS stream.
+             */
+            struct entropy_rans {
+
+                static const uint32_t scale_bits = 12;
+                static const uint32_t scale = 1u << scale_bits;
+                static const uint32_t lower_bound = 1u << 23;
+
+                static void encode(const std::vector<uint8_t> &in, std::vector<uint8_t> &out) {
+                    std::array<uint32_t, 256> frequencies;
+                    normalized_frequencies(in, frequencies);
+                    std::array<uint32_t, 256> starts;
+                    uint32_t start = 0;
+                    for (index_t s = 0; s < 256; s++) {
+                        starts[s] = start;
+                        start += frequencies[s];
+                        write_value(out, (uint16_t) frequencies[s]);
+                    }
+
+                    // symbols are encoded in reverse order and bytes are output backward,
+                    // a symbol cannot take more than scale_bits bits
+                    std::vector<uint8_t> buffer(2 * in.size() + 16);
+                    uint8_t *ptr = buffer.data() + buffer.size();
+                    uint32_t x[2] = {lower_bound, lower_bound};
+                    for (size_t i = in.size(); i-- > 0;) {
+                        auto &xs = x[i & 1];
+                        uint32_t frequency = frequencies[in[i]];
+                        uint32_t x_max = ((lower_bound >> scale_bits) << 8) * frequency;
+                        while (xs >= x_max) {
+                            *--ptr = (uint8_t) (xs & 0xff);
+                            xs >>= 8;
+                        }
+                        xs = ((xs / frequency) << scale_bits) + (xs % frequency) + starts[in[i]];
+                    }
+                    for (index_t s = 1; s >= 0; s--) {
+                        ptr -= 4;
+                        std::memcpy(ptr, &x[s], 4);
+                    }
+                    out.insert(out.end(), ptr, buffer.data() + buffer.size());
+                }
+
+                static void decode(const uint8_t *in, size_t in_size, uint8_t *out, size_t out_size) {
+                    hg_assert(in_size >= 256 * sizeof(uint16_t) + 8, "Corrupted rANS block.");
+                    std::array<uint32_t, 256> frequencies;
+                    std::array<uint32_t, 256> starts;
+                    uint32_t start = 0;
+                    for (index_t s = 0; s < 256; s++) {
+                        frequencies[s] = read_value<uint16_t>(in + s * sizeof(uint16_t));
+                        starts[s] = start;
+                        start += frequencies[s];
+                    }
+                    hg_assert(start == scale, "Corrupted rANS block.");
+
+                    // decoding table packed in 32 bits to stay in L1 cache: symbol (8 bits), frequency - 1
+                    // (12 bits) and offset of the slot in the symbol range (12 bits)
+                    std::vector<uint32_t> slots(scale);
+                    for (index_t s = 0; s < 256; s++) {
+                        for (uint32_t j = 0; j < frequencies[s]; j++) {
+                            slots[starts[s] + j] = (uint32_t) s | ((frequencies[s] - 1) << 8) | (j << 20);
+                        }
+                    }
+                    const uint32_t *table = slots.data();
+
+                    const uint8_t *ptr = in + 256 * sizeof(uint16_t);
+                    const uint8_t *end = in + in_size;
+                    uint32_t x0 = read_value<uint32_t>(ptr);
+                    uint32_t x1 = read_value<uint32_t>(ptr + 4);
+                    ptr += 8;
+
+                    auto decode_symbol = [table](uint32_t &x) {
+                        auto slot = table[x & (scale - 1)];
+                        x = (((slot >> 8) & (scale - 1)) + 1) * (x >> scale_bits) + (slot >> 20);
+                        return (uint8_t) slot;
+                    };
+
+                    // the state never needs more than 2 bytes after a symbol: renormalization is done without
+                    // branches as long as 4 bytes remain in the stream
+                    auto renormalize = [&ptr](uint32_t &x) {
+                        for (index_t k = 0; k < 2; k++) {
+                            uint32_t read = x < lower_bound;
+                            x = (x << (8 * read)) | (*ptr & (0u - read));
+                            ptr += read;
+                        }
+                    };
+
+                    size_t i = 0;
+                    for (; i + 1 < out_size && end - ptr >= 4; i += 2) {
+                        auto s0 = decode_symbol(x0);
+                        auto s1 = decode_symbol(x1);
+                        renormalize(x0);
+                        renormalize(x1);
+                        out[i] = s0;
+                        out[i + 1] = s1;
+                    }
+                    for (; i < out_size; i++) {
+                        auto &x = (i & 1) ? x1 : x0;
+                        out[i] = decode_symbol(x);
+                        while (x < lower_bound) {
+                            hg_assert(ptr < end, "Corrupted rANS block.");
+                            x = (x << 8) | *ptr++;
+                        }
+                    }
+                }
+
+            private:
+
+                /**
+                 * Symbol frequencies scaled such that they sum to scale, every symbol present in the input
+                 * has a non zero frequency.
+                 */
+                static void normalized_frequencies(const std::vector<uint8_t> &in,
+                                                   std::array<uint32_t, 256> &frequencies) {
+                    std::array<uint64_t, 256> counts{};
+                    for (auto v: in) {
+                        counts[v]++;
+                    }
+                    if (in.empty()) {
+                        counts[0] = 1;
+                    }
+                    uint64_t total = std::max<uint64_t>(in.size(), 1);
+                    int64_t sum = 0;
+                    index_t largest = 0;
+                    for (index_t s = 0; s < 256; s++) {
+                        frequencies[s] = (counts[s] == 0) ? 0 : (uint32_t) std::max<uint64_t>(1, counts[s] * scale /
+                                                                                                  total);
+                        sum += frequencies[s];
+                        if (counts[s] > counts[largest]) {
+                            largest = s;
+                        }
+                    }
+                    // fix rounding errors, the most frequent symbol absorbs the difference when possible
+                    while (sum != scale) {
+                        index_t best = largest;
+                        if (sum > scale && frequencies[best] <= 1) {
+                            for (index_t s = 0; s < 256; s++) {
+                                if (frequencies[s] > frequencies[best]) {
+                                    best = s;
+                                }
+                            }
+                        }
+                        int64_t delta = (int64_t) scale - sum;
+                        if (delta < 0) {
+                            delta = -std::min<int64_t>(-delta, frequencies[best] - 1);
+                        }
+                        frequencies[best] = (uint32_t) (frequencies[best] + delta);
+                        sum += delta;
+                    }
+                }
+            };
+
+            /**
+             * Calls fun with the entropy stage corresponding to the given identifier.
+             */
+            template<typename fun_t>
+            void dispatch_entropy_stage(entropy method, fun_t &&fun) {
+                switch (method) {
+                    case entropy::none:
+                        fun(entropy_none());
+                        break;
+                    case entropy::rans:
+                        fun(entropy_rans());
+                        break;
+                    default:
+                        hg_assert(false, "Unknown entropy stage.");
+                }
+            }
+        }
+
+        /**
+         * Compressed representation of the parent array of a tree.
+         */
+        class compressed_parents {
+        public:
+
+            compressed_parents() = default;
+
+            /**
+             * Compresses the given parent array.
+             *
+             * @param parents parent array of a tree
+             * @param options packing, entropy stage and block size
+             */
+            template<typename T>
+            compressed_parents(const xt::xexpression<T> &xparents, const codec_options &options = {}) :
+                    m_num_vertices(xparents.derived_cast().size()),
+                    m_block_size(options.block_size),
+                    m_packing(options.packing_method),
+                    m_entropy(options.entropy_method) {
+                using namespace tree_codec_internal;
+                auto &parents = xparents.derived_cast();
+                hg_assert_1d_array(parents);
+                hg_assert_integral_value_type(parents);
+                hg_assert(m_block_size > 0, "Block size must be positive.");
+
+                index_t num_blocks = (m_num_vertices + m_block_size - 1) / m_block_size;
+                std::vector<std::vector<uint8_t>> payloads(num_blocks);
+                m_raw_sizes.resize(num_blocks);
+                parfor(0, num_blocks, [&](index_t b) {
+                    index_t begin = b * m_block_size;
+                    index_t end = (std::min)(begin + m_block_size, m_num_vertices);
+                    std::vector<uint64_t> values(end - begin);
+                    values[0] = zigzag_encode((int64_t) parents(begin) - begin);
+                    for (index_t i = begin + 1; i < end; i++) {
+                        values[i - begin] = zigzag_encode((int64_t) parents(i) - (int64_t) parents(i - 1));
+                    }
+                    std::vector<uint8_t> packed;
+                    if (m_packing == packing::varint) {
+                        varint_pack(values.data(), end - begin, packed);
+                    } else {
+                        bit_pack(values.data(), end - begin, packed);
+                    }
+                    m_raw_sizes[b] = packed.size();
+                    dispatch_entropy_stage(m_entropy, [&packed, &payloads, b](auto stage) {
+                        stage.encode(packed, payloads[b]);
+                    });
+                });
+
+                m_block_ends.resize(num_blocks);
+                size_t total = 0;
+                for (index_t b = 0; b < num_blocks; b++) {
+                    total += payloads[b].size();
+                    m_block_ends[b] = total;
+                }
+                m_data.reserve(total);
+                for (auto &p: payloads) {
+                    m_data.insert(m_data.end(), p.begin(), p.end());
+                }
+            }
+
+            index_t num_vertices() const {
+                return m_num_vertices;
+            }
+
+            index_t block_size() const {
+                return m_block_size;
+            }
+
+            index_t num_blocks() const {
+                return m_block_ends.size();
+            }
+
+            /**
+             * Size of the compressed representation in bytes (block table included)
+             */
+            size_t compressed_size() const {
+                return 32 + m_block_ends.size() * 16 + m_data.size();
+            }
+
+            /**
+             * Decompresses the whole parent array, blocks are decompressed in parallel.
+             */
+            array_1d<index_t> decompress() const {
+                return decompress_range(0, m_num_vertices);
+            }
+
+            /**
+             * Decompresses the parents of the nodes in [begin, end): only the blocks overlapping the range are
+             * decompressed.
+             */
+            array_1d<index_t> decompress_range(index_t begin, index_t end) const {
+                hg_assert(begin >= 0 && begin <= end && end <= m_num_vertices, "Invalid node range.");
+                array_1d<index_t> result = array_1d<index_t>::from_shape({(size_t) (end - begin)});
+                if (begin == end) {
+                    return result;
+                }
+                index_t first_block = begin / m_block_size;
+                index_t last_block = (end - 1) / m_block_size;
+                parfor(first_block, last_block + 1, [&](index_t b) {
+                    index_t block_begin = b * m_block_size;
+                    index_t block_end = (std::min)(block_begin + m_block_size, m_num_vertices);
+                    index_t range_begin = (std::max)(block_begin, begin);
+                    index_t range_end = (std::min)(block_end, end);
+                    if (range_begin == block_begin && range_end == block_end) {
+                        decompress_block(b, &result(block_begin - begin));
+                    } else {
+                        std::vector<index_t> tmp(block_end - block_begin);
+                        decompress_block(b, tmp.data());
+                        std::copy(tmp.begin() + (range_begin - block_begin), tmp.begin() + (range_end - block_begin),
+                                  &result(range_begin - begin));
+                    }
+                });
+                return result;
+            }
+
+            void write(std::ostream &out) const {
+                using namespace tree_codec_internal;
+                std::vector<uint8_t> header;
+                write_value(header, (uint64_t) m_num_vertices);
+                write_value(header, (uint64_t) m_block_size);
+                write_value(header, (uint8_t) m_packing);
+                write_value(header, (uint8_t) m_entropy);
+                header.resize(header.size() + 6, 0);
+                write_value(header, (uint64_t) m_block_ends.size());
+                for (size_t b = 0; b < m_block_ends.size(); b++) {
+                    write_value(header, (uint64_t) m_block_ends[b]);
+                    write_value(header, (uint64_t) m_raw_sizes[b]);
+                }
+                out.write(reinterpret_cast<const char *>(header.data()), std::streamsize(header.size()));
+                out.write(reinterpret_cast<const char *>(m_data.data()), std::streamsize(m_data.size()));
+            }
+
+            static compressed_parents read(std::istream &in) {
+                using namespace tree_codec_internal;
+                compressed_parents c;
+                uint8_t header[32];
+                in.read(reinterpret_cast<char *>(header), 32);
+                hg_assert(in.good(), "Truncated compressed parents.");
+                c.m_num_vertices = (index_t) read_value<uint64_t>(header);
+                c.m_block_size = (index_t) read_value<uint64_t>(header + 8);
+                c.m_packing = (packing) header[16];
+                c.m_entropy = (entropy) header[17];
+                auto num_blocks = (index_t) read_value<uint64_t>(header + 24);
+                hg_assert(c.m_block_size > 0 && c.m_num_vertices >= 0 &&
+                          num_blocks == (c.m_num_vertices + c.m_block_size - 1) / c.m_block_size,
+                          "Corrupted compressed parents.");
+                hg_assert(c.m_packing == packing::varint || c.m_packing == packing::bitpack,
+                          "Unknown packing method.");
+
+                std::vector<uint8_t> table(num_blocks * 16);
+                in.read(reinterpret_cast<char *>(table.data()), std::streamsize(table.size()));
+                c.m_block_ends.resize(num_blocks);
+                c.m_raw_sizes.resize(num_blocks);
+                for (index_t b = 0; b < num_blocks; b++) {
+                    c.m_block_ends[b] = read_value<uint64_t>(table.data() + 16 * b);
+                    c.m_raw_sizes[b] = read_value<uint64_t>(table.data() + 16 * b + 8);
+                    hg_assert(b == 0 || c.m_block_ends[b] >= c.m_block_ends[b - 1], "Corrupted compressed parents.");
+                }
+                c.m_data.resize(num_blocks == 0 ? 0 : c.m_block_ends.back());
+                in.read(reinterpret_cast<char *>(c.m_data.data()), std::streamsize(c.m_data.size()));
+                hg_assert(in.good(), "Truncated compressed parents.");
+                return c;
+            }
+
+        private:
+
+            void decompress_block(index_t b, index_t *out) const {
+                using namespace tree_codec_internal;
+                index_t block_begin = b * m_block_size;
+                index_t size = (std::min)(block_begin + m_block_size, m_num_vertices) - block_begin;
+                size_t payload_begin = (b == 0) ? 0 : m_block_ends[b - 1];
+                size_t payload_size = m_block_ends[b] - payload_begin;
+
+                std::vector<uint8_t> packed(m_raw_sizes[b]);
+                dispatch_entropy_stage(m_entropy, [&](auto stage) {
+                    stage.decode(m_data.data() + payload_begin, payload_size, packed.data(), packed.size());
+                });
+                std::vector<uint64_t> values(size);
+                if (m_packing == packing::varint) {
+                    varint_unpack(packed.data(), packed.size(), values.data(), size);
+                } else {
+                    bit_unpack(packed.data(), packed.size(), values.data(), size);
+                }
+                int64_t parent = block_begin;
+                for (index_t i = 0; i < size; i++) {
+                    parent += zigzag_decode(values[i]);
+                    out[i] = (index_t) parent;
+                }
+            }
+
+            index_t m_num_vertices = 0;
+            index_t m_block_size = 1;
+            packing m_packing = packing::varint;
+            entropy m_entropy = entropy::none;
+            // end offset of each block payload in m_data
+            std::vector<size_t> m_block_ends;
+            // size of the packed data of each block (before the entropy stage)
+            std::vector<size_t> m_raw_sizes;
+            std::vector<uint8_t> m_data;
+        };
+    }
+}
@@ -11,6 +11,7 @@
 #pragma once
 
 #include "../graph.hpp"
+#include "tree_codec.hpp"
 #include "xtensor/xexpression.hpp"
 #include <istream>
 #include <ostream>
@@ -19,12 +20,15 @@
 namespace hg {
 
 #define HG_TREE_IO_VERSION "1"
+#define HG_TREE_IO_COMPRESSED_VERSION "2"
 
 #define HG_TREE_IO_VERSION_KEY "VERSION"
 #define HG_TREE_IO_NBNODES_KEY "NBNODES"
 #define HG_TREE_IO_NBATTRIBUTES_KEY "NBATTR"
 #define HG_TREE_IO_HEADEREND_KEY "END"
 #define HG_TREE_IO_NAME_KEY "NAME"
+#define HG_TREE_IO_PARENTS_CODEC_KEY "PARENTS_CODEC"
+#define HG_TREE_IO_PARENTS_CODEC_DELTA "delta"
 
     //bool saveBPT(char * path, int nbnodes, int * parents, int numAttr, double ** attrs, char ** attrNames);
     //bool readBPT(char * path, int * nbnodes, int ** parents, int * numAttr, double *** attrs, char *** attrNames);
@@ -41,6 +45,11 @@ namespace hg {
                 init();
             }
 
+            tree_saver_helper(out_type out, const tree &t, const tree_codec::codec_options &options) :
+                    m_tree(t), m_out(out), m_compress_parents(true), m_codec_options(options) {
+                init();
+            }
+
             ~tree_saver_helper() {
                 finalize();
             }
@@ -76,7 +85,12 @@ namespace hg {
 
         private:
             void init() {
-                m_out << HG_TREE_IO_VERSION_KEY << "=" << HG_TREE_IO_VERSION << std::endl;
+                if (m_compress_parents) {
+                    m_out << HG_TREE_IO_VERSION_KEY << "=" << HG_TREE_IO_COMPRESSED_VERSION << std::endl;
+                    m_out << HG_TREE_IO_PARENTS_CODEC_KEY << "=" << HG_TREE_IO_PARENTS_CODEC_DELTA << std::endl;
+                } else {
+                    m_out << HG_TREE_IO_VERSION_KEY << "=" << HG_TREE_IO_VERSION << std::endl;
+                }
                 m_out << HG_TREE_IO_NBNODES_KEY << "=" << m_tree.num_vertices() << std::endl;
                 m_out << HG_TREE_IO_NBATTRIBUTES_KEY << "=";
                 m_nb_attr_position = m_out.tellp();
@@ -84,6 +98,11 @@ namespace hg {
                 m_out << "                             " << std::endl;
                 m_out << HG_TREE_IO_HEADEREND_KEY << std::endl;
 
+                if (m_compress_parents) {
+                    tree_codec::compressed_parents(parents(m_tree), m_codec_options).write(m_out);
+                    return;
+                }
+
                 std::vector<int> p;
                 p.reserve(num_vertices(m_tree));
                 for (auto v: parents(m_tree))
@@ -98,6 +117,8 @@ namespace hg {
             index_t m_nb_attr_position = -1;
             index_t m_num_attr = 0;
             bool finalized = false;
+            bool m_compress_parents = false;
+            tree_codec::codec_options m_codec_options;
         };
 
     }
@@ -108,6 +129,20 @@ namespace hg {
         return tree_io_internal::tree_saver_helper(out, t);
     }
 
+    /**
+     * Saves a tree with a compressed parent array (see tree_codec.hpp), attributes are stored uncompressed.
+     *
+     * @param out output stream
+     * @param t tree
+     * @param options codec options
+     * @return a helper object used to add attributes
+     */
+    inline
+    auto
+    save_tree(std::ostream &out, const tree &t, const tree_codec::codec_options &options) {
+        return tree_io_internal::tree_saver_helper(out, t, options);
+    }
+
 
     inline
     auto
@@ -118,14 +153,15 @@ namespace hg {
 
         int num_vertices = -1;
         int num_attributes = -1;
+        bool compressed_parents = false;
 
         while (key != HG_TREE_IO_HEADEREND_KEY) {
-            int value;
+            std::string value;
             in >> tmp;
             std::size_t pos = tmp.find('=');
             if (pos != std::string::npos) {
                 key = tmp.substr(0, pos);
-                value = std::stoi(tmp.substr(pos + 1));
+                value = tmp.substr(pos + 1);
             } else {
                 key = tmp;
             }
@@ -133,9 +169,12 @@ namespace hg {
             if (key == HG_TREE_IO_VERSION_KEY) {
 
             } else if (key == HG_TREE_IO_NBNODES_KEY) {
-                num_vertices = value;
+                num_vertices = std::stoi(value);
             } else if (key == HG_TREE_IO_NBATTRIBUTES_KEY) {
-                num_attributes = value;
+                num_attributes = std::stoi(value);
+            } else if (key == HG_TREE_IO_PARENTS_CODEC_KEY) {
+                hg_assert(value == HG_TREE_IO_PARENTS_CODEC_DELTA, "Unknown parents codec '" + value + "'.");
+                compressed_parents = true;
             } else if (key == HG_TREE_IO_HEADEREND_KEY) {
 
             } else {
@@ -151,9 +190,16 @@ namespace hg {
 
         in.read(&dummy, 1); // consumme the last \n left by cin...
 
-        array_1d<int> parents;
-        parents.resize({std::size_t(num_vertices)});
-        in.read(reinterpret_cast<char *>(parents.data()), std::streamsize(num_vertices * sizeof(int)));
+        array_1d<index_t> parents;
+        if (compressed_parents) {
+            auto c = tree_codec::compressed_parents::read(in);
+            hg_assert(c.num_vertices() == num_vertices, "Compressed parents size does not match the number of nodes.");
+            parents = c.decompress();
+        } else {
+            array_1d<int> p = array_1d<int>::from_shape({std::size_t(num_vertices)});
+            in.read(reinterpret_cast<char *>(p.data()), std::streamsize(num_vertices * sizeof(int)));
+            parents = p;
+        }
 
         std::map<std::string, array_1d<double>> attributes;
 
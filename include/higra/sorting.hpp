@@ -23,6 +23,10 @@
 
 #endif
 
+#include <array>
+#include <cstring>
+#include <type_traits>
+
 namespace hg {
 
 
@@ -116,9 +120,230 @@ return indices;
         return arg_sort(arrayx, std::less<typename T::value_type>());
     }
 
+    namespace sorting_internal {
+
+        /**
+         * Bijection between the values of an arithmetic type and unsigned integers of the same size
+         * that preserves the ordering given by std::less.
+         */
+        template<typename T, typename Enable = void>
+        struct radix_key;
+
+        template<typename T>
+        struct radix_key<T, std::enable_if_t<std::is_integral<T>::value && std::is_unsigned<T>::value>> {
+            using type = T;
+
+            static type get(T value) {
+                return value;
+            }
+        };
+
+        template<typename T>
+        struct radix_key<T, std::enable_if_t<std::is_integral<T>::value && std::is_signed<T>::value>> {
+            using type = std::make_unsigned_t<T>;
+
+            static type get(T value) {
+                return (type) value ^ ((type) 1 << (sizeof(type) * 8 - 1));
+            }
+        };
+
+        template<typename T>
+        struct radix_key<T, std::enable_if_t<std::is_floating_point<T>::value>> {
+            using type = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>;
+            static_assert(sizeof(T) == sizeof(type), "Unsupported floating point type.");
+
+            // IEEE 754: flip all the bits of negative numbers and only the sign bit of positive numbers
+            static type get(T value) {
+                constexpr type sign_mask = (type) 1 << (sizeof(type) * 8 - 1);
+                type bits;
+                std::memcpy(&bits, &value, sizeof(T));
+                // -0 and +0 are equal for std::less: they must have the same key (done on the bits as
+                // the comparison with 0 may be optimized out with fast math)
+                if ((bits & ~sign_mask) == 0) {
+                    bits = 0;
+                }
+                return (bits & sign_mask) ? ~bits : (bits | sign_mask);
+            }
+        };
+
+        /**
+         * Tells if an array with values of type T sorted with the comparator Compare can be sorted with
+         * the radix sort, and if yes, in which order.
+         */
+        template<typename T, typename Compare>
+        struct radix_sort_order {
+            static constexpr bool enabled = false;
+            static constexpr bool descending = false;
+        };
+
+        template<typename T>
+        struct radix_sort_order<T, std::less<T>> {
+            static constexpr bool enabled = std::is_arithmetic<T>::value && !std::is_same<T, bool>::value;
+            static constexpr bool descending = false;
+        };
+
+        template<typename T>
+        struct radix_sort_order<T, std::greater<T>> {
+            static constexpr bool enabled = std::is_arithmetic<T>::value && !std::is_same<T, bool>::value;
+            static constexpr bool descending = true;
+        };
+
+        /**
+         * Arrays smaller than this are sorted with the comparison based stable sort.
+         */
+        const index_t radix_sort_min_size = 256;
+
+        /**
+         * Stable arg sort of a 1d array of arithmetic values with a least significant digit radix sort
+         * on 8 bits digits.
+         *
+         * Values are first mapped to unsigned integer keys (see radix_key), digits that are identical for all
+         * the keys are skipped (e.g. no more than 2 passes are done on uint16 values). Each pass splits the array
+         * into chunks: the histograms of the chunks are computed in parallel, and the elements of the chunks
+         * are then scattered in parallel at the positions given by the prefix sum of those histograms.
+         *
+         * @param arrayx 1d array of arithmetic values
+         * @param descending if true the array is sorted in decreasing order
+         * @return array of indices that sort the input array
+         */
+        template<typename T>
+        auto radix_stable_arg_sort(const xt::xexpression<T> &arrayx, bool descending = false) {
+            HG_TRACE();
+            auto &array = arrayx.derived_cast();
+            hg_assert_1d_array(array);
+            using value_type = typename T::value_type;
+            using key_type = typename radix_key<value_type>::type;
+            constexpr index_t num_buckets = 256;
+            constexpr index_t num_digits = sizeof(key_type);
+            constexpr index_t chunk_size = 1 << 16;
+
+            const index_t size = array.size();
+            const index_t num_chunks = (std::max)((size + chunk_size - 1) / chunk_size, (index_t) 1);
+
+            array_1d<key_type> keys = array_1d<key_type>::from_shape({(size_t) size});
+            array_1d<index_t> indices = xt::arange<index_t>(size);
+            array_1d<key_type> keys_buffer = array_1d<key_type>::from_shape({(size_t) size});
+            array_1d<index_t> indices_buffer = array_1d<index_t>::from_shape({(size_t) size});
+
+            if (size == 0) {
+                return indices;
+            }
+
+            const key_type key_mask = descending ? ~(key_type) 0 : (key_type) 0;
+
+            // computes the keys and the histograms of all the digits
+            std::vector<std::array<index_t, num_buckets * num_digits>> chunk_histograms(num_chunks);
+            parfor(0, num_chunks, [&](index_t c) {
+                auto &histogram = chunk_histograms[c];
+                histogram.fill(0);
+                index_t chunk_end = (std::min)((c + 1) * chunk_size, size);
+                for (index_t i = c * chunk_size; i < chunk_end; i++) {
+                    key_type key = radix_key<value_type>::get(array(i)) ^ key_mask;
+                    keys(i) = key;
+                    for (index_t d = 0; d < num_digits; d++) {
+                        histogram[d * num_buckets + ((key >> (d * 8)) & 0xFF)]++;
+                    }
+                }
+            });
+
+            std::array<bool, num_digits> skip_digit;
+            for (index_t d = 0; d < num_digits; d++) {
+                index_t total = 0;
+                for (index_t c = 0; c < num_chunks; c++) {
+                    total += chunk_histograms[c][d * num_buckets + ((keys(0) >> (d * 8)) & 0xFF)];
+                }
+                skip_digit[d] = (total == size);
+            }
+
+            std::vector<std::array<index_t, num_buckets>> chunk_offsets(num_chunks);
+            bool first_pass = true;
+
+            for (index_t d = 0; d < num_digits; d++) {
+                if (skip_digit[d]) {
+                    continue;
+                }
+                const index_t shift = d * 8;
+
+                // histograms of the chunks in the current order
+                if (first_pass) {
+                    parfor(0, num_chunks, [&](index_t c) {
+                        std::copy_n(chunk_histograms[c].begin() + d * num_buckets, num_buckets,
+                                    chunk_offsets[c].begin());
+                    });
+                    first_pass = false;
+                } else {
+                    parfor(0, num_chunks, [&](index_t c) {
+                        auto &histogram = chunk_offsets[c];
+                        histogram.fill(0);
+                        index_t chunk_end = (std::min)((c + 1) * chunk_size, size);
+                        for (index_t i = c * chunk_size; i < chunk_end; i++) {
+                            histogram[(keys(i) >> shift) & 0xFF]++;
+                        }
+                    });
+                }
+
+                // exclusive prefix sum in bucket major order
+                index_t sum = 0;
+                for (index_t b = 0; b < num_buckets; b++) {
+                    for (index_t c = 0; c < num_chunks; c++) {
+                        index_t count = chunk_offsets[c][b];
+                        chunk_offsets[c][b] = sum;
+                        sum += count;
+                    }
+                }
+
+                parfor(0, num_chunks, [&](index_t c) {
+                    auto &offsets = chunk_offsets[c];
+                    index_t chunk_end = (std::min)((c + 1) * chunk_size, size);
+                    for (index_t i = c * chunk_size; i < chunk_end; i++) {
+                        auto key = keys(i);
+                        index_t pos = offsets[(key >> shift) & 0xFF]++;
+                        keys_buffer(pos) = key;
+                        indices_buffer(pos) = indices(i);
+                    }
+                });
+
+                std::swap(keys, keys_buffer);
+                std::swap(indices, indices_buffer);
+            }
+
+            return indices;
+        }
+
+        template<typename T, typename Compare>
+        auto comparison_stable_arg_sort(const xt::xexpression<T> &arrayx, Compare comp) {
+            HIGRA_ARG_SORT(hg::stable_sort);
+        }
+
+        template<typename T, typename Compare>
+        auto stable_arg_sort(const xt::xexpression<T> &arrayx, Compare comp, std::false_type) {
+            return comparison_stable_arg_sort(arrayx, comp);
+        }
+
+        template<typename T, typename Compare>
+        auto stable_arg_sort(const xt::xexpression<T> &arrayx, Compare comp, std::true_type) {
+            auto &array = arrayx.derived_cast();
+            if (array.dimension() == 1 && (index_t) array.size() >= radix_sort_min_size) {
+                return radix_stable_arg_sort(array, radix_sort_order<typename T::value_type, Compare>::descending);
+            }
+            return comparison_stable_arg_sort(arrayx, comp);
+        }
+    }
+
+    /**
+     * Indices that sort the given array in a stable way according to the given comparator.
+     *
+     * 1d arrays of arithmetic values sorted with std::less or std::greater are sorted with a radix sort
+     * (see sorting_internal::radix_stable_arg_sort), other arrays are sorted with a comparison based stable sort.
+     *
+     * @param arrayx 1d or 2d array (2d arrays are sorted in lexicographic order)
+     * @param comp comparator
+     * @return array of indices that sort the input array
+     */
     template<typename T, typename Compare>
     auto stable_arg_sort(const xt::xexpression<T> &arrayx, Compare comp) {
-        HIGRA_ARG_SORT(hg::stable_sort);
+        using radix_order = sorting_internal::radix_sort_order<typename T::value_type, Compare>;
+        return sorting_internal::stable_arg_sort(arrayx, comp, std::integral_constant<bool, radix_order::enabled>());
     }
 
     template<typename T>
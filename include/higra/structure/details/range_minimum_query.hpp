@@ -11,11 +11,14 @@
 #pragma once
 
 #include "higra/structure/array.hpp"
+#include <functional>
+#include <limits>
 #include <vector>
 
 #ifdef _MSC_VER
 #include <intrin.h>
 #pragma intrinsic(_BitScanReverse64)
+#pragma intrinsic(_BitScanForward64)
 #endif
 
 namespace hg {
@@ -391,5 +394,221 @@ namespace hg {
             rmq_sparse_table<index_t> m_sparse_table;
 
         };
+
+        /**
+         * Index of the least significant bit set in a non zero word
+         */
+        inline index_t lowest_bit_index(uint64_t word) {
+#ifdef _MSC_VER
+            unsigned long bit_index = 0;
+            _BitScanForward64(&bit_index, word);
+            return bit_index;
+#else
+            return __builtin_ctzll(word);
+#endif
+        }
+
+        /**
+         * Index of the most significant bit set in a non zero word
+         */
+        inline index_t highest_bit_index(uint64_t word) {
+#ifdef _MSC_VER
+            unsigned long bit_index = 0;
+            _BitScanReverse64(&bit_index, word);
+            return bit_index;
+#else
+            return 63 - __builtin_clzll(word);
+#endif
+        }
+
+        /**
+         * RMQ based on blocks of w elements (w = 32 if idx_t is a 32 bits integer and w = 64 otherwise):
+         * - in block queries are answered with one w bits mask per element: the bit k of the mask of the element
+         *   at position i of a block is set if the k-th element of the block is a minimum of the range [k, i]
+         *   (Fischer and Heun's stack based in block rmq)
+         * - queries spanning several blocks use a sparse table on the blocks minima
+         *
+         * Overall:
+         * - O(n) preprocessing and memory (n words for the masks, (n/w)log(n/w) indices for the sparse table)
+         * - worst case O(1) query
+         *
+         * Positions are stored with the type idx_t: the size of the data must be smaller than the largest value
+         * representable by idx_t.
+         *
+         * @tparam data_t
+         * @tparam idx_t integral type used to store positions
+         * @tparam compare_t strict weak ordering on data_t (std::greater<data_t> gives a range maximum query)
+         */
+        template<typename data_t, typename idx_t = index_t, typename compare_t = std::less<data_t>>
+        struct rmq_bitmask_block {
+
+            using self_type = rmq_bitmask_block<data_t, idx_t, compare_t>;
+            using mask_t = std::conditional_t<sizeof(idx_t) <= 4, uint32_t, uint64_t>;
+            static const index_t block_size = sizeof(mask_t) * 8;
+
+            rmq_bitmask_block() {
+
+            }
+
+            template<typename T>
+            rmq_bitmask_block(const T &values, const compare_t &compare = compare_t()) :
+                    m_data(values.data()),
+                    m_data_size(values.size()),
+                    m_compare(compare) {
+                hg_assert(m_data_size < (index_t) (std::numeric_limits<idx_t>::max)(),
+                          "Data size is too large for the index type.");
+                init();
+            }
+
+            /**
+             * Precondition l < r
+             * @param l
+             * @param r
+             * @return position of the minimum in the range [l, r)
+             */
+            index_t query(index_t l, index_t r) const {
+                r--;
+                index_t lb = l / block_size;
+                index_t rb = r / block_size;
+                if (lb == rb) {
+                    return in_block_query(l, r);
+                }
+                index_t v = best(in_block_query(l, lb * block_size + block_size - 1),
+                                 in_block_query(rb * block_size, r));
+                if (lb + 1 == rb) {
+                    return v;
+                }
+                return best(v, sparse_table_query(lb + 1, rb - 1));
+            }
+
+            template<template<typename> typename container_t>
+            struct internal_state {
+                using type = self_type;
+                index_t data_size;
+                container_t<mask_t> masks;
+                container_t<idx_t> sparse_table;
+
+                internal_state(index_t _data_size,
+                               const container_t<mask_t> &_masks,
+                               const container_t<idx_t> &_sparse_table) :
+                        data_size(_data_size),
+                        masks(_masks),
+                        sparse_table(_sparse_table) {}
+
+                internal_state(index_t _data_size,
+                               container_t<mask_t> &&_masks,
+                               container_t<idx_t> &&_sparse_table) :
+                        data_size(_data_size),
+                        masks(std::move(_masks)),
+                        sparse_table(std::move(_sparse_table)) {}
+            };
+
+            auto get_state() const {
+                return internal_state<array_1d>(m_data_size, m_masks, m_sparse_table);
+            }
+
+            template<template<typename> typename container_t, typename T>
+            static auto make_from_state(internal_state<container_t> &&state, const T &data) {
+                self_type rmq;
+                rmq.m_data_size = state.data_size;
+                rmq.m_masks = std::move(state.masks);
+                rmq.m_sparse_table = std::move(state.sparse_table);
+                rmq.m_data = data.data();
+                rmq.init_level_offsets();
+                return rmq;
+            }
+
+            template<template<typename> typename container_t, typename T>
+            static auto make_from_state(const internal_state<container_t> &state, const T &data) {
+                self_type rmq;
+                rmq.m_data_size = state.data_size;
+                rmq.m_masks = state.masks;
+                rmq.m_sparse_table = state.sparse_table;
+                rmq.m_data = data.data();
+                rmq.init_level_offsets();
+                return rmq;
+            }
+
+            /**
+             * Memory used by the rmq structure in bytes (the data are not included)
+             */
+            size_t memory_usage() const {
+                return m_masks.size() * sizeof(mask_t) + m_sparse_table.size() * sizeof(idx_t);
+            }
+
+        private:
+
+            index_t best(index_t p1, index_t p2) const {
+                return m_compare(m_data[p2], m_data[p1]) ? p2 : p1;
+            }
+
+            /**
+             * Precondition: l <= r and l, r in the same block
+             */
+            index_t in_block_query(index_t l, index_t r) const {
+                mask_t mask = m_masks(r) & ((~(mask_t) 0) << (l % block_size));
+                return r - (r % block_size) + lowest_bit_index(mask);
+            }
+
+            /**
+             * Precondition: lb <= rb
+             */
+            index_t sparse_table_query(index_t lb, index_t rb) const {
+                auto level = highest_bit_index(rb - lb + 1);
+                auto table = m_sparse_table.data() + m_level_offsets[level];
+                return best(table[lb], table[rb - ((index_t) 1 << level) + 1]);
+            }
+
+            void init_level_offsets() {
+                index_t num_blocks = (m_data_size + block_size - 1) / block_size;
+                m_level_offsets.clear();
+                index_t offset = 0;
+                for (index_t lvl = 0; ((index_t) 1 << lvl) <= num_blocks; lvl++) {
+                    m_level_offsets.push_back(offset);
+                    offset += num_blocks - ((index_t) 1 << lvl) + 1;
+                }
+                m_level_offsets.push_back(offset);
+            }
+
+            void init() {
+                index_t num_blocks = (m_data_size + block_size - 1) / block_size;
+                init_level_offsets();
+                m_masks.resize({(size_t) m_data_size});
+                m_sparse_table.resize({(size_t) m_level_offsets.back()});
+
+                parfor(0, num_blocks, [this](index_t b) {
+                    index_t block_start = b * block_size;
+                    index_t block_end = (std::min)(block_start + block_size, m_data_size);
+                    mask_t stack = 0;
+                    for (index_t i = block_start; i < block_end; i++) {
+                        while (stack != 0 &&
+                               m_compare(m_data[i], m_data[block_start + highest_bit_index(stack)])) {
+                            stack ^= (mask_t) 1 << highest_bit_index(stack);
+                        }
+                        stack |= (mask_t) 1 << (i - block_start);
+                        m_masks(i) = stack;
+                    }
+                    m_sparse_table(b) = (idx_t) in_block_query(block_start, block_end - 1);
+                });
+
+                for (index_t lvl = 0; lvl + 2 < (index_t) m_level_offsets.size(); lvl++) {
+                    auto previous = m_sparse_table.data() + m_level_offsets[lvl];
+                    auto current = m_sparse_table.data() + m_level_offsets[lvl + 1];
+                    index_t size = m_level_offsets[lvl + 2] - m_level_offsets[lvl + 1];
+                    index_t shift = (index_t) 1 << lvl;
+                    parfor(0, size, [this, previous, current, shift](index_t i) {
+                        current[i] = (idx_t) best(previous[i], previous[i + shift]);
+                    });
+                }
+            }
+
+            const data_t *m_data;
+            index_t m_data_size;
+            compare_t m_compare;
+            array_1d<mask_t> m_masks;
+            // sparse table levels are stored contiguously, level l starts at m_level_offsets[l]
+            array_1d<idx_t> m_sparse_table;
+            std::vector<index_t> m_level_offsets;
+        };
     }
 }
@@ -118,8 +118,8 @@ namespace hg {
         /**
          * Fibonacci Heap
          *
-         * Warning different heaps will share the same object pool which is NOT thread safe !
-         * The following method are not thread safe: push, pop, erase, clear, destructor
+         * Warning different heaps created in the same thread share the same object pool: a heap must be used and
+         * destroyed in the thread that created it.
          *
          * @tparam T Value type, must implement operator < (ie. with a and b two values of type T, a < b must be a well formed expression)
          */
@@ -131,7 +131,7 @@ namespace hg {
         private:
 
             static object_pool<node_t> &s_pool() {
-                static object_pool<node_t> pool{};
+                static thread_local object_pool<node_t> pool{};
                 return pool;
             }
 
@@ -0,0 +1,256 @@
+/***************************************************************************
+* Copyright ESIEE Paris (2021)                                             *
+*                                                                          *
+* Contributor(s) : Benjamin Perret                                         *
+*                                                                          *
+* Distributed under the terms of the CECILL-B License.                     *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#pragma once
+
+#include <vector>
+#include "../utils.hpp"
+
+namespace hg {
+
+    /**
+     * Indexed d-ary min heap.
+     *
+     * Each element of the heap is identified by an index in [0, capacity) given when the element is pushed. A
+     * position array maps any element index to the location of the element in the heap: the value of any element
+     * can thus be changed in logarithmic time without handles.
+     *
+     * Elements are stored contiguously in an array (with their index) which makes this heap much more cache friendly
+     * than node based heaps like fibonacci_heap.
+     *
+     * Elements with equal values are ordered by increasing indices: the order in which elements are popped does not
+     * depend on the order of the operations performed on the heap.
+     *
+     * @tparam T Value type, must implement operator < (ie. with a and b two values of type T, a < b must be a well formed expression)
+     * @tparam D arity of the heap
+     */
+    template<typename T, index_t D = 4>
+    struct indexed_dary_heap {
+        static_assert(D >= 2, "The arity of a d-ary heap must be greater than or equal to 2.");
+
+    private:
+
+        struct element {
+            T value;
+            index_t index;
+        };
+
+        std::vector<element> m_heap;
+        std::vector<index_t> m_positions;
+
+    public:
+
+        /**
+         * Creates an empty min-heap that can contain elements with indices in [0, capacity)
+         * @param capacity
+         */
+        indexed_dary_heap(index_t capacity = 0) : m_positions(capacity, invalid_index) {
+
+        }
+
+        /**
+         * Test if heap is empty
+         * @return
+         */
+        bool empty() const {
+            return m_heap.empty();
+        }
+
+        auto size() const {
+            return m_heap.size();
+        }
+
+        /**
+         * Number of element indices supported by the heap
+         * @return
+         */
+        index_t capacity() const {
+            return (index_t) m_positions.size();
+        }
+
+        /**
+         * Reserves memory for the given number of elements
+         * @param num_elements
+         */
+        void reserve(index_t num_elements) {
+            m_heap.reserve(num_elements);
+        }
+
+        /**
+         * Test if the element of given index is in the heap
+         * @param index
+         * @return
+         */
+        bool contains(index_t index) const {
+            return m_positions[index] != invalid_index;
+        }
+
+        /**
+         * Insert a new element in the heap
+         *
+         * Complexity O(log_D(n))
+         *
+         * @param index index of the new element (must not be in the heap)
+         * @param value value of the new element
+         */
+        void push(index_t index, const T &value) {
+            hg_assert(!contains(index), "Element is already in the heap.");
+            m_heap.push_back({value, index});
+            m_positions[index] = (index_t) m_heap.size() - 1;
+            sift_up((index_t) m_heap.size() - 1);
+        }
+
+        /**
+         * Index of the min element of the heap
+         *
+         * Complexity O(1)
+         *
+         * @return
+         */
+        index_t top() const {
+            return m_heap[0].index;
+        }
+
+        /**
+         * Value of the min element of the heap
+         *
+         * Complexity O(1)
+         *
+         * @return
+         */
+        const T &top_value() const {
+            return m_heap[0].value;
+        }
+
+        /**
+         * Value of the element of given index (must be in the heap)
+         * @param index
+         * @return
+         */
+        const T &value(index_t index) const {
+            return m_heap[m_positions[index]].value;
+        }
+
+        /**
+         * Removes the min element from the heap
+         *
+         * Complexity O(D * log_D(n))
+         */
+        void pop() {
+            remove_at(0);
+        }
+
+        /**
+         * Removes the element of given index from the heap (must be in the heap)
+         *
+         * Complexity O(D * log_D(n))
+         *
+         * @param index
+         */
+        void erase(index_t index) {
+            remove_at(m_positions[index]);
+        }
+
+        /**
+         * Changes the value of the element of given index (must be in the heap)
+         *
+         * Complexity O(log_D(n)) if the value decreases and O(D * log_D(n)) otherwise
+         *
+         * @param index
+         * @param value
+         */
+        void update(index_t index, const T &value) {
+            index_t position = m_positions[index];
+            if (value < m_heap[position].value) {
+                m_heap[position].value = value;
+                sift_up(position);
+            } else {
+                m_heap[position].value = value;
+                sift_down(position);
+            }
+        }
+
+        /**
+         * Empties the heap
+         *
+         * Complexity O(n)
+         */
+        void clear() {
+            for (auto &e: m_heap) {
+                m_positions[e.index] = invalid_index;
+            }
+            m_heap.clear();
+        }
+
+    private:
+
+        static bool less(const element &a, const element &b) {
+            return a.value < b.value || (!(b.value < a.value) && a.index < b.index);
+        }
+
+        void remove_at(index_t position) {
+            m_positions[m_heap[position].index] = invalid_index;
+            index_t last = (index_t) m_heap.size() - 1;
+            if (position != last) {
+                m_heap[position] = std::move(m_heap[last]);
+                m_positions[m_heap[position].index] = position;
+                m_heap.pop_back();
+                if (position > 0 && less(m_heap[position], m_heap[(position - 1) / D])) {
+                    sift_up(position);
+                } else {
+                    sift_down(position);
+                }
+            } else {
+                m_heap.pop_back();
+            }
+        }
+
+        void sift_up(index_t position) {
+            element e = std::move(m_heap[position]);
+            while (position > 0) {
+                index_t parent = (position - 1) / D;
+                if (!less(e, m_heap[parent])) {
+                    break;
+                }
+                m_heap[position] = std::move(m_heap[parent]);
+                m_positions[m_heap[position].index] = position;
+                position = parent;
+            }
+            m_positions[e.index] = position;
+            m_heap[position] = std::move(e);
+        }
+
+        void sift_down(index_t position) {
+            const index_t size = (index_t) m_heap.size();
+            element e = std::move(m_heap[position]);
+            while (true) {
+                index_t first_child = position * D + 1;
+                if (first_child >= size) {
+                    break;
+                }
+                index_t last_child = (std::min)(first_child + D, size);
+                index_t min_child = first_child;
+                for (index_t c = first_child + 1; c < last_child; c++) {
+                    if (less(m_heap[c], m_heap[min_child])) {
+                        min_child = c;
+                    }
+                }
+                if (!less(m_heap[min_child], e)) {
+                    break;
+                }
+                m_heap[position] = std::move(m_heap[min_child]);
+                m_positions[m_heap[position].index] = position;
+                position = min_child;
+            }
+            m_positions[e.index] = position;
+            m_heap[position] = std::move(e);
+        }
+    };
+}
@@ -12,6 +12,8 @@
 
 #include "../graph.hpp"
 #include "details/range_minimum_query.hpp"
+#include "unionfind.hpp"
+#include <limits>
 #include <stack>
 
 namespace hg {
@@ -239,10 +241,432 @@ namespace hg {
 
         };
 
+
+        /**
+         * Lowest common ancestor solver based on a range maximum query on the preorder of the tree.
+         *
+         * Let rank(n) be the rank of the node n in a preorder traversal of the tree and p the array such that
+         * p(rank(n)) = parent(n). As the parent of a node has a larger index than the node itself, for any two
+         * distinct nodes n1 and n2 such that rank(n1) < rank(n2):
+         *
+         *     lca(n1, n2) = max{p(i) | i in ]rank(n1), rank(n2)]}
+         *
+         * Compared to the Euler tour approach (see lca_rmq), the array searched by the range maximum query has
+         * n elements instead of 2n - 1 and the depth of the nodes is not needed. The range maximum query is
+         * solved with rmq_bitmask_block (linear memory, worst case constant time queries).
+         *
+         * Node indices are stored with the type idx_t: a 32 bits integer type can be used if the number of nodes
+         * in the tree is smaller than 2^31.
+         *
+         * @tparam tree_t
+         * @tparam idx_t integral type used to store node indices
+         */
+        template<typename tree_t, typename idx_t = index_t>
+        struct lca_preorder_rmq {
+
+            using rmq_type = range_minimum_query_internal::rmq_bitmask_block<idx_t, idx_t, std::greater<idx_t>>;
+
+        public:
+            using self_type = lca_preorder_rmq<tree_t, idx_t>;
+
+            lca_preorder_rmq(const tree_t &tree) {
+                HG_TRACE();
+                index_t num_nodes = hg::num_vertices(tree);
+                hg_assert(num_nodes < (index_t) (std::numeric_limits<idx_t>::max)(),
+                          "Tree is too large for the index type.");
+
+                m_preorder_rank.resize({(size_t) num_nodes});
+                m_preorder_parents.resize({(size_t) num_nodes});
+
+                compute_preorder(tree);
+                m_rmq_solver = rmq_type(m_preorder_parents);
+            }
+
+            /**
+             * Return the lowest common ancestor of two nodes
+             * @param n1
+             * @param n2
+             * @return
+             */
+            index_t lca(index_t n1, index_t n2) const {
+                if (n1 == n2)
+                    return n1;
+
+                index_t ii = m_preorder_rank(n1);
+                index_t jj = m_preorder_rank(n2);
+
+                if (ii > jj) {
+                    std::swap(ii, jj);
+                }
+
+                return m_preorder_parents(m_rmq_solver.query(ii + 1, jj + 1));
+            }
+
+            /**
+             * Return the lowest common ancestors of a range of pairs of nodes
+             * @tparam T
+             * @param range
+             * @return
+             */
+            template<typename T>
+            auto lca(const T &range) const {
+                HG_TRACE();
+                size_t size = range.end() - range.begin();
+                auto result = array_1d<index_t>::from_shape({size});
+
+                auto it = range.begin();
+                parfor(0, size, [&result, &it, this](index_t i) {
+                    auto e = it[i];
+                    result(i) = this->lca(e.first, e.second);
+                });
+                return result;
+            }
+
+            /**
+             * Given two 1d array of graph vertex indices v1 and v2, both containing n elements,
+             * this function returns a 1d array or tree vertex indices of size n such that
+             * for all i in 0..n-1, res(i) = lca(v1(i); v2(i))
+             *
+             * @tparam T
+             * @param xvertices1 first array of graph vertices
+             * @param xvertices2 second array of graph vertices
+             * @return array of lowest common ancestors
+             */
+            template<typename T>
+            auto lca(const xt::xexpression<T> &xvertices1, const xt::xexpression<T> &xvertices2) const {
+                HG_TRACE();
+                auto &vertices1 = xvertices1.derived_cast();
+                auto &vertices2 = xvertices2.derived_cast();
+                hg_assert_1d_array(vertices1);
+                hg_assert_integral_value_type(vertices1);
+                hg_assert_same_shape(vertices1, vertices2);
+
+                auto size = vertices1.size();
+                auto result = array_1d<index_t>::from_shape({size});
+
+                parfor(0, size, [&vertices1, &vertices2, &result, this](index_t i) {
+                    result(i) = this->lca(vertices1(i), vertices2(i));
+                });
+                return result;
+            }
+
+            template<template<typename> typename container_t>
+            struct internal_state {
+                using type = self_type;
+                using rmq_state_type = typename rmq_type::template internal_state<container_t>;
+                container_t<idx_t> preorder_rank;
+                container_t<idx_t> preorder_parents;
+                rmq_state_type rmq_state;
+
+                internal_state(const container_t<idx_t> &_preorder_rank,
+                               const container_t<idx_t> &_preorder_parents,
+                               const rmq_state_type &_rmq_state) :
+                        preorder_rank(_preorder_rank),
+                        preorder_parents(_preorder_parents),
+                        rmq_state(_rmq_state) {}
+
+                internal_state(container_t<idx_t> &&_preorder_rank,
+                               container_t<idx_t> &&_preorder_parents,
+                               rmq_state_type &&_rmq_state) :
+                        preorder_rank(std::move(_preorder_rank)),
+                        preorder_parents(std::move(_preorder_parents)),
+                        rmq_state(std::move(_rmq_state)) {}
+            };
+
+            auto get_state() const {
+                return internal_state<array_1d>(m_preorder_rank,
+                                                m_preorder_parents,
+                                                m_rmq_solver.get_state());
+            }
+
+            template<template<typename> typename container_t>
+            static auto make_from_state(internal_state<container_t> &&state) {
+                self_type lca;
+                lca.m_preorder_rank = std::move(state.preorder_rank);
+                lca.m_preorder_parents = std::move(state.preorder_parents);
+                lca.m_rmq_solver = rmq_type::make_from_state(std::move(state.rmq_state), lca.m_preorder_parents);
+                return lca;
+            }
+
+            template<template<typename> typename container_t>
+            static auto make_from_state(const internal_state<container_t> &state) {
+                self_type lca;
+                lca.m_preorder_rank = state.preorder_rank;
+                lca.m_preorder_parents = state.preorder_parents;
+                lca.m_rmq_solver = rmq_type::make_from_state(state.rmq_state, lca.m_preorder_parents);
+                return lca;
+            }
+
+            index_t num_elements() const {
+                return m_preorder_rank.size();
+            }
+
+            /**
+             * Memory used by the lca structure in bytes
+             */
+            size_t memory_usage() const {
+                return (m_preorder_rank.size() + m_preorder_parents.size()) * sizeof(idx_t) +
+                       m_rmq_solver.memory_usage();
+            }
+
+        private:
+
+            lca_preorder_rmq() {};
+
+            // rank of each node in the preorder traversal of the tree
+            array_1d<idx_t> m_preorder_rank;
+            // parent of the node of rank i in the preorder traversal of the tree
+            array_1d<idx_t> m_preorder_parents;
+
+            // rmq solver
+            rmq_type m_rmq_solver;
+
+            /**
+             * Preorder ranks are computed from the subtree sizes in a root to leaves traversal: the children
+             * of a node are not needed.
+             */
+            void compute_preorder(const tree_t &tree) {
+                index_t num_nodes = num_vertices(tree);
+                auto &parents = tree.parents();
+                index_t root = tree.root();
+
+                // subtree sizes
+                std::vector<idx_t> next_rank(num_nodes, 1);
+                for (index_t n = 0; n < root; n++) {
+                    next_rank[parents(n)] += next_rank[n];
+                }
+
+                m_preorder_rank(root) = 0;
+                m_preorder_parents(0) = (idx_t) root;
+                next_rank[root] = 1;
+                for (index_t n = root - 1; n >= 0; n--) {
+                    auto p = parents(n);
+                    idx_t subtree_size = next_rank[n];
+                    idx_t rank = next_rank[p];
+                    next_rank[p] += subtree_size;
+                    m_preorder_rank(n) = rank;
+                    m_preorder_parents(rank) = (idx_t) p;
+                    // first child of n will be just after n
+                    next_rank[n] = rank + 1;
+                }
+            }
+        };
     }
 
     using lca_sparse_table_block = lca_internal::lca_rmq<tree, range_minimum_query_internal::rmq_sparse_table_block<index_t>>;
     using lca_sparse_table = lca_internal::lca_rmq<tree, range_minimum_query_internal::rmq_sparse_table<index_t>>;
 
-    using lca_fast = lca_sparse_table_block;
+    using lca_preorder_block = lca_internal::lca_preorder_rmq<tree, index_t>;
+    using lca_preorder_block_32 = lca_internal::lca_preorder_rmq<tree, int32_t>;
+
+    using lca_fast = lca_preorder_block;
+
+    namespace lca_internal {
+
+        /**
+         * Tarjan's offline lowest common ancestor algorithm, see lca_offline.
+         *
+         * Nodes are finished in a postorder of the tree computed from the subtree sizes (the children of the nodes
+         * are not needed): the subtree of a node n is the postorder range [post(n) - size(n) + 1, post(n)].
+         * When a node is finished, it is linked to its parent in the union find: the canonical element of
+         * a finished node is then its lowest unfinished ancestor, and union by rank as well as the ancestor
+         * array of the classical algorithm are not needed.
+         *
+         * The tree is cut into independent subtrees of at most grain nodes whose queries are processed in
+         * parallel. The remaining queries, whose lca lies above the subtrees, are then processed on the top
+         * part of the tree where each subtree is represented by its root.
+         *
+         * @tparam idx_t integral type used to store node indices and 4 times the number of queries
+         */
+        template<typename idx_t, typename tree_t, typename T1, typename T2>
+        auto lca_offline_impl(const tree_t &tree, const T1 &vertices1, const T2 &vertices2, index_t grain) {
+            index_t num_nodes = num_vertices(tree);
+            index_t num_queries = vertices1.size();
+            auto &parents = tree.parents();
+            index_t root = tree.root();
+
+            array_1d<index_t> result = array_1d<index_t>::from_shape({(size_t) num_queries});
+
+            std::vector<idx_t> size(num_nodes, 1);
+            for (index_t n = 0; n < root; n++) {
+                size[parents(n)] += size[n];
+            }
+
+            // aux: next available postorder rank for the children of each node
+            std::vector<idx_t> aux(num_nodes);
+            std::vector<idx_t> order(num_nodes);
+            order[num_nodes - 1] = (idx_t) root;
+            aux[root] = (idx_t) (num_nodes - 2);
+            for (index_t n = root - 1; n >= 0; n--) {
+                auto p = parents(n);
+                auto post = aux[p];
+                order[post] = (idx_t) n;
+                aux[p] -= size[n];
+                aux[n] = post - 1;
+            }
+
+            // aux: subtree root of each node, top nodes have more than grain descendants and are their own
+            // subtree root
+            auto &subtree_root = aux;
+            subtree_root[root] = (idx_t) root;
+            for (index_t n = root - 1; n >= 0; n--) {
+                auto p = parents(n);
+                subtree_root[n] = (size[n] > grain || size[p] > grain) ? (idx_t) n : subtree_root[p];
+            }
+
+            // a query between two nodes of the same subtree is internal, other queries are attached to the
+            // subtree roots of their nodes.
+            // queries attached to each node are encoded as 4q + 2 * internal + side where side is 0 for vertices1
+            // and 1 for vertices2
+            std::vector<idx_t> query_offsets(num_nodes + 1, 0);
+            for (index_t q = 0; q < num_queries; q++) {
+                index_t n1 = vertices1(q);
+                index_t n2 = vertices2(q);
+                if (n1 == n2) {
+                    result(q) = n1;
+                } else if (subtree_root[n1] == subtree_root[n2]) {
+                    query_offsets[n1 + 1]++;
+                    query_offsets[n2 + 1]++;
+                } else {
+                    query_offsets[subtree_root[n1] + 1]++;
+                    query_offsets[subtree_root[n2] + 1]++;
+                }
+            }
+            for (index_t n = 0; n < num_nodes; n++) {
+                query_offsets[n + 1] += query_offsets[n];
+            }
+            std::vector<idx_t> query_entries(query_offsets[num_nodes]);
+            for (index_t q = 0; q < num_queries; q++) {
+                index_t n1 = vertices1(q);
+                index_t n2 = vertices2(q);
+                if (n1 == n2) {
+                    continue;
+                }
+                if (subtree_root[n1] == subtree_root[n2]) {
+                    query_entries[query_offsets[n1]++] = (idx_t) (4 * q + 2);
+                    query_entries[query_offsets[n2]++] = (idx_t) (4 * q + 3);
+                } else {
+                    query_entries[query_offsets[subtree_root[n1]]++] = (idx_t) (4 * q);
+                    query_entries[query_offsets[subtree_root[n2]]++] = (idx_t) (4 * q + 1);
+                }
+            }
+            // offsets were shifted by the insertion
+            for (index_t n = num_nodes; n > 0; n--) {
+                query_offsets[n] = query_offsets[n - 1];
+            }
+            query_offsets[0] = 0;
+
+            // uf_parent(n) = n while n is not finished
+            std::vector<idx_t> uf_parent(num_nodes);
+            for (index_t n = 0; n < num_nodes; n++) {
+                uf_parent[n] = (idx_t) n;
+            }
+            auto find = [&uf_parent](index_t n) {
+                while (uf_parent[n] != n) {
+                    uf_parent[n] = uf_parent[uf_parent[n]];
+                    n = uf_parent[n];
+                }
+                return n;
+            };
+
+            // node n is finished: answer its queries of the given kind whose other node is finished
+            // and link n to its parent
+            auto finish_node = [&](index_t n, index_t internal_queries, bool link_to_parent) {
+                for (index_t i = query_offsets[n]; i < query_offsets[n + 1]; i++) {
+                    index_t e = query_entries[i];
+                    if (((e >> 1) & 1) != internal_queries) {
+                        continue;
+                    }
+                    index_t q = e >> 2;
+                    index_t other = (e & 1) ? vertices1(q) : vertices2(q);
+                    if (!internal_queries) {
+                        other = subtree_root[other];
+                    }
+                    if (uf_parent[other] != other) {
+                        result(q) = find(other);
+                    }
+                }
+                if (link_to_parent) {
+                    uf_parent[n] = (idx_t) parents(n);
+                }
+            };
+
+            // subtrees: (root, postorder rank of the root)
+            std::vector<std::pair<idx_t, idx_t>> subtrees;
+            for (index_t k = 0; k < num_nodes; k++) {
+                index_t n = order[k];
+                if (subtree_root[n] == n && size[n] <= grain) {
+                    subtrees.push_back({(idx_t) n, (idx_t) k});
+                }
+            }
+
+            // subtrees are independent: they only access the union find elements and the queries of their nodes
+            parfor(0, subtrees.size(), [&](index_t i) {
+                index_t c = subtrees[i].first;
+                index_t end = subtrees[i].second;
+                for (index_t k = end - size[c] + 1; k < end; k++) {
+                    finish_node(order[k], 1, true);
+                }
+                finish_node(c, 1, false);
+            });
+
+            // top part of the tree, subtrees are represented by their roots
+            for (index_t k = 0; k < num_nodes; k++) {
+                index_t n = order[k];
+                if (subtree_root[n] != n) {
+                    n = subtree_root[n];
+                    k += size[n] - 1;
+                }
+                finish_node(n, 0, n != root);
+            }
+
+            return result;
+        }
+    }
+
+    /**
+     * Offline computation of the lowest common ancestors of a set of pairs of nodes
+     * (Tarjan's offline algorithm with a union find).
+     *
+     * Given two 1d array of tree node indices v1 and v2, both containing n elements,
+     * this function returns a 1d array or tree node indices of size n such that
+     * for all i in 0..n-1, res(i) = lca(v1(i); v2(i))
+     *
+     * Contrarily to the lca structures (lca_fast...), no index is built: all the lowest common ancestors are
+     * computed in a single pass on the tree, in linear time. This is efficient when the lowest common ancestors
+     * of a given set of pairs are needed only once. The work is parallelized over independent subtrees.
+     *
+     * @tparam tree_t
+     * @tparam T1
+     * @tparam T2
+     * @param tree input tree
+     * @param xvertices1 first array of tree nodes
+     * @param xvertices2 second array of tree nodes
+     * @return array of lowest common ancestors
+     */
+    template<typename tree_t, typename T1, typename T2>
+    auto lca_offline(const tree_t &tree,
+                     const xt::xexpression<T1> &xvertices1,
+                     const xt::xexpression<T2> &xvertices2) {
+        HG_TRACE();
+        auto &vertices1 = xvertices1.derived_cast();
+        auto &vertices2 = xvertices2.derived_cast();
+        hg_assert_1d_array(vertices1);
+        hg_assert_integral_value_type(vertices1);
+        hg_assert_same_shape(vertices1, vertices2);
+
+        index_t num_nodes = num_vertices(tree);
+#ifdef HG_USE_TBB
+        index_t grain = (std::max)((index_t) 1 << 14,
+                                   num_nodes / (4 * (index_t) tbb::this_task_arena::max_concurrency()));
+#else
+        index_t grain = num_nodes;
+#endif
+        if (num_nodes < (index_t) (std::numeric_limits<int32_t>::max)() &&
+            4 * (index_t) vertices1.size() < (index_t) (std::numeric_limits<int32_t>::max)()) {
+            return lca_internal::lca_offline_impl<int32_t>(tree, vertices1, vertices2, grain);
+        } else {
+            return lca_internal::lca_offline_impl<index_t>(tree, vertices1, vertices2, grain);
+        }
+    }
 }
\ No newline at end of file
@@ -0,0 +1,326 @@
+/***************************************************************************
+* Copyright ESIEE Paris (2021)                                             *
+*                                                                          *
+* Contributor(s) : Benjamin Perret                                         *
+*                                                                          *
+* Distributed under the terms of the CECILL-B License.                     *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#pragma once
+
+#include <vector>
+#include "../utils.hpp"
+
+namespace hg {
+
+    namespace pairing_heap_internal {
+
+        template<typename T>
+        struct pairing_heap;
+
+        template<typename T>
+        struct node {
+            using self_t = node<T>;
+            using pointer_t = self_t *;
+        private:
+            T m_value;
+            pointer_t m_child;
+            // next sibling
+            pointer_t m_next;
+            // previous sibling or parent if this node is the first child of its parent
+            pointer_t m_previous;
+
+            void init(const T &value) {
+                m_value = value;
+                m_child = nullptr;
+                m_next = nullptr;
+                m_previous = nullptr;
+            }
+
+        public:
+            friend struct pairing_heap<T>;
+
+            T get_value() { return m_value; }
+        };
+
+        /**
+         * Pairing Heap
+         *
+         * Nodes are allocated in blocks owned by the heap: a heap can be safely used in any thread but handles
+         * are invalidated when the heap is destroyed.
+         *
+         * @tparam T Value type, must implement operator < (ie. with a and b two values of type T, a < b must be a well formed expression)
+         */
+        template<typename T>
+        struct pairing_heap final {
+            using node_t = node<T>;
+            using value_handle = node_t *;
+
+        private:
+            std::vector<std::vector<node_t>> m_blocks;
+            node_t *m_first_free = nullptr;
+            size_t m_block_size;
+
+            node_t *m_heap = nullptr;
+            size_t m_size = 0;
+
+        public:
+
+            /**
+             * Creates an empty min-heap
+             *
+             * @param block_size number of nodes allocated at once when the heap needs memory
+             */
+            pairing_heap(size_t block_size = 4096) : m_block_size(block_size) {
+
+            }
+
+            pairing_heap(const pairing_heap &) = delete;
+
+            pairing_heap &operator=(const pairing_heap &) = delete;
+
+            pairing_heap(pairing_heap &&other) = default;
+
+            pairing_heap &operator=(pairing_heap &&other) = default;
+
+            /**
+             * Test if heap is empty
+             * @return
+             */
+            bool empty() const {
+                return m_heap == nullptr;
+            }
+
+            auto size() const {
+                return m_size;
+            }
+
+            /**
+             * Insert new value in the heap
+             *
+             * Complexity O(1)
+             *
+             * @param value
+             * @return Handle on the new value (used for increase/decrease/update/erase operations)
+             */
+            value_handle push(const T &value) {
+                m_size++;
+                node_t *new_node = allocate();
+                new_node->init(value);
+                m_heap = m_meld(m_heap, new_node);
+                return new_node;
+            }
+
+            /**
+             * Returns an handle on the min element of the heap
+             *
+             * Complexity O(1)
+             *
+             * @return Handle on the value (used for increase/decrease/update/erase operations)
+             */
+            value_handle top() {
+                return m_heap;
+            }
+
+            /**
+             * Removes the min element from the heap (this invalidates any previously obtained handles on this element)
+             *
+             * Complexity amortized O(log(n))
+             */
+            void pop() {
+                auto old_heap = m_heap;
+                m_heap = m_two_pass_merge(m_heap->m_child);
+                m_size--;
+                free(old_heap);
+            }
+
+            /**
+             * Removes the given element from the heap.
+             *
+             * Complexity amortized O(log(n))
+             *
+             * @param node
+             */
+            void erase(value_handle node) {
+                m_detach(node);
+                m_size--;
+                free(node);
+            }
+
+            /**
+             * Decreases the value of the given element to the given value.
+             *
+             * Complexity amortized o(log(n))
+             *
+             * @param node
+             * @param value
+             */
+            void decrease(value_handle node, const T &value) {
+                node->m_value = value;
+                if (node != m_heap) {
+                    m_cut(node);
+                    m_heap = m_meld(m_heap, node);
+                }
+            }
+
+            /**
+             * Increases the value of the given element to the given value.
+             *
+             * Complexity amortized O(log(n))
+             *
+             * @param node
+             * @param value
+             */
+            void increase(value_handle node, const T &value) {
+                m_detach(node);
+                node->init(value);
+                m_heap = m_meld(m_heap, node);
+            }
+
+            /**
+             * Changes the value of the given element to the given value.
+             *
+             * Complexity amortized O(log(n))
+             *
+             * @param node
+             * @param value
+             */
+            void update(value_handle node, const T &value) {
+                if (value < node->m_value) {
+                    decrease(node, value);
+                } else if (node->m_value < value) {
+                    increase(node, value);
+                } else {
+                    node->m_value = value;
+                }
+            }
+
+            /**
+             * Empties the heap: all handles are invalidated
+             *
+             * Complexity O(1)
+             */
+            void clear() {
+                m_blocks.clear();
+                m_first_free = nullptr;
+                m_heap = nullptr;
+                m_size = 0;
+            }
+
+        private:
+
+            node_t *allocate() {
+                if (m_first_free == nullptr) {
+                    m_blocks.emplace_back(m_block_size);
+                    auto &block = m_blocks.back();
+                    for (index_t i = 0; i < (index_t) block.size() - 1; i++) {
+                        block[i].m_next = &block[i + 1];
+                    }
+                    block.back().m_next = nullptr;
+                    m_first_free = &block[0];
+                }
+                node_t *tmp = m_first_free;
+                m_first_free = m_first_free->m_next;
+                return tmp;
+            }
+
+            void free(node_t *node) {
+                node->m_next = m_first_free;
+                m_first_free = node;
+            }
+
+            /**
+             * Merges two heap ordered trees (their roots must not have siblings)
+             */
+            static node_t *m_meld(node_t *root1, node_t *root2) {
+                if (root1 == nullptr)
+                    return root2;
+                if (root2 == nullptr)
+                    return root1;
+                if (root2->m_value < root1->m_value) {
+                    std::swap(root1, root2);
+                }
+                root2->m_previous = root1;
+                root2->m_next = root1->m_child;
+                if (root1->m_child != nullptr) {
+                    root1->m_child->m_previous = root2;
+                }
+                root1->m_child = root2;
+                return root1;
+            }
+
+            /**
+             * Merges a list of siblings into a single tree: siblings are first melded by pairs from left to right
+             * and the resulting trees are then melded from right to left.
+             */
+            static node_t *m_two_pass_merge(node_t *first) {
+                if (first == nullptr)
+                    return nullptr;
+
+                // first pass: the melded pairs are stacked in reverse order with the m_next pointer
+                node_t *pairs = nullptr;
+                node_t *current = first;
+                while (current != nullptr) {
+                    node_t *a = current;
+                    node_t *b = a->m_next;
+                    current = (b != nullptr) ? b->m_next : nullptr;
+                    a->m_next = a->m_previous = nullptr;
+                    if (b != nullptr) {
+                        b->m_next = b->m_previous = nullptr;
+                    }
+                    node_t *melded = m_meld(a, b);
+                    melded->m_next = pairs;
+                    pairs = melded;
+                }
+
+                // second pass
+                node_t *result = pairs;
+                node_t *rest = pairs->m_next;
+                result->m_next = nullptr;
+                while (rest != nullptr) {
+                    node_t *next = rest->m_next;
+                    rest->m_next = nullptr;
+                    result = m_meld(result, rest);
+                    rest = next;
+                }
+                return result;
+            }
+
+            /**
+             * Removes the given non root node (and its subtree) from the list of children of its parent
+             */
+            static void m_cut(node_t *node) {
+                if (node->m_previous->m_child == node) {
+                    node->m_previous->m_child = node->m_next;
+                } else {
+                    node->m_previous->m_next = node->m_next;
+                }
+                if (node->m_next != nullptr) {
+                    node->m_next->m_previous = node->m_previous;
+                }
+                node->m_next = nullptr;
+                node->m_previous = nullptr;
+            }
+
+            /**
+             * Removes the given node from the heap, its children are merged back into the heap
+             */
+            void m_detach(node_t *node) {
+                node_t *subtree = m_two_pass_merge(node->m_child);
+                node->m_child = nullptr;
+                if (node == m_heap) {
+                    m_heap = subtree;
+                } else {
+                    m_cut(node);
+                    m_heap = m_meld(m_heap, subtree);
+                }
+            }
+        };
+    }
+
+    template<typename value_type>
+    using pairing_heap = pairing_heap_internal::pairing_heap<value_type>;
+
+}
@@ -0,0 +1,445 @@
+/***************************************************************************
+* Copyright ESIEE Paris (2021)                                             *
+*                                                                          *
+* Contributor(s) : Benjamin Perret                                         *
+*                                                                          *
+* Distributed under the terms of the CECILL-B License.                     *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#pragma once
+
+#include "undirected_graph.hpp"
+#include <algorithm>
+
+namespace hg {
+
+    namespace region_merging_graph_internal {
+
+        /**
+         * Iterator on the live entries of the out edge list of a vertex in a region_merging_graph.
+         *
+         * @tparam graph_t region_merging_graph
+         * @tparam value_t edge_descriptor (out/in edges) or vertex_descriptor (adjacent vertices)
+         * @tparam in_edge if true, the given vertex is the target of the edge descriptors (in edges)
+         */
+        template<typename graph_t, typename value_t, bool in_edge = false>
+        struct live_edge_iterator :
+                public forward_iterator_facade<live_edge_iterator<graph_t, value_t, in_edge>, value_t, value_t> {
+
+            using self_type = live_edge_iterator<graph_t, value_t, in_edge>;
+            using base_iterator_t = typename std::vector<index_t>::const_iterator;
+
+            live_edge_iterator() : m_vertex(invalid_index), m_graph(nullptr) {}
+
+            live_edge_iterator(index_t vertex, base_iterator_t current, base_iterator_t end, const graph_t *graph) :
+                    m_vertex(vertex), m_current(current), m_end(end), m_graph(graph) {
+                skip_stale();
+            }
+
+            void increment() {
+                m_current++;
+                skip_stale();
+            }
+
+            bool equal(const self_type &other) const {
+                return m_current == other.m_current;
+            }
+
+            value_t dereference() const {
+                return dereference_impl(static_cast<value_t *>(nullptr));
+            }
+
+        private:
+
+            void skip_stale() {
+                while (m_current != m_end && !m_graph->is_incident(*m_current, m_vertex)) {
+                    m_current++;
+                }
+            }
+
+            template<typename T>
+            T dereference_impl(T *) const {
+                const auto &e = m_graph->edge_from_index(*m_current);
+                auto other = (e.source == m_vertex) ? e.target : e.source;
+                return in_edge ? T(other, m_vertex, e.index) : T(m_vertex, other, e.index);
+            }
+
+            index_t dereference_impl(index_t *) const {
+                const auto &e = m_graph->edge_from_index(*m_current);
+                return (e.source == m_vertex) ? e.target : e.source;
+            }
+
+            index_t m_vertex;
+            base_iterator_t m_current;
+            base_iterator_t m_end;
+            const graph_t *m_graph;
+        };
+
+        /**
+         * Mutable undirected graph dedicated to region merging algorithms (see binary_partition_tree).
+         *
+         * The out edges of each vertex are stored in a contiguous vector of edge indices. Removing an edge or moving
+         * one of its extremities (set_edge) does not search the edge in the out edge lists of the old extremities:
+         * the corresponding entries become tombstones, which are detected as the edge is not incident to the vertex
+         * anymore, and skipped by the iterators. The out edge list of a vertex is compacted when it contains more
+         * tombstones than live entries and released when it is empty: all operations are thus amortized O(1).
+         *
+         * Compared to undirected_graph<hash_setS>, this reduces the memory footprint of the graph by a factor 3 to 4
+         * and iterating on the out edges of a vertex is a linear scan of a contiguous array.
+         *
+         * Restriction: an edge can be detached from a vertex (with set_edge) and attached to another vertex, but it
+         * cannot be attached again to a vertex it has been detached from before. This always holds in region
+         * merging algorithms where an edge is only moved from merged regions to the new region.
+         */
+        struct region_merging_graph {
+
+            // Graph associated types
+            using vertex_descriptor = index_t;
+            using edge_index_t = index_t;
+            using edge_descriptor = indexed_edge<vertex_descriptor, edge_index_t>;
+            using directed_category = graph::undirected_tag;
+            using edge_parallel_category = graph::allow_parallel_edge_tag;
+            using traversal_category = undirected_graph_internal::undirected_graph_traversal_category;
+
+            // VertexListGraph associated types
+            using vertex_iterator = counting_iterator<vertex_descriptor>;
+            using vertices_size_type = size_t;
+
+            // EdgeListGraph associated types
+            using edges_size_type = size_t;
+            using edge_iterator = std::vector<edge_descriptor>::const_iterator;
+
+            // IncidenceGraph associated types
+            using out_edge_iterator = live_edge_iterator<region_merging_graph, edge_descriptor>;
+            using degree_size_type = size_t;
+
+            //BidirectionalGraph associated types
+            using in_edge_iterator = live_edge_iterator<region_merging_graph, edge_descriptor, true>;
+
+            //AdjacencyGraph associated types
+            using adjacency_iterator = live_edge_iterator<region_merging_graph, vertex_descriptor>;
+
+            region_merging_graph(const size_t num_vertices = 0,
+                                 const size_t reserved_edges = 0,
+                                 const size_t reserved_edge_per_vertex = 0) :
+                    m_out_edges(num_vertices), m_num_stale(num_vertices, 0) {
+                if (reserved_edges > 0) {
+                    m_edges.reserve(reserved_edges);
+                }
+                if (reserved_edge_per_vertex > 0) {
+                    for (auto &l: m_out_edges) {
+                        l.reserve(reserved_edge_per_vertex);
+                    }
+                }
+            };
+
+            vertices_size_type num_vertices() const {
+                return m_out_edges.size();
+            }
+
+            edges_size_type num_edges() const {
+                return m_edges.size();
+            }
+
+            degree_size_type degree(vertex_descriptor v) const {
+                return m_out_edges[v].size() - m_num_stale[v];
+            }
+
+            vertex_descriptor add_vertex() {
+                m_out_edges.emplace_back();
+                m_num_stale.push_back(0);
+                return (vertex_descriptor) m_out_edges.size() - 1;
+            }
+
+            void add_vertices(size_t num) {
+                m_out_edges.resize(m_out_edges.size() + num);
+                m_num_stale.resize(m_num_stale.size() + num, 0);
+            }
+
+            const edge_descriptor &add_edge(vertex_descriptor v1, vertex_descriptor v2) {
+                if (v1 > v2) {
+                    std::swap(v1, v2);
+                }
+                edge_index_t index = m_edges.size();
+                m_edges.emplace_back(v1, v2, index);
+                m_out_edges[v1].push_back(index);
+                if (v1 != v2)
+                    m_out_edges[v2].push_back(index);
+                return m_edges[index];
+            }
+
+            /**
+             * Removes the given edge: its index stays valid but it is not incident to any vertex anymore.
+             *
+             * Complexity amortized O(1)
+             *
+             * @param ei
+             */
+            void remove_edge(edge_index_t ei) {
+                auto &e = m_edges[ei];
+                auto s = e.source;
+                auto t = e.target;
+                if (s == invalid_index)
+                    return;
+                e.source = invalid_index;
+                e.target = invalid_index;
+                detach(s);
+                if (s != t)
+                    detach(t);
+            }
+
+            /**
+             * Changes the extremities of the given edge.
+             *
+             * Complexity amortized O(1)
+             *
+             * @param ei
+             * @param v1
+             * @param v2
+             */
+            void set_edge(edge_index_t ei, vertex_descriptor v1, vertex_descriptor v2) {
+                if (v1 > v2) {
+                    std::swap(v1, v2);
+                }
+                auto &e = m_edges[ei];
+                auto s = e.source;
+                auto t = e.target;
+                e.source = v1;
+                e.target = v2;
+
+                if (s != invalid_index) {
+                    if (s != v1 && s != v2)
+                        detach(s);
+                    if (t != s && t != v1 && t != v2)
+                        detach(t);
+                }
+
+                if (v1 != s && v1 != t)
+                    m_out_edges[v1].push_back(ei);
+                if (v2 != v1 && v2 != s && v2 != t)
+                    m_out_edges[v2].push_back(ei);
+            }
+
+            const auto &edge_from_index(edge_index_t ei) const {
+                return m_edges[ei];
+            }
+
+            /**
+             * Test if the given edge is incident to the given vertex
+             * @param ei
+             * @param v
+             * @return
+             */
+            bool is_incident(edge_index_t ei, vertex_descriptor v) const {
+                const auto &e = m_edges[ei];
+                return e.source == v || e.target == v;
+            }
+
+            auto edges_cbegin() const {
+                return m_edges.cbegin();
+            }
+
+            auto edges_cend() const {
+                return m_edges.cend();
+            }
+
+            out_edge_iterator out_edges_cbegin(vertex_descriptor v) const {
+                return out_edge_iterator(v, m_out_edges[v].cbegin(), m_out_edges[v].cend(), this);
+            }
+
+            out_edge_iterator out_edges_cend(vertex_descriptor v) const {
+                return out_edge_iterator(v, m_out_edges[v].cend(), m_out_edges[v].cend(), this);
+            }
+
+            in_edge_iterator in_edges_cbegin(vertex_descriptor v) const {
+                return in_edge_iterator(v, m_out_edges[v].cbegin(), m_out_edges[v].cend(), this);
+            }
+
+            in_edge_iterator in_edges_cend(vertex_descriptor v) const {
+                return in_edge_iterator(v, m_out_edges[v].cend(), m_out_edges[v].cend(), this);
+            }
+
+            adjacency_iterator adjacent_vertices_cbegin(vertex_descriptor v) const {
+                return adjacency_iterator(v, m_out_edges[v].cbegin(), m_out_edges[v].cend(), this);
+            }
+
+            adjacency_iterator adjacent_vertices_cend(vertex_descriptor v) const {
+                return adjacency_iterator(v, m_out_edges[v].cend(), m_out_edges[v].cend(), this);
+            }
+
+            auto sources() const {
+                return HG_ADAPT_STRUCT_ARRAY(m_edges.data(), source, num_edges());
+            }
+
+            auto targets() const {
+                return HG_ADAPT_STRUCT_ARRAY(m_edges.data(), target, num_edges());
+            }
+
+            /**
+             * Memory allocated by the graph in bytes
+             * @return
+             */
+            size_t memory_usage() const {
+                size_t res = m_edges.capacity() * sizeof(edge_descriptor) +
+                             m_out_edges.capacity() * sizeof(std::vector<index_t>) +
+                             m_num_stale.capacity() * sizeof(index_t);
+                for (const auto &l: m_out_edges) {
+                    res += l.capacity() * sizeof(index_t);
+                }
+                return res;
+            }
+
+        private:
+
+            /**
+             * An edge has been detached from vertex v: its entry in the out edge list of v is now a tombstone.
+             */
+            void detach(vertex_descriptor v) {
+                auto &l = m_out_edges[v];
+                m_num_stale[v]++;
+                if (2 * m_num_stale[v] > (index_t) l.size()) {
+                    if (m_num_stale[v] == (index_t) l.size()) {
+                        std::vector<index_t>().swap(l);
+                    } else {
+                        l.erase(std::remove_if(l.begin(), l.end(),
+                                               [this, v](index_t ei) { return !is_incident(ei, v); }),
+                                l.end());
+                    }
+                    m_num_stale[v] = 0;
+                }
+            }
+
+            std::vector<edge_descriptor> m_edges;
+            std::vector<std::vector<index_t>> m_out_edges;
+            std::vector<index_t> m_num_stale;
+        };
+    }
+
+    using region_merging_graph = region_merging_graph_internal::region_merging_graph;
+
+    namespace graph {
+        template<>
+        struct graph_traits<region_merging_graph> {
+            using G = region_merging_graph;
+
+            using vertex_descriptor = typename G::vertex_descriptor;
+            using edge_descriptor = typename G::edge_descriptor;
+            using edge_iterator = typename G::edge_iterator;
+            using out_edge_iterator = typename G::out_edge_iterator;
+
+            using directed_category = typename G::directed_category;
+            using edge_parallel_category = typename G::edge_parallel_category;
+            using traversal_category = typename G::traversal_category;
+
+            using degree_size_type = typename G::degree_size_type;
+
+            using in_edge_iterator = typename G::in_edge_iterator;
+            using vertex_iterator = typename G::vertex_iterator;
+            using vertices_size_type = typename G::vertices_size_type;
+            using edges_size_type = typename G::edges_size_type;
+            using adjacency_iterator = typename G::adjacency_iterator;
+
+            using edge_index = typename G::edge_index_t;
+        };
+    }
+
+    inline
+    const auto &edge_from_index(const region_merging_graph::edge_index_t ei, const region_merging_graph &g) {
+        return g.edge_from_index(ei);
+    }
+
+    inline
+    region_merging_graph::vertices_size_type num_vertices(const region_merging_graph &g) {
+        return g.num_vertices();
+    }
+
+    inline
+    region_merging_graph::edges_size_type num_edges(const region_merging_graph &g) {
+        return g.num_edges();
+    }
+
+    inline
+    region_merging_graph::degree_size_type degree(region_merging_graph::vertex_descriptor v,
+                                                  const region_merging_graph &g) {
+        return g.degree(v);
+    }
+
+    inline
+    region_merging_graph::degree_size_type in_degree(region_merging_graph::vertex_descriptor v,
+                                                     const region_merging_graph &g) {
+        return g.degree(v);
+    }
+
+    inline
+    region_merging_graph::degree_size_type out_degree(region_merging_graph::vertex_descriptor v,
+                                                      const region_merging_graph &g) {
+        return g.degree(v);
+    }
+
+    inline
+    region_merging_graph::vertex_descriptor add_vertex(region_merging_graph &g) {
+        return g.add_vertex();
+    }
+
+    inline
+    void add_vertices(size_t num, region_merging_graph &g) {
+        g.add_vertices(num);
+    }
+
+    inline
+    region_merging_graph::edge_descriptor add_edge(region_merging_graph::vertex_descriptor v1,
+                                                   region_merging_graph::vertex_descriptor v2,
+                                                   region_merging_graph &g) {
+        return g.add_edge(v1, v2);
+    }
+
+    inline
+    void remove_edge(region_merging_graph::edge_index_t ei, region_merging_graph &g) {
+        g.remove_edge(ei);
+    }
+
+    inline
+    void set_edge(region_merging_graph::edge_index_t ei,
+                  region_merging_graph::vertex_descriptor v1,
+                  region_merging_graph::vertex_descriptor v2,
+                  region_merging_graph &g) {
+        g.set_edge(ei, v1, v2);
+    }
+
+    inline
+    std::pair<region_merging_graph::vertex_iterator, region_merging_graph::vertex_iterator>
+    vertices(const region_merging_graph &g) {
+        using vertex_iterator = region_merging_graph::vertex_iterator;
+        return std::make_pair(
+                vertex_iterator(0),                 // The first iterator position
+                vertex_iterator(num_vertices(g))); // The last iterator position
+    }
+
+    inline
+    std::pair<region_merging_graph::edge_iterator, region_merging_graph::edge_iterator>
+    edges(const region_merging_graph &g) {
+        return std::make_pair(
+                g.edges_cbegin(),                 // The first iterator position
+                g.edges_cend()); // The last iterator position
+    }
+
+    inline
+    std::pair<region_merging_graph::out_edge_iterator, region_merging_graph::out_edge_iterator>
+    out_edges(region_merging_graph::vertex_descriptor v, const region_merging_graph &g) {
+        return std::make_pair(g.out_edges_cbegin(v), g.out_edges_cend(v));
+    }
+
+    inline
+    std::pair<region_merging_graph::in_edge_iterator, region_merging_graph::in_edge_iterator>
+    in_edges(region_merging_graph::vertex_descriptor v, const region_merging_graph &g) {
+        return std::make_pair(g.in_edges_cbegin(v), g.in_edges_cend(v));
+    }
+
+    inline
+    std::pair<region_merging_graph::adjacency_iterator, region_merging_graph::adjacency_iterator>
+    adjacent_vertices(region_merging_graph::vertex_descriptor v, const region_merging_graph &g) {
+        return std::make_pair(g.adjacent_vertices_cbegin(v), g.adjacent_vertices_cend(v));
+    }
+}
@@ -13,11 +13,15 @@
 
 #include "details/graph_concepts.hpp"
 #include "higra/structure/details/iterators.hpp"
+#include <algorithm>
+#include <array>
 #include <functional>
 #include <vector>
 #include <utility>
 
 #include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xmath.hpp"
 #include "embedding.hpp"
 
 namespace hg {
@@ -72,12 +76,106 @@ namespace hg {
             //BidirectionalGraph associated types
             using in_edge_iterator = out_edge_iterator;
 
+            // EdgeListGraph associated types
+            using edges_size_type = size_t;
+            using edge_index_t = index_t;
+
             using point_type = typename embedding_t::point_type;
 
             vertices_size_type num_vertices() const {
                 return m_embedding.size();
             }
 
+            /**
+             * Number of edges of the graph.
+             *
+             * Edges are indexed in the order of the explicit graph copy_graph(graph): vertices are taken in
+             * increasing order and, for each vertex v, the edges {v, n} with n > v are taken in the order of the
+             * neighbour list. The index of an edge and its extremities are computed in closed form from the
+             * neighbour list and the shape of the embedding: edges are never stored.
+             */
+            edges_size_type num_edges() const {
+                return m_num_edges;
+            }
+
+            /**
+             * Edge of given index: the source is the vertex of smallest index.
+             *
+             * Runs in O(d log(b)) with d the dimension of the embedding and b the number of breakpoints of an axis
+             * (at most 2k + 2 with k the number of neighbours).
+             *
+             * @param ei edge index
+             * @return a pair (source, target)
+             */
+            edge_descriptor edge_from_index(index_t ei) const {
+                // the number of edges whose source precedes a vertex is, along each axis, a piecewise linear
+                // function of the coordinate whose slopes only depend on the cell of the coordinates along the
+                // previous axes: the coordinates of the source are found axis by axis with the decoding tables
+                coordinates_t coordinates;
+                index_t cell = 0;
+                index_t count = 0;
+                for (index_t i = 0; i < embedding_t::_dim; i++) {
+                    const auto &breakpoints = m_edge_breakpoints[i];
+                    index_t num_segments = breakpoints.size() - 1;
+                    const index_t *counts = m_edge_counts[i].data() + cell * (num_segments + 1);
+                    const index_t *slopes = m_edge_slopes[i].data() + cell * num_segments;
+                    // segment j such that counts[j] <= ei - count < counts[j + 1] (its slope is positive)
+                    index_t j = std::upper_bound(counts, counts + num_segments + 1, ei - count) - counts - 1;
+                    index_t local = ei - count - counts[j];
+                    coordinates[i] = breakpoints[j] + local / slopes[j];
+                    count += counts[j] + (local / slopes[j]) * slopes[j];
+                    cell = cell * num_segments + j;
+                }
+                index_t source = m_embedding.grid2lin(coordinates);
+                return std::make_pair(source, source + m_cell_edge_offsets[m_cell_edge_offsets_begin[cell] +
+                                                                           ei - count]);
+            }
+
+            /**
+             * Index of the edge linking the two given vertices.
+             *
+             * Runs in O(d k) with d the dimension of the embedding and k the number of neighbours.
+             *
+             * @param v1 a vertex
+             * @param v2 a vertex
+             * @return the index of the edge {v1, v2} or invalid_index if v1 and v2 are not adjacent
+             */
+            index_t edge_index(vertex_descriptor v1, vertex_descriptor v2) const {
+                if (v1 > v2) {
+                    std::swap(v1, v2);
+                }
+                index_t offset = v2 - v1;
+                coordinates_t coordinates = vertex_coordinates(v1);
+                index_t ei = num_edges_before(coordinates);
+                for (const auto &box: m_edge_boxes) {
+                    if (box_contains(box, coordinates)) {
+                        if (box.offset == offset) {
+                            return ei;
+                        }
+                        ei++;
+                    }
+                }
+                return invalid_index;
+            }
+
+            /**
+             * Lazy 1d expression of the sources of the edges (see edge_from_index).
+             * The expression references the graph.
+             */
+            auto sources() const {
+                return xt::make_lambda_xfunction([this](index_t ei) { return edge_from_index(ei).first; },
+                                                 xt::arange<index_t>((index_t) m_num_edges));
+            }
+
+            /**
+             * Lazy 1d expression of the targets of the edges (see edge_from_index).
+             * The expression references the graph.
+             */
+            auto targets() const {
+                return xt::make_lambda_xfunction([this](index_t ei) { return edge_from_index(ei).second; },
+                                                 xt::arange<index_t>((index_t) m_num_edges));
+            }
+
             const auto &embedding() const {
                 return m_embedding;
             }
@@ -89,6 +187,7 @@ namespace hg {
             regular_graph(embedding_t _embedding = {}, point_list_t<index_t, embedding_t::_dim> _neighbours = {})
                     : m_embedding(_embedding), m_neighbours(_neighbours) {
                 init_safe_area();
+                init_edge_boxes();
             }
 
             ~regular_graph() = default;
@@ -144,6 +243,153 @@ namespace hg {
                 }
             }
 
+            using coordinates_t = std::array<index_t, embedding_t::_dim>;
+
+            /**
+             * The sources of the edges associated to a given forward neighbour (a neighbour with a positive linear
+             * offset) are the vertices of the box [lower, upper) of the grid.
+             */
+            struct edge_box {
+                index_t offset;
+                coordinates_t lower;
+                coordinates_t upper;
+                // strides of the box in raster order
+                coordinates_t strides;
+            };
+
+            void init_edge_boxes() {
+                const auto &shape = m_embedding.shape();
+                m_num_edges = 0;
+                for (const auto &n: m_neighbours) {
+                    edge_box box;
+                    box.offset = 0;
+                    for (index_t i = 0; i < embedding_t::_dim; i++) {
+                        box.offset = box.offset * shape[i] + n[i];
+                    }
+                    if (box.offset <= 0) {
+                        continue;
+                    }
+                    index_t size = 1;
+                    for (index_t i = embedding_t::_dim - 1; i >= 0; i--) {
+                        box.lower[i] = (std::min)((index_t) shape[i], (std::max)((index_t) 0, -n[i]));
+                        box.upper[i] = (std::max)(box.lower[i], (std::min)((index_t) shape[i], shape[i] - n[i]));
+                        box.strides[i] = size;
+                        size *= box.upper[i] - box.lower[i];
+                    }
+                    m_num_edges += size;
+                    m_edge_boxes.push_back(box);
+                }
+                for (index_t i = 0; i < embedding_t::_dim; i++) {
+                    auto &breakpoints = m_edge_breakpoints[i];
+                    breakpoints = {0, (index_t) shape[i]};
+                    for (const auto &box: m_edge_boxes) {
+                        breakpoints.push_back(box.lower[i]);
+                        breakpoints.push_back(box.upper[i]);
+                    }
+                    std::sort(breakpoints.begin(), breakpoints.end());
+                    breakpoints.erase(std::unique(breakpoints.begin(), breakpoints.end()), breakpoints.end());
+                }
+                init_decoding_tables();
+            }
+
+            /**
+             * The breakpoints of the axes split the grid into cells, every box is a union of cells. Along axis i,
+             * for each cell of the first i axes (numbered in raster order) and each segment j between two
+             * consecutive breakpoints of axis i:
+             *  - m_edge_slopes[i]: number of edges whose sources are in a hyperplane orthogonal to axis i
+             *  - m_edge_counts[i]: number of edges whose sources precede the beginning of the segment j (relatively
+             *    to the beginning of the cell)
+             * m_cell_edge_offsets contains, for each cell of the grid, the offsets of the targets of the boxes
+             * containing the cell, in the order of the boxes.
+             */
+            void init_decoding_tables() {
+                index_t num_boxes = m_edge_boxes.size();
+                // boxes containing each cell of the first i axes
+                std::vector<char> cell_boxes(num_boxes, 1);
+                index_t num_cells = 1;
+                for (index_t i = 0; i < embedding_t::_dim; i++) {
+                    const auto &breakpoints = m_edge_breakpoints[i];
+                    index_t num_segments = breakpoints.size() - 1;
+                    auto &counts = m_edge_counts[i];
+                    auto &slopes = m_edge_slopes[i];
+                    counts.assign(num_cells * (num_segments + 1), 0);
+                    slopes.assign(num_cells * num_segments, 0);
+                    std::vector<char> next_cell_boxes(num_cells * num_segments * num_boxes, 0);
+                    for (index_t c = 0; c < num_cells; c++) {
+                        for (index_t j = 0; j < num_segments; j++) {
+                            index_t slope = 0;
+                            for (index_t b = 0; b < num_boxes; b++) {
+                                const auto &box = m_edge_boxes[b];
+                                if (cell_boxes[c * num_boxes + b] && box.lower[i] <= breakpoints[j] &&
+                                    breakpoints[j + 1] <= box.upper[i]) {
+                                    next_cell_boxes[(c * num_segments + j) * num_boxes + b] = 1;
+                                    slope += box.strides[i];
+                                }
+                            }
+                            slopes[c * num_segments + j] = slope;
+                            counts[c * (num_segments + 1) + j + 1] = counts[c * (num_segments + 1) + j] +
+                                                                     slope * (breakpoints[j + 1] - breakpoints[j]);
+                        }
+                    }
+                    cell_boxes.swap(next_cell_boxes);
+                    num_cells *= num_segments;
+                }
+
+                m_cell_edge_offsets_begin.assign(num_cells + 1, 0);
+                m_cell_edge_offsets.clear();
+                for (index_t c = 0; c < num_cells; c++) {
+                    for (index_t b = 0; b < num_boxes; b++) {
+                        if (cell_boxes[c * num_boxes + b]) {
+                            m_cell_edge_offsets.push_back(m_edge_boxes[b].offset);
+                        }
+                    }
+                    m_cell_edge_offsets_begin[c + 1] = m_cell_edge_offsets.size();
+                }
+            }
+
+            coordinates_t vertex_coordinates(index_t v) const {
+                const auto &shape = m_embedding.shape();
+                coordinates_t coordinates;
+                for (index_t i = embedding_t::_dim - 1; i >= 0; i--) {
+                    coordinates[i] = v % shape[i];
+                    v /= shape[i];
+                }
+                return coordinates;
+            }
+
+            /**
+             * True if the given coordinates are in the box along the first num_axes axes.
+             */
+            static bool box_contains(const edge_box &box,
+                                     const coordinates_t &coordinates,
+                                     index_t num_axes = embedding_t::_dim) {
+                for (index_t i = 0; i < num_axes; i++) {
+                    if (coordinates[i] < box.lower[i] || coordinates[i] >= box.upper[i]) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            /**
+             * Number of edges whose source is smaller than the vertex of given coordinates: for each box, counts the
+             * box elements preceding the given coordinates in raster order.
+             */
+            index_t num_edges_before(const coordinates_t &coordinates) const {
+                index_t count = 0;
+                for (const auto &box: m_edge_boxes) {
+                    for (index_t i = 0; i < embedding_t::_dim; i++) {
+                        index_t c = coordinates[i] - box.lower[i];
+                        index_t size = box.upper[i] - box.lower[i];
+                        count += (std::max)((index_t) 0, (std::min)(c, size)) * box.strides[i];
+                        if (c < 0 || c >= size) {
+                            break;
+                        }
+                    }
+                }
+                return count;
+            }
+
             bool is_in_safe_area(const point<index_t, embedding_t::_dim> &point) const {
                 for (index_t i = 0; i < embedding_t::_dim; ++i) {
                     if (point(i) < m_safe_lower_bound(i) || point(i) > m_safe_upper_bound(i)) {
@@ -158,6 +404,15 @@ namespace hg {
             point<index_t, embedding_t::_dim> m_safe_lower_bound;
             point<index_t, embedding_t::_dim> m_safe_upper_bound;
             std::vector<index_t> m_relative_neighbours;
+            std::vector<edge_box> m_edge_boxes;
+            // for each axis, sorted bounds of the edge boxes
+            std::array<std::vector<index_t>, embedding_t::_dim> m_edge_breakpoints;
+            // decoding tables of edge_from_index (see init_decoding_tables)
+            std::array<std::vector<index_t>, embedding_t::_dim> m_edge_counts;
+            std::array<std::vector<index_t>, embedding_t::_dim> m_edge_slopes;
+            std::vector<index_t> m_cell_edge_offsets_begin;
+            std::vector<index_t> m_cell_edge_offsets;
+            size_t m_num_edges;
 
             friend struct regular_graph_adjacent_vertex_iterator<embedding_t>;
         };
@@ -326,6 +581,26 @@ namespace hg {
         return g.num_vertices();
     };
 
+    template<typename embedding_t>
+    typename hg::regular_graph<embedding_t>::edges_size_type
+    num_edges(const hg::regular_graph<embedding_t> &g) {
+        return g.num_edges();
+    };
+
+    template<typename embedding_t>
+    typename hg::regular_graph<embedding_t>::edge_descriptor
+    edge_from_index(const typename hg::regular_graph<embedding_t>::edge_index_t ei,
+                    const hg::regular_graph<embedding_t> &g) {
+        return g.edge_from_index(ei);
+    };
+
+    template<typename embedding_t>
+    typename hg::regular_graph<embedding_t>::edge_index_t
+    index(const typename hg::regular_graph<embedding_t>::edge_descriptor &e,
+          const hg::regular_graph<embedding_t> &g) {
+        return g.edge_index(e.first, e.second);
+    };
+
     template<typename embedding_t>
     std::pair<typename hg::regular_graph<embedding_t>::vertex_iterator, typename hg::regular_graph<embedding_t>::vertex_iterator>
     vertices(const hg::regular_graph<embedding_t> &g) {
@@ -14,6 +14,10 @@
 #include "details/indexed_edge.hpp"
 #include "details/graph_concepts.hpp"
 #include "higra/structure/details/iterators.hpp"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <utility>
 #include "../utils.hpp"
@@ -54,6 +58,229 @@ namespace hg {
         // forward declaration
         struct tree_graph_node_to_root_iterator;
 
+        /**
+         * Range over the children of a node: a contiguous segment of the children storage of the tree
+         */
+        struct children_range {
+            using value_type = index_t;
+            using const_iterator = const value_type *;
+            using iterator = const_iterator;
+
+            children_range(const_iterator begin = nullptr, const_iterator end = nullptr) :
+                    m_begin(begin), m_end(end) {}
+
+            const_iterator begin() const {
+                return m_begin;
+            }
+
+            const_iterator end() const {
+                return m_end;
+            }
+
+            const_iterator cbegin() const {
+                return m_begin;
+            }
+
+            const_iterator cend() const {
+                return m_end;
+            }
+
+            size_t size() const {
+                return m_end - m_begin;
+            }
+
+            bool empty() const {
+                return m_begin == m_end;
+            }
+
+            value_type operator[](index_t i) const {
+                return m_begin[i];
+            }
+
+        private:
+            const_iterator m_begin;
+            const_iterator m_end;
+        };
+
+        /**
+         * Compressed sparse row representation of the children relation of a tree: the children of the internal
+         * node n are the elements of indices in the range [offsets[n - num_leaves], offsets[n - num_leaves + 1]),
+         * sorted in increasing order.
+         *
+         * The parallel version (with HG_USE_TBB) counts and scatters the children with atomic operations and then
+         * sorts the children of each node.
+         *
+         * @tparam T
+         * @param parents parent relation of the tree
+         * @param num_leaves number of leaves of the tree
+         * @param offsets (output) offsets of the children of each internal node, size: num_internal_nodes + 1
+         * @param indices (output) children of each internal node, size: num_vertices - 1
+         * @param parallel use the parallel version
+         */
+        template<typename T>
+        void compute_children_csr(const T &parents,
+                                  index_t num_leaves,
+                                  std::vector<index_t> &offsets,
+                                  std::vector<index_t> &indices,
+                                  bool parallel = false) {
+            index_t num_vertices = parents.size();
+            index_t root = num_vertices - 1;
+            index_t num_internal_nodes = num_vertices - num_leaves;
+            offsets.assign(num_internal_nodes + 1, 0);
+            indices.resize(root);
+
+            if (!parallel) {
+                // offsets[n + 1] first counts the children of n, then stores the start of the children of n, and
+                // finally serves as insertion cursor and ends at the end of the children of n
+                for (index_t v = 0; v < root; ++v) {
+                    offsets[parents(v) - num_leaves + 1]++;
+                }
+                index_t sum = 0;
+                for (index_t i = 1; i <= num_internal_nodes; ++i) {
+                    auto count = offsets[i];
+                    offsets[i] = sum;
+                    sum += count;
+                }
+                for (index_t v = 0; v < root; ++v) {
+                    indices[offsets[parents(v) - num_leaves + 1]++] = v;
+                }
+                return;
+            }
+
+            std::unique_ptr<std::atomic<index_t>[]> cursor(new std::atomic<index_t>[num_internal_nodes]);
+            parfor(0, num_internal_nodes, [&cursor](index_t i) {
+                cursor[i].store(0, std::memory_order_relaxed);
+            });
+            parfor(0, root, [&](index_t v) {
+                cursor[parents(v) - num_leaves].fetch_add(1, std::memory_order_relaxed);
+            });
+            for (index_t i = 0; i < num_internal_nodes; ++i) {
+                offsets[i + 1] = offsets[i] + cursor[i].load(std::memory_order_relaxed);
+                cursor[i].store(offsets[i], std::memory_order_relaxed);
+            }
+            parfor(0, root, [&](index_t v) {
+                indices[cursor[parents(v) - num_leaves].fetch_add(1, std::memory_order_relaxed)] = v;
+            });
+            parfor(0, num_internal_nodes, [&offsets, &indices](index_t i) {
+                std::sort(indices.begin() + offsets[i], indices.begin() + offsets[i + 1]);
+            });
+        }
+
+        /**
+         * Nodes of a tree grouped by levels: the nodes of level l are stored in the range
+         * [level_begin(l), level_end(l)) in increasing order.
+         */
+        struct tree_level_schedule {
+
+            index_t num_levels() const {
+                return (offsets.size() == 0) ? 0 : offsets.size() - 1;
+            }
+
+            const index_t *level_begin(index_t l) const {
+                return nodes.data() + offsets[l];
+            }
+
+            const index_t *level_end(index_t l) const {
+                return nodes.data() + offsets[l + 1];
+            }
+
+            index_t level_size(index_t l) const {
+                return offsets[l + 1] - offsets[l];
+            }
+
+            /**
+             * Groups the given nodes by levels with a counting sort
+             *
+             * @tparam T
+             * @param level level of each node, nodes whose level is invalid_index are ignored
+             * @param num_levels number of levels
+             */
+            template<typename T>
+            void set_levels(const T &level, index_t num_levels) {
+                offsets.assign(num_levels + 1, 0);
+                for (index_t i = 0; i < (index_t) level.size(); i++) {
+                    if (level[i] != invalid_index) {
+                        offsets[level[i] + 1]++;
+                    }
+                }
+                index_t sum = 0;
+                for (index_t l = 1; l <= num_levels; l++) {
+                    auto count = offsets[l];
+                    offsets[l] = sum;
+                    sum += count;
+                }
+                nodes.resize(sum);
+                for (index_t i = 0; i < (index_t) level.size(); i++) {
+                    if (level[i] != invalid_index) {
+                        nodes[offsets[level[i] + 1]++] = i;
+                    }
+                }
+            }
+
+            void clear() {
+                std::vector<index_t>().swap(offsets);
+                std::vector<index_t>().swap(nodes);
+            }
+
+        private:
+            std::vector<index_t> offsets;
+            std::vector<index_t> nodes;
+        };
+
+        /**
+         * Lazily computed tree level schedule.
+         *
+         * The schedule is computed at most once, even if several threads request it concurrently
+         * (double checked locking). Copying a cache copies the schedule if it has already been computed.
+         */
+        struct tree_level_schedule_cache {
+
+            tree_level_schedule_cache() = default;
+
+            tree_level_schedule_cache(const tree_level_schedule_cache &other) {
+                std::lock_guard<std::mutex> lock(other.m_mutex);
+                m_schedule = other.m_schedule;
+                m_computed.store(other.m_computed.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            }
+
+            tree_level_schedule_cache &operator=(const tree_level_schedule_cache &other) {
+                if (this != &other) {
+                    std::lock(m_mutex, other.m_mutex);
+                    std::lock_guard<std::mutex> lock1(m_mutex, std::adopt_lock);
+                    std::lock_guard<std::mutex> lock2(other.m_mutex, std::adopt_lock);
+                    m_schedule = other.m_schedule;
+                    m_computed.store(other.m_computed.load(std::memory_order_relaxed), std::memory_order_release);
+                }
+                return *this;
+            }
+
+            /**
+             * Returns the cached schedule, calls compute(schedule) to fill it on the first call.
+             */
+            template<typename F>
+            const tree_level_schedule &get(F &&compute) const {
+                if (!m_computed.load(std::memory_order_acquire)) {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if (!m_computed.load(std::memory_order_relaxed)) {
+                        compute(m_schedule);
+                        m_computed.store(true, std::memory_order_release);
+                    }
+                }
+                return m_schedule;
+            }
+
+            void clear() const {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_schedule.clear();
+                m_computed.store(false, std::memory_order_release);
+            }
+
+        private:
+            mutable std::mutex m_mutex;
+            mutable std::atomic<bool> m_computed{false};
+            mutable tree_level_schedule m_schedule;
+        };
+
         struct tree_graph_traversal_category :
                 virtual public graph::incidence_graph_tag,
                 virtual public graph::bidirectional_graph_tag,
@@ -66,7 +293,7 @@ namespace hg {
             // Graph associated types
             using vertex_descriptor = index_t;
             using edge_index_t = index_t;
-            using children_list_t = std::vector<vertex_descriptor>;
+            using children_list_t = children_range;
             using children_iterator = children_list_t::const_iterator;
             using ancestors_iterator = tree_graph_node_to_root_iterator;
             using edge_descriptor = indexed_edge<vertex_descriptor, edge_index_t>;
@@ -113,7 +340,6 @@ namespace hg {
                  tree_category category = tree_category::partition_tree) :
                     _parents(parents),
                     _children_computed(false),
-                    _children(0),
                     _category(category) {
                 HG_TRACE();
                 _init();
@@ -124,7 +350,6 @@ namespace hg {
                  tree_category category = tree_category::partition_tree) :
                     _parents(std::move(parents.derived_cast())),
                     _children_computed(false),
-                    _children(0),
                     _category(category) {
                 HG_TRACE();
                 _init();
@@ -146,18 +371,21 @@ namespace hg {
                 return (_num_vertices == 0) ? 0 : _num_vertices - 1;
             }
 
-            const auto &children(vertex_descriptor v) const {
+            children_list_t children(vertex_descriptor v) const {
                 if (v < _num_leaves) {
-                    return _empty_children;
+                    return children_list_t();
                 }
-                return _children[v - _num_leaves];
+                auto i = v - _num_leaves;
+                return children_list_t(_children_indices.data() + _children_offsets[i],
+                                       _children_indices.data() + _children_offsets[i + 1]);
             }
 
             size_t num_children(const vertex_descriptor v) const {
                 if (v < _num_leaves) {
                     return 0;
                 }
-                return _children[v - _num_leaves].size();
+                auto i = v - _num_leaves;
+                return _children_offsets[i + 1] - _children_offsets[i];
             }
 
             vertex_descriptor root() const {
@@ -177,7 +405,7 @@ namespace hg {
             }
 
             auto child(index_t i, vertex_descriptor v) const {
-                return _children[v - _num_leaves][i];
+                return _children_indices[_children_offsets[v - _num_leaves] + i];
             }
 
             template<typename... Args>
@@ -223,22 +451,105 @@ namespace hg {
                 return v;
             }
 
+            /**
+             * Computes the children relation of the tree (compressed sparse row storage). The computation is done in
+             * parallel for large trees if HG_USE_TBB is defined.
+             */
             void compute_children() const {
                 if (!_children_computed) {
-                    _children.resize(_num_vertices - _num_leaves);
-                    for (vertex_descriptor v = 0; v < _root; ++v) {
-                        vertex_descriptor parent_v = _parents(v);
-                        _children[parent_v - _num_leaves].push_back(v);
-                    }
+                    bool parallel = false;
+#ifdef HG_USE_TBB
+                    parallel = (index_t) _num_vertices >= parallel_children_min_size;
+#endif
+                    compute_children_csr(_parents, _num_leaves, _children_offsets, _children_indices, parallel);
                     _children_computed = true;
                 }
             }
 
+            /**
+             * Sets the children relation of the tree from its compressed sparse row representation
+             * (see compute_children_csr), for example to restore children saved with the tree.
+             * The consistency with the parent relation is not checked.
+             *
+             * @tparam T1
+             * @tparam T2
+             * @param offsets offsets of the children of each internal node, size: num_internal_nodes + 1
+             * @param indices children of each internal node, size: num_vertices - 1
+             */
+            template<typename T1, typename T2>
+            void set_children(const T1 &offsets, const T2 &indices) const {
+                hg_assert((index_t) offsets.size() == (index_t) (_num_vertices - _num_leaves + 1),
+                          "Invalid size of the children offsets.");
+                hg_assert((index_t) indices.size() == _root, "Invalid size of the children indices.");
+                _children_offsets.assign(offsets.begin(), offsets.end());
+                _children_indices.assign(indices.begin(), indices.end());
+                _children_computed = true;
+            }
+
             void clear_children() const {
-                _children.clear();
+                std::vector<index_t>().swap(_children_offsets);
+                std::vector<index_t>().swap(_children_indices);
                 _children_computed = false;
             }
 
+            /**
+             * Internal nodes grouped by height: level l contains the nodes of height l + 1 (leaves have height 0).
+             * The nodes of a level only depend on the nodes of lower levels: each level of the schedule can be
+             * processed in parallel in a leaves to root traversal.
+             *
+             * The schedule is computed on the first call and cached, concurrent calls are safe.
+             */
+            const tree_level_schedule &height_schedule() const {
+                return _height_schedule.get([this](tree_level_schedule &schedule) {
+                    if (_num_vertices > 0) {
+                        index_t numl = _num_leaves;
+                        std::vector<index_t> level(_num_vertices, invalid_index);
+                        std::vector<index_t> height(_num_vertices - numl, 0);
+                        for (vertex_descriptor v = 0; v < _root; ++v) {
+                            auto h = (v < numl) ? 0 : height[v - numl];
+                            auto &hp = height[_parents(v) - numl];
+                            hp = (std::max)(hp, h + 1);
+                        }
+                        for (vertex_descriptor v = numl; v <= _root; ++v) {
+                            level[v] = height[v - numl] - 1;
+                        }
+                        schedule.set_levels(level, (_root >= numl) ? height[_root - numl] : 0);
+                    }
+                });
+            }
+
+            /**
+             * All nodes grouped by depth: level l contains the nodes of depth l (the root has depth 0).
+             * The nodes of a level only depend on the nodes of lower levels: each level of the schedule can be
+             * processed in parallel in a root to leaves traversal.
+             *
+             * The schedule is computed on the first call and cached, concurrent calls are safe.
+             */
+            const tree_level_schedule &depth_schedule() const {
+                return _depth_schedule.get([this](tree_level_schedule &schedule) {
+                    if (_num_vertices > 0) {
+                        std::vector<index_t> depth(_num_vertices);
+                        depth[_root] = 0;
+                        index_t max_depth = 0;
+                        for (vertex_descriptor v = _root - 1; v >= 0; --v) {
+                            depth[v] = depth[_parents(v)] + 1;
+                            max_depth = (std::max)(max_depth, depth[v]);
+                        }
+                        schedule.set_levels(depth, max_depth + 1);
+                    }
+                });
+            }
+
+            void clear_schedules() const {
+                _height_schedule.clear();
+                _depth_schedule.clear();
+            }
+
+            /**
+             * Minimal number of nodes for the parallel computation of the children relation
+             */
+            static const index_t parallel_children_min_size = 1 << 20;
+
             bool children_computed() const {
                 return _children_computed;
             }
@@ -291,11 +602,11 @@ namespace hg {
             index_t _num_leaves;
             array_1d <vertex_descriptor> _parents;
             mutable bool _children_computed;
-            mutable std::vector<children_list_t> _children;
+            mutable std::vector<index_t> _children_offsets;
+            mutable std::vector<index_t> _children_indices;
+            tree_level_schedule_cache _height_schedule;
+            tree_level_schedule_cache _depth_schedule;
             tree_category _category;
-
-            // for leaf nodes
-            children_list_t _empty_children;
         };
 
 
@@ -324,7 +635,7 @@ namespace hg {
         public:
             using graph_t = tree;
             using graph_vertex_t = graph_t::vertex_descriptor;
-            using point_list_iterator_t = graph_t::children_list_t::const_iterator;
+            using point_list_iterator_t = graph_t::children_iterator;
 
             tree_graph_adjacent_vertex_iterator() {}
 
@@ -554,7 +865,7 @@ namespace hg {
     inline
     std::pair<tree::children_iterator, tree::children_iterator>
     children(const tree::vertex_descriptor v, const tree &g) {
-        auto &c = g.children(v);
+        auto c = g.children(v);
         return std::make_pair(c.cbegin(), c.cend());
     }
 
@@ -638,7 +949,7 @@ namespace hg {
     std::pair<typename hg::tree::adjacency_iterator, typename hg::tree::adjacency_iterator>
     adjacent_vertices(typename hg::tree::vertex_descriptor v, const hg::tree &g) {
         using it = typename hg::tree::adjacency_iterator;
-        auto &c = g.children(v);
+        auto c = g.children(v);
         auto par = g.parent(v);
         return std::make_pair(
                 it(v, par, c.cbegin()),
@@ -652,7 +963,7 @@ namespace hg {
         auto fun = [v](const typename hg::tree::vertex_descriptor t) {
             return hg::tree::edge_descriptor(v, t, (std::min)(v, t));
         };
-        auto &c = g.children(v);
+        auto c = g.children(v);
         using it = typename hg::tree::out_edge_iterator;
         using ita = typename hg::tree::adjacency_iterator;
         auto par = g.parent(v);
@@ -667,7 +978,7 @@ namespace hg {
         auto fun = [v](const typename hg::tree::vertex_descriptor t) {
             return hg::tree::edge_descriptor(t, v, (std::min)(v, t));
         };
-        auto &c = g.children(v);
+        auto c = g.children(v);
         using it = typename hg::tree::out_edge_iterator;
         using ita = typename hg::tree::adjacency_iterator;
         auto par = g.parent(v);
@@ -10,70 +10,319 @@
 
 #pragma once
 
+#include <atomic>
 #include <vector>
+#include <memory>
 #include "../utils.hpp"
 
 namespace hg {
 
+    /**
+     * Policies of basic_union_find
+     */
+    namespace union_find_policy {
+        /**
+         * Find: two passes, every node on the path to the root is linked to the root
+         */
+        struct path_compression {
+        };
+
+        /**
+         * Find: one pass, every other node on the path to the root is linked to its grand parent
+         */
+        struct path_halving {
+        };
+
+        /**
+         * Find: one pass, every node on the path to the root is linked to its grand parent
+         */
+        struct path_splitting {
+        };
+
+        /**
+         * Storage: parents and ranks are stored in two separate arrays
+         */
+        struct separate_storage {
+        };
+
+        /**
+         * Storage: the parent and the rank of a node are stored side by side in a single array (one cache miss per
+         * node on the path to the root)
+         */
+        struct interleaved_storage {
+        };
+    }
+
     namespace union_find_internal {
 
-        template<typename idx_t=index_t>
+        template<typename idx_t, typename storage_policy>
+        struct storage;
+
+        template<typename idx_t>
+        struct storage<idx_t, union_find_policy::separate_storage> {
+
+            storage(size_t size) : m_parent(size), m_rank(size, 0) {}
+
+            idx_t &parent(idx_t i) { return m_parent[i]; }
+
+            const idx_t &parent(idx_t i) const { return m_parent[i]; }
+
+            idx_t &rank(idx_t i) { return m_rank[i]; }
+
+            size_t size() const { return m_parent.size(); }
+
+            void push_back(idx_t parent, idx_t rank) {
+                m_parent.push_back(parent);
+                m_rank.push_back(rank);
+            }
+
+        private:
+            std::vector<idx_t> m_parent;
+            std::vector<idx_t> m_rank;
+        };
+
+        template<typename idx_t>
+        struct storage<idx_t, union_find_policy::interleaved_storage> {
+
+            storage(size_t size) : m_nodes(size, {0, 0}) {}
+
+            idx_t &parent(idx_t i) { return m_nodes[i].parent; }
+
+            const idx_t &parent(idx_t i) const { return m_nodes[i].parent; }
+
+            idx_t &rank(idx_t i) { return m_nodes[i].rank; }
+
+            size_t size() const { return m_nodes.size(); }
+
+            void push_back(idx_t parent, idx_t rank) {
+                m_nodes.push_back({parent, rank});
+            }
+
+        private:
+            struct node {
+                idx_t parent;
+                idx_t rank;
+            };
+            std::vector<node> m_nodes;
+        };
+
+        /**
+         * Sequential union find with union by rank
+         *
+         * @tparam idx_t index type (index_t or a smaller signed integral type to reduce the memory footprint)
+         * @tparam path_policy union_find_policy::path_compression, path_halving, or path_splitting
+         * @tparam storage_policy union_find_policy::separate_storage or interleaved_storage
+         */
+        template<typename idx_t=index_t,
+                typename path_policy=union_find_policy::path_compression,
+                typename storage_policy=union_find_policy::separate_storage>
         struct union_find {
 
         public:
 
-            union_find(size_t size = 0) : parent(size), rank(size) {
-                for (index_t i = 0; i < (index_t)parent.size(); ++i) {
-                    parent[i] = i;
+            union_find(size_t size = 0) : m_storage(size) {
+                for (index_t i = 0; i < (index_t) size; ++i) {
+                    m_storage.parent(i) = i;
                 }
             }
 
             idx_t make_set() {
-                idx_t i = parent.size();
-                parent.push_back(i);
-                rank.push_back(0);
+                idx_t i = m_storage.size();
+                m_storage.push_back(i, 0);
                 return i;
             }
 
-
             idx_t find(idx_t element) {
+                return find(element, path_policy());
+            }
+
+            /**
+             * Find without path compression: the structure is not modified and several threads can thus
+             * call this function concurrently as long as no other thread modifies the structure.
+             *
+             * @param element
+             * @return index of the canonical node of element
+             */
+            idx_t find_no_compression(idx_t element) const {
+                while (m_storage.parent(element) != element)
+                    element = m_storage.parent(element);
+                return element;
+            }
+
+            /**
+             * Union by rank
+             * @param i index of canonical node
+             * @param j index of canonical node
+             * @return index of the canonical node representing the union of i and j (either i or j)
+             */
+            idx_t link(idx_t i, idx_t j) {
+                if (m_storage.rank(i) > m_storage.rank(j))
+                    std::swap(i, j);
+                else if (m_storage.rank(i) == m_storage.rank(j)) {
+                    m_storage.rank(j) += 1;
+                }
+                m_storage.parent(i) = j;
+                return j;
+            }
+
+        private:
+
+            idx_t find(idx_t element, union_find_policy::path_compression) {
                 idx_t i = element;
                 // find canonical node i
-                while (parent[i] != i)
-                    i = parent[i];
+                while (m_storage.parent(i) != i)
+                    i = m_storage.parent(i);
                 // path compression
-                while (parent[element] != i) {
+                while (m_storage.parent(element) != i) {
                     idx_t tmp = element;
-                    element = parent[element];
-                    parent[tmp] = i;
+                    element = m_storage.parent(element);
+                    m_storage.parent(tmp) = i;
                 }
                 return i;
             }
 
+            idx_t find(idx_t element, union_find_policy::path_halving) {
+                while (m_storage.parent(element) != element) {
+                    m_storage.parent(element) = m_storage.parent(m_storage.parent(element));
+                    element = m_storage.parent(element);
+                }
+                return element;
+            }
+
+            idx_t find(idx_t element, union_find_policy::path_splitting) {
+                while (m_storage.parent(element) != element) {
+                    idx_t next = m_storage.parent(element);
+                    m_storage.parent(element) = m_storage.parent(next);
+                    element = next;
+                }
+                return element;
+            }
+
+            storage<idx_t, storage_policy> m_storage;
+        };
+
+        /**
+         * Concurrent union find: find, unite, and same_set can be called concurrently by several threads.
+         *
+         * Trees are linked by index (the root of smaller index becomes a child of the other root) with a CAS:
+         * the parent of a node always has a larger index than the node which prevents the creation of cycles
+         * by concurrent links. Find uses path halving with CAS that are allowed to fail: find is wait-free and
+         * unite is lock-free.
+         *
+         * The sequential interface of union_find (find, find_no_compression, link) is also provided: link must not
+         * be called concurrently with other operations.
+         *
+         * @tparam idx_t index type
+         */
+        template<typename idx_t=index_t>
+        struct concurrent_union_find {
+
+        public:
+
+            concurrent_union_find(size_t size = 0) :
+                    m_parent(new std::atomic<idx_t>[size]), m_size(size) {
+                for (index_t i = 0; i < (index_t) size; ++i) {
+                    m_parent[i].store(i, std::memory_order_relaxed);
+                }
+            }
+
+            size_t size() const {
+                return m_size;
+            }
+
+            idx_t find(idx_t element) {
+                while (true) {
+                    idx_t parent = m_parent[element].load(std::memory_order_relaxed);
+                    if (parent == element) {
+                        return element;
+                    }
+                    idx_t grand_parent = m_parent[parent].load(std::memory_order_relaxed);
+                    if (grand_parent != parent) {
+                        // path halving, nothing to do if another thread has already modified the parent of element
+                        m_parent[element].compare_exchange_weak(parent, grand_parent, std::memory_order_relaxed);
+                    }
+                    element = grand_parent;
+                }
+            }
+
+            idx_t find_no_compression(idx_t element) const {
+                idx_t parent;
+                while ((parent = m_parent[element].load(std::memory_order_relaxed)) != element)
+                    element = parent;
+                return element;
+            }
+
             /**
-             * Union by rank
+             * Union by index (not thread safe)
              * @param i index of canonical node
              * @param j index of canonical node
              * @return index of the canonical node representing the union of i and j (either i or j)
              */
             idx_t link(idx_t i, idx_t j) {
-                if (rank[i] > rank[j])
+                if (i > j)
                     std::swap(i, j);
-                else if (rank[i] == rank[j]) {
-                    rank[j] += 1;
-                }
-                parent[i] = j;
+                m_parent[i].store(j, std::memory_order_relaxed);
                 return j;
             }
 
+            /**
+             * Merges the sets containing i and j (thread safe)
+             * @param i
+             * @param j
+             * @return false if i and j were already in the same set and true otherwise
+             */
+            bool unite(idx_t i, idx_t j) {
+                while (true) {
+                    i = find(i);
+                    j = find(j);
+                    if (i == j) {
+                        return false;
+                    }
+                    if (i > j) {
+                        std::swap(i, j);
+                    }
+                    // fails if i is not a root anymore
+                    if (m_parent[i].compare_exchange_strong(i, j)) {
+                        return true;
+                    }
+                }
+            }
+
+            /**
+             * Test if i and j are in the same set (thread safe)
+             * @param i
+             * @param j
+             * @return
+             */
+            bool same_set(idx_t i, idx_t j) {
+                while (true) {
+                    i = find(i);
+                    j = find(j);
+                    if (i == j) {
+                        return true;
+                    }
+                    // i is still a root: i and j were in different sets when j was found
+                    if (m_parent[i].load() == i) {
+                        return false;
+                    }
+                }
+            }
+
         private:
-            using container_t = std::vector<idx_t>;
 
-            container_t parent;
-            container_t rank;
+            std::unique_ptr<std::atomic<idx_t>[]> m_parent;
+            size_t m_size;
         };
     }
 
-    using union_find = union_find_internal::union_find<>;
+    template<typename idx_t=index_t,
+            typename path_policy=union_find_policy::path_compression,
+            typename storage_policy=union_find_policy::separate_storage>
+    using basic_union_find = union_find_internal::union_find<idx_t, path_policy, storage_policy>;
+
+    using union_find = basic_union_find<>;
+
+    template<typename idx_t=index_t>
+    using concurrent_union_find = union_find_internal::concurrent_union_find<idx_t>;
 
 }
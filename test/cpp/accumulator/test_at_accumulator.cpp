@@ -9,6 +9,7 @@
 ****************************************************************************/
 #include "../test_utils.hpp"
 #include "higra/accumulator/at_accumulator.hpp"
+#include "xtensor/xrandom.hpp"
 
 using namespace hg;
 
@@ -35,4 +36,51 @@ namespace accumulator {
                 {4, 9}};
         REQUIRE((res_vec == expected_res_vec));
     }
-}
\ No newline at end of file
+
+    template<bool vectorial, typename T, typename accumulator_t>
+    void check_at_accumulator_engines(const array_1d<index_t> &indices, const T &weights,
+                                      const accumulator_t &accumulator) {
+        using namespace at_accumulator_internal;
+        using output_t = typename T::value_type;
+        auto expected = at_accumulate<vectorial, T, accumulator_t, output_t>(indices, weights, accumulator);
+        for (index_t num_input_chunks: {1, 3, 8}) {
+            auto res = at_accumulate_sorted<vectorial, T, accumulator_t, output_t>(indices, weights, accumulator,
+                                                                                   num_input_chunks);
+            REQUIRE((res == expected));
+        }
+    }
+
+    TEST_CASE("test at_accumulator engines", "at_accumulator") {
+        xt::random::seed(42);
+        index_t size = 20000;
+        // about half of the weights go to output element 0, a few are ignored and some output elements are empty
+        array_1d<index_t> indices = xt::random::randint<index_t>({size}, -100, 6000);
+        indices = xt::where(indices < 0, xt::where(indices < -90, -1, 0), indices);
+        indices = xt::where(indices < 3000, 0, indices - 3000);
+        REQUIRE(xt::sum(xt::equal(indices, 0))() > size / 3);
+
+        array_1d<double> weights = xt::random::randint<int>({size}, 1, 100);
+        check_at_accumulator_engines<false>(indices, weights, accumulator_sum());
+        check_at_accumulator_engines<false>(indices, weights, accumulator_min());
+        check_at_accumulator_engines<false>(indices, weights, accumulator_max());
+        check_at_accumulator_engines<false>(indices, weights, accumulator_mean());
+        check_at_accumulator_engines<false>(indices, weights, accumulator_counter());
+        check_at_accumulator_engines<false>(indices, weights, accumulator_first());
+        check_at_accumulator_engines<false>(indices, weights, accumulator_last());
+        check_at_accumulator_engines<false>(indices, weights, accumulator_argmin());
+        check_at_accumulator_engines<false>(indices, weights, accumulator_argmax());
+
+        array_2d<double> weights_vec = xt::random::randint<int>({size, (index_t) 3}, 1, 100);
+        check_at_accumulator_engines<true>(indices, weights_vec, accumulator_sum());
+        check_at_accumulator_engines<true>(indices, weights_vec, accumulator_max());
+        check_at_accumulator_engines<true>(indices, weights_vec, accumulator_mean());
+        check_at_accumulator_engines<true>(indices, weights_vec, accumulator_last());
+
+        // several blocks of output elements in the prefix sum of the histograms
+        index_t size2 = 60000;
+        array_1d<index_t> indices2 = xt::random::randint<index_t>({size2}, 0, 12000);
+        array_1d<double> weights2 = xt::random::randint<int>({size2}, 1, 100);
+        check_at_accumulator_engines<false>(indices2, weights2, accumulator_sum());
+        check_at_accumulator_engines<false>(indices2, weights2, accumulator_last());
+    }
+}
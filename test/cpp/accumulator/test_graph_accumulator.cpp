@@ -44,6 +44,11 @@ namespace graph_accumulator {
                 {8,  6}
         };
         REQUIRE(xt::allclose(ref2, res2));
+
+        array_1d<double> vertex_weights3{1, 2, 3, 4, 5, 6};
+        auto res3 = accumulate_graph_vertices(g, vertex_weights3, accumulator_mean());
+        array_1d<double> ref3{3, 3, 4, 3, 4, 4};
+        REQUIRE(xt::allclose(ref3, res3));
     }
 
     TEST_CASE("accumulator graph edges", "[graph_accumulator]") {
@@ -10,6 +10,7 @@
 
 #include "../test_utils.hpp"
 #include "higra/accumulator/tree_accumulator.hpp"
+#include "xtensor/xrandom.hpp"
 #include <functional>
 
 
@@ -262,4 +263,185 @@ namespace tree_accumulator {
                            {8,  1}};
         REQUIRE(xt::allclose(ref5, output5));
     }
-}
\ No newline at end of file
+
+    TEST_CASE("tree level schedules", "[tree_accumulator]") {
+
+        auto tree = data.t;
+
+        auto &hs = tree.height_schedule();
+        REQUIRE(hs.num_levels() == 2);
+        REQUIRE(std::vector<index_t>(hs.level_begin(0), hs.level_end(0)) == std::vector<index_t>{5, 6});
+        REQUIRE(std::vector<index_t>(hs.level_begin(1), hs.level_end(1)) == std::vector<index_t>{7});
+
+        auto &ds = tree.depth_schedule();
+        REQUIRE(ds.num_levels() == 3);
+        REQUIRE(std::vector<index_t>(ds.level_begin(0), ds.level_end(0)) == std::vector<index_t>{7});
+        REQUIRE(std::vector<index_t>(ds.level_begin(1), ds.level_end(1)) == std::vector<index_t>{5, 6});
+        REQUIRE(std::vector<index_t>(ds.level_begin(2), ds.level_end(2)) == std::vector<index_t>{0, 1, 2, 3, 4});
+
+        auto tree2 = tree;
+        auto &hs2 = tree2.height_schedule();
+        REQUIRE(&hs2 != &hs);
+        REQUIRE(std::vector<index_t>(hs2.level_begin(0), hs2.level_end(0)) == std::vector<index_t>{5, 6});
+
+        tree2.clear_schedules();
+        auto &ds2 = tree2.depth_schedule();
+        REQUIRE(ds2.num_levels() == 3);
+        REQUIRE(std::vector<index_t>(ds2.level_begin(1), ds2.level_end(1)) == std::vector<index_t>{5, 6});
+    }
+
+    /*
+     * Random tree with num_leaves leaves and num_internal internal nodes
+     */
+    hg::tree random_tree(index_t num_leaves, index_t num_internal) {
+        index_t num_nodes = num_leaves + num_internal;
+        array_1d<index_t> parents = array_1d<index_t>::from_shape({(size_t) num_nodes});
+        for (index_t i = 0; i < num_nodes - 1; i++) {
+            index_t low = (i < num_leaves) ? num_leaves : i + 1;
+            parents(i) = xt::random::randint<index_t>({1}, low, num_nodes)(0);
+        }
+        // every internal node needs at least one child
+        for (index_t i = 0; i < num_internal; i++) {
+            parents(i) = num_leaves + i;
+        }
+        parents(num_nodes - 1) = num_nodes - 1;
+        return hg::tree(parents);
+    }
+
+    template<bool vectorial, typename tree_t, typename T, typename accumulator_t>
+    void check_multi_threaded_accumulators(const tree_t &tree, const T &input, const accumulator_t &acc) {
+        auto leaf_data = xt::eval(xt::view(input, xt::range(0, num_leaves(tree))));
+
+        // value of leaves (no children) is not defined for all accumulators
+        auto internal_nodes = xt::range(num_leaves(tree), num_vertices(tree));
+        auto ref1 = tree_accumulator_detail::accumulate_parallel_impl<vectorial>(tree, input, acc);
+        auto res1 = tree_accumulator_detail::accumulate_parallel_multi_threaded_impl<vectorial>(tree, input, acc);
+        REQUIRE((xt::view(ref1, internal_nodes) == xt::view(res1, internal_nodes)));
+
+        auto ref2 = tree_accumulator_detail::accumulate_sequential_impl<vectorial>(tree, leaf_data, acc);
+        auto res2 = tree_accumulator_detail::accumulate_sequential_multi_threaded_impl<vectorial>(tree, leaf_data,
+                                                                                                  acc);
+        REQUIRE((ref2 == res2));
+    }
+
+    TEST_CASE("tree accumulator multi-threaded engines", "[tree_accumulator]") {
+
+        xt::random::seed(42);
+        // large enough to be split in several chunks
+        auto tree = random_tree(20000, 12000);
+        auto n = num_vertices(tree);
+
+        array_1d<double> input1 = xt::random::randint<int>({n}, 0, 50);
+        array_2d<double> input2 = xt::random::randint<int>({n, (size_t) 3}, 0, 50);
+
+        check_multi_threaded_accumulators<false>(tree, input1, accumulator_sum());
+        check_multi_threaded_accumulators<false>(tree, input1, accumulator_min());
+        check_multi_threaded_accumulators<false>(tree, input1, accumulator_max());
+        check_multi_threaded_accumulators<false>(tree, input1, accumulator_mean());
+        check_multi_threaded_accumulators<false>(tree, input1, accumulator_counter());
+        check_multi_threaded_accumulators<false>(tree, input1, accumulator_first());
+        check_multi_threaded_accumulators<false>(tree, input1, accumulator_last());
+        check_multi_threaded_accumulators<false>(tree, input1, accumulator_argmin());
+        check_multi_threaded_accumulators<false>(tree, input1, accumulator_argmax());
+
+        check_multi_threaded_accumulators<true>(tree, input2, accumulator_sum());
+        check_multi_threaded_accumulators<true>(tree, input2, accumulator_min());
+        check_multi_threaded_accumulators<true>(tree, input2, accumulator_max());
+        check_multi_threaded_accumulators<true>(tree, input2, accumulator_mean());
+        check_multi_threaded_accumulators<true>(tree, input2, accumulator_counter());
+        check_multi_threaded_accumulators<true>(tree, input2, accumulator_first());
+        check_multi_threaded_accumulators<true>(tree, input2, accumulator_last());
+        check_multi_threaded_accumulators<true>(tree, input2, accumulator_argmin());
+        check_multi_threaded_accumulators<true>(tree, input2, accumulator_argmax());
+    }
+
+    TEST_CASE("tree propagate multi-threaded engines", "[tree_accumulator]") {
+
+        xt::random::seed(42);
+        auto tree = random_tree(20000, 12000);
+        auto n = num_vertices(tree);
+
+        array_1d<double> input1 = xt::random::rand<double>({n});
+        array_2d<double> input2 = xt::random::rand<double>({n, (size_t) 3});
+        array_1d<bool> condition = xt::random::randint<int>({n}, 0, 2);
+
+        REQUIRE((tree_accumulator_detail::propagate_parallel_impl<false>(tree, input1) ==
+                 tree_accumulator_detail::propagate_parallel_multi_threaded_impl<false>(tree, input1)));
+        REQUIRE((tree_accumulator_detail::propagate_parallel_impl<true>(tree, input2) ==
+                 tree_accumulator_detail::propagate_parallel_multi_threaded_impl<true>(tree, input2)));
+
+        REQUIRE((tree_accumulator_detail::propagate_parallel_impl<false>(tree, input1, condition) ==
+                 tree_accumulator_detail::propagate_parallel_multi_threaded_impl<false>(tree, input1, condition)));
+        REQUIRE((tree_accumulator_detail::propagate_parallel_impl<true>(tree, input2, condition) ==
+                 tree_accumulator_detail::propagate_parallel_multi_threaded_impl<true>(tree, input2, condition)));
+
+        REQUIRE((tree_accumulator_detail::propagate_sequential_impl<false>(tree, input1, condition) ==
+                 tree_accumulator_detail::propagate_sequential_multi_threaded_impl<false>(tree, input1, condition)));
+        REQUIRE((tree_accumulator_detail::propagate_sequential_impl<true>(tree, input2, condition) ==
+                 tree_accumulator_detail::propagate_sequential_multi_threaded_impl<true>(tree, input2, condition)));
+    }
+
+    template<bool vectorial, typename T>
+    void check_composite_accumulators(const tree &tree, const T &input, bool multi_threaded) {
+        auto composite = make_accumulator_composite(accumulator_sum(), accumulator_min(), accumulator_max(),
+                                                    accumulator_mean(), accumulator_first());
+
+        // some accumulators leave the output of the leaves uninitialized in accumulate_parallel
+        auto internal_nodes = [&tree](const auto &a) {
+            return xt::eval(xt::view(a, xt::range(num_leaves(tree), num_vertices(tree))));
+        };
+        auto res1 = tree_accumulator_detail::accumulate_composite_impl<vectorial, false>(tree, input, composite,
+                                                                                        multi_threaded);
+        REQUIRE(res1.size() == 5);
+        REQUIRE((internal_nodes(res1[0]) == internal_nodes(accumulate_parallel(tree, input, accumulator_sum()))));
+        REQUIRE((internal_nodes(res1[1]) == internal_nodes(accumulate_parallel(tree, input, accumulator_min()))));
+        REQUIRE((internal_nodes(res1[2]) == internal_nodes(accumulate_parallel(tree, input, accumulator_max()))));
+        REQUIRE((internal_nodes(res1[3]) == internal_nodes(accumulate_parallel(tree, input, accumulator_mean()))));
+        REQUIRE((internal_nodes(res1[4]) == internal_nodes(accumulate_parallel(tree, input, accumulator_first()))));
+
+        auto leaf_data = xt::eval(xt::view(input, xt::range(0, num_leaves(tree))));
+        auto res2 = tree_accumulator_detail::accumulate_composite_impl<vectorial, true>(tree, leaf_data, composite,
+                                                                                       multi_threaded);
+        REQUIRE((res2[0] == accumulate_sequential(tree, leaf_data, accumulator_sum())));
+        REQUIRE((res2[1] == accumulate_sequential(tree, leaf_data, accumulator_min())));
+        REQUIRE((res2[2] == accumulate_sequential(tree, leaf_data, accumulator_max())));
+        REQUIRE((res2[3] == accumulate_sequential(tree, leaf_data, accumulator_mean())));
+        REQUIRE((res2[4] == accumulate_sequential(tree, leaf_data, accumulator_first())));
+
+        composite.set_enabled(1, false);
+        composite.set_enabled(4, false);
+        auto res3 = tree_accumulator_detail::accumulate_composite_impl<vectorial, true>(tree, leaf_data, composite,
+                                                                                       multi_threaded);
+        REQUIRE(res3[1].size() == 0);
+        REQUIRE(res3[4].size() == 0);
+        REQUIRE((res3[0] == res2[0]));
+        REQUIRE((res3[2] == res2[2]));
+        REQUIRE((res3[3] == res2[3]));
+    }
+
+    TEST_CASE("tree composite accumulator", "[tree_accumulator]") {
+        auto tree = data.t;
+
+        array_1d<double> input{1, 8, 2, 5, 3, 0, 4, 7};
+        auto composite = make_accumulator_composite(accumulator_sum(), accumulator_max(), accumulator_counter());
+        auto res = accumulate_parallel(tree, input, composite);
+        REQUIRE((res[0] == array_1d<double>{0, 0, 0, 0, 0, 9, 10, 4}));
+        REQUIRE((res[1] == accumulate_parallel(tree, input, accumulator_max())));
+        REQUIRE((res[2] == array_1d<double>{0, 0, 0, 0, 0, 2, 3, 2}));
+
+        array_1d<double> leaf_data{1, 8, 2, 5, 3};
+        auto res2 = accumulate_sequential(tree, leaf_data, composite);
+        REQUIRE((res2[0] == array_1d<double>{1, 8, 2, 5, 3, 9, 10, 19}));
+        REQUIRE((res2[1] == array_1d<double>{1, 8, 2, 5, 3, 8, 5, 8}));
+
+        xt::random::seed(42);
+        auto tree2 = random_tree(20000, 12000);
+        auto n = num_vertices(tree2);
+        array_1d<double> input1 = xt::random::randint<int>({n}, 0, 50);
+        array_2d<double> input2 = xt::random::randint<int>({n, (size_t) 3}, 0, 50);
+        for (bool multi_threaded: {false, true}) {
+            check_composite_accumulators<false>(tree2, input1, multi_threaded);
+            check_composite_accumulators<true>(tree2, input2, multi_threaded);
+        }
+    }
+}
@@ -12,6 +12,8 @@
 #include "higra/accumulator/tree_contour_accumulator.hpp"
 #include "higra/image/graph_image.hpp"
 #include "higra/attribute/tree_attribute.hpp"
+#include "higra/hierarchy/hierarchy_core.hpp"
+#include "xtensor/xrandom.hpp"
 
 
 using namespace hg;
@@ -85,4 +87,59 @@ namespace tree_contour_accumulator {
             REQUIRE(xt::allclose(result, expected));
 
     }
-}
\ No newline at end of file
+
+    template<bool vectorial, typename tree_t, typename T, typename T2, typename accumulator_t>
+    void check_contour_accumulator(const ugraph &graph, const tree_t &tree, const T &node_weights,
+                                   const T2 &depth, const accumulator_t &accumulator) {
+        using namespace tree_contour_accumulator_detail;
+        auto result = accumulate_on_contours_heavy_path_impl<vectorial>(graph, tree, node_weights, depth,
+                                                                        accumulator);
+        auto expected = accumulate_on_contours_impl<vectorial>(graph, tree, node_weights, depth, accumulator);
+        REQUIRE(xt::allclose(result, expected));
+    }
+
+    template<typename tree_t, typename T>
+    void check_contour_accumulators(const ugraph &graph, const tree_t &tree, const T &node_weights) {
+        auto depth = attribute_depth(tree);
+        check_contour_accumulator<false>(graph, tree, node_weights, depth, accumulator_sum());
+        check_contour_accumulator<false>(graph, tree, node_weights, depth, accumulator_min());
+        check_contour_accumulator<false>(graph, tree, node_weights, depth, accumulator_max());
+        check_contour_accumulator<false>(graph, tree, node_weights, depth, accumulator_prod());
+
+        array_2d<double> node_weights2 = xt::stack(xt::xtuple(node_weights, 2 * node_weights + 1), 1);
+        check_contour_accumulator<true>(graph, tree, node_weights2, depth, accumulator_sum());
+        check_contour_accumulator<true>(graph, tree, node_weights2, depth, accumulator_max());
+    }
+
+    TEST_CASE("contour accumulator random trees", "[tree_contour_accumulator]") {
+        xt::random::seed(42);
+        auto graph = get_4_adjacency_graph({13, 17});
+        index_t num_leaves = num_vertices(graph);
+
+        for (index_t k = 0; k < 3; k++) {
+            array_1d<double> edge_weights = xt::random::randint<int>({num_edges(graph)}, 0, 10);
+            auto t = bpt_canonical(graph, edge_weights).tree;
+            array_1d<double> node_weights = xt::random::rand<double>({num_vertices(t)}, 0.8, 1.2);
+            check_contour_accumulators(graph, t, node_weights);
+
+            auto t2 = simplify_tree(t, [](index_t i) { return i % 3 == 0; }).tree;
+            array_1d<double> node_weights2 = xt::random::rand<double>({num_vertices(t2)}, 0.8, 1.2);
+            check_contour_accumulators(graph, t2, node_weights2);
+        }
+
+        // chain tree: leaves are merged one by one in a random order
+        array_1d<index_t> order = xt::arange<index_t>(num_leaves);
+        xt::random::shuffle(order);
+        array_1d<index_t> parents = array_1d<index_t>::from_shape({(size_t) (2 * num_leaves - 1)});
+        parents(order(0)) = num_leaves;
+        for (index_t i = 1; i < num_leaves; i++) {
+            parents(order(i)) = num_leaves + i - 1;
+        }
+        for (index_t n = num_leaves; n < 2 * num_leaves - 1; n++) {
+            parents(n) = (n == 2 * num_leaves - 2) ? n : n + 1;
+        }
+        hg::tree chain(parents);
+        array_1d<double> node_weights = xt::random::rand<double>({num_vertices(chain)}, 0.8, 1.2);
+        check_contour_accumulators(graph, chain, node_weights);
+    }
+}
@@ -10,6 +10,7 @@
 
 #include "higra/image/graph_image.hpp"
 #include "higra/algo/graph_weights.hpp"
+#include "xtensor/xrandom.hpp"
 #include "../test_utils.hpp"
 
 
@@ -99,4 +100,73 @@ namespace test_graph_weights {
         auto r8 = weight_graph(g, data2, hg::weight_functions::L0);
         REQUIRE(xt::allclose(ref8, r8));
     }
+
+    template<typename graph_t, typename T>
+    void check_weight_regular_graph(const graph_t &graph, const T &data, bool vectorial) {
+        auto explicit_graph = copy_graph<ugraph>(graph);
+        std::vector<weight_functions> functions{weight_functions::L0,
+                                                weight_functions::L1,
+                                                weight_functions::L2,
+                                                weight_functions::L_infinity,
+                                                weight_functions::L2_squared};
+        if (!vectorial) {
+            functions.insert(functions.end(), {weight_functions::mean,
+                                               weight_functions::min,
+                                               weight_functions::max,
+                                               weight_functions::source,
+                                               weight_functions::target});
+        }
+        for (auto f: functions) {
+            auto ref = weight_graph(explicit_graph, data, f);
+            auto res = weight_graph(graph, data, f);
+            REQUIRE(xt::allclose(ref, res));
+        }
+    }
+
+    TEST_CASE("regular graph edge weighting", "[graph_weights]") {
+
+        auto g = get_4_adjacency_implicit_graph({2, 2});
+        array_1d<double> data{0, 1, 2, 3};
+
+        array_1d<double> ref1{0.5, 1, 2, 2.5};
+        auto r1 = weight_graph(g, data, hg::weight_functions::mean);
+        REQUIRE(xt::allclose(ref1, r1));
+
+        array_2d<double> data2{{0, 1},
+                               {2, 3},
+                               {0, 1},
+                               {6, 7}};
+        array_1d<double> ref2{1, 0, 1, 1};
+        auto r2 = weight_graph(g, data2, hg::weight_functions::L0);
+        REQUIRE(xt::allclose(ref2, r2));
+
+        xt::random::seed(42);
+        std::vector<std::vector<size_t>> shapes{{1, 1}, {1, 7}, {7, 1}, {5, 9}, {17, 23}};
+        for (const auto &shape: shapes) {
+            embedding_grid_2d embedding(shape);
+            array_1d<double> scalar = xt::random::rand<double>({embedding.size()});
+            array_3d<double> vectorial = xt::random::rand<double>({embedding.size(), (size_t) 2, (size_t) 3});
+            array_1d<int> integral = xt::random::randint<int>({embedding.size()}, 0, 3);
+
+            for (const auto &graph: {get_4_adjacency_implicit_graph(embedding),
+                                     get_8_adjacency_implicit_graph(embedding),
+                                     regular_grid_graph_2d(embedding, {{0, 2}, {-1, 3}, {2, 1}, {0, -2}})}) {
+                check_weight_regular_graph(graph, scalar, false);
+                check_weight_regular_graph(graph, vectorial, true);
+                check_weight_regular_graph(graph, integral, false);
+            }
+        }
+
+        embedding_grid_3d embedding3d{4, 5, 6};
+        regular_grid_graph_3d g3d(embedding3d, {{-1, 0, 0}, {0, -1, 0}, {0, 0, -1}, {0, 0, 1}, {0, 1, 0}, {1, 0, 0}});
+        array_1d<float> scalar3d = xt::random::rand<float>({embedding3d.size()});
+        array_2d<float> vectorial3d = xt::random::rand<float>({embedding3d.size(), (size_t) 4});
+        check_weight_regular_graph(g3d, scalar3d, false);
+        check_weight_regular_graph(g3d, vectorial3d, true);
+
+        embedding_grid_1d embedding1d{13};
+        regular_grid_graph_1d g1d(embedding1d, {{-1}, {1}, {3}});
+        array_1d<double> scalar1d = xt::random::rand<double>({embedding1d.size()});
+        check_weight_regular_graph(g1d, scalar1d, false);
+    }
 }
@@ -9,7 +9,10 @@
 ****************************************************************************/
 
 #include "higra/assessment/dendrogram_purity.hpp"
+#include "higra/hierarchy/hierarchy_core.hpp"
+#include "higra/image/graph_image.hpp"
 #include "../test_utils.hpp"
+#include "xtensor/xrandom.hpp"
 
 using namespace hg;
 
@@ -33,4 +36,37 @@ namespace assessment_dendrogram_purity {
             REQUIRE(almost_equal(p, 0.5666666666666667));
         }
     }
+
+    TEST_CASE("dendrogram purity random trees", "[dendrogram purity]") {
+        xt::random::seed(42);
+        auto g = get_4_adjacency_graph({23, 17});
+        for (index_t num_labels: {1, 3, 40}) {
+            array_1d<double> edge_weights = xt::random::randint<int>({num_edges(g)}, 0, 10);
+            auto t = bpt_canonical(g, edge_weights).tree;
+            array_1d<index_t> labels = xt::random::randint<index_t>({num_leaves(t)}, 0, num_labels);
+
+            // dense reference
+            auto area = attribute_area(t);
+            array_2d<double> label_histo_leaves = xt::zeros<double>({num_leaves(t), (size_t) num_labels});
+            for (index_t i = 0; i < (index_t) num_leaves(t); i++) {
+                label_histo_leaves(i, labels(i)) = 1;
+            }
+            auto label_histo = accumulate_sequential(t, label_histo_leaves, accumulator_sum());
+            auto weights = attribute_children_pair_sum_product(t, label_histo);
+            double ref = xt::sum(label_histo / xt::view(area, xt::all(), xt::newaxis()) * weights)() /
+                         xt::sum(weights)();
+
+            REQUIRE(almost_equal(dendrogram_purity(t, labels), ref));
+
+            // same tree with non binary nodes
+            auto t2 = simplify_tree(t, [](index_t i) { return i % 3 == 0; }).tree;
+            auto area2 = attribute_area(t2);
+            auto label_histo2 = accumulate_sequential(t2, label_histo_leaves, accumulator_sum());
+            auto weights2 = attribute_children_pair_sum_product(t2, label_histo2);
+            double ref2 = xt::sum(label_histo2 / xt::view(area2, xt::all(), xt::newaxis()) * weights2)() /
+                          xt::sum(weights2)();
+
+            REQUIRE(almost_equal(dendrogram_purity(t2, labels), ref2));
+        }
+    }
 }
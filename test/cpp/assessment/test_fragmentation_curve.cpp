@@ -17,6 +17,23 @@ using namespace hg;
 
 namespace assessment_fragmentation_curve {
 
+    TEST_CASE("sparse cardinal of intersections tree ground truth", "[fragmentation_curve]") {
+        tree t(array_1d<index_t>{ 8, 8, 9, 9, 10, 10, 11, 13, 12, 12, 11, 13, 14, 14, 14 });
+        array_1d<char> ground_truth{ 1, 1, 2, 2, 2, 5, 5, 5 };
+
+        auto ci = fragmentation_curve_internal::compute_card_intersection_tree_ground_truth(t, ground_truth);
+        REQUIRE(ci.num_rows() == num_vertices(t));
+        REQUIRE(ci.num_columns() == 6);
+        REQUIRE(ci.num_non_zeros() == 21);
+
+        array_2d<index_t> leaves_ci = xt::zeros<index_t>({num_leaves(t), (size_t)6});
+        for (auto i: leaves_iterator(t)) {
+            leaves_ci(i, ground_truth(i)) = 1;
+        }
+        array_2d<index_t> ref = accumulate_sequential(t, leaves_ci, accumulator_sum());
+        REQUIRE((ci.to_dense() == ref));
+    }
+
     TEST_CASE("fragmentation curve BCE optimal cut", "[fragmentation_curve]") {
             tree t(array_1d<index_t>{ 8, 8, 9, 9, 10, 10, 11, 13, 12, 12, 11, 13, 14, 14, 14 });
             array_1d<char> ground_truth{ 0, 0, 1, 1, 1, 2, 2, 2 };
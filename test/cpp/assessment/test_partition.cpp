@@ -41,6 +41,42 @@ namespace assessment_partition {
             }
     }
 
+    TEST_CASE("sparse cardinal of intersections", "[assessment_partition]") {
+            array_1d<int> candidate{ 0, 0, 0, 1, 1, 1, 3, 3, 3 };
+            array_1d<int> gt{ 0, 0, 1, 1, 1, 2, 2, 3, 3 };
+
+            auto r = sparse_card_intersections(candidate, gt);
+            REQUIRE(r.size() == 1);
+            auto &ci = r[0];
+            REQUIRE(ci.num_rows() == 4);
+            REQUIRE(ci.num_columns() == 4);
+            REQUIRE(ci.num_non_zeros() == 6);
+            REQUIRE(ci.row_begin(2) == ci.row_end(2));
+            REQUIRE(ci.row_area(1) == 3);
+
+            array_2d<index_t> ref{
+                    { 2, 1, 0, 0 },
+                    { 0, 2, 1, 0 },
+                    { 0, 0, 0, 0 },
+                    { 0, 0, 1, 2 }
+            };
+            REQUIRE((ci.to_dense() == ref));
+            array_1d<index_t> ref_column_areas{ 2, 3, 2, 2 };
+            REQUIRE((ci.column_areas() == ref_column_areas));
+    }
+
+    TEST_CASE("sparse scorers match dense scorers", "[assessment_partition]") {
+            array_1d<int> candidate{ 0, 0, 0, 1, 1, 1, 2, 2, 2, 3, 0, 3 };
+            array_1d<int> gt{ 0, 0, 1, 1, 1, 2, 2, 3, 3, 3, 4, 4 };
+
+            auto dense = card_intersections<double>(candidate, gt)[0];
+            auto sparse = sparse_card_intersections(candidate, gt)[0];
+            REQUIRE(almost_equal(scorer_partition_BCE::score(dense), scorer_partition_BCE::score(sparse)));
+            REQUIRE(almost_equal(scorer_partition_DHamming::score(dense), scorer_partition_DHamming::score(sparse)));
+            REQUIRE(almost_equal(scorer_partition_DCovering::score(dense),
+                                 scorer_partition_DCovering::score(sparse)));
+    }
+
     TEST_CASE("assess partition BCE", "[assessment_partition]") {
             array_1d<int> candidate{ 0, 0, 0, 1, 1, 1, 2, 2, 2 };
             array_1d<int> gt1{ 0, 0, 1, 1, 1, 2, 2, 3, 3 };
@@ -234,4 +234,123 @@ namespace binary_partition_tree {
         REQUIRE(r3.tree.parents() == r3_ref.tree.parents());
     }
 
+    template<typename ref_heap_policy, typename heap_policy>
+    void test_heap_policy(const ugraph &g, const array_1d<double> &edge_weights, const array_1d<double> &edge_weight_weights) {
+        auto r_ref = binary_partition_tree_average_linkage<ref_heap_policy>(g, edge_weights, edge_weight_weights);
+        auto r = binary_partition_tree_average_linkage<heap_policy>(g, edge_weights, edge_weight_weights);
+        REQUIRE(r.tree.parents() == r_ref.tree.parents());
+        REQUIRE((r.altitudes == r_ref.altitudes));
+
+        auto r2_ref = binary_partition_tree_complete_linkage<ref_heap_policy>(g, edge_weights);
+        auto r2 = binary_partition_tree_complete_linkage<heap_policy>(g, edge_weights);
+        REQUIRE(r2.tree.parents() == r2_ref.tree.parents());
+        REQUIRE((r2.altitudes == r2_ref.altitudes));
+    }
+
+    TEST_CASE("binary partition tree heap policies", "[binary_partition_tree]") {
+        xt::random::seed(42);
+        auto g = copy_graph(get_4_adjacency_graph({20, 20}));
+        // many ties: broken with edge indices by all the policies except fibonacci
+        array_1d<double> edge_weights = xt::random::randint<int>({num_edges(g)}, 0, 10);
+        array_1d<double> edge_weight_weights = xt::random::randint<int>({num_edges(g)}, 1, 10);
+
+        test_heap_policy<bpt_heap::dary, bpt_heap::pairing>(g, edge_weights, edge_weight_weights);
+        test_heap_policy<bpt_heap::dary, bpt_heap::automatic>(g, edge_weights, edge_weight_weights);
+
+        // no ties: all the policies give the same result
+        array_1d<double> edge_weights2 = xt::random::rand<double>({num_edges(g)});
+        test_heap_policy<bpt_heap::fibonacci, bpt_heap::dary>(g, edge_weights2, edge_weight_weights);
+        test_heap_policy<bpt_heap::fibonacci, bpt_heap::pairing>(g, edge_weights2, edge_weight_weights);
+        test_heap_policy<bpt_heap::fibonacci, bpt_heap::automatic>(g, edge_weights2, edge_weight_weights);
+
+        // runtime selection of the heap
+        auto r_ref = binary_partition_tree_complete_linkage<bpt_heap::dary>(g, edge_weights);
+        auto r = binary_partition_tree_internal::dispatch_heap_policy(bpt_heap_policy::dary, [&](auto heap) {
+            return binary_partition_tree_complete_linkage<decltype(heap)>(g, edge_weights);
+        });
+        REQUIRE(r.tree.parents() == r_ref.tree.parents());
+        REQUIRE((r.altitudes == r_ref.altitudes));
+        auto r2_ref = binary_partition_tree_complete_linkage(g, edge_weights);
+        auto r2 = binary_partition_tree_internal::dispatch_heap_policy(bpt_heap_policy::fibonacci, [&](auto heap) {
+            return binary_partition_tree_complete_linkage<decltype(heap)>(g, edge_weights);
+        });
+        REQUIRE(r2.tree.parents() == r2_ref.tree.parents());
+        REQUIRE((r2.altitudes == r2_ref.altitudes));
+        auto r3_ref = binary_partition_tree_complete_linkage<bpt_heap::nn_chain>(g, edge_weights);
+        auto r3 = binary_partition_tree_internal::dispatch_heap_policy(bpt_heap_policy::nn_chain, [&](auto heap) {
+            return binary_partition_tree_complete_linkage<decltype(heap)>(g, edge_weights);
+        });
+        REQUIRE(r3.tree.parents() == r3_ref.tree.parents());
+        REQUIRE((r3.altitudes == r3_ref.altitudes));
+    }
+
+    TEST_CASE("binary partition tree region graph types", "[binary_partition_tree]") {
+        xt::random::seed(42);
+        auto g = copy_graph(get_4_adjacency_graph({20, 20}));
+        array_1d<double> edge_weights = xt::random::rand<double>({num_edges(g)});
+
+        auto r_ref = hg::binary_partition_tree<bpt_heap::automatic, undirected_graph<hash_setS> >(
+                g, edge_weights,
+                binary_partition_tree_internal::binary_partition_tree_complete_linkage_weighting_functor<array_1d<double>>(
+                        edge_weights));
+        auto r = hg::binary_partition_tree<bpt_heap::automatic, region_merging_graph>(
+                g, edge_weights,
+                binary_partition_tree_internal::binary_partition_tree_complete_linkage_weighting_functor<array_1d<double>>(
+                        edge_weights));
+        REQUIRE(r.tree.parents() == r_ref.tree.parents());
+        REQUIRE((r.altitudes == r_ref.altitudes));
+    }
+
+    TEST_CASE("binary partition tree nearest-neighbor chain", "[binary_partition_tree]") {
+        xt::random::seed(42);
+        auto g = copy_graph(get_4_adjacency_graph({20, 20}));
+        array_1d<double> edge_weights = xt::random::rand<double>({num_edges(g)});
+        array_1d<double> edge_weight_weights = xt::random::rand<double>({num_edges(g)});
+
+        auto r1_ref = binary_partition_tree_complete_linkage(g, edge_weights);
+        auto r1 = binary_partition_tree_complete_linkage<bpt_heap::nn_chain>(g, edge_weights);
+        REQUIRE(r1.tree.parents() == r1_ref.tree.parents());
+        REQUIRE((r1.altitudes == r1_ref.altitudes));
+
+        auto r2_ref = binary_partition_tree_average_linkage(g, edge_weights, edge_weight_weights);
+        auto r2 = binary_partition_tree_average_linkage<bpt_heap::nn_chain>(g, edge_weights, edge_weight_weights);
+        REQUIRE(r2.tree.parents() == r2_ref.tree.parents());
+        REQUIRE(xt::allclose(r2.altitudes, r2_ref.altitudes));
+
+        auto r3_ref = binary_partition_tree_exponential_linkage(g, edge_weights, 2.0, edge_weight_weights);
+        auto r3 = binary_partition_tree_exponential_linkage<bpt_heap::nn_chain>(g, edge_weights, 2.0,
+                                                                                edge_weight_weights);
+        REQUIRE(r3.tree.parents() == r3_ref.tree.parents());
+        REQUIRE(xt::allclose(r3.altitudes, r3_ref.altitudes));
+
+        // Ward linkage is reducible on complete graphs
+        ugraph g2(30);
+        for (index_t i = 0; i < 30; i++) {
+            for (index_t j = i + 1; j < 30; j++) {
+                add_edge(i, j, g2);
+            }
+        }
+        array_2d<double> vertex_centroids = xt::random::rand<double>({30, 2});
+        array_1d<double> vertex_sizes = xt::random::randint<int>({30}, 1, 10);
+        auto r4_ref = binary_partition_tree_ward_linkage(g2, vertex_centroids, vertex_sizes, "none");
+        auto r4 = binary_partition_tree_ward_linkage<bpt_heap::nn_chain>(g2, vertex_centroids, vertex_sizes, "none");
+        REQUIRE(r4.tree.parents() == r4_ref.tree.parents());
+        REQUIRE(xt::allclose(r4.altitudes, r4_ref.altitudes));
+    }
+
+    TEST_CASE("binary partition tree nearest-neighbor chain multiple edges", "[binary_partition_tree]") {
+        auto graph = get_4_adjacency_graph({3, 3});
+        index_t ne = (index_t) num_edges(graph);
+        for (index_t i = 0; i < ne; i++) {
+            auto e = edge_from_index(i, graph);
+            add_edge(source(e, graph), target(e, graph), graph);
+        }
+        array_1d<double> edge_weights({1, 8, 2, 10, 15, 3, 11, 4, 12, 13, 5, 6,
+                                       1, 8, 2, 10, 15, 3, 11, 4, 12, 13, 5, 6});
+
+        auto r_ref = binary_partition_tree_complete_linkage(graph, edge_weights);
+        auto r = binary_partition_tree_complete_linkage<bpt_heap::nn_chain>(graph, edge_weights);
+        REQUIRE(r.tree.parents() == r_ref.tree.parents());
+        REQUIRE((r.altitudes == r_ref.altitudes));
+    }
 }
@@ -14,6 +14,7 @@
 #include "higra/image/graph_image.hpp"
 #include "higra/algo/tree.hpp"
 #include "xtensor/xadapt.hpp"
+#include "xtensor/xrandom.hpp"
 
 using namespace hg;
 using namespace std;
@@ -184,4 +185,106 @@ namespace binary_partition_tree {
 
         REQUIRE((expected_filtered_weights == filtered_weights));
     }
-}
\ No newline at end of file
+
+    TEST_CASE("test tiled canonized tree construction", "[component_tree]") {
+        xt::random::seed(42);
+        auto graph4 = get_4_adjacency_implicit_graph({37, 23});
+        auto graph8 = get_8_adjacency_implicit_graph({37, 23});
+        array_1d<int> vertex_weights = xt::random::randint<int>({37 * 23}, 0, 10);
+        array_1d<index_t> sorted_vertex_indices = stable_arg_sort(vertex_weights);
+
+        auto parents4 = component_tree_internal::pre_tree_construction(graph4, sorted_vertex_indices);
+        component_tree_internal::canonize_tree(parents4, vertex_weights, sorted_vertex_indices);
+        auto parents8 = component_tree_internal::pre_tree_construction(graph8, sorted_vertex_indices);
+        component_tree_internal::canonize_tree(parents8, vertex_weights, sorted_vertex_indices);
+        for (index_t num_tiles: {1, 2, 3, 5, 8, 37, 100}) {
+            auto tiled_parents4 = component_tree_internal::canonized_tree_construction_tiled(
+                    graph4, vertex_weights, sorted_vertex_indices, num_tiles);
+            REQUIRE((parents4 == tiled_parents4));
+            auto tiled_parents8 = component_tree_internal::canonized_tree_construction_tiled(
+                    graph8, vertex_weights, sorted_vertex_indices, num_tiles);
+            REQUIRE((parents8 == tiled_parents8));
+        }
+
+        // 3d graph whose edges span two slices along the first axis
+        std::vector<point_3d_i> neighbours{{{-2, 0,  0}},
+                                           {{0,  -1, 0}},
+                                           {{0,  0,  -1}},
+                                           {{0,  0,  1}},
+                                           {{0,  1,  0}},
+                                           {{2,  0,  0}}};
+        regular_grid_graph_3d graph3d(embedding_grid_3d({7, 5, 6}), neighbours);
+        array_1d<int> vertex_weights3d = xt::random::randint<int>({7 * 5 * 6}, 0, 5);
+        array_1d<index_t> sorted_vertex_indices3d = stable_arg_sort(vertex_weights3d);
+        auto parents3d = component_tree_internal::pre_tree_construction(graph3d, sorted_vertex_indices3d);
+        component_tree_internal::canonize_tree(parents3d, vertex_weights3d, sorted_vertex_indices3d);
+        auto tiled_parents3d = component_tree_internal::canonized_tree_construction_tiled(
+                graph3d, vertex_weights3d, sorted_vertex_indices3d, 3);
+        REQUIRE((parents3d == tiled_parents3d));
+    }
+
+    TEST_CASE("test max tree and min tree engines", "[component_tree]") {
+        xt::random::seed(42);
+        auto graph = get_8_adjacency_implicit_graph({50, 40});
+        array_1d<double> vertex_weights = xt::random::randint<int>({50 * 40}, 0, 20);
+
+        auto res_max = component_tree_max_tree<component_tree_engine::sequential>(graph, vertex_weights);
+        auto res_max_tiled = component_tree_max_tree<component_tree_engine::tiled>(graph, vertex_weights);
+        REQUIRE((res_max.tree.parents() == res_max_tiled.tree.parents()));
+        REQUIRE((res_max.altitudes == res_max_tiled.altitudes));
+
+        auto res_min = component_tree_min_tree<component_tree_engine::sequential>(graph, vertex_weights);
+        auto res_min_tiled = component_tree_min_tree<component_tree_engine::tiled>(graph, vertex_weights);
+        REQUIRE((res_min.tree.parents() == res_min_tiled.tree.parents()));
+        REQUIRE((res_min.altitudes == res_min_tiled.altitudes));
+    }
+
+    TEST_CASE("test max tree and min tree hierarchical queue", "[component_tree]") {
+        auto graph = get_4_adjacency_implicit_graph({4, 4});
+        array_1d<int> vertex_weights({0, 1, 4, 4,
+                                      7, 5, 6, 8,
+                                      2, 3, 4, 1,
+                                      9, 8, 6, 7});
+
+        auto res = component_tree_max_tree<component_tree_engine::hierarchical_queue>(graph, vertex_weights);
+        array_1d<index_t> expected_parents({28, 27, 24, 24,
+                                            20, 23, 22, 18,
+                                            26, 25, 24, 27,
+                                            16, 17, 21, 19,
+                                            17, 21, 22, 21, 23, 24, 23, 24, 25, 26, 27, 28, 28});
+        REQUIRE(category(res.tree) == tree_category::component_tree);
+        REQUIRE((expected_parents == res.tree.parents()));
+        array_1d<int> expected_altitudes({0, 1, 4, 4,
+                                          7, 5, 6, 8,
+                                          2, 3, 4, 1,
+                                          9, 8, 6, 7, 9,
+                                          8, 8, 7, 7, 6,
+                                          6, 5, 4, 3, 2,
+                                          1, 0});
+        REQUIRE((expected_altitudes == res.altitudes));
+
+        xt::random::seed(42);
+        for (index_t i = 0; i < 10; i++) {
+            auto graph8 = get_8_adjacency_implicit_graph({13, 17});
+            array_1d<unsigned char> random_weights = xt::random::randint<int>({13 * 17}, 0, 2 + i * 10);
+
+            auto res_max = component_tree_max_tree<component_tree_engine::sequential>(graph8, random_weights);
+            auto res_max_hq = component_tree_max_tree<component_tree_engine::hierarchical_queue>(graph8,
+                                                                                                random_weights);
+            REQUIRE((res_max.tree.parents() == res_max_hq.tree.parents()));
+            REQUIRE((res_max.altitudes == res_max_hq.altitudes));
+
+            auto res_min = component_tree_min_tree<component_tree_engine::sequential>(graph8, random_weights);
+            auto res_min_hq = component_tree_min_tree<component_tree_engine::hierarchical_queue>(graph8,
+                                                                                                random_weights);
+            REQUIRE((res_min.tree.parents() == res_min_hq.tree.parents()));
+            REQUIRE((res_min.altitudes == res_min_hq.altitudes));
+        }
+
+        ugraph empty_graph(0);
+        array_1d<int> empty_weights = xt::zeros<int>({0});
+        REQUIRE_THROWS_AS(component_tree_max_tree<component_tree_engine::hierarchical_queue>(empty_graph,
+                                                                                            empty_weights),
+                          std::runtime_error);
+    }
+}
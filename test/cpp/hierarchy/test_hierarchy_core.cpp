@@ -65,6 +65,253 @@ namespace hierarchy_core {
         REQUIRE((mst_edge_map == array_1d<int>({1, 0, 3, 4, 2})));
     }
 
+    TEST_CASE("canonical binary partition tree filter kruskal", "[hierarchy_core]") {
+        auto graph = get_4_adjacency_graph({2, 3});
+
+        array_1d<double> edge_weights{1, 0, 2, 1, 1, 1, 2};
+
+        auto res = bpt_canonical(graph, edge_weights, bpt_canonical_algorithm::filter_kruskal);
+        auto &tree = res.tree;
+        auto &altitudes = res.altitudes;
+        auto &mst_edge_map = res.mst_edge_map;
+
+        REQUIRE(num_vertices(tree) == 11);
+        REQUIRE(xt::allclose(hg::parents(tree), xt::xarray<unsigned int>({6, 7, 9, 6, 8, 9, 7, 8, 10, 10, 10})));
+        REQUIRE(xt::allclose(altitudes, xt::xarray<double>({0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 2})));
+        REQUIRE((mst_edge_map == array_1d<int>({1, 0, 3, 4, 2})));
+    }
+
+    TEST_CASE("canonical binary partition tree filter kruskal random", "[hierarchy_core]") {
+        auto graph = get_8_adjacency_graph({37, 23});
+        xt::random::seed(42);
+
+        for (index_t block_size: {1, 7, 100, 0}) {
+            array_1d<int> edge_weights = xt::random::randint<int>({num_edges(graph)}, 0, 20);
+            array_1d<index_t> sorted_edges_indices = stable_arg_sort(edge_weights);
+
+            auto ref = hierarchy_core_internal::bpt_canonical_from_sorted_edges(
+                    sources(graph), targets(graph), sorted_edges_indices, num_vertices(graph));
+            auto res = hierarchy_core_internal::bpt_canonical_from_sorted_edges_filter_kruskal(
+                    sources(graph), targets(graph), sorted_edges_indices, num_vertices(graph), block_size);
+
+            REQUIRE((ref.first == res.first));
+            REQUIRE((ref.second == res.second));
+        }
+    }
+
+    TEST_CASE("canonical binary partition tree union find", "[hierarchy_core]") {
+        auto graph = get_8_adjacency_graph({37, 23});
+        xt::random::seed(42);
+        array_1d<int> edge_weights = xt::random::randint<int>({num_edges(graph)}, 0, 20);
+
+        auto ref = bpt_canonical(graph, edge_weights);
+        auto res1 = bpt_canonical<basic_union_find<int32_t, union_find_policy::path_halving,
+                union_find_policy::interleaved_storage>>(graph, edge_weights);
+        REQUIRE((ref.tree.parents() == res1.tree.parents()));
+        REQUIRE((ref.mst_edge_map == res1.mst_edge_map));
+        auto res2 = bpt_canonical<concurrent_union_find<>>(graph, edge_weights,
+                                                            bpt_canonical_algorithm::filter_kruskal);
+        REQUIRE((ref.tree.parents() == res2.tree.parents()));
+        REQUIRE((ref.mst_edge_map == res2.mst_edge_map));
+    }
+
+    TEST_CASE("canonical binary partition tree batch", "[hierarchy_core]") {
+        // graph 0: 2x3 4-adjacency grid, graph 1: single vertex, graph 2: no vertex, graph 3: 3 vertices
+        array_1d<index_t> sources{0, 0, 1, 1, 2, 3, 4, 0, 1, 0};
+        array_1d<index_t> targets{1, 3, 2, 4, 5, 4, 5, 1, 2, 2};
+        array_1d<double> edge_weights{1, 0, 2, 1, 1, 1, 2, 3, 1, 2};
+        array_1d<index_t> edge_offsets{0, 7, 7, 7, 10};
+        array_1d<index_t> vertex_offsets{0, 6, 7, 7, 10};
+
+        auto res = bpt_canonical_batch(sources, targets, edge_weights, edge_offsets, vertex_offsets);
+
+        REQUIRE((res.node_offsets == array_1d<index_t>{0, 11, 12, 12, 17}));
+        REQUIRE((res.parents == array_1d<index_t>{6, 7, 9, 6, 8, 9, 7, 8, 10, 10, 10,
+                                                  0,
+                                                  4, 3, 3, 4, 4}));
+        REQUIRE((res.altitudes == array_1d<double>{0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 2,
+                                                   0,
+                                                   0, 0, 0, 1, 2}));
+        REQUIRE((res.mst_edge_map == array_1d<index_t>{1, 0, 3, 4, 2, 1, 2}));
+    }
+
+    TEST_CASE("canonical binary partition tree batch random", "[hierarchy_core]") {
+        xt::random::seed(42);
+        std::vector<ugraph> graphs{get_4_adjacency_graph({5, 7}),
+                                   get_8_adjacency_graph({3, 4}),
+                                   get_4_adjacency_graph({1, 1}),
+                                   get_4_adjacency_graph({10, 3})};
+        std::vector<array_1d<int>> weights;
+        std::vector<index_t> edge_offsets{0};
+        std::vector<index_t> vertex_offsets{0};
+        for (auto &g: graphs) {
+            weights.push_back(xt::random::randint<int>({num_edges(g)}, 0, 5));
+            edge_offsets.push_back(edge_offsets.back() + num_edges(g));
+            vertex_offsets.push_back(vertex_offsets.back() + num_vertices(g));
+        }
+        array_1d<index_t> sources = array_1d<index_t>::from_shape({(size_t) edge_offsets.back()});
+        array_1d<index_t> targets = array_1d<index_t>::from_shape({(size_t) edge_offsets.back()});
+        array_1d<int> edge_weights = array_1d<int>::from_shape({(size_t) edge_offsets.back()});
+        for (index_t k = 0; k < (index_t) graphs.size(); k++) {
+            auto range = xt::range(edge_offsets[k], edge_offsets[k + 1]);
+            xt::view(sources, range) = hg::sources(graphs[k]);
+            xt::view(targets, range) = hg::targets(graphs[k]);
+            xt::view(edge_weights, range) = weights[k];
+        }
+
+        auto res = bpt_canonical_batch(sources, targets, edge_weights,
+                                       xt::adapt(edge_offsets), xt::adapt(vertex_offsets));
+
+        for (index_t k = 0; k < (index_t) graphs.size(); k++) {
+            auto ref = bpt_canonical(graphs[k], weights[k]);
+            auto node_range = xt::range(res.node_offsets(k), res.node_offsets(k + 1));
+            auto mst_range = xt::range(res.node_offsets(k) - vertex_offsets[k],
+                                       res.node_offsets(k + 1) - vertex_offsets[k + 1]);
+            REQUIRE((ref.tree.parents() == xt::view(res.parents, node_range)));
+            REQUIRE((ref.altitudes == xt::view(res.altitudes, node_range)));
+            REQUIRE((ref.mst_edge_map == xt::view(res.mst_edge_map, mst_range)));
+        }
+    }
+
+
+    TEST_CASE("canonical binary partition tree update", "[hierarchy_core]") {
+        auto graph = get_4_adjacency_graph({2, 3});
+        array_1d<double> edge_weights{1, 0, 2, 1, 1, 1, 2};
+        auto bpt = bpt_canonical(graph, edge_weights);
+
+        // edge 2 decreases, edge 4 increases and is replaced by edge 6 in the mst
+        auto res = bpt_canonical_update(graph, edge_weights, bpt.tree, bpt.altitudes, bpt.mst_edge_map,
+                                        array_1d<index_t>{2, 4}, array_1d<double>{0, 3});
+
+        REQUIRE((res.tree.parents() == array_1d<index_t>{6, 7, 7, 6, 9, 10, 8, 8, 9, 10, 10}));
+        REQUIRE((res.altitudes == array_1d<double>{0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 2}));
+        REQUIRE((res.mst_edge_map == array_1d<index_t>{1, 2, 0, 3, 6}));
+        REQUIRE((res.node_map == array_1d<index_t>{0, 1, 2, 3, 4, 5, 6, -1, -1, -1, -1}));
+
+        // modifications that do not change the tree
+        auto res2 = bpt_canonical_update(graph, edge_weights, bpt.tree, bpt.altitudes, bpt.mst_edge_map,
+                                         array_1d<index_t>{6, 0}, array_1d<double>{5, 1});
+        REQUIRE((res2.tree.parents() == bpt.tree.parents()));
+        REQUIRE((res2.altitudes == bpt.altitudes));
+        REQUIRE((res2.mst_edge_map == bpt.mst_edge_map));
+        REQUIRE((res2.node_map == xt::arange<index_t>(num_vertices(bpt.tree))));
+    }
+
+    TEST_CASE("canonical binary partition tree update random", "[hierarchy_core]") {
+        xt::random::seed(42);
+        std::vector<ugraph> graphs{get_4_adjacency_graph({13, 17}),
+                                   get_8_adjacency_graph({9, 8}),
+                                   get_4_adjacency_graph({1, 2})};
+        for (auto &graph: graphs) {
+            for (int max_weight: {4, 1000}) {
+                array_1d<int> edge_weights = xt::random::randint<int>({num_edges(graph)}, 0, max_weight);
+                auto bpt = bpt_canonical(graph, edge_weights);
+                for (index_t i = 0; i < 30; i++) {
+                    index_t num_changes = xt::random::randint<index_t>({1}, 1, (i % 3 == 0) ? 20 : 4)(0);
+                    array_1d<index_t> changed_edges = xt::random::randint<index_t>({num_changes}, 0,
+                                                                                   num_edges(graph));
+                    array_1d<int> new_weights = xt::random::randint<int>({num_changes}, 0, max_weight);
+
+                    auto res = bpt_canonical_update(graph, edge_weights, bpt.tree, bpt.altitudes,
+                                                    bpt.mst_edge_map, changed_edges, new_weights);
+                    xt::index_view(edge_weights, changed_edges) = new_weights;
+                    auto ref = bpt_canonical(graph, edge_weights);
+
+                    REQUIRE((res.tree.parents() == ref.tree.parents()));
+                    REQUIRE((res.altitudes == ref.altitudes));
+                    REQUIRE((res.mst_edge_map == ref.mst_edge_map));
+                    for (index_t n = 0; n < (index_t) num_vertices(res.tree); n++) {
+                        auto m = res.node_map(n);
+                        if (n < (index_t) num_leaves(res.tree)) {
+                            REQUIRE(m == n);
+                        } else if (m != invalid_index) {
+                            auto num_points = (index_t) num_leaves(res.tree);
+                            REQUIRE(bpt.mst_edge_map(m - num_points) == res.mst_edge_map(n - num_points));
+                            REQUIRE(bpt.altitudes(m) == res.altitudes(n));
+                        }
+                    }
+                    bpt = std::move(ref);
+                }
+            }
+        }
+    }
+
+    TEST_CASE("dynamic canonical binary partition tree", "[hierarchy_core]") {
+        auto graph = get_4_adjacency_graph({2, 3});
+        array_1d<double> edge_weights{1, 0, 2, 1, 1, 1, 2};
+        auto bpt = make_dynamic_bpt_canonical(graph, edge_weights);
+
+        // internal node 6 + ei is built by the edge ei
+        REQUIRE((bpt.parents() == array_1d<index_t>{7, 6, 10, 7, 9, 10, 9, 6, 8, 8, 8, -1, -1}));
+        REQUIRE(bpt.root() == 8);
+        REQUIRE(bpt.altitude(10) == 1);
+        REQUIRE(bpt.building_edge(10) == 4);
+        REQUIRE(bpt.is_node(10));
+        REQUIRE(!bpt.is_node(11));
+
+        // edge 2 decreases, edge 4 increases and is replaced by edge 6 in the mst
+        auto changes = bpt.update(array_1d<index_t>{2, 4}, array_1d<double>{0, 3});
+        REQUIRE((bpt.parents() == array_1d<index_t>{7, 8, 8, 7, 9, 12, 9, 6, 6, 12, -1, -1, 12}));
+        REQUIRE(bpt.root() == 12);
+        REQUIRE((bpt.edge_weights() == array_1d<double>{1, 0, 0, 1, 3, 1, 2}));
+        REQUIRE((changes.removed_nodes == array_1d<index_t>{8, 10, 9, 6}));
+        REQUIRE((changes.added_nodes == array_1d<index_t>{8, 6, 9, 12}));
+        REQUIRE((changes.reparented_nodes == array_1d<index_t>{7, 1, 2, 4, 5}));
+
+        auto res = bpt.canonical_tree();
+        REQUIRE((res.tree.parents() == array_1d<index_t>{6, 7, 7, 6, 9, 10, 8, 8, 9, 10, 10}));
+        REQUIRE((res.altitudes == array_1d<double>{0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 2}));
+        REQUIRE((res.mst_edge_map == array_1d<index_t>{1, 2, 0, 3, 6}));
+
+        // modifications that do not change the tree
+        auto changes2 = bpt.update(array_1d<index_t>{5, 0}, array_1d<double>{5, 1});
+        REQUIRE(changes2.removed_nodes.size() == 0);
+        REQUIRE(changes2.added_nodes.size() == 0);
+        REQUIRE(changes2.reparented_nodes.size() == 0);
+        REQUIRE((bpt.parents() == array_1d<index_t>{7, 8, 8, 7, 9, 12, 9, 6, 6, 12, -1, -1, 12}));
+    }
+
+    TEST_CASE("dynamic canonical binary partition tree random", "[hierarchy_core]") {
+        xt::random::seed(42);
+        std::vector<ugraph> graphs{get_4_adjacency_graph({13, 17}),
+                                   get_8_adjacency_graph({9, 8}),
+                                   get_4_adjacency_graph({1, 2})};
+        for (auto &graph: graphs) {
+            for (int max_weight: {4, 1000}) {
+                array_1d<int> edge_weights = xt::random::randint<int>({num_edges(graph)}, 0, max_weight);
+                auto bpt = make_dynamic_bpt_canonical(graph, edge_weights);
+                for (index_t i = 0; i < 30; i++) {
+                    index_t num_changes = xt::random::randint<index_t>({1}, 1, (i % 3 == 0) ? 20 : 4)(0);
+                    array_1d<index_t> changed_edges = xt::random::randint<index_t>({num_changes}, 0,
+                                                                                   num_edges(graph));
+                    array_1d<int> new_weights = xt::random::randint<int>({num_changes}, 0, max_weight);
+
+                    array_1d<index_t> previous_parents = bpt.parents();
+                    auto changes = bpt.update(changed_edges, new_weights);
+                    xt::index_view(edge_weights, changed_edges) = new_weights;
+                    auto ref = bpt_canonical(graph, edge_weights);
+
+                    auto res = bpt.canonical_tree();
+                    REQUIRE((res.tree.parents() == ref.tree.parents()));
+                    REQUIRE((res.altitudes == ref.altitudes));
+                    REQUIRE((res.mst_edge_map == ref.mst_edge_map));
+
+                    // only the reported nodes have been modified
+                    array_1d<bool> changed = xt::zeros<bool>({previous_parents.size()});
+                    for (auto nodes: {&changes.removed_nodes, &changes.added_nodes, &changes.reparented_nodes}) {
+                        for (auto n: *nodes) {
+                            changed(n) = true;
+                        }
+                    }
+                    for (index_t n = 0; n < (index_t) previous_parents.size(); n++) {
+                        if (!changed(n)) {
+                            REQUIRE(previous_parents(n) == bpt.parent(n));
+                        }
+                    }
+                }
+            }
+        }
+    }
 
     TEST_CASE("simplify tree", "[hierarchy_core]") {
 
@@ -0,0 +1,102 @@
+/***************************************************************************
+* Copyright ESIEE Paris (2021)                                             *
+*                                                                          *
+* Contributor(s) : Benjamin Perret                                         *
+*                                                                          *
+* Distributed under the terms of the CECILL-B License.                     *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "../test_utils.hpp"
+#include "higra/hierarchy/tiled_hierarchy.hpp"
+#include "higra/image/graph_image.hpp"
+#include "xtensor/xrandom.hpp"
+
+namespace tiled_hierarchy {
+
+    using namespace hg;
+    using namespace std;
+
+    template<typename T1, typename T2>
+    void check_same_hierarchy(const T1 &res, const T2 &ref) {
+        REQUIRE((parents(res.tree) == parents(ref.tree)));
+        REQUIRE((res.altitudes == ref.altitudes));
+        REQUIRE((res.mst_edge_map == ref.mst_edge_map));
+    }
+
+    TEST_CASE("4 adjacency edge indices", "[tiled_hierarchy]") {
+        using namespace tiled_hierarchy_internal;
+        for (auto shape: vector<pair<index_t, index_t>>{{3, 4}, {1, 5}, {5, 1}, {2, 2}}) {
+            index_t h = shape.first;
+            index_t w = shape.second;
+            auto g = get_4_adjacency_graph({h, w});
+            for (index_t ei = 0; ei < (index_t) num_edges(g); ei++) {
+                auto e = edge_extremities(ei, h, w);
+                REQUIRE(e.first == (index_t) source(edge_from_index(ei, g), g));
+                REQUIRE(e.second == (index_t) target(edge_from_index(ei, g), g));
+                index_t y = e.first / w;
+                index_t x = e.first % w;
+                if (e.second == e.first + 1) {
+                    REQUIRE(right_edge_index(y, x, h, w) == ei);
+                } else {
+                    REQUIRE(bottom_edge_index(y, x, w) == ei);
+                }
+            }
+        }
+    }
+
+    TEST_CASE("tiled bpt canonical", "[tiled_hierarchy]") {
+        xt::random::seed(42);
+        index_t h = 23;
+        index_t w = 31;
+        auto g = get_4_adjacency_graph({h, w});
+        // many ties
+        array_1d<int> edge_weights = xt::random::randint<int>({num_edges(g)}, 0, 10);
+        auto ref = bpt_canonical(g, edge_weights);
+        auto reader = make_tile_reader_from_edge_weights({h, w}, edge_weights);
+
+        for (auto tile_shape: vector<array<index_t, 2>>{{1, 1}, {4, 7}, {8, 8}, {23, 5}, {100, 100}}) {
+            auto res = bpt_canonical_tiled({h, w}, reader, tile_shape);
+            check_same_hierarchy(res, ref);
+        }
+    }
+
+    TEST_CASE("tiled bpt canonical image reader", "[tiled_hierarchy]") {
+        xt::random::seed(42);
+        index_t h = 17;
+        index_t w = 12;
+        array_2d<double> image = xt::random::rand<double>({h, w});
+        auto g = get_4_adjacency_graph({h, w});
+        array_1d<double> edge_weights = weight_graph(g, xt::flatten(image), weight_functions::L1);
+        auto ref = bpt_canonical(g, edge_weights);
+
+        auto reader = make_tile_reader_from_image({h, w}, image, [](double a, double b) { return std::abs(a - b); });
+        auto res = bpt_canonical_tiled({h, w}, reader, {5, 4});
+        check_same_hierarchy(res, ref);
+    }
+
+    TEST_CASE("tiled watershed hierarchy by area", "[tiled_hierarchy]") {
+        xt::random::seed(42);
+        index_t h = 32;
+        index_t w = 27;
+        auto g = get_4_adjacency_graph({h, w});
+        array_1d<double> edge_weights = xt::random::randint<int>({num_edges(g)}, 0, 20);
+        auto ref = watershed_hierarchy_by_area(g, edge_weights);
+        auto reader = make_tile_reader_from_edge_weights({h, w}, edge_weights);
+
+        for (auto tile_shape: vector<array<index_t, 2>>{{3, 3}, {16, 9}, {32, 27}}) {
+            auto res = watershed_hierarchy_by_area_tiled({h, w}, reader, tile_shape);
+            check_same_hierarchy(res, ref);
+        }
+    }
+
+    TEST_CASE("tile shape from memory budget", "[tiled_hierarchy]") {
+        auto s = tile_shape_from_memory_budget(100 * 100 * tiled_hierarchy_bytes_per_tile_pixel);
+        REQUIRE(s[0] == 100);
+        REQUIRE(s[1] == 100);
+        auto s2 = tile_shape_from_memory_budget(0);
+        REQUIRE(s2[0] == 1);
+        REQUIRE(s2[1] == 1);
+    }
+}
@@ -12,6 +12,8 @@
 #include "higra/hierarchy/watershed_hierarchy.hpp"
 #include "higra/image/graph_image.hpp"
 #include "higra/algo/tree.hpp"
+#include "higra/algo/graph_weights.hpp"
+#include "xtensor/xrandom.hpp"
 
 namespace watershed_hierarchy {
 
@@ -124,4 +126,33 @@ namespace watershed_hierarchy {
         REQUIRE((altitudes == ref_altitudes));
     }
 
+
+    TEST_CASE("watershed hierarchy on implicit 3d graph", "[watershed_hierarchy]") {
+        embedding_grid_3d embedding{4, 5, 6};
+        xt::random::seed(42);
+        array_1d<double> image = xt::random::rand<double>({embedding.size()});
+
+        for (const auto &g: {get_6_adjacency_implicit_graph(embedding),
+                             get_26_adjacency_implicit_graph(embedding)}) {
+            auto ge = copy_graph<ugraph>(g);
+            auto edge_weights = weight_graph(g, image, weight_functions::L1);
+            REQUIRE((edge_weights == weight_graph(ge, image, weight_functions::L1)));
+
+            auto bpt = bpt_canonical(g, edge_weights);
+            auto bpt_ref = bpt_canonical(ge, edge_weights);
+            REQUIRE((bpt.tree.parents() == bpt_ref.tree.parents()));
+            REQUIRE((bpt.altitudes == bpt_ref.altitudes));
+            REQUIRE((bpt.mst_edge_map == bpt_ref.mst_edge_map));
+
+            auto res = watershed_hierarchy_by_area(g, edge_weights);
+            auto res_ref = watershed_hierarchy_by_area(ge, edge_weights);
+            REQUIRE((res.tree.parents() == res_ref.tree.parents()));
+            REQUIRE((res.altitudes == res_ref.altitudes));
+
+            auto res2 = watershed_hierarchy_by_dynamics(g, edge_weights);
+            auto res2_ref = watershed_hierarchy_by_dynamics(ge, edge_weights);
+            REQUIRE((res2.tree.parents() == res2_ref.tree.parents()));
+            REQUIRE((res2.altitudes == res2_ref.altitudes));
+        }
+    }
 }
\ No newline at end of file
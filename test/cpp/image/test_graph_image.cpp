@@ -104,6 +104,37 @@ namespace graph_image {
         }
     }
 
+    TEST_CASE("6, 18 and 26 adjacency graphs", "[graph_image]") {
+        embedding_grid_3d embedding{3, 4, 5};
+        auto g6 = get_6_adjacency_implicit_graph(embedding);
+        auto g18 = get_18_adjacency_implicit_graph(embedding);
+        auto g26 = get_26_adjacency_implicit_graph(embedding);
+        REQUIRE(g6.neighbours().size() == 6);
+        REQUIRE(g18.neighbours().size() == 18);
+        REQUIRE(g26.neighbours().size() == 26);
+
+        index_t center = embedding.grid2lin({1, 1, 1});
+        REQUIRE(out_degree(center, g6) == 6);
+        REQUIRE(out_degree(center, g18) == 18);
+        REQUIRE(out_degree(center, g26) == 26);
+        REQUIRE(out_degree(0, g6) == 3);
+        REQUIRE(out_degree(0, g18) == 6);
+        REQUIRE(out_degree(0, g26) == 7);
+
+        // edges along each axis: (d - 1) * h * w + d * (h - 1) * w + d * h * (w - 1)
+        REQUIRE(num_edges(g6) == 2 * 4 * 5 + 3 * 3 * 5 + 3 * 4 * 4);
+        REQUIRE(num_edges(get_6_adjacency_graph(embedding)) == num_edges(g6));
+        REQUIRE(num_edges(get_18_adjacency_graph(embedding)) == num_edges(g18));
+        REQUIRE(num_edges(get_26_adjacency_graph(embedding)) == num_edges(g26));
+
+        vector<pair<index_t, index_t>> ref{{0, 1}, {0, 5}, {0, 20}};
+        vector<pair<index_t, index_t>> test;
+        for (auto e: hg::out_edge_iterator(0, g6)) {
+            test.push_back({source(e, g6), target(e, g6)});
+        }
+        REQUIRE(vectorEqual(ref, test));
+    }
+
     TEST_CASE("4 adjacency graph to Khalimsky 2d", "[graph_image]") {
         auto g = get_4_adjacency_graph({4, 5});
 
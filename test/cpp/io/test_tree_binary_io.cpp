@@ -0,0 +1,255 @@
+/***************************************************************************
+* Copyright ESIEE Paris (2021)                                             *
+*                                                                          *
+* Contributor(s) : Benjamin Perret                                         *
+*                                                                          *
+* Distributed under the terms of the CECILL-B License.                     *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "../test_utils.hpp"
+#include "higra/io/tree_binary_io.hpp"
+#include "higra/image/graph_image.hpp"
+#include "higra/hierarchy/hierarchy_core.hpp"
+#include "xtensor/xrandom.hpp"
+#include <cstdio>
+#include <fstream>
+
+namespace tree_binary_io {
+
+    using namespace hg;
+    using namespace std;
+
+    const string filename = "test_tree_binary_io.tmp";
+
+    TEST_CASE("save and mmap binary tree", "[tree_binary_io]") {
+        array_1d<index_t> parent{5, 5, 6, 6, 6, 7, 7, 7};
+        array_1d<double> attr1{1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0};
+        array_1d<int> attr2{8, 7, 6, 5, 4, 3, 2, 1};
+        array_1d<uint8_t> attr3{0, 1, 0, 1, 0, 1, 0, 1};
+        tree t(parent);
+
+        {
+            ofstream out(filename, ios::binary);
+            save_tree_binary(out, t)
+                    .add_attribute("attr1", attr1)
+                    .add_attribute("attr2", attr2)
+                    .add_attribute("attr3", attr3)
+                    .finalize();
+        }
+
+        {
+            tree_mmap file(filename);
+            REQUIRE(file.num_vertices() == 8);
+            REQUIRE(file.get_column_type("parents") == tree_mmap::column_type::int32);
+            REQUIRE((file.column<int32_t>("parents") == parent));
+            REQUIRE(!file.has_children());
+            REQUIRE(!file.has_lca());
+
+            auto names = file.attribute_names();
+            REQUIRE((names == vector<string>{"attr1", "attr2", "attr3"}));
+            REQUIRE(file.get_attribute_type("attr1") == tree_mmap::column_type::float64);
+            REQUIRE(file.get_attribute_type("attr2") == tree_mmap::column_type::int32);
+            REQUIRE(file.get_attribute_type("attr3") == tree_mmap::column_type::uint8);
+            REQUIRE((file.attribute<double>("attr1") == attr1));
+            REQUIRE((file.attribute<int>("attr2") == attr2));
+            REQUIRE((file.attribute<uint8_t>("attr3") == attr3));
+
+            // columns are aligned and not copied
+            REQUIRE(reinterpret_cast<uintptr_t>(file.column_data("attribute:attr1")) % 64 == 0);
+            REQUIRE(file.attribute<double>("attr1").data() == file.column_data("attribute:attr1"));
+
+            REQUIRE_THROWS(file.attribute<float>("attr1"));
+            REQUIRE_THROWS(file.attribute<double>("attr4"));
+
+            auto t2 = file.get_tree();
+            REQUIRE((parents(t2) == parent));
+        }
+        remove(filename.c_str());
+    }
+
+    TEST_CASE("save and mmap binary tree with children and lca", "[tree_binary_io]") {
+        xt::random::seed(42);
+        auto g = get_4_adjacency_graph({20, 30});
+        array_1d<double> w = xt::random::rand<double>({num_edges(g)});
+        auto h = bpt_canonical(g, w);
+        auto &t = h.tree;
+
+        {
+            ofstream out(filename, ios::binary);
+            save_tree_binary(out, t).add_attribute("altitudes", h.altitudes).add_children().add_lca().finalize();
+        }
+
+        {
+            tree_mmap file(filename);
+            REQUIRE(file.has_children());
+            REQUIRE(file.has_lca());
+            auto t2 = file.get_tree();
+            REQUIRE(t2.children_computed());
+            REQUIRE((parents(t2) == parents(t)));
+            t.compute_children();
+            for (auto n: leaves_to_root_iterator(t)) {
+                auto c1 = t.children(n);
+                auto c2 = t2.children(n);
+                REQUIRE(vector<index_t>(c1.begin(), c1.end()) == vector<index_t>(c2.begin(), c2.end()));
+            }
+            REQUIRE((file.attribute<double>("altitudes") == h.altitudes));
+
+            auto lca = file.get_lca<lca_preorder_block_32>();
+            lca_sparse_table ref_lca(t);
+            REQUIRE((lca.lca(sources(g), targets(g)) == ref_lca.lca(sources(g), targets(g))));
+            REQUIRE_THROWS(file.get_lca<lca_preorder_block>());
+        }
+        remove(filename.c_str());
+    }
+
+    TEST_CASE("mmap invalid binary tree", "[tree_binary_io]") {
+        {
+            ofstream out(filename, ios::binary);
+            out << "NOT A TREE FILE NOT A TREE FILE NOT A TREE FILE NOT A TREE FILE NOT A TREE FILE";
+        }
+        REQUIRE_THROWS(tree_mmap(filename));
+        remove(filename.c_str());
+        REQUIRE_THROWS(tree_mmap(filename));
+    }
+
+    /*
+     * Overwrites a field of the first column of the directory of a binary tree file
+     */
+    template<typename T>
+    void corrupt_first_column(const string &content, uint64_t field_offset, T value) {
+        string corrupted = content;
+        uint64_t directory_offset;
+        memcpy(&directory_offset, corrupted.data() + 32, sizeof(directory_offset));
+        memcpy(&corrupted[directory_offset + tree_binary_io_internal::max_name_size + field_offset], &value,
+               sizeof(value));
+        ofstream out(filename, ios::binary);
+        out << corrupted;
+    }
+
+    TEST_CASE("mmap corrupted binary tree directory", "[tree_binary_io]") {
+        tree t(array_1d<index_t>{5, 5, 6, 6, 6, 7, 7, 7});
+        {
+            ofstream out(filename, ios::binary);
+            save_tree_binary(out, t).finalize();
+        }
+        string content;
+        {
+            ifstream in(filename, ios::binary);
+            content.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+        }
+        REQUIRE_NOTHROW(tree_mmap(filename));
+
+        // element size does not match the column type
+        corrupt_first_column<uint32_t>(content, 20, 1);
+        REQUIRE_THROWS(tree_mmap(filename));
+
+        // offset + size * element_size overflows
+        corrupt_first_column<uint64_t>(content, 8, ((uint64_t) 1 << 62) + 1);
+        REQUIRE_THROWS(tree_mmap(filename));
+
+        // offset beyond the end of the file
+        corrupt_first_column<uint64_t>(content, 0, (uint64_t) -8);
+        REQUIRE_THROWS(tree_mmap(filename));
+
+        remove(filename.c_str());
+    }
+
+    /*
+     * Overwrites an element of a column of a binary tree file
+     */
+    template<typename T>
+    void corrupt_column(const string &content, const string &name, uint64_t index, T value) {
+        string corrupted = content;
+        uint64_t num_columns, directory_offset;
+        memcpy(&num_columns, corrupted.data() + 24, sizeof(num_columns));
+        memcpy(&directory_offset, corrupted.data() + 32, sizeof(directory_offset));
+        for (uint64_t i = 0; i < num_columns; i++) {
+            auto entry = corrupted.data() + directory_offset + i * tree_binary_io_internal::directory_entry_size;
+            if (name == entry) {
+                uint64_t offset;
+                memcpy(&offset, entry + tree_binary_io_internal::max_name_size, sizeof(offset));
+                memcpy(&corrupted[offset + index * sizeof(T)], &value, sizeof(value));
+            }
+        }
+        ofstream out(filename, ios::binary);
+        out << corrupted;
+    }
+
+    TEST_CASE("mmap corrupted binary tree columns", "[tree_binary_io]") {
+        xt::random::seed(42);
+        auto g = get_4_adjacency_graph({5, 7});
+        array_1d<double> w = xt::random::rand<double>({num_edges(g)});
+        auto h = bpt_canonical(g, w);
+        auto &t = h.tree;
+        int32_t num_nodes = (int32_t) num_vertices(t);
+        {
+            ofstream out(filename, ios::binary);
+            save_tree_binary(out, t).add_children().add_lca().finalize();
+        }
+        string content;
+        {
+            ifstream in(filename, ios::binary);
+            content.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+        }
+        {
+            tree_mmap file(filename);
+            REQUIRE(file.get_column_type("parents") == tree_mmap::column_type::int32);
+            REQUIRE_NOTHROW(file.get_tree());
+            REQUIRE_NOTHROW(file.get_lca<lca_preorder_block_32>());
+        }
+
+        auto check_get_tree_throws = [](){
+            tree_mmap file(filename);
+            REQUIRE_THROWS(file.get_tree());
+        };
+        auto check_get_lca_throws = [](){
+            tree_mmap file(filename);
+            REQUIRE_THROWS(file.get_lca<lca_preorder_block_32>());
+        };
+
+        // parent beyond the root
+        corrupt_column<int32_t>(content, "parents", 0, num_nodes + 10);
+        check_get_tree_throws();
+
+        // children offsets do not start at 0, decrease, or do not end at num_vertices - 1
+        corrupt_column<int32_t>(content, "children_offsets", 0, 1);
+        check_get_tree_throws();
+        corrupt_column<int32_t>(content, "children_offsets", 2, -100);
+        check_get_tree_throws();
+        corrupt_column<int32_t>(content, "children_offsets", num_nodes - num_leaves(t), num_nodes);
+        check_get_tree_throws();
+
+        // child out of bounds, child of another node, unordered children
+        corrupt_column<int32_t>(content, "children_indices", 0, num_nodes + 10);
+        check_get_tree_throws();
+        corrupt_column<int32_t>(content, "children_indices", 0, num_nodes - 2);
+        check_get_tree_throws();
+        t.compute_children();
+        corrupt_column<int32_t>(content, "children_indices", 0, (int32_t) t.child(1, num_leaves(t)));
+        check_get_tree_throws();
+
+        // ranks out of bounds or not a permutation
+        corrupt_column<int32_t>(content, "lca_preorder_rank", 0, num_nodes);
+        check_get_lca_throws();
+        corrupt_column<int32_t>(content, "lca_preorder_rank", 0, 0);
+        check_get_lca_throws();
+
+        // preorder parents do not match the parents
+        corrupt_column<int32_t>(content, "lca_preorder_parents", 1, num_nodes + 10);
+        check_get_lca_throws();
+
+        // masks with missing or extra bits
+        corrupt_column<uint32_t>(content, "lca_rmq_masks", 3, 0);
+        check_get_lca_throws();
+        corrupt_column<uint32_t>(content, "lca_rmq_masks", 3, 0xFFFFFFFF);
+        check_get_lca_throws();
+
+        // sparse table position out of bounds
+        corrupt_column<int32_t>(content, "lca_rmq_sparse_table", 0, num_nodes);
+        check_get_lca_throws();
+
+        remove(filename.c_str());
+    }
+}
@@ -0,0 +1,110 @@
+/***************************************************************************
+* Copyright ESIEE Paris (2021)                                             *
+*                                                                          *
+* Contributor(s) : Benjamin Perret                                         *
+*                                                                          *
+* Distributed under the terms of the CECILL-B License.                     *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "../test_utils.hpp"
+#include "higra/io/tree_codec.hpp"
+#include "higra/image/graph_image.hpp"
+#include "higra/hierarchy/hierarchy_core.hpp"
+#include "xtensor/xrandom.hpp"
+#include <sstream>
+
+namespace tree_codec_test {
+
+    using namespace hg;
+    using namespace std;
+    using namespace hg::tree_codec;
+
+    array_1d<index_t> random_bpt_parents(index_t size) {
+        xt::random::seed(42);
+        auto g = get_4_adjacency_graph({size, size});
+        array_1d<double> w = xt::random::rand<double>({num_edges(g)});
+        return parents(bpt_canonical(g, w).tree);
+    }
+
+    vector<codec_options> all_options(index_t block_size) {
+        vector<codec_options> options;
+        for (auto p: {packing::varint, packing::bitpack}) {
+            for (auto e: {entropy::none, entropy::rans}) {
+                codec_options o;
+                o.packing_method = p;
+                o.entropy_method = e;
+                o.block_size = block_size;
+                options.push_back(o);
+            }
+        }
+        return options;
+    }
+
+    TEST_CASE("compressed parents", "[tree_codec]") {
+        array_1d<index_t> parents{5, 5, 6, 6, 6, 7, 7, 7};
+        for (auto &o: all_options(3)) {
+            compressed_parents c(parents, o);
+            REQUIRE(c.num_vertices() == 8);
+            REQUIRE(c.num_blocks() == 3);
+            REQUIRE((c.decompress() == parents));
+            REQUIRE((c.decompress_range(2, 7) == xt::view(parents, xt::range(2, 7))));
+            REQUIRE((c.decompress_range(3, 6) == xt::view(parents, xt::range(3, 6))));
+            REQUIRE(c.decompress_range(4, 4).size() == 0);
+        }
+    }
+
+    TEST_CASE("compressed parents bpt", "[tree_codec]") {
+        auto parents = random_bpt_parents(64);
+        index_t n = parents.size();
+        for (auto &o: all_options(1000)) {
+            compressed_parents c(parents, o);
+            REQUIRE(c.compressed_size() < n * sizeof(int32_t));
+            REQUIRE((c.decompress() == parents));
+            REQUIRE((c.decompress_range(999, 3001) == xt::view(parents, xt::range(999, 3001))));
+
+            stringstream s;
+            c.write(s);
+            REQUIRE(s.str().size() == c.compressed_size());
+            auto c2 = compressed_parents::read(s);
+            REQUIRE(c2.num_blocks() == c.num_blocks());
+            REQUIRE((c2.decompress() == parents));
+        }
+    }
+
+    TEST_CASE("compressed parents large differences", "[tree_codec]") {
+        // root has a negative difference, all bit widths are used
+        array_1d<index_t> parents = xt::arange<index_t>(1, 101);
+        parents(99) = 99;
+        for (index_t i = 0; i < 60; i++) {
+            parents(i) = std::min<index_t>(i + ((index_t) 1 << i), 99);
+        }
+        array_1d<index_t> big{(index_t) 1 << 62, ((index_t) 1 << 62) - 5, -((index_t) 1 << 61), 0};
+        for (auto &o: all_options(16)) {
+            REQUIRE((compressed_parents(parents, o).decompress() == parents));
+            REQUIRE((compressed_parents(big, o).decompress() == big));
+        }
+    }
+
+    TEST_CASE("compressed parents corrupted", "[tree_codec]") {
+        auto parents = random_bpt_parents(16);
+        stringstream s;
+        compressed_parents(parents).write(s);
+        auto data = s.str();
+
+        stringstream truncated(data.substr(0, data.size() - 10));
+        REQUIRE_THROWS(compressed_parents::read(truncated));
+
+        data[data.size() - 100] ^= 0x5a;
+        data[data.size() - 200] ^= 0x5a;
+        stringstream corrupted(data);
+        auto c = compressed_parents::read(corrupted);
+        // corruption is either detected or gives wrong parents
+        try {
+            auto p = c.decompress();
+            REQUIRE(!(p == parents));
+        } catch (const std::runtime_error &) {
+        }
+    }
+}
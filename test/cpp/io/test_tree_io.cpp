@@ -40,4 +40,26 @@ namespace tree_io {
             REQUIRE(attributes.count("attr2") == 1);
             REQUIRE(xt::allclose(attributes["attr2"], attr2));
     }
-}
\ No newline at end of file
+
+    TEST_CASE("read and save tree compressed", "[tree_io]") {
+        array_1d<int> parent{5, 5, 6, 6, 6, 7, 7, 7};
+
+        array_1d<double> attr1{1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0};
+        tree t(parent);
+        tree_codec::codec_options options;
+        options.block_size = 3;
+        ostringstream out;
+        save_tree(out, t, options).add_attribute("attr1", attr1).finalize();
+        string res = out.str();
+
+        istringstream in(res);
+        auto tree_attr = read_tree(in);
+        auto t2 = tree_attr.first;
+        auto attributes = tree_attr.second;
+
+        REQUIRE((parent == parents(t2)));
+
+        REQUIRE(attributes.count("attr1") == 1);
+        REQUIRE(xt::allclose(attributes["attr1"], attr1));
+    }
+}
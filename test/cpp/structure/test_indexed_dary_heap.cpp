@@ -0,0 +1,136 @@
+/***************************************************************************
+* Copyright ESIEE Paris (2021)                                             *
+*                                                                          *
+* Contributor(s) : Benjamin Perret                                         *
+*                                                                          *
+* Distributed under the terms of the CECILL-B License.                     *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "higra/structure/indexed_dary_heap.hpp"
+#include "../test_utils.hpp"
+#include <random>
+#include <set>
+
+namespace test_indexed_dary_heap {
+
+    using namespace hg;
+    using namespace std;
+
+    TEST_CASE("indexed dary heap push-top-size-empty", "[indexed_dary_heap]") {
+        indexed_dary_heap<double> heap(10);
+        REQUIRE(heap.empty());
+        REQUIRE(heap.capacity() == 10);
+        heap.push(3, 10);
+        REQUIRE(heap.size() == 1);
+        REQUIRE(!heap.empty());
+        REQUIRE(heap.contains(3));
+        REQUIRE(!heap.contains(2));
+        REQUIRE(heap.top() == 3);
+        REQUIRE(heap.top_value() == 10);
+        heap.push(5, 15);
+        REQUIRE(heap.top() == 3);
+        heap.push(0, 8);
+        REQUIRE(heap.size() == 3);
+        REQUIRE(heap.top() == 0);
+        REQUIRE(heap.top_value() == 8);
+        REQUIRE(heap.value(5) == 15);
+
+        heap.clear();
+        REQUIRE(heap.size() == 0);
+        REQUIRE(heap.empty());
+        REQUIRE(!heap.contains(0));
+        REQUIRE(!heap.contains(3));
+        REQUIRE(!heap.contains(5));
+    }
+
+    template<index_t D>
+    void test_update_erase() {
+        indexed_dary_heap<index_t, D> heap(10);
+        array_1d<index_t> values{10, 15, 8, 22, 17, 5, 19, 2};
+        for (index_t i = 0; i < (index_t) values.size(); i++) {
+            heap.push(i, values(i));
+        }
+
+        heap.update(4, 12); // decrease
+        heap.update(3, 3); // decrease
+        heap.update(0, 25); // increase
+        heap.erase(6);
+        heap.erase(7); // top
+
+        array_1d<index_t> ref_indices{3, 5, 2, 4, 1, 0};
+        array_1d<index_t> ref_values{3, 5, 8, 12, 15, 25};
+        for (index_t i = 0; i < (index_t) ref_indices.size(); i++) {
+            REQUIRE(heap.top() == ref_indices(i));
+            REQUIRE(heap.top_value() == ref_values(i));
+            heap.pop();
+            REQUIRE(!heap.contains(ref_indices(i)));
+        }
+        REQUIRE(heap.empty());
+    }
+
+    TEST_CASE("indexed dary heap update erase", "[indexed_dary_heap]") {
+        test_update_erase<2>();
+        test_update_erase<3>();
+        test_update_erase<4>();
+        test_update_erase<8>();
+    }
+
+    template<index_t D>
+    void randomized_stress_test(index_t nbop) {
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<index_t> dist100(1, 100);
+        std::uniform_int_distribution<index_t> weights(1, 1000);
+        const index_t capacity = 500;
+        std::uniform_int_distribution<index_t> indices(0, capacity - 1);
+
+        indexed_dary_heap<index_t, D> heap(capacity);
+        std::set<std::pair<index_t, index_t>> reference;
+        std::vector<index_t> values(capacity, invalid_index);
+
+        for (index_t i = 0; i < nbop; i++) {
+            auto op = dist100(rng);
+            auto index = indices(rng);
+            if (op < 50) {
+                if (values[index] == invalid_index) {
+                    auto w = weights(rng);
+                    heap.push(index, w);
+                    reference.insert({w, index});
+                    values[index] = w;
+                }
+            } else if (op < 70) {
+                if (!reference.empty()) {
+                    REQUIRE(heap.top_value() == reference.begin()->first);
+                    REQUIRE(values[heap.top()] == heap.top_value());
+                    values[heap.top()] = invalid_index;
+                    reference.erase({heap.top_value(), heap.top()});
+                    heap.pop();
+                }
+            } else if (op < 90) {
+                if (values[index] != invalid_index) {
+                    auto w = weights(rng);
+                    reference.erase({values[index], index});
+                    reference.insert({w, index});
+                    values[index] = w;
+                    heap.update(index, w);
+                    REQUIRE(heap.value(index) == w);
+                }
+            } else {
+                if (values[index] != invalid_index) {
+                    reference.erase({values[index], index});
+                    values[index] = invalid_index;
+                    heap.erase(index);
+                }
+            }
+            REQUIRE(heap.size() == reference.size());
+            REQUIRE(heap.contains(index) == (values[index] != invalid_index));
+        }
+    }
+
+    TEST_CASE("indexed dary heap randomized stress test", "[indexed_dary_heap]") {
+        randomized_stress_test<2>(20000);
+        randomized_stress_test<4>(20000);
+        randomized_stress_test<7>(20000);
+    }
+}
@@ -31,7 +31,8 @@ namespace lca {
     } data;
 
 
-    TEMPLATE_TEST_CASE("lca pairs of vertices", "[lca]", hg::lca_sparse_table, hg::lca_sparse_table_block) {
+    TEMPLATE_TEST_CASE("lca pairs of vertices", "[lca]", hg::lca_sparse_table, hg::lca_sparse_table_block,
+                       hg::lca_preorder_block, hg::lca_preorder_block_32) {
         auto t = data.t;
         TestType lca(t);
         REQUIRE(lca.lca(0, 0) == 0);
@@ -49,7 +50,8 @@ namespace lca {
         REQUIRE(lca.lca(2, 6) == 6);
     }
 
-    TEMPLATE_TEST_CASE("lca iterators", "[lca]", hg::lca_sparse_table, hg::lca_sparse_table_block) {
+    TEMPLATE_TEST_CASE("lca iterators", "[lca]", hg::lca_sparse_table, hg::lca_sparse_table_block,
+                       hg::lca_preorder_block, hg::lca_preorder_block_32) {
         auto g = get_4_adjacency_graph({2, 2});
         tree t(array_1d<index_t>{4, 4, 5, 5, 6, 6, 6});
         TestType lca(t);
@@ -58,7 +60,8 @@ namespace lca {
         REQUIRE((l == ref));
     }
 
-    TEMPLATE_TEST_CASE("lca tensors", "[lca]", hg::lca_sparse_table, hg::lca_sparse_table_block) {
+    TEMPLATE_TEST_CASE("lca tensors", "[lca]", hg::lca_sparse_table, hg::lca_sparse_table_block,
+                       hg::lca_preorder_block, hg::lca_preorder_block_32) {
         tree t(array_1d<index_t>{4, 4, 5, 5, 6, 6, 6});
         TestType lca(t);
         array_1d<index_t> v1{0, 0, 1, 3};
@@ -68,7 +71,8 @@ namespace lca {
         REQUIRE((l == ref));
     }
 
-    TEMPLATE_TEST_CASE("lca sanity", "[lca]", hg::lca_sparse_table, hg::lca_sparse_table_block) {
+    TEMPLATE_TEST_CASE("lca sanity", "[lca]", hg::lca_sparse_table, hg::lca_sparse_table_block,
+                       hg::lca_preorder_block, hg::lca_preorder_block_32) {
         xt::random::seed(42);
         auto g = hg::get_4_adjacency_graph({20, 20});
         auto w = xt::eval(xt::random::rand<double>({num_edges(g)}));
@@ -106,7 +110,8 @@ namespace lca {
         }
     }
 
-    TEMPLATE_TEST_CASE("lca serialization", "[lca]", hg::lca_sparse_table, hg::lca_sparse_table_block) {
+    TEMPLATE_TEST_CASE("lca serialization", "[lca]", hg::lca_sparse_table, hg::lca_sparse_table_block,
+                       hg::lca_preorder_block, hg::lca_preorder_block_32) {
         tree t(array_1d<index_t>{4, 4, 5, 5, 6, 6, 6});
         TestType lca(t);
         array_1d<index_t> v1{0, 0, 1, 3};
@@ -123,4 +128,80 @@ namespace lca {
         auto l2 = lca3.lca(v1, v2);
         REQUIRE((l2 == ref));
     }
-}
\ No newline at end of file
+
+    TEMPLATE_TEST_CASE("lca preorder block large tree", "[lca]", hg::lca_preorder_block, hg::lca_preorder_block_32) {
+        // several blocks of 32 or 64 elements: in block, adjacent blocks and sparse table queries
+        xt::random::seed(42);
+        auto g = hg::get_4_adjacency_graph({40, 50});
+        auto w = xt::eval(xt::random::rand<double>({num_edges(g)}));
+        auto h = hg::bpt_canonical(g, w);
+        auto &tree = h.tree;
+        index_t num_nodes = num_vertices(tree);
+
+        TestType lca(tree);
+        REQUIRE(lca.num_elements() == num_nodes);
+        lca_sparse_table ref_lca(tree);
+
+        array_1d<index_t> v1 = xt::random::randint<index_t>({10000}, 0, num_nodes);
+        array_1d<index_t> v2 = xt::random::randint<index_t>({10000}, 0, num_nodes);
+        auto ref = ref_lca.lca(v1, v2);
+        auto res = lca.lca(v1, v2);
+        REQUIRE((ref == res));
+
+        for (index_t i = 0; i < num_nodes; i++) {
+            REQUIRE(lca.lca(i, tree.root()) == tree.root());
+            REQUIRE(lca.lca(i, parent(i, tree)) == parent(i, tree));
+        }
+    }
+
+    TEST_CASE("rmq bitmask block", "[lca]") {
+        using namespace range_minimum_query_internal;
+        xt::random::seed(42);
+        array_1d<index_t> data = xt::random::randint<index_t>({300}, 0, 20);
+        rmq_bitmask_block<index_t, int32_t> rmq_min(data);
+        rmq_bitmask_block<index_t, index_t, std::greater<index_t>> rmq_max(data);
+        for (index_t l = 0; l < (index_t) data.size(); l++) {
+            for (index_t r = l + 1; r <= (index_t) data.size(); r++) {
+                auto min = *std::min_element(data.begin() + l, data.begin() + r);
+                auto max = *std::max_element(data.begin() + l, data.begin() + r);
+                auto pmin = rmq_min.query(l, r);
+                auto pmax = rmq_max.query(l, r);
+                REQUIRE((pmin >= l && pmin < r && data(pmin) == min));
+                REQUIRE((pmax >= l && pmax < r && data(pmax) == max));
+            }
+        }
+    }
+
+    TEST_CASE("lca offline", "[lca]") {
+        tree t(array_1d<index_t>{4, 4, 5, 5, 6, 6, 6});
+        array_1d<index_t> v1{0, 0, 1, 3, 2, 4};
+        array_1d<index_t> v2{0, 3, 0, 0, 3, 5};
+        auto l = lca_offline(t, v1, v2);
+        array_1d<index_t> ref{0, 6, 4, 6, 5, 6};
+        REQUIRE((l == ref));
+    }
+
+    TEST_CASE("lca offline subtrees", "[lca]") {
+        xt::random::seed(42);
+        auto g = hg::get_4_adjacency_graph({30, 40});
+        auto w = xt::eval(xt::random::rand<double>({num_edges(g)}));
+        auto h = hg::bpt_canonical(g, w);
+        auto &tree = h.tree;
+        index_t num_nodes = num_vertices(tree);
+
+        lca_sparse_table ref_lca(tree);
+        auto ref_edges = ref_lca.lca(edge_iterator(g));
+        REQUIRE((lca_offline(tree, sources(g), targets(g)) == ref_edges));
+
+        array_1d<index_t> v1 = xt::random::randint<index_t>({5000}, 0, num_nodes);
+        array_1d<index_t> v2 = xt::random::randint<index_t>({5000}, 0, num_nodes);
+        auto ref = ref_lca.lca(v1, v2);
+        REQUIRE((lca_offline(tree, v1, v2) == ref));
+
+        // cut the tree into small subtrees
+        for (index_t grain: {1, 7, 100, 1000}) {
+            REQUIRE((lca_internal::lca_offline_impl<int32_t>(tree, v1, v2, grain) == ref));
+            REQUIRE((lca_internal::lca_offline_impl<index_t>(tree, sources(g), targets(g), grain) == ref_edges));
+        }
+    }
+}
@@ -0,0 +1,111 @@
+/***************************************************************************
+* Copyright ESIEE Paris (2021)                                             *
+*                                                                          *
+* Contributor(s) : Benjamin Perret                                         *
+*                                                                          *
+* Distributed under the terms of the CECILL-B License.                     *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "higra/structure/pairing_heap.hpp"
+#include "../test_utils.hpp"
+#include <random>
+#include <set>
+
+namespace test_pairing_heap {
+
+    using namespace hg;
+    using namespace std;
+
+    TEST_CASE("pairing heap push-top-size-empty", "[pairing_heap]") {
+        pairing_heap<hg::index_t> heap;
+        REQUIRE(heap.empty());
+        heap.push(10);
+        REQUIRE(heap.size() == 1);
+        REQUIRE(!heap.empty());
+        REQUIRE(heap.top()->get_value() == 10);
+        heap.push(15);
+        REQUIRE(heap.top()->get_value() == 10);
+        heap.push(8);
+        REQUIRE(heap.size() == 3);
+        REQUIRE(heap.top()->get_value() == 8);
+
+        heap.clear();
+        REQUIRE(heap.size() == 0);
+        REQUIRE(heap.empty());
+    }
+
+    TEST_CASE("pairing heap decrease increase erase", "[pairing_heap]") {
+        pairing_heap<hg::index_t> heap(3); // small blocks
+        heap.push(10);
+        heap.push(15);
+        auto e0 = heap.push(8);
+        auto e1 = heap.push(22);
+        auto e2 = heap.push(17);
+        auto e3 = heap.push(5);
+        auto e4 = heap.push(19);
+        heap.push(2);
+
+        REQUIRE(heap.top()->get_value() == 2);
+        heap.pop();
+
+        heap.decrease(e2, 12);
+        heap.decrease(e1, 3);
+        heap.increase(e3, 25);
+        heap.update(e0, 9);
+        heap.erase(e4);
+
+        std::vector<hg::index_t> ref{3, 9, 10, 12, 15, 25};
+        for (auto v: ref) {
+            REQUIRE(heap.top()->get_value() == v);
+            heap.pop();
+        }
+        REQUIRE(heap.empty());
+        REQUIRE(heap.size() == 0);
+    }
+
+    TEST_CASE("pairing heap randomized stress test", "[pairing_heap]") {
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<index_t> dist100(1, 100);
+        std::uniform_int_distribution<index_t> weights(1, 1000);
+
+        using heap_t = pairing_heap<std::pair<index_t, index_t>>;
+        heap_t heap(64);
+        std::set<std::pair<index_t, index_t>> reference;
+        std::vector<heap_t::value_handle> handles;
+        index_t counter = 0;
+
+        for (index_t i = 0; i < 20000; i++) {
+            auto op = dist100(rng);
+            if (op < 50) {
+                std::pair<index_t, index_t> v{weights(rng), counter++};
+                handles.push_back(heap.push(v));
+                reference.insert(v);
+            } else if (op < 70) {
+                if (!reference.empty()) {
+                    auto top = heap.top();
+                    REQUIRE(top->get_value() == *reference.begin());
+                    reference.erase(reference.begin());
+                    handles.erase(std::find(handles.begin(), handles.end(), top));
+                    heap.pop();
+                }
+            } else if (!handles.empty()) {
+                std::uniform_int_distribution<index_t> dist(0, (index_t) handles.size() - 1);
+                auto pos = dist(rng);
+                auto handle = handles[pos];
+                reference.erase(handle->get_value());
+                if (op < 90) {
+                    std::pair<index_t, index_t> v{weights(rng), handle->get_value().second};
+                    heap.update(handle, v);
+                    reference.insert(v);
+                } else {
+                    heap.erase(handle);
+                    handles.erase(handles.begin() + pos);
+                }
+            }
+            REQUIRE(heap.size() == reference.size());
+            REQUIRE(heap.empty() == reference.empty());
+        }
+    }
+}
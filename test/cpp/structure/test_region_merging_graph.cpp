@@ -0,0 +1,158 @@
+/***************************************************************************
+* Copyright ESIEE Paris (2021)                                             *
+*                                                                          *
+* Contributor(s) : Benjamin Perret                                         *
+*                                                                          *
+* Distributed under the terms of the CECILL-B License.                     *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "higra/graph.hpp"
+#include "higra/structure/region_merging_graph.hpp"
+#include "higra/image/graph_image.hpp"
+#include "../test_utils.hpp"
+#include <random>
+
+namespace test_region_merging_graph {
+
+    using namespace std;
+    using namespace hg;
+
+    template<typename graph_t>
+    auto adjacency_lists(const graph_t &g) {
+        vector<vector<pair<index_t, index_t>>> res;
+        for (auto v: hg::vertex_iterator(g)) {
+            res.push_back({});
+            for (auto e: hg::out_edge_iterator(v, g)) {
+                REQUIRE(source(e, g) == v);
+                res[v].push_back({index(e, g), target(e, g)});
+            }
+            REQUIRE(res[v].size() == degree(v, g));
+            std::sort(res[v].begin(), res[v].end());
+        }
+        return res;
+    }
+
+    TEST_CASE("region merging graph basics", "[region_merging_graph]") {
+        region_merging_graph g(4);
+        add_edge(0, 1, g);
+        add_edge(1, 2, g);
+        add_edge(0, 2, g);
+
+        REQUIRE(num_vertices(g) == 4);
+        REQUIRE(num_edges(g) == 3);
+        REQUIRE(degree(0, g) == 2);
+        REQUIRE(degree(3, g) == 0);
+
+        vector<vector<index_t>> adj_ref{{1, 2},
+                                        {0, 2},
+                                        {0, 1},
+                                        {}};
+        for (auto v: hg::vertex_iterator(g)) {
+            vector<index_t> adj;
+            for (auto n: hg::adjacent_vertex_iterator(v, g)) {
+                adj.push_back(n);
+            }
+            REQUIRE(vectorSame(adj_ref[v], adj));
+            for (auto e: hg::in_edge_iterator(v, g)) {
+                REQUIRE(target(e, g) == v);
+            }
+        }
+
+        remove_edge(1, g);
+        REQUIRE(edge_from_index(1, g).source == invalid_index);
+        REQUIRE(degree(0, g) == 2);
+        REQUIRE(degree(1, g) == 1);
+        REQUIRE(degree(2, g) == 1);
+
+        set_edge(2, 3, 0, g);
+        auto e = edge_from_index(2, g);
+        REQUIRE(e.source == 0);
+        REQUIRE(e.target == 3);
+        REQUIRE(degree(0, g) == 2);
+        REQUIRE(degree(2, g) == 0);
+        REQUIRE(degree(3, g) == 1);
+
+        vector<vector<index_t>> adj_ref2{{1, 3},
+                                         {0},
+                                         {},
+                                         {0}};
+        for (auto v: hg::vertex_iterator(g)) {
+            vector<index_t> adj;
+            for (auto n: hg::adjacent_vertex_iterator(v, g)) {
+                adj.push_back(n);
+            }
+            REQUIRE(vectorSame(adj_ref2[v], adj));
+        }
+    }
+
+    TEST_CASE("region merging graph copy", "[region_merging_graph]") {
+        auto g0 = get_4_adjacency_graph({3, 4});
+        auto g = copy_graph<region_merging_graph>(g0);
+        REQUIRE(num_vertices(g) == num_vertices(g0));
+        REQUIRE(num_edges(g) == num_edges(g0));
+        REQUIRE((sources(g) == sources(g0)));
+        REQUIRE((targets(g) == targets(g0)));
+        REQUIRE(adjacency_lists(g) == adjacency_lists(g0));
+    }
+
+    TEST_CASE("region merging graph random merges", "[region_merging_graph]") {
+        // simulates a region merging process on both a region_merging_graph and an undirected_graph<hash_setS>
+        std::mt19937 rng(42);
+        auto g0 = get_4_adjacency_graph({20, 20});
+        auto g = copy_graph<region_merging_graph>(g0);
+        auto gref = copy_graph<undirected_graph<hash_setS>>(g0);
+        auto initial_memory = g.memory_usage();
+
+        std::vector<index_t> alive_edges(num_edges(g0));
+        std::iota(alive_edges.begin(), alive_edges.end(), 0);
+
+        while (!alive_edges.empty()) {
+            std::uniform_int_distribution<index_t> dist(0, (index_t) alive_edges.size() - 1);
+            auto ei = alive_edges[dist(rng)];
+            auto e = edge_from_index(ei, gref);
+            auto r1 = e.source;
+            auto r2 = e.target;
+            auto new_region = add_vertex(g);
+            REQUIRE(add_vertex(gref) == new_region);
+
+            // edges of r1 and r2 are moved to the new region, edges between r1 and r2 and duplicate edges are removed
+            std::vector<index_t> neighbour_edge(num_vertices(gref), invalid_index);
+            std::vector<index_t> to_remove;
+            std::vector<std::pair<index_t, index_t>> to_move;
+            for (auto r: {r1, r2}) {
+                for (auto oe: out_edge_iterator(r, gref)) {
+                    auto n = target(oe, gref);
+                    if (n == r1 || n == r2 || neighbour_edge[n] != invalid_index) {
+                        to_remove.push_back(oe.index);
+                    } else {
+                        neighbour_edge[n] = oe.index;
+                        to_move.push_back({oe.index, n});
+                    }
+                }
+            }
+            std::sort(to_remove.begin(), to_remove.end());
+            to_remove.erase(std::unique(to_remove.begin(), to_remove.end()), to_remove.end());
+            for (auto r: to_remove) {
+                remove_edge(r, g);
+                remove_edge(r, gref);
+            }
+            for (auto &m: to_move) {
+                set_edge(m.first, m.second, new_region, g);
+                set_edge(m.first, m.second, new_region, gref);
+            }
+
+            alive_edges.clear();
+            for (index_t i = 0; i < (index_t) num_edges(gref); i++) {
+                if (edge_from_index(i, gref).source != invalid_index) {
+                    alive_edges.push_back(i);
+                }
+            }
+            REQUIRE(adjacency_lists(g) == adjacency_lists(gref));
+        }
+        REQUIRE(num_vertices(g) == 2 * num_vertices(g0) - 1);
+        // the out edge lists of merged regions are released
+        REQUIRE(g.memory_usage() < initial_memory + num_vertices(g0) * (sizeof(std::vector<index_t>) + sizeof(index_t)) * 2);
+    }
+}
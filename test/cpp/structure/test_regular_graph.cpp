@@ -200,4 +200,40 @@ namespace regular_graph {
         REQUIRE(num_vertices(ug4) == 16);
         REQUIRE(num_edges(ug4) == 32);
     }
+
+    template<typename graph_t>
+    void check_regular_graph_edge_index(const graph_t &g) {
+        auto ug = copy_graph(g);
+        REQUIRE(num_edges(g) == num_edges(ug));
+        for (index_t ei = 0; ei < (index_t) num_edges(ug); ei++) {
+            auto e = edge_from_index(ei, g);
+            REQUIRE(source(e, g) == source(edge_from_index(ei, ug), ug));
+            REQUIRE(target(e, g) == target(edge_from_index(ei, ug), ug));
+            REQUIRE(index(e, g) == ei);
+            REQUIRE(index(std::make_pair(target(e, g), source(e, g)), g) == ei);
+        }
+        REQUIRE((sources(g) == sources(ug)));
+        REQUIRE((targets(g) == targets(ug)));
+    }
+
+    TEST_CASE("regular graph edge index", "[regular_graph]") {
+        hg::embedding_grid_1d embedding1{7};
+        check_regular_graph_edge_index(hg::regular_grid_graph_1d(embedding1, {{-1}, {1}, {3}, {0}}));
+
+        check_regular_graph_edge_index(data.g);
+        hg::embedding_grid_2d embedding2{5, 4};
+        check_regular_graph_edge_index(hg::regular_grid_graph_2d(embedding2, {{1, 1}, {0, 1}, {1, -1}, {-1, 0},
+                                                                              {2, -3}, {0, 5}}));
+
+        hg::embedding_grid_3d embedding3{3, 4, 5};
+        check_regular_graph_edge_index(hg::regular_grid_graph_3d(embedding3, {{0, 0, 1}, {1, -1, 0}, {0, 1, 0},
+                                                                              {-1, -1, -1}, {1, 1, 1}, {1, 0, 0}}));
+
+        hg::embedding_grid_4d embedding4{2, 3, 2, 3};
+        check_regular_graph_edge_index(hg::regular_grid_graph_4d(embedding4, {{0, 0, 0, 1}, {0, 0, 1, 0},
+                                                                              {0, 1, 0, 0}, {1, 0, 0, 0},
+                                                                              {1, -1, 1, -1}}));
+
+        REQUIRE(index(std::make_pair((index_t) 0, (index_t) 5), data.g) == invalid_index);
+    }
 }
\ No newline at end of file
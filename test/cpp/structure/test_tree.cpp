@@ -56,6 +56,31 @@ namespace tree {
         REQUIRE(t.children_computed() == false);
     }
 
+    TEST_CASE("tree children csr", "[tree]") {
+        array_1d<index_t> parents{9, 9, 10, 11, 10, 11, 12, 12, 12, 13, 13, 13, 13, 13};
+        std::vector<index_t> offsets;
+        std::vector<index_t> indices;
+        tree_internal::compute_children_csr(parents, 9, offsets, indices);
+        std::vector<index_t> ref_offsets{0, 2, 4, 6, 9, 13};
+        std::vector<index_t> ref_indices{0, 1, 2, 4, 3, 5, 6, 7, 8, 9, 10, 11, 12};
+        REQUIRE(offsets == ref_offsets);
+        REQUIRE(indices == ref_indices);
+
+        std::vector<index_t> offsets_parallel;
+        std::vector<index_t> indices_parallel;
+        tree_internal::compute_children_csr(parents, 9, offsets_parallel, indices_parallel, true);
+        REQUIRE(offsets_parallel == ref_offsets);
+        REQUIRE(indices_parallel == ref_indices);
+
+        hg::tree t(parents);
+        t.compute_children();
+        REQUIRE(t.children(0).empty());
+        REQUIRE(t.children(12).size() == 3);
+        REQUIRE(t.child(1, 10) == 4);
+        std::vector<index_t> children13(t.children(13).begin(), t.children(13).end());
+        REQUIRE(children13 == std::vector<index_t>{9, 10, 11, 12});
+    }
+
     TEST_CASE("tree sizes", "[tree]") {
         auto t = data.t;
         REQUIRE(hg::category(t) == tree_category::partition_tree);
@@ -0,0 +1,98 @@
+/***************************************************************************
+* Copyright ESIEE Paris (2021)                                             *
+*                                                                          *
+* Contributor(s) : Benjamin Perret                                         *
+*                                                                          *
+* Distributed under the terms of the CECILL-B License.                     *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "higra/structure/unionfind.hpp"
+#include "../test_utils.hpp"
+#include <numeric>
+#include <random>
+
+namespace test_unionfind {
+
+    using namespace hg;
+    using namespace std;
+
+    /*
+     * Random unions checked against a naive labeling where each union relabels a whole set
+     */
+    template<typename uf_t>
+    void test_union_find_random() {
+        const index_t size = 500;
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<index_t> dist(0, size - 1);
+
+        uf_t uf(size);
+        std::vector<index_t> labels(size);
+        std::iota(labels.begin(), labels.end(), 0);
+
+        for (index_t k = 0; k < 400; k++) {
+            auto i = dist(rng);
+            auto j = dist(rng);
+            auto ci = uf.find(i);
+            auto cj = uf.find(j);
+            REQUIRE(ci == uf.find_no_compression(i));
+            REQUIRE((ci == cj) == (labels[i] == labels[j]));
+            if (ci != cj) {
+                auto c = uf.link(ci, cj);
+                REQUIRE((c == ci || c == cj));
+                auto li = labels[i];
+                for (auto &l: labels) {
+                    if (l == li) {
+                        l = labels[j];
+                    }
+                }
+            }
+        }
+        for (index_t i = 0; i < size; i++) {
+            for (index_t j = 0; j < size; j += 7) {
+                REQUIRE((uf.find(i) == uf.find(j)) == (labels[i] == labels[j]));
+            }
+        }
+    }
+
+    TEST_CASE("union find", "[union_find]") {
+        test_union_find_random<union_find>();
+        test_union_find_random<basic_union_find<index_t, union_find_policy::path_halving>>();
+        test_union_find_random<basic_union_find<index_t, union_find_policy::path_splitting>>();
+        test_union_find_random<basic_union_find<index_t, union_find_policy::path_compression,
+                union_find_policy::interleaved_storage>>();
+        test_union_find_random<basic_union_find<int32_t, union_find_policy::path_halving,
+                union_find_policy::interleaved_storage>>();
+        test_union_find_random<concurrent_union_find<>>();
+        test_union_find_random<concurrent_union_find<int32_t>>();
+    }
+
+    TEST_CASE("union find make set", "[union_find]") {
+        basic_union_find<int32_t, union_find_policy::path_splitting, union_find_policy::interleaved_storage> uf;
+        REQUIRE(uf.make_set() == 0);
+        REQUIRE(uf.make_set() == 1);
+        REQUIRE(uf.make_set() == 2);
+        REQUIRE(uf.find(1) == 1);
+        uf.link(uf.find(0), uf.find(2));
+        REQUIRE(uf.find(0) == uf.find(2));
+        REQUIRE(uf.find(0) != uf.find(1));
+    }
+
+    TEST_CASE("concurrent union find", "[union_find]") {
+        const index_t size = 100000;
+        concurrent_union_find<> uf(size);
+
+        // links i and i + 2: two sets containing respectively even and odd elements
+        parfor(0, size - 2, [&uf](index_t i) {
+            uf.unite(i, i + 2);
+        });
+
+        REQUIRE(uf.same_set(0, size - 2));
+        REQUIRE(uf.same_set(1, size - 1));
+        REQUIRE(!uf.same_set(0, 1));
+        REQUIRE(!uf.unite(4, 100));
+        REQUIRE(uf.unite(4, 101));
+        REQUIRE(uf.same_set(0, 1));
+    }
+}
@@ -10,6 +10,7 @@
 
 #include "higra/sorting.hpp"
 #include "test_utils.hpp"
+#include "xtensor/xrandom.hpp"
 
 namespace test_sorting {
 
@@ -72,4 +73,33 @@ namespace test_sorting {
         array_1d<int> ref2 = {4, 0, 1, 2, 3};
         REQUIRE((i2 == ref2));
     }
+
+    TEMPLATE_TEST_CASE("radix stable arg sort", "[sorting]", uint8_t, int16_t, uint32_t, int64_t, float, double) {
+        xt::random::seed(1);
+        for (index_t size: {0, 1, 17, 1000, 100000}) {
+            array_1d<TestType> a = xt::random::randint<int>({(size_t) size}, -40, 40);
+            if (std::is_floating_point<TestType>::value) {
+                a /= (TestType) 7;
+            }
+
+            auto ref = sorting_internal::comparison_stable_arg_sort(a, std::less<TestType>());
+            auto res = sorting_internal::radix_stable_arg_sort(a);
+            REQUIRE((ref == res));
+
+            auto ref2 = sorting_internal::comparison_stable_arg_sort(a, std::greater<TestType>());
+            auto res2 = sorting_internal::radix_stable_arg_sort(a, true);
+            REQUIRE((ref2 == res2));
+
+            REQUIRE((ref == hg::stable_arg_sort(a)));
+            REQUIRE((ref2 == hg::stable_arg_sort(a, std::greater<TestType>())));
+        }
+    }
+
+    TEST_CASE("radix stable arg sort float special values", "[sorting]") {
+        double inf = std::numeric_limits<double>::infinity();
+        array_1d<double> a = {0., -0., 1.5, -inf, -1.5, inf, 0., -0., 1e-300, -1e-300, 1e300};
+        array_1d<index_t> ref = {3, 4, 9, 0, 1, 6, 7, 8, 2, 10, 5};
+        REQUIRE((sorting_internal::radix_stable_arg_sort(a) == ref));
+        REQUIRE((sorting_internal::comparison_stable_arg_sort(a, std::less<double>()) == ref));
+    }
 }
\ No newline at end of file
@@ -61,6 +61,24 @@ class TestTreeAccumulators(unittest.TestCase):
         ref = np.asarray((-1, -1, -1, -1, -1, 1, 2, 1))
         self.assertTrue(np.allclose(ref, res))
 
+    def test_tree_accumulator_fused(self):
+        tree = TestTreeAccumulators.get_tree()
+        input_array = np.asarray((1, 8, 2, 5, 3, 0, 4, 7), dtype=np.float64)
+
+        accumulators = [hg.Accumulators.sum, hg.Accumulators.mean, hg.Accumulators.counter, hg.Accumulators.sum]
+        res = hg.accumulate_parallel(tree, input_array, accumulators)
+        self.assertTrue(len(res) == 4)
+        for r, acc in zip(res, accumulators):
+            ref = hg.accumulate_parallel(tree, input_array, acc)
+            self.assertTrue(np.allclose(ref[tree.num_leaves():], r[tree.num_leaves():]))
+
+        leaf_data = np.asarray(((1, 2), (8, 1), (2, 3), (5, 0), (3, 3)), dtype=np.float64)
+        accumulators = (hg.Accumulators.min, hg.Accumulators.max, hg.Accumulators.mean)
+        res = hg.accumulate_sequential(tree, leaf_data, accumulators)
+        self.assertTrue(len(res) == 3)
+        for r, acc in zip(res, accumulators):
+            self.assertTrue(np.allclose(hg.accumulate_sequential(tree, leaf_data, acc), r))
+
     def test_tree_accumulatorVec(self):
         tree = TestTreeAccumulators.get_tree()
         input_array = np.asarray(((1, 0),
@@ -73,6 +73,27 @@ class TestGraphWeights(unittest.TestCase):
         r = hg.weight_graph(g, data, hg.WeightFunction.L2_squared)
         self.assertTrue(np.allclose(ref, r))
 
+    def test_weighting_regular_graph(self):
+        shape = (5, 7)
+        np.random.seed(42)
+        data = np.random.rand(*shape)
+        data_vectorial = np.random.rand(shape[0], shape[1], 3)
+
+        for g in (hg.get_4_adjacency_implicit_graph(shape), hg.get_8_adjacency_implicit_graph(shape)):
+            ge = g.as_explicit_graph()
+            for f in (hg.WeightFunction.mean, hg.WeightFunction.min, hg.WeightFunction.max, hg.WeightFunction.L0,
+                      hg.WeightFunction.L1, hg.WeightFunction.L2, hg.WeightFunction.L_infinity,
+                      hg.WeightFunction.L2_squared, hg.WeightFunction.source, hg.WeightFunction.target):
+                ref = hg.weight_graph(ge, data, f)
+                r = hg.weight_graph(g, data, f)
+                self.assertTrue(np.allclose(ref, r))
+
+            for f in (hg.WeightFunction.L0, hg.WeightFunction.L1, hg.WeightFunction.L2, hg.WeightFunction.L_infinity,
+                      hg.WeightFunction.L2_squared):
+                ref = hg.weight_graph(ge, data_vectorial, f)
+                r = hg.weight_graph(g, data_vectorial, f)
+                self.assertTrue(np.allclose(ref, r))
+
 
 if __name__ == '__main__':
     unittest.main()
@@ -168,6 +168,98 @@ class TestBinaryPartitionTree(unittest.TestCase):
         self.assertTrue(np.all(tree.parents() == t_ref.parents()))
         self.assertTrue(np.allclose(altitudes, alt_ref))
 
+    def test_binary_partition_tree_heap_policies(self):
+        np.random.seed(10)
+
+        g = hg.get_4_adjacency_graph((10, 10))
+        # no ties: all the heaps give the same tree
+        edge_weights = np.random.rand(g.num_edges())
+        edge_weight_weights = np.random.randint(1, 10, g.num_edges()).astype(np.float64)
+        vertex_centroids = np.random.rand(g.num_vertices(), 3)
+
+        t_ref1, alt_ref1 = hg.binary_partition_tree_complete_linkage(g, edge_weights)
+        t_ref2, alt_ref2 = hg.binary_partition_tree_average_linkage(g, edge_weights, edge_weight_weights)
+        t_ref3, alt_ref3 = hg.binary_partition_tree_exponential_linkage(g, edge_weights, 2, edge_weight_weights)
+        t_ref4, alt_ref4 = hg.binary_partition_tree_ward_linkage(g, vertex_centroids)
+
+        for heap_policy in (hg.BptHeapPolicy.fibonacci, hg.BptHeapPolicy.pairing, hg.BptHeapPolicy.dary,
+                            hg.BptHeapPolicy.automatic):
+            t1, alt1 = hg.binary_partition_tree_complete_linkage(g, edge_weights, heap_policy=heap_policy)
+            self.assertTrue(np.all(t1.parents() == t_ref1.parents()))
+            self.assertTrue(np.allclose(alt1, alt_ref1))
+
+            t2, alt2 = hg.binary_partition_tree_average_linkage(g, edge_weights, edge_weight_weights,
+                                                                heap_policy=heap_policy)
+            self.assertTrue(np.all(t2.parents() == t_ref2.parents()))
+            self.assertTrue(np.allclose(alt2, alt_ref2))
+
+            t3, alt3 = hg.binary_partition_tree_exponential_linkage(g, edge_weights, 2, edge_weight_weights,
+                                                                    heap_policy=heap_policy)
+            self.assertTrue(np.all(t3.parents() == t_ref3.parents()))
+            self.assertTrue(np.allclose(alt3, alt_ref3))
+
+            t4, alt4 = hg.binary_partition_tree_ward_linkage(g, vertex_centroids, heap_policy=heap_policy)
+            self.assertTrue(np.all(t4.parents() == t_ref4.parents()))
+            self.assertTrue(np.allclose(alt4, alt_ref4))
+
+    def test_binary_partition_tree_heap_policies_ties(self):
+        graph = hg.get_4_adjacency_graph((3, 3))
+        edge_weights = np.asarray((1, 1, 1, 2, 2, 1, 2, 1, 2, 1, 1, 2), np.float64)
+
+        # ties are broken with the edge indices by the heaps other than the Fibonacci heap
+        t_ref, alt_ref = hg.binary_partition_tree_complete_linkage(graph, edge_weights,
+                                                                   heap_policy=hg.BptHeapPolicy.dary)
+        for heap_policy in (hg.BptHeapPolicy.pairing, hg.BptHeapPolicy.automatic):
+            tree, altitudes = hg.binary_partition_tree_complete_linkage(graph, edge_weights, heap_policy=heap_policy)
+            self.assertTrue(np.all(tree.parents() == t_ref.parents()))
+            self.assertTrue(np.all(altitudes == alt_ref))
+
+    def test_binary_partition_tree_nn_chain(self):
+        np.random.seed(11)
+
+        g = hg.get_4_adjacency_graph((10, 10))
+        edge_weights = np.random.rand(g.num_edges())
+        edge_weight_weights = np.random.randint(1, 10, g.num_edges()).astype(np.float64)
+        nn_chain = hg.BptHeapPolicy.nn_chain
+
+        t_ref1, alt_ref1 = hg.binary_partition_tree_complete_linkage(g, edge_weights)
+        t1, alt1 = hg.binary_partition_tree_complete_linkage(g, edge_weights, heap_policy=nn_chain)
+        self.assertTrue(np.all(t1.parents() == t_ref1.parents()))
+        self.assertTrue(np.allclose(alt1, alt_ref1))
+
+        t_ref2, alt_ref2 = hg.binary_partition_tree_average_linkage(g, edge_weights, edge_weight_weights)
+        t2, alt2 = hg.binary_partition_tree_average_linkage(g, edge_weights, edge_weight_weights,
+                                                            heap_policy=nn_chain)
+        self.assertTrue(np.all(t2.parents() == t_ref2.parents()))
+        self.assertTrue(np.allclose(alt2, alt_ref2))
+
+        t_ref3, alt_ref3 = hg.binary_partition_tree_exponential_linkage(g, edge_weights, 2, edge_weight_weights)
+        t3, alt3 = hg.binary_partition_tree_exponential_linkage(g, edge_weights, 2, edge_weight_weights,
+                                                                heap_policy=nn_chain)
+        self.assertTrue(np.all(t3.parents() == t_ref3.parents()))
+        self.assertTrue(np.allclose(alt3, alt_ref3))
+
+        # the Ward linkage is reducible on complete graphs
+        num_points = 30
+        g4 = hg.UndirectedGraph(num_points)
+        sources, targets = np.triu_indices(num_points, 1)
+        g4.add_edges(sources, targets)
+        vertex_centroids = np.random.rand(num_points, 3)
+        vertex_sizes = np.random.randint(1, 5, num_points).astype(np.float64)
+
+        t_ref4, alt_ref4 = hg.binary_partition_tree_ward_linkage(g4, vertex_centroids, vertex_sizes)
+        t4, alt4 = hg.binary_partition_tree_ward_linkage(g4, vertex_centroids, vertex_sizes, heap_policy=nn_chain)
+        self.assertTrue(np.all(t4.parents() == t_ref4.parents()))
+        self.assertTrue(np.allclose(alt4, alt_ref4))
+
+        def weighting_function(graph, fusion_edge_index, new_region, merged_region1, merged_region2,
+                               new_neighbours):
+            for n in new_neighbours:
+                n.set_new_edge_weight(0)
+
+        with self.assertRaises(RuntimeError):
+            hg.binary_partition_tree(g, weighting_function, edge_weights, heap_policy=nn_chain)
+
 
 if __name__ == '__main__':
     unittest.main()
@@ -114,6 +114,97 @@ class TestHierarchyCore(unittest.TestCase):
         self.assertTrue(np.all(tree.parents() == ref_parents))
         self.assertTrue(np.all(altitudes == ref_altitudes_no_weights))
 
+    def test_bpt_canonical_filter_kruskal(self):
+        graph = hg.get_8_adjacency_graph((25, 31))
+        edge_weights = np.random.randint(0, 10, graph.num_edges())
+
+        tree_ref, altitudes_ref = hg.bpt_canonical(graph, edge_weights)
+        tree, altitudes = hg.bpt_canonical(graph, edge_weights, algorithm=hg.BptCanonicalAlgorithm.filter_kruskal)
+        self.assertTrue(np.all(tree.parents() == tree_ref.parents()))
+        self.assertTrue(np.all(tree.mst_edge_map == tree_ref.mst_edge_map))
+        self.assertTrue(np.all(altitudes == altitudes_ref))
+
+    def test_bpt_canonical_batch(self):
+        sources = np.asarray((0, 1, 0, 0))
+        targets = np.asarray((1, 2, 2, 1))
+        edge_weights = np.asarray((3, 1, 2, 5))
+
+        parents, altitudes, mst_edge_map, node_offsets = hg.bpt_canonical_batch(
+            sources, targets, edge_weights, edge_offsets=(0, 3, 3, 4), vertex_offsets=(0, 3, 3, 5))
+
+        self.assertTrue(np.all(parents == (4, 3, 3, 4, 4, 2, 2, 2)))
+        self.assertTrue(np.all(altitudes == (0, 0, 0, 1, 2, 0, 0, 5)))
+        self.assertTrue(np.all(mst_edge_map == (1, 2, 0)))
+        self.assertTrue(np.all(node_offsets == (0, 5, 5, 8)))
+
+    def test_bpt_canonical_batch_random(self):
+        graphs = [hg.get_4_adjacency_graph((5, 7)), hg.get_8_adjacency_graph((4, 3)), hg.get_4_adjacency_graph((9, 2))]
+        all_edge_weights = [np.random.rand(g.num_edges()) for g in graphs]
+        edge_offsets = np.cumsum([0] + [g.num_edges() for g in graphs])
+        vertex_offsets = np.cumsum([0] + [g.num_vertices() for g in graphs])
+        sources = np.concatenate([g.edge_list()[0] for g in graphs])
+        targets = np.concatenate([g.edge_list()[1] for g in graphs])
+
+        parents, altitudes, mst_edge_map, node_offsets = hg.bpt_canonical_batch(
+            sources, targets, np.concatenate(all_edge_weights), edge_offsets, vertex_offsets)
+
+        for k, (g, edge_weights) in enumerate(zip(graphs, all_edge_weights)):
+            tree_ref, altitudes_ref = hg.bpt_canonical(g, edge_weights)
+            nodes = slice(node_offsets[k], node_offsets[k + 1])
+            mst_edges = slice(node_offsets[k] - vertex_offsets[k], node_offsets[k + 1] - vertex_offsets[k + 1])
+            self.assertTrue(np.all(parents[nodes] == tree_ref.parents()))
+            self.assertTrue(np.all(altitudes[nodes] == altitudes_ref))
+            self.assertTrue(np.all(mst_edge_map[mst_edges] == tree_ref.mst_edge_map))
+
+    def test_bpt_canonical_update(self):
+        g = hg.get_4_adjacency_graph((7, 9))
+        edge_weights = np.random.randint(0, 5, g.num_edges())
+        tree, altitudes = hg.bpt_canonical(g, edge_weights)
+        for _ in range(10):
+            changed_edges = np.random.randint(0, g.num_edges(), 5)
+            new_weights = np.random.randint(0, 5, 5)
+            tree2, altitudes2, node_map = hg.bpt_canonical_update(g, edge_weights, tree, altitudes,
+                                                                   changed_edges, new_weights)
+            edge_weights[changed_edges] = new_weights
+            tree_ref, altitudes_ref = hg.bpt_canonical(g, edge_weights)
+            self.assertTrue(np.all(tree2.parents() == tree_ref.parents()))
+            self.assertTrue(np.all(altitudes2 == altitudes_ref))
+            self.assertTrue(np.all(tree2.mst_edge_map == tree_ref.mst_edge_map))
+            kept = node_map >= 0
+            self.assertTrue(np.all(altitudes[node_map[kept]] == altitudes2[kept]))
+            tree, altitudes = tree2, altitudes2
+
+    def test_dynamic_bpt_canonical(self):
+        g = hg.get_4_adjacency_graph((7, 9))
+        edge_weights = np.random.randint(0, 5, g.num_edges()).astype(np.float64)
+        bpt = hg.DynamicBptCanonical(g, edge_weights)
+        num_leaves = bpt.num_leaves()
+        self.assertTrue(num_leaves == g.num_vertices())
+        for _ in range(10):
+            changed_edges = np.random.randint(0, g.num_edges(), 5)
+            new_weights = np.random.randint(0, 5, 5).astype(np.float64)
+            parents = bpt.parents().copy()
+            removed_nodes, added_nodes, reparented_nodes = bpt.update(changed_edges, new_weights)
+            edge_weights[changed_edges] = new_weights
+            self.assertTrue(np.all(bpt.edge_weights() == edge_weights))
+
+            tree, altitudes = bpt.canonical_tree()
+            tree_ref, altitudes_ref = hg.bpt_canonical(g, edge_weights)
+            self.assertTrue(np.all(tree.parents() == tree_ref.parents()))
+            self.assertTrue(np.all(altitudes == altitudes_ref))
+            self.assertTrue(np.all(tree.mst_edge_map == tree_ref.mst_edge_map))
+            self.assertTrue(hg.CptHierarchy.get_leaf_graph(tree) is g)
+
+            # the other nodes are unchanged
+            unchanged = np.ones(parents.size, dtype=bool)
+            unchanged[removed_nodes] = False
+            unchanged[added_nodes] = False
+            unchanged[reparented_nodes] = False
+            self.assertTrue(np.all(bpt.parents()[unchanged] == parents[unchanged]))
+            for n in added_nodes:
+                self.assertTrue(bpt.is_node(n))
+                self.assertTrue(bpt.altitude(n) == edge_weights[bpt.building_edge(n)])
+
     def test_bpt_canonical_vectorial(self):
         graph = hg.get_4_adjacency_graph((2, 3))
         edge_weights = np.asarray(((1, 0, 2, 1, 1, 1, 2),
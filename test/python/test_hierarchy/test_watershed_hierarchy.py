@@ -9,6 +9,7 @@
 ############################################################################
 
 import unittest
+import concurrent.futures
 import numpy as np
 import higra as hg
 
@@ -126,6 +127,20 @@ class TestWatershedHierarchy(unittest.TestCase):
         self.assertTrue(hg.test_tree_isomorphism(tree, ref_tree))
         self.assertTrue(np.allclose(altitudes, ref_altitudes))
 
+    def test_watershed_hierarchy_by_area_multithreaded(self):
+        g = hg.get_4_adjacency_graph((32, 32))
+        np.random.seed(42)
+        all_edge_weights = [np.random.randint(0, 10, g.num_edges()) for _ in range(8)]
+
+        refs = [hg.watershed_hierarchy_by_area(g, edge_weights) for edge_weights in all_edge_weights]
+
+        with concurrent.futures.ThreadPoolExecutor(max_workers=4) as executor:
+            results = list(executor.map(lambda w: hg.watershed_hierarchy_by_area(g, w), all_edge_weights))
+
+        for (ref_tree, ref_altitudes), (tree, altitudes) in zip(refs, results):
+            self.assertTrue(np.all(ref_tree.parents() == tree.parents()))
+            self.assertTrue(np.all(ref_altitudes == altitudes))
+
 
 if __name__ == '__main__':
     unittest.main()
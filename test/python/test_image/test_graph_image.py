@@ -101,6 +101,27 @@ class TestGraphImage(unittest.TestCase):
 
         self.assertTrue(ref_edges == res_edges)
 
+    def test_get_3d_adjacency_graphs(self):
+        shape = (2, 3, 2)
+        graph = hg.get_6_adjacency_graph(shape)
+        self.assertTrue(graph.num_vertices() == 12)
+        ref_edges = set(((0, 1), (0, 2), (0, 6), (1, 3), (1, 7), (2, 3), (2, 4), (2, 8), (3, 5), (3, 9), (4, 5),
+                         (4, 10), (5, 11), (6, 7), (6, 8), (7, 9), (8, 9), (8, 10), (9, 11), (10, 11)))
+        res_edges = set(zip(*graph.edge_list()))
+        self.assertTrue(ref_edges == res_edges)
+
+        shape = (3, 3, 3)
+        for adjacency, graph_implicit, graph in ((6, hg.get_6_adjacency_implicit_graph(shape),
+                                                  hg.get_6_adjacency_graph(shape)),
+                                                 (18, hg.get_18_adjacency_implicit_graph(shape),
+                                                  hg.get_18_adjacency_graph(shape)),
+                                                 (26, hg.get_26_adjacency_implicit_graph(shape),
+                                                  hg.get_26_adjacency_graph(shape))):
+            self.assertTrue(graph_implicit.out_degree(13) == adjacency)
+            self.assertTrue(graph.out_degree(13) == adjacency)
+            self.assertTrue(graph.num_edges() == graph_implicit.as_explicit_graph().num_edges())
+            self.assertTrue(np.all(hg.CptGridGraph.get_shape(graph_implicit) == shape))
+
     def test_match_pixels_image_2d_empty(self):
         im1 = np.asarray([[1, 0, 0, 0],
                           [0, 0, 0, 0]])
@@ -56,6 +56,50 @@ class TestTreeIO(unittest.TestCase):
 
         self.assertTrue(np.allclose(tree.parents(), parents))
 
+    def test_treeReadWriteCompressed(self):
+        filename = "testTreeIO.graph"
+        silent_remove(filename)
+
+        parents = np.asarray((5, 5, 6, 6, 6, 7, 7, 7), dtype=np.uint64)
+        tree = hg.Tree(parents)
+        attr1 = np.asarray((1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0))
+
+        hg.save_tree(filename, tree, {"attr1": attr1}, compress_parents=True)
+
+        tree, attributes = hg.read_tree(filename)
+        silent_remove(filename)
+
+        self.assertTrue(np.all(tree.parents() == parents))
+        self.assertTrue(np.allclose(attr1, attributes["attr1"]))
+
+    def test_treeBinaryReadWrite(self):
+        filename = "testTreeIO.bin"
+        silent_remove(filename)
+
+        parents = np.asarray((5, 5, 6, 6, 6, 7, 7, 7), dtype=np.int64)
+        tree = hg.Tree(parents)
+
+        attr1 = np.asarray((1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0))
+        attr2 = np.asarray((8, 7, 6, 5, 4, 3, 2, 1), dtype=np.int32)
+        attr3 = np.asarray((0, 1, 0, 1, 0, 1, 0, 1), dtype=np.uint8)
+
+        hg.save_tree_binary(filename, tree, {"attr1": attr1, "attr2": attr2, "attr3": attr3}, lca=True)
+
+        tree2, attributes = hg.read_tree_mmap(filename)
+
+        self.assertTrue(np.all(tree2.parents() == parents))
+        self.assertTrue(np.all(tree2.children(7) == (5, 6)))
+
+        for k, v in (("attr1", attr1), ("attr2", attr2), ("attr3", attr3)):
+            self.assertTrue(k in attributes)
+            self.assertTrue(attributes[k].dtype == v.dtype)
+            self.assertTrue(np.all(attributes[k] == v))
+            self.assertFalse(attributes[k].flags.writeable)
+            self.assertTrue(np.all(hg.get_attribute(tree2, k) == v))
+
+        del tree2, attributes
+        silent_remove(filename)
+
     def test_print_partition_tree(self):
         tree = hg.Tree((5, 5, 6, 6, 6, 7, 7, 7))
         s = hg.print_partition_tree(tree, altitudes=np.asarray([0, 0, 0, 0, 0, 100, 1100, 20000]),